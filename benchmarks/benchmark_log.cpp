@@ -2,8 +2,11 @@
 
 #include "benchmark.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <climits>
+#include <cstdint>
 #include <complex>
 #include <fstream>
 #include <iomanip>
@@ -11,9 +14,12 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <mutex>
 #include <random>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -301,15 +307,49 @@ void benchmark_raw_logging_overhead() {
     cols.thread   = false;
     cols.callsite = false;
     cols.level    = false;
-    log::add_file_sink("temp/log1.log").set_columns(cols).set_flush_interval(std::chrono::nanoseconds{5000});
+
+    // Only one sink is active at a time, the rest are "muted" by lowering their verbosity
+    auto& file_sink = log::add_file_sink("temp/log1.log").set_columns(cols).set_flush_interval(nanoseconds{5000});
+    auto& posix_sink =
+        log::add_posix_file_sink("temp/log4.log").set_columns(cols).set_flush_interval(nanoseconds{5000});
+    auto& posix_direct_sink =
+        log::add_posix_file_sink("temp/log5.log", log::OpenMode::REWRITE, log::Verbosity::TRACE,
+                                 log::Colors::DISABLE, milliseconds{15}, cols, 1 << 20, log::DirectIO::ENABLE);
+    auto& posix_fdatasync_sink =
+        log::add_posix_file_sink("temp/log6.log", log::OpenMode::REWRITE, log::Verbosity::TRACE,
+                                 log::Colors::DISABLE, milliseconds{15}, cols, 1 << 20, log::DirectIO::DISABLE,
+                                 log::FileSync::FDATASYNC);
+
+    const auto mute_sinks = [&] {
+        for (log::Sink* sink : {&file_sink, &posix_sink, &posix_direct_sink, &posix_fdatasync_sink})
+            sink->set_verbosity(log::Verbosity::ERR);
+    };
 
     std::ofstream log_file_2("temp/log2.log");
     std::ofstream log_file_3("temp/log3.log");
 
-    benchmark("utl::log", [&]() {
+    const auto log_messages = [&] {
         REPEAT(repeats)
         UTL_LOG_TRACE("int = ", datagen::rand_int(), ", float = ", datagen::rand_double(), ", string = ", datagen::rand_string());
-    });
+    };
+
+    mute_sinks();
+    file_sink.set_verbosity(log::Verbosity::TRACE);
+    benchmark("utl::log (file sink)", log_messages);
+
+    mute_sinks();
+    posix_sink.set_verbosity(log::Verbosity::TRACE);
+    benchmark("utl::log (POSIX file sink)", log_messages);
+
+    mute_sinks();
+    posix_direct_sink.set_verbosity(log::Verbosity::TRACE);
+    benchmark("utl::log (POSIX file sink, O_DIRECT, flush every 15 ms)", log_messages);
+
+    mute_sinks();
+    posix_fdatasync_sink.set_verbosity(log::Verbosity::TRACE);
+    benchmark("utl::log (POSIX file sink, fdatasync(), flush every 15 ms)", log_messages);
+
+    mute_sinks();
 
     benchmark("flushed std::ostream::<<", [&]() {
         REPEAT(repeats)
@@ -325,9 +365,170 @@ void benchmark_raw_logging_overhead() {
     });
 }
 
+// ========================================
+// --- Multithreaded logging benchmarks ---
+// ========================================
+
+// Nanobench measures single-threaded code, which doesn't show how logging behaves under contention. Here we use
+// a simple custom harness instead: all threads start logging at the same moment, total wall time gives us the
+// throughput, while timing every individual call gives us latency percentiles as seen by the caller.
+
+struct ContentionResult {
+    double messages_per_sec;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+};
+
+template <class Func>
+ContentionResult run_contended(std::size_t thread_count, std::size_t total_messages, Func log_message) {
+    const std::size_t messages_per_thread = total_messages / thread_count;
+
+    std::vector<std::vector<std::uint32_t>> latencies(thread_count, std::vector<std::uint32_t>(messages_per_thread));
+
+    std::atomic<std::size_t> ready_count{0};
+    std::atomic<bool>        start{false};
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t)
+        threads.emplace_back([&, t] {
+            auto& thread_latencies = latencies[t];
+
+            ++ready_count;
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            for (std::size_t i = 0; i < messages_per_thread; ++i) {
+                const auto call_start = std::chrono::steady_clock::now();
+                log_message(i);
+                const auto call_end = std::chrono::steady_clock::now();
+                thread_latencies[i] =
+                    static_cast<std::uint32_t>(std::chrono::duration_cast<nanoseconds>(call_end - call_start).count());
+            }
+        });
+
+    while (ready_count.load() < thread_count) std::this_thread::yield();
+
+    const auto wall_start = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& thread : threads) thread.join();
+    const auto wall_end = std::chrono::steady_clock::now();
+
+    // Merge per-thread latencies and compute percentiles
+    std::vector<std::uint32_t> merged;
+    merged.reserve(thread_count * messages_per_thread);
+    for (const auto& thread_latencies : latencies)
+        merged.insert(merged.end(), thread_latencies.begin(), thread_latencies.end());
+
+    const auto percentile = [&](double q) {
+        const auto nth = merged.begin() + static_cast<std::ptrdiff_t>(q * static_cast<double>(merged.size() - 1));
+        std::nth_element(merged.begin(), nth, merged.end());
+        return static_cast<double>(*nth);
+    };
+
+    const double wall_time_sec = std::chrono::duration<double>(wall_end - wall_start).count();
+
+    return {static_cast<double>(merged.size()) / wall_time_sec, percentile(0.5), percentile(0.99), percentile(0.999)};
+}
+
+// Stream buffer that discards everything, lets us measure the cost of formatting & locking without any I/O
+class NullStreambuf : public std::streambuf {
+protected:
+    int_type        overflow(int_type ch) override { return ch; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+void benchmark_multithreaded_logging() {
+    using namespace utl;
+
+    constexpr std::size_t total_messages = 128'000;
+    constexpr std::size_t thread_counts[] = {1, 4, 16, 64};
+
+    log::Columns cols;
+    cols.datetime = false;
+    cols.uptime   = false;
+    cols.callsite = false;
+    cols.level    = false;
+
+    // Message data is pregenerated, 'datagen::' PRNG is not thread-safe
+    std::vector<std::string> strings(500);
+    for (auto& e : strings) e = datagen::rand_string();
+
+    // Sinks stay registered after the benchmark returns, the streams they point to have to outlive it
+    static NullStreambuf      null_streambuf;
+    static std::ostream       null_stream(&null_streambuf);
+    static std::ostringstream string_stream;
+
+    // Only one sink is active at a time, the rest are "muted" by lowering their verbosity
+    auto& null_sink = log::add_ostream_sink(null_stream, log::Verbosity::ERR, log::Colors::DISABLE, milliseconds{15},
+                                            cols);
+    auto& ostream_sink = log::add_ostream_sink(string_stream, log::Verbosity::ERR, log::Colors::DISABLE,
+                                               milliseconds{15}, cols);
+    auto& file_sink = log::add_file_sink("temp/log7.log", log::OpenMode::REWRITE, log::Verbosity::ERR,
+                                         log::Colors::DISABLE, milliseconds{15}, cols);
+    auto& posix_sink = log::add_posix_file_sink("temp/log8.log", log::OpenMode::REWRITE, log::Verbosity::ERR,
+                                                log::Colors::DISABLE, milliseconds{15}, cols);
+    auto& recorder_sink =
+        log::add_flight_recorder_sink("temp/log10.log", 4096, log::Verbosity::ERR, log::OpenMode::REWRITE, cols)
+            .set_verbosity(log::Verbosity::ERR);
+
+    const auto log_message = [&](std::size_t i) {
+        UTL_LOG_TRACE("int = ", i, ", float = ", static_cast<double>(i) * 0.37, ", string = ",
+                      strings[i % strings.size()]);
+    };
+
+    // Baselines, the best we could hope for is formatting without any output, the simplest
+    // thing one would do without a logger is to stream into the file under a mutex
+    std::ofstream log_file_9("temp/log9.log");
+    std::mutex    log_file_9_mutex;
+
+    const auto format_only = [&](std::size_t i) {
+        thread_local std::string buffer;
+        buffer.clear();
+        log::append_stringified(buffer, "int = ", i, ", float = ", static_cast<double>(i) * 0.37, ", string = ",
+                                strings[i % strings.size()], "\n");
+        DO_NOT_OPTIMIZE_AWAY(buffer);
+    };
+
+    const auto locked_ostream = [&](std::size_t i) {
+        const std::lock_guard lock(log_file_9_mutex);
+        log_file_9 << "int = " << i << ", float = " << static_cast<double>(i) * 0.37
+                   << ", string = " << strings[i % strings.size()] << '\n';
+    };
+
+    table::create({50, 8, 16, 12, 12, 12});
+    table::set_formats({table::DEFAULT(), table::DEFAULT(), table::FIXED(0), table::FIXED(0), table::FIXED(0),
+                        table::FIXED(0)});
+    table::hline();
+    table::cell("Method", "Threads", "Messages/sec", "p50 (ns)", "p99 (ns)", "p999 (ns)");
+    table::hline();
+
+    const auto run = [&](const char* name, auto func) {
+        for (const std::size_t thread_count : thread_counts) {
+            const auto res = run_contended(thread_count, total_messages, func);
+            table::cell(name, thread_count, res.messages_per_sec, res.p50_ns, res.p99_ns, res.p999_ns);
+        }
+        table::hline();
+    };
+
+    const auto run_sink = [&](const char* name, log::Sink& sink) {
+        sink.set_verbosity(log::Verbosity::TRACE);
+        run(name, log_message);
+        sink.set_verbosity(log::Verbosity::ERR);
+    };
+
+    run("log::append_stringified() (no output, baseline)", format_only);
+    run("std::ofstream << under std::mutex (baseline)", locked_ostream);
+    run_sink("utl::log (null sink)", null_sink);
+    run_sink("utl::log (std::ostringstream sink)", ostream_sink);
+    run_sink("utl::log (file sink)", file_sink);
+    run_sink("utl::log (POSIX file sink)", posix_sink);
+    run_sink("utl::log (flight recorder sink)", recorder_sink);
+}
+
 int main() {
     using namespace utl;
 
     //benchmark_stringification();
     benchmark_raw_logging_overhead();
+    benchmark_multithreaded_logging();
 }
\ No newline at end of file
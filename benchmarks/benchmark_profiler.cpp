@@ -78,6 +78,26 @@ void benchmark_profiling_overhead() {
     // completely different profiling method (like, for example, sampling or CPU instruction modeling)
 }
 
+void benchmark_clock_overhead() {
+    constexpr int repeats = 1'000;
+
+    bench.title("Clock overhead").minEpochIterations(100).timeUnit(nanosecond, "ns").relative(true);
+
+    const auto benchmark_clock = [&](const char* name, auto clock) {
+        using clock_type = decltype(clock);
+        benchmark(name, [&]() {
+            REPEAT(repeats) DO_NOT_OPTIMIZE_AWAY(clock_type::now());
+        });
+    };
+
+    benchmark_clock("std::chrono::steady_clock::now()", std::chrono::steady_clock{});
+#if defined(UTL_PROFILER_HAS_x86_TSC)
+    benchmark_clock("profiler::tsc_clock::now()", utl::profiler::tsc_clock{});
+    benchmark_clock("profiler::tsc_clock_rdtscp::now()", utl::profiler::tsc_clock_rdtscp{});
+    benchmark_clock("profiler::tsc_clock_fenced::now()", utl::profiler::tsc_clock_fenced{});
+#endif
+}
+
 void test_scope_profiler_precision() {
     UTL_PROFILER("Scope precision test:   50 ms") utl::sleep::spinlock(50);
     UTL_PROFILER("Scope precision test:  200 ms") utl::sleep::spinlock(200);
@@ -122,6 +142,20 @@ void test_profiler_recursion_handling() {
     DO_NOT_OPTIMIZE_AWAY(sum);
 }
 
+void test_multithreaded_profiling() {
+    // Each task spins for 10 ms, we expect 'Parallel task' time to sum up to ~ (task_count * 10 ms) across threads
+    // and every thread of the pool to show up in per-thread results
+    constexpr int task_count = 40;
+
+    utl::parallel::set_thread_count(4);
+
+    utl::parallel::for_loop(utl::parallel::IndexRange<int>{0, task_count, 1}, [](int low, int high) {
+        for (int i = low; i < high; ++i) {
+            UTL_PROFILER("Parallel task: 10 ms each") utl::sleep::spinlock(10);
+        }
+    });
+}
+
 void computation_1() { std::this_thread::sleep_for(std::chrono::milliseconds(300)); }
 void computation_2() { std::this_thread::sleep_for(std::chrono::milliseconds(200)); }
 void computation_3() { std::this_thread::sleep_for(std::chrono::milliseconds(400)); }
@@ -130,9 +164,11 @@ void computation_5() { std::this_thread::sleep_for(std::chrono::milliseconds(100
 
 int main() {
     //benchmark_profiling_overhead();
+    //benchmark_clock_overhead();
     //test_scope_profiler_precision();
     //test_segment_profiler_precision();
     //test_profiler_recursion_handling();
+    //test_multithreaded_profiling();
     
     // Profile a scope
     UTL_PROFILER("Computation 1 & 2") {
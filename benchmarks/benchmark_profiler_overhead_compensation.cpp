@@ -0,0 +1,57 @@
+// __________ BENCHMARK FRAMEWORK & LIBRARY  __________
+
+#include <chrono>
+#include <iostream>
+
+// Compensation changes the reported times of every record, which is why it gets its own translation unit
+// instead of affecting the default configuration measured by 'benchmark_profiler'
+#define UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+
+#include "benchmark.hpp"
+
+#include "thirdparty/nanobench.h"
+
+// ________________ BENCHMARK INCLUDES ________________
+
+#include <cmath>
+
+// _____________ BENCHMARK IMPLEMENTATION _____________
+
+const auto compute_value = []() { return std::atan(std::pow(std::cos(std::sin(utl::random::rand_double())), 0.5)); };
+// same computation as in 'benchmark_profiler', heavy enough to be measurable, yet fast enough to not overshadow
+// profiling overhead
+
+void test_overhead_compensation() {
+    // Short frequently hit scope nested inside a parent, this is the worst case for timer overhead. We expect
+    // compensated time of the parent to be a lot closer to the runtime without profiling than the raw one
+    constexpr int repeats = 1'000'000;
+
+    const auto work = [&](auto&& profiled_body) {
+        double s = 0.;
+        REPEAT(repeats) profiled_body(s);
+        DO_NOT_OPTIMIZE_AWAY(s);
+    };
+
+    const auto time = [](auto&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    const double unprofiled_ms = time([&] { work([](double& s) { s += compute_value(); }); });
+
+    utl::profiler::reset();
+    UTL_PROFILER("Overhead compensation test: parent") {
+        work([](double& s) { UTL_PROFILER("Overhead compensation test: child") s += compute_value(); });
+    }
+
+    const utl::profiler::snapshot results = utl::profiler::get_snapshot();
+    for (const auto& record : results.records) {
+        using ms = std::chrono::duration<double, std::milli>;
+        std::cout << record.callsite->label << " -> raw " << ms(record.overhead.raw_time).count()
+                  << " ms, compensated " << ms(record.accumulated_time).count() << " ms, no profiling "
+                  << unprofiled_ms << " ms\n";
+    }
+}
+
+int main() { test_overhead_compensation(); }
@@ -1,10 +1,15 @@
 // __________ BENCHMARK FRAMEWORK & LIBRARY  __________
 
 #include "benchmark.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -62,6 +67,435 @@ void benchmark_prngs() {
     benchmark_prng<random::generators::Xoshiro256PlusPlus>("Xoshiro256++");
     benchmark_prng<random::generators::Xorshift64Star>("Xorshift64*");
     benchmark_prng<random::generators::ChaCha20>("ChaCha20");
+    benchmark_prng<random::generators::Philox4x32>("Philox4x32");
+    benchmark_prng<random::generators::Philox4x64>("Philox4x64");
+}
+
+// =====================
+// --- Distributions ---
+// =====================
+
+template <class Distribution>
+void benchmark_distribution(const char* name, Distribution distr) {
+    using result_type = typename Distribution::result_type;
+
+    utl::random::generators::Xoshiro256PlusPlus gen{rand_seed};
+    std::vector<result_type>                    data(data_size);
+
+    benchmark(name, [&] {
+        for (auto& e : data) e = distr(gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+}
+
+void benchmark_distributions() {
+    using namespace utl;
+
+    log::println("\n\n====== BENCHMARKING: Distributions ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Data memory usage -> ", math::memory_size<double>(data_size), " MiB");
+
+    bench.title("Uniform int").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+    benchmark_distribution("std::uniform_int_distribution<>", std::uniform_int_distribution{0, 999});
+    benchmark_distribution("random::distributions::UniformIntDistribution<>",
+                           random::distributions::UniformIntDistribution{0, 999});
+
+    bench.title("Uniform real").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+    benchmark_distribution("std::uniform_real_distribution<>", std::uniform_real_distribution{-1., 1.});
+    benchmark_distribution("random::distributions::UniformRealDistribution<>",
+                           random::distributions::UniformRealDistribution{-1., 1.});
+
+    bench.title("Normal").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+    benchmark_distribution("std::normal_distribution<>", std::normal_distribution{0., 1.});
+    benchmark_distribution("random::distributions::NormalDistribution<>",
+                           random::distributions::NormalDistribution{0., 1.});
+
+    bench.title("Exponential").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+    benchmark_distribution("std::exponential_distribution<>", std::exponential_distribution{1.});
+    benchmark_distribution("random::distributions::ExponentialDistribution<>",
+                           random::distributions::ExponentialDistribution{1.});
+}
+
+// =======================
+// --- Bulk Generation ---
+// =======================
+
+template <class Generator>
+void benchmark_bulk_bits(const char* name) {
+    using result_type = typename Generator::result_type;
+
+    Generator                gen{rand_seed};
+    std::vector<result_type> data(data_size * sizeof(std::uint64_t) / sizeof(result_type));
+
+    benchmark((std::string(name) + " (sequential)").c_str(), [&] {
+        for (auto& e : data) e = gen();
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark((std::string(name) + " (bulk)").c_str(), [&] {
+        utl::random::generate(gen, data);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+}
+
+void benchmark_bulk_generation() {
+    using namespace utl;
+
+    log::println("\n\n====== BENCHMARKING: Bulk generation ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Data memory usage -> ", math::memory_size<std::uint64_t>(data_size), " MiB");
+
+    bench.title("Bulk random bits").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    benchmark_bulk_bits<random::generators::Xoshiro256PlusPlus>("Xoshiro256++");
+    benchmark_bulk_bits<random::generators::RomuTrio32>("RomuTrio32");
+
+    bench.title("Bulk distributions").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    random::generators::Xoshiro256PlusPlus gen{rand_seed};
+    std::vector<double>                    data(data_size);
+
+    benchmark("std::uniform_real_distribution<>", [&] {
+        std::uniform_real_distribution dist{-1., 1.};
+        for (auto& e : data) e = dist(gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("random::fill_uniform()", [&] {
+        random::fill_uniform(gen, data, -1., 1.);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("std::normal_distribution<>", [&] {
+        std::normal_distribution dist{0., 1.};
+        for (auto& e : data) e = dist(gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("random::fill_normal()", [&] {
+        random::fill_normal(gen, data);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    // Bulk generation relies on auto-vectorization, to see the full effect compile with '-O3 -march=native'
+}
+
+// ======================
+// --- Counter access ---
+// ======================
+
+void benchmark_counter_access() {
+    using namespace utl;
+
+    log::println("\n\n====== BENCHMARKING: Counter-based access ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Data memory usage -> ", math::memory_size<std::uint32_t>(data_size), " MiB");
+
+    bench.title("Philox4x32 access").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    random::generators::Philox4x32 gen{rand_seed};
+    std::vector<std::uint32_t>     data(data_size); // 'data_size' is a multiple of 4
+
+    benchmark("Sequential", [&] {
+        for (auto& e : data) e = gen();
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Single block at()", [&] {
+        for (std::size_t i = 0; i < data.size() / 4; ++i) {
+            const auto block = gen.at(i);
+            for (std::size_t j = 0; j < 4; ++j) data[4 * i + j] = block[j];
+        }
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Batch at()", [&] {
+        gen.at(0, 0, data.data(), data.size() / 4);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Batch at() + parallel::for_loop()", [&] {
+        const parallel::IndexRange<std::size_t> blocks{0, data.size() / 4};
+        parallel::for_loop(blocks, [&](std::size_t low, std::size_t high) {
+            gen.at(low, 0, data.data() + 4 * low, high - low); // same result for any split between threads
+        });
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+}
+
+// =========================
+// --- Discrete Sampling ---
+// =========================
+
+void benchmark_discrete_sampling() {
+    using namespace utl;
+
+    constexpr std::size_t category_count = 1'000'000;
+
+    log::println("\n\n====== BENCHMARKING: Discrete sampling ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Categories        -> ", category_count);
+    log::println("Data memory usage -> ", math::memory_size<std::uint32_t>(data_size), " MiB");
+
+    random::generators::Xoshiro256PlusPlus gen{rand_seed};
+    std::vector<double>                    weights(category_count);
+    random::fill_uniform(gen, weights);
+
+    bench.title("Discrete build").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    benchmark("std::discrete_distribution<>", [&] {
+        std::discrete_distribution<std::uint32_t> distr(weights.begin(), weights.end());
+        DO_NOT_OPTIMIZE_AWAY(distr);
+    });
+
+    benchmark("random::distributions::DiscreteDistribution<>", [&] {
+        random::distributions::DiscreteDistribution<std::uint32_t> distr(weights.begin(), weights.end());
+        DO_NOT_OPTIMIZE_AWAY(distr);
+    });
+
+    bench.title("Discrete sampling").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    std::vector<std::uint32_t>                                 data(data_size);
+    std::discrete_distribution<std::uint32_t>                  std_distr(weights.begin(), weights.end());
+    random::distributions::DiscreteDistribution<std::uint32_t> distr(weights.begin(), weights.end());
+
+    benchmark("std::discrete_distribution<>", [&] {
+        for (auto& e : data) e = std_distr(gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("random::distributions::DiscreteDistribution<>", [&] {
+        for (auto& e : data) e = distr(gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("random::distributions::DiscreteDistribution<>::fill()", [&] {
+        distr.fill(gen, data);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+}
+
+// ================================
+// --- Quasi-random sequences ---
+// ================================
+
+void benchmark_sequences() {
+    using namespace utl;
+
+    constexpr std::size_t dimensions  = 8;
+    constexpr std::size_t point_count = data_size / dimensions;
+
+    log::println("\n\n====== BENCHMARKING: Quasi-random sequences ======\n");
+    log::println("N                 -> ", point_count);
+    log::println("Dimensions        -> ", dimensions);
+    log::println("Data memory usage -> ", math::memory_size<double>(data_size), " MiB");
+
+    bench.title("Sequence generation").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    std::vector<std::array<double, dimensions>> data(point_count);
+
+    random::generators::Xoshiro256PlusPlus gen{rand_seed};
+    random::sequences::Sobol               sobol(dimensions);
+    random::sequences::Halton              halton(dimensions);
+    random::sequences::R2                  r2(dimensions);
+
+    benchmark("Uniform random points", [&] {
+        for (auto& e : data) random::fill_uniform(gen, e);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Sobol::next()", [&] {
+        sobol = random::sequences::Sobol(dimensions); // restart the sequence so we don't run out of points
+        for (auto& e : data) sobol.next(e);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Sobol::at()", [&] {
+        for (std::size_t i = 0; i < data.size(); ++i) sobol.at(i, data[i]);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Sobol::discard() + next() + parallel::for_loop()", [&] {
+        parallel::for_loop(parallel::IndexRange<std::size_t>{0, data.size()}, [&](std::size_t low, std::size_t high) {
+            random::sequences::Sobol local(dimensions);
+            local.discard(low);
+            for (std::size_t i = low; i < high; ++i) local.next(data[i]);
+        });
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("Halton::next()", [&] {
+        for (auto& e : data) halton.next(e);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("R2::next()", [&] {
+        for (auto& e : data) r2.next(e);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+}
+
+// ==============================
+// --- Shuffling & sampling ---
+// ==============================
+
+void benchmark_shuffling() {
+    using namespace utl;
+
+    constexpr std::size_t sample_size = data_size / 100;
+
+    log::println("\n\n====== BENCHMARKING: Shuffling & sampling ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Sample size       -> ", sample_size);
+    log::println("Threads           -> ", std::thread::hardware_concurrency());
+    log::println("Data memory usage -> ", math::memory_size<std::uint32_t>(data_size), " MiB");
+
+    random::generators::Xoshiro256PlusPlus gen{rand_seed};
+    std::vector<std::uint32_t>             data(data_size);
+    std::iota(data.begin(), data.end(), 0);
+
+    bench.title("Shuffle").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    benchmark("std::shuffle()", [&] {
+        std::shuffle(data.begin(), data.end(), gen);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    benchmark("random::shuffle()", [&] {
+        random::shuffle(gen, data);
+        DO_NOT_OPTIMIZE_AWAY(data.data());
+    });
+
+    bench.title("Sampling").timeUnit(millisecond, "ms").minEpochIterations(5).warmup(10).relative(true);
+
+    std::vector<std::uint32_t> sample(sample_size);
+
+    benchmark("std::sample()", [&] {
+        std::sample(data.begin(), data.end(), sample.begin(), sample_size, gen);
+        DO_NOT_OPTIMIZE_AWAY(sample.data());
+    });
+
+    benchmark("random::sample_reservoir()", [&] {
+        const auto reservoir = random::sample_reservoir(gen, data.begin(), data.end(), sample_size);
+        DO_NOT_OPTIMIZE_AWAY(reservoir.data());
+    });
+
+    benchmark("random::sample_indices() + gather", [&] {
+        const auto indices = random::sample_indices(gen, data.size(), sample_size);
+        for (std::size_t i = 0; i < sample_size; ++i) sample[i] = data[indices[i]];
+        DO_NOT_OPTIMIZE_AWAY(sample.data());
+    });
+}
+
+// ===================================
+// --- Generator throughput matrix ---
+// ===================================
+
+// Every generator x workload x thread count. Each thread gets its own 'split()' of the generator and fills its own
+// part of the data, which is how generators are supposed to be used in parallel code. Nanobench can't time several
+// threads, so we use the best wall time out of several runs, thread creation is included but it's negligible
+// compared to the ~10 ms of actual work.
+
+struct ThroughputResult {
+    double ns_per_number;
+    double gb_per_sec;
+};
+
+template <class Generator, class T, class Fill>
+ThroughputResult run_throughput(std::size_t thread_count, Fill fill) {
+    constexpr std::size_t repeats = 5;
+
+    const std::size_t numbers_per_thread = data_size / thread_count;
+
+    Generator              gen{rand_seed};
+    std::vector<Generator> thread_generators;
+    for (std::size_t t = 0; t < thread_count; ++t) thread_generators.push_back(gen.split());
+
+    std::vector<std::vector<T>> data(thread_count, std::vector<T>(numbers_per_thread));
+
+    double best_time_sec = std::numeric_limits<double>::max();
+    for (std::size_t run = 0; run <= repeats; ++run) { // first run is a warmup
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < thread_count; ++t)
+            threads.emplace_back([&, t] {
+                fill(thread_generators[t], data[t]);
+                DO_NOT_OPTIMIZE_AWAY(data[t].data());
+            });
+        for (auto& thread : threads) thread.join();
+
+        const double time_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (run) best_time_sec = std::min(best_time_sec, time_sec);
+    }
+
+    const double numbers = static_cast<double>(numbers_per_thread * thread_count);
+
+    return {best_time_sec * 1e9 / numbers, numbers * sizeof(T) / best_time_sec / 1e9};
+}
+
+template <class Generator>
+void benchmark_generator_throughput(const char* name, const std::vector<std::size_t>& thread_counts) {
+    using namespace utl;
+    using result_type = typename Generator::result_type;
+
+    const auto run = [&](const char* workload, auto value, auto fill) {
+        for (const std::size_t thread_count : thread_counts) {
+            const auto res = run_throughput<Generator, decltype(value)>(thread_count, fill);
+            table::cell(name, workload, thread_count, res.ns_per_number, res.gb_per_sec);
+        }
+    };
+
+    run("uniform int", int{}, [](Generator& gen, std::vector<int>& data) {
+        random::distributions::UniformIntDistribution<int> dist{0, 999};
+        for (auto& e : data) e = dist(gen);
+    });
+    run("uniform double", double{}, [](Generator& gen, std::vector<double>& data) {
+        random::distributions::UniformRealDistribution<double> dist{0., 1.};
+        for (auto& e : data) e = dist(gen);
+    });
+    run("normal double", double{}, [](Generator& gen, std::vector<double>& data) {
+        random::distributions::NormalDistribution<double> dist{0., 1.};
+        for (auto& e : data) e = dist(gen);
+    });
+    run("bulk bits", result_type{}, [](Generator& gen, std::vector<result_type>& data) {
+        random::generate(gen, data);
+    });
+
+    table::hline();
+}
+
+void benchmark_generator_matrix() {
+    using namespace utl;
+
+    const std::size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2) thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    log::println("\n\n====== BENCHMARKING: Generator throughput matrix ======\n");
+    log::println("N                 -> ", data_size);
+    log::println("Threads           -> ", max_threads);
+    log::println("Data memory usage -> ", math::memory_size<double>(data_size), " MiB");
+
+    table::create({20, 16, 8, 12, 12});
+    table::set_formats({table::DEFAULT(), table::DEFAULT(), table::DEFAULT(), table::FIXED(2), table::FIXED(2)});
+    table::hline();
+    table::cell("Generator", "Workload", "Threads", "ns/number", "GB/s");
+    table::hline();
+
+    benchmark_generator_throughput<random::generators::RomuTrio32>("RomuTrio32", thread_counts);
+    benchmark_generator_throughput<random::generators::JSF32>("JSF32", thread_counts);
+    benchmark_generator_throughput<random::generators::RomuDuoJr>("RomuDuoJr", thread_counts);
+    benchmark_generator_throughput<random::generators::JSF64>("JSF64", thread_counts);
+    benchmark_generator_throughput<random::generators::Xoshiro256PlusPlus>("Xoshiro256++", thread_counts);
+    benchmark_generator_throughput<random::generators::Xorshift64Star>("Xorshift64*", thread_counts);
+    benchmark_generator_throughput<random::generators::ChaCha20>("ChaCha20", thread_counts);
+    benchmark_generator_throughput<random::generators::Philox4x32>("Philox4x32", thread_counts);
+    benchmark_generator_throughput<random::generators::Philox4x64>("Philox4x64", thread_counts);
+
+    // Statistical quality of the same generators is checked by the smoke battery in 'tests/test_random.cpp'
 }
 
 int main() {
@@ -69,6 +503,13 @@ int main() {
     random::generators::ChaCha20 gen(random::entropy_seq());
     
     benchmark_prngs();
+    benchmark_distributions();
+    benchmark_bulk_generation();
+    benchmark_counter_access();
+    benchmark_discrete_sampling();
+    benchmark_sequences();
+    benchmark_shuffling();
+    benchmark_generator_matrix();
 
     return 0;
 }
\ No newline at end of file
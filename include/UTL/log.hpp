@@ -14,17 +14,23 @@
 
 // _______________________ INCLUDES _______________________
 
+#include <algorithm>     // min(), max()
 #include <array>         // array<>
+#include <atomic>        // atomic<>
 #include <charconv>      // to_chars()
 #include <chrono>        // steady_clock
 #include <cstddef>       // size_t
+#include <cstdint>       // uint32_t, uint64_t
 #include <exception>     // exception
 #include <fstream>       // ofstream
+#include <functional>    // hash<>
 #include <iostream>      // cout
 #include <iterator>      // next()
 #include <limits>        // numeric_limits<>
 #include <list>          // list<>
+#include <memory>        // unique_ptr<>
 #include <mutex>         // lock_guard<>, mutex
+#include <new>           // align_val_t
 #include <ostream>       // ostream
 #include <sstream>       // std::ostringstream
 #include <stdexcept>     // std::runtime_error
@@ -38,6 +44,18 @@
 #include <utility>       // forward<>()
 #include <variant>       // variant<>
 
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define UTL_LOG_HAS_POSIX_IO
+#include <cerrno>      // errno, EINTR
+#include <cstring>     // memcpy(), memmove(), memset(), strerror()
+#include <fcntl.h>     // open(), O_WRONLY, O_CREAT, O_TRUNC, O_APPEND, O_DIRECT
+#include <signal.h>    // sigaction(), raise(), SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT
+#include <sys/types.h> // off_t, ssize_t
+#include <sys/uio.h>   // writev(), iovec
+#include <time.h>      // clock_gettime(), CLOCK_MONOTONIC_COARSE
+#include <unistd.h>    // write(), pwrite(), pread(), lseek(), close(), fdatasync(), ftruncate(), STDERR_FILENO
+#endif
+
 // ____________________ DEVELOPER DOCS ____________________
 
 // Reasonable performance and convenient logger.
@@ -105,17 +123,102 @@ inline std::size_t _get_thread_index(const std::thread::id id) {
     return it->second;
 }
 
+// --- Fast integer formatting ---
+// -------------------------------
+
+// Table-driven digit counting, bit width gives us an estimate of 'log10()' which
+// needs at most one correction that can be looked up in a table of powers of 10
+constexpr std::array<std::uint64_t, 20> _powers_of_10 = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+inline unsigned int _bit_width(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - static_cast<unsigned int>(__builtin_clzll(value)) : 0;
+#else
+    unsigned int width = 0;
+    while (value) value >>= 1, ++width;
+    return width;
+#endif
+}
+
+inline unsigned int _count_digits(std::uint64_t value) noexcept {
+    value |= 1; // zero has 1 digit, setting the lowest bit never changes the digit count otherwise
+    const unsigned int estimate = (_bit_width(value) * 1233) >> 12; // 1233 / 4096 ~ log10(2)
+    return estimate + (value >= _powers_of_10[estimate]);
+}
+
+// All 2-digit pairs, lets us write integers 2 digits at a time which halves the number of divisions
+constexpr char _digit_pairs[] = "00010203040506070809"
+                                "10111213141516171819"
+                                "20212223242526272829"
+                                "30313233343536373839"
+                                "40414243444546474849"
+                                "50515253545556575859"
+                                "60616263646566676869"
+                                "70717273747576777879"
+                                "80818283848586878889"
+                                "90919293949596979899";
+
+// Writes digits of 'value' backwards ending at 'end', caller has to reserve '_count_digits(value)' chars
+inline void _write_digits(char* end, std::uint64_t value) noexcept {
+    while (value >= 100) {
+        const std::size_t pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = _digit_pairs[pair + 1];
+        *--end = _digit_pairs[pair];
+    }
+    if (value >= 10) {
+        const std::size_t pair = static_cast<std::size_t>(value) * 2;
+        *--end                 = _digit_pairs[pair + 1];
+        *--end                 = _digit_pairs[pair];
+    } else *--end = static_cast<char>('0' + value);
+}
+
+template <class T>
+std::uint64_t _unsigned_abs(T value) noexcept {
+    if constexpr (std::is_signed_v<T>)
+        return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    else return static_cast<std::uint64_t>(value);
+}
+
+template <class T>
+std::string _stringify_int(T value) {
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+    const std::uint64_t abs    = _unsigned_abs(value);
+    const std::size_t   length = negative + _count_digits(abs);
+
+    std::string str(length, '-'); // leading '-' stays in place for negative numbers
+    _write_digits(str.data() + length, abs);
+    return str;
+}
+
 template <class IntType, std::enable_if_t<std::is_integral<IntType>::value, bool> = true>
 unsigned int _integer_digit_count(IntType value) {
-    unsigned int digits = (value <= 0) ? 1 : 0;
-    // (value <  0) => we add 1 digit because of '-' in front
-    // (value == 0) => we add 1 digit for '0' because the loop doesn't account for zero integers
-    while (value) {
-        value /= 10;
-        ++digits;
-    }
-    return digits;
-    // Note: There is probably a faster way of doing it
+    if constexpr (std::is_signed_v<IntType>) return (value < 0) + _count_digits(_unsigned_abs(value));
+    else return _count_digits(value);
+    // (value < 0) => we add 1 digit because of '-' in front
 }
 
 using clock = std::chrono::steady_clock;
@@ -224,6 +327,84 @@ const auto& _underlying_container_cref(const Adaptor& adaptor) {
     return Hack::get_container(adaptor);
 }
 
+// --- Fast float formatting ---
+// -----------------------------
+
+// Values that are logged in practice very often have a short exact decimal representation (0.5, 12.25, 3 and etc.),
+// such values can be formatted through an integer formatting which is several times faster than 'std::to_chars()'.
+//
+// Output has to be exactly the same as the one produced by 'std::to_chars()', which is the shortest representation
+// that round-trips, formatted as fixed or scientific depending on which one is shorter (fixed wins the ties).
+//
+// We check if 'value * 10^P' is an integer 'N' such that 'N / 10^P == value', where 'P' is the fixed precision limit.
+// Both 'N' and '10^P' are exactly representable and division is correctly rounded, which means the decimal
+// 'N * 10^-P' parses back into 'value'. Restricting 'N < 2^(mantissa_bits - 1)' ensures decimal grid is coarser than
+// the float spacing, making such 'N' unique. Stripping trailing zeroes of 'N' gives us the shortest representation.
+//
+// Values outside of the fast path domain (too large, too small, too many digits, zero, inf, NaN) return 'false'.
+
+template <class T>
+constexpr unsigned int _float_fast_path_precision = std::is_same_v<T, float> ? 3 : 6;
+
+template <class T>
+bool _append_short_float(std::string& buffer, T value) {
+    if constexpr (!std::is_same_v<T, float> && !std::is_same_v<T, double>) return false;
+    else {
+        constexpr unsigned int precision = _float_fast_path_precision<T>;
+        constexpr T            scale     = static_cast<T>(_powers_of_10[precision]);
+        constexpr T            max_abs   = static_cast<T>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+
+        const bool negative = value < T(0);
+        const T    abs      = negative ? -value : value;
+        const T    scaled   = abs * scale;
+
+        if (!(scaled >= T(1) && scaled < max_abs)) return false; // also rejects zero, inf & NaN
+
+        std::uint64_t mantissa = static_cast<std::uint64_t>(scaled + T(0.5));
+        if (static_cast<T>(mantissa) / scale != abs) return false;
+
+        // Strip trailing zeroes to get the shortest representation
+        int fraction_digits = static_cast<int>(precision);
+        while (fraction_digits > 0 && mantissa % 10 == 0) mantissa /= 10, --fraction_digits;
+        int trailing_zeroes = 0; // only integers can have trailing zeroes that are not a part of the fraction
+        std::uint64_t significant = mantissa;
+        while (fraction_digits == 0 && significant % 10 == 0) significant /= 10, ++trailing_zeroes;
+
+        const int mantissa_digits    = static_cast<int>(_count_digits(mantissa));
+        const int significant_digits = mantissa_digits - trailing_zeroes;
+
+        // Compare with the length of scientific notation, 'std::to_chars()' picks whichever is shorter
+        const int exponent        = mantissa_digits - 1 - fraction_digits;
+        const int exponent_digits = std::max(2, static_cast<int>(_count_digits(_unsigned_abs(exponent))));
+        const int sci_length      = significant_digits + (significant_digits > 1) + 2 + exponent_digits;
+        const int int_digits      = std::max(1, mantissa_digits - fraction_digits);
+        const int fixed_length    = int_digits + (fraction_digits ? 1 + fraction_digits : 0);
+
+        if (fixed_length > sci_length) return false;
+
+        // Format straight into the buffer
+        const std::size_t old_size = buffer.size();
+        buffer.resize(old_size + negative + fixed_length);
+
+        char* const begin = buffer.data() + old_size;
+        char* const end   = begin + negative + fixed_length;
+
+        if (negative) *begin = '-';
+
+        if (fraction_digits) {
+            char* const point = end - fraction_digits - 1;
+            const auto  div   = _powers_of_10[fraction_digits];
+            std::fill(begin + negative, point, '0');
+            std::fill(point + 1, end, '0');
+            _write_digits(point, mantissa / div);
+            *point = '.';
+            if (mantissa % div) _write_digits(end, mantissa % div);
+        } else _write_digits(end, mantissa);
+
+        return true;
+    }
+}
+
 // --- Alignment ---
 // -----------------
 
@@ -279,11 +460,28 @@ struct StringifierBase {
 
     template <class T>
     static void append_int(std::string& buffer, const T& value) {
-        std::array<char, _max_int_digits<T>> stbuff;
-        const auto [number_end_ptr, error_code] = std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
-        if (error_code != std::errc())
-            throw std::runtime_error("Stringifier encountered std::to_chars() error while serializing an integer.");
-        buffer.append(stbuff.data(), number_end_ptr - stbuff.data());
+        // Format straight into the buffer, 2 digits at a time
+        if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+            bool negative = false;
+            if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+            const std::uint64_t abs      = _unsigned_abs(value);
+            const std::size_t   old_size = buffer.size();
+            const std::size_t   length   = negative + _count_digits(abs);
+
+            buffer.resize(old_size + length);
+            if (negative) buffer[old_size] = '-';
+            _write_digits(buffer.data() + old_size + length, abs);
+        }
+        // Fallback for extended integer types
+        else {
+            std::array<char, _max_int_digits<T>> stbuff;
+            const auto [number_end_ptr, error_code] =
+                std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
+            if (error_code != std::errc())
+                throw std::runtime_error("Stringifier encountered std::to_chars() error while serializing an integer.");
+            buffer.append(stbuff.data(), number_end_ptr - stbuff.data());
+        }
     }
     
     template <class T>
@@ -293,6 +491,8 @@ struct StringifierBase {
 
     template <class T>
     static void append_float(std::string& buffer, const T& value) {
+        if (_append_short_float(buffer, value)) return;
+
         std::array<char, _max_float_digits<T>> stbuff;
         const auto [number_end_ptr, error_code] = std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
         if (error_code != std::errc())
@@ -472,14 +672,13 @@ struct Stringifier : public StringifierBase<Stringifier> {
 
     using base::stringify;
 
-    [[nodiscard]] static std::string stringify(int arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(long long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned int arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned long long arg) { return std::to_string(arg); }
-    // for individual ints 'std::to_string()' beats 'append_int()' with <charconv> since any reasonable compiler
-    // implements it using the same <charconv> routine, but formatted directly into a string upon its creation
+    [[nodiscard]] static std::string stringify(int arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(long long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned int arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned long long arg) { return _stringify_int(arg); }
+    // for individual ints we can format digits directly into a string upon its creation
 
     [[nodiscard]] static std::string stringify(std::string&& arg) { return arg; }
     // no need to do all the appending stuff for individual r-value strings, just forward them as is
@@ -525,6 +724,10 @@ enum class OpenMode { REWRITE, APPEND };
 
 enum class Colors { ENABLE, DISABLE };
 
+enum class DirectIO { DISABLE, ENABLE };
+
+enum class FileSync { NONE, FDATASYNC };
+
 struct Columns {
     bool datetime = true;
     bool uptime   = true;
@@ -634,6 +837,417 @@ constexpr std::string_view _color_info  = color::white;
 constexpr std::string_view _color_warn  = color::yellow;
 constexpr std::string_view _color_err   = color::bold_red;
 
+// =========================
+// --- POSIX file output ---
+// =========================
+
+// A file handle that bypasses 'std::ofstream' and writes straight to the file descriptor. Since sinks already
+// format each message into a 'std::string' buffer, going through 'std::ofstream' only adds its own buffering,
+// locking and locale handling on top of it. Here we accumulate messages in a large user-space buffer and hand it
+// to the OS in as few syscalls as possible.
+//
+// Messages that don't fit into the remaining buffer get submitted together with the buffer in a single 'writev()',
+// this saves both a syscall and a copy for unusually large messages.
+//
+// With 'DirectIO::ENABLE' file gets opened with 'O_DIRECT' (when the platform & filesystem support it), bypassing
+// the page cache. Direct I/O requires aligned buffers, sizes and offsets, which is why in this mode we only ever
+// submit whole aligned blocks. On flush the unaligned tail gets padded with zeroes to a whole block, written and
+// truncated back to its real size, the tail stays in the buffer and gets overwritten by the next block. This keeps
+// the descriptor in 'O_DIRECT' mode at all times. If 'O_DIRECT' isn't available we silently fall back to a regular
+// buffered output.
+//
+// With 'FileSync::FDATASYNC' every flush is followed by 'fdatasync()', which ensures that flushed messages survive
+// a system crash at the cost of a much slower flush.
+//
+// Writes retry on 'EINTR' and continue after short writes. Other errors can't be propagated out of the logging
+// calls, the first one gets reported to 'stderr', after which the file keeps trying to write (errors such as
+// a full disk can go away) without flooding the output.
+
+#ifdef UTL_LOG_HAS_POSIX_IO
+
+constexpr std::size_t _direct_io_alignment = 4096; // covers logical block size of pretty much any device
+
+struct _aligned_buffer_deleter {
+    void operator()(char* ptr) const noexcept { ::operator delete[](ptr, std::align_val_t{_direct_io_alignment}); }
+};
+
+// Zero-size writes don't set 'errno', without this check they would also loop forever
+inline bool _fd_write_all(int fd, const char* data, std::size_t count) noexcept {
+    while (count) {
+        const ssize_t written = ::write(fd, data, count);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            if (!written) errno = EIO;
+            return false;
+        }
+        data += written;
+        count -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+inline bool _fd_pwrite_all(int fd, const char* data, std::size_t count, off_t offset) noexcept {
+    while (count) {
+        const ssize_t written = ::pwrite(fd, data, count, offset);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            if (!written) errno = EIO;
+            return false;
+        }
+        data += written;
+        offset += written;
+        count -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+inline bool _fd_writev_all(int fd, const char* data_1, std::size_t count_1, const char* data_2,
+                           std::size_t count_2) noexcept {
+    iovec iov[2] = {{const_cast<char*>(data_1), count_1}, {const_cast<char*>(data_2), count_2}};
+
+    ssize_t written{};
+    do written = ::writev(fd, iov, 2);
+    while (written < 0 && errno == EINTR);
+
+    if (written < 0) return false;
+
+    // Partial writes are rare, but possible, in which case we just write the rest piece-by-piece
+    const std::size_t written_1 = std::min(static_cast<std::size_t>(written), count_1);
+    const std::size_t written_2 = static_cast<std::size_t>(written) - written_1;
+
+    return _fd_write_all(fd, data_1 + written_1, count_1 - written_1) &&
+           _fd_write_all(fd, data_2 + written_2, count_2 - written_2);
+}
+
+inline bool _fd_sync(int fd) noexcept {
+    int result{};
+#if defined(__APPLE__)
+    do result = ::fsync(fd); // no 'fdatasync()' on MacOS
+    while (result < 0 && errno == EINTR);
+#else
+    do result = ::fdatasync(fd);
+    while (result < 0 && errno == EINTR);
+#endif
+    return result == 0;
+}
+
+inline bool _fd_truncate(int fd, off_t size) noexcept {
+    int result{};
+    do result = ::ftruncate(fd, size);
+    while (result < 0 && errno == EINTR);
+    return result == 0;
+}
+
+class _fd_file {
+private:
+    int                                              fd = -1;
+    std::unique_ptr<char[], _aligned_buffer_deleter> buffer;
+    std::size_t                                      capacity{};
+    std::size_t                                      size{};
+    off_t                                            offset{}; // file position of the buffer start, direct I/O only
+    // part of the buffer that is already in the file, direct I/O only
+    std::size_t                                      synced_tail{};
+    bool                                             direct{};
+    FileSync                                         sync{};
+    bool                                             error_reported{};
+
+    void check(bool success, std::string_view operation) noexcept {
+        if (success || this->error_reported) return;
+        this->error_reported = true;
+
+        const std::string_view reason = std::strerror(errno);
+        for (const std::string_view str : {std::string_view("utl::log: POSIX file sink failed to "), operation,
+                                           std::string_view(": "), reason, std::string_view("\n")})
+            _fd_write_all(STDERR_FILENO, str.data(), str.size());
+    }
+
+    // Direct I/O: write all whole blocks, keep the unaligned tail at the front of the buffer
+    void write_aligned_blocks() noexcept {
+        const std::size_t aligned_size = this->size - this->size % _direct_io_alignment;
+        if (!aligned_size) return;
+
+        this->check(_fd_pwrite_all(this->fd, this->buffer.get(), aligned_size, this->offset), "write");
+
+        this->offset += static_cast<off_t>(aligned_size);
+        this->size -= aligned_size;
+        this->synced_tail = 0;
+        std::memmove(this->buffer.get(), this->buffer.get() + aligned_size, this->size);
+    }
+
+    // Direct I/O: unaligned tail is written as a zero-padded block & truncated back to its real size, it stays
+    // in the buffer and will be overwritten with a proper aligned block once it fills up. Tail that is already
+    // in the file doesn't get rewritten, flushing an idle file costs no syscalls.
+    void write_unaligned_tail() noexcept {
+        if (this->size == this->synced_tail) return;
+
+        std::memset(this->buffer.get() + this->size, 0, _direct_io_alignment - this->size);
+        const bool written = _fd_pwrite_all(this->fd, this->buffer.get(), _direct_io_alignment, this->offset) &&
+                             _fd_truncate(this->fd, this->offset + static_cast<off_t>(this->size));
+
+        this->check(written, "write");
+        if (written) this->synced_tail = this->size;
+    }
+
+public:
+    _fd_file(const std::string& filename, OpenMode open_mode, std::size_t buffer_size, DirectIO direct_io,
+             FileSync sync)
+        : sync(sync) {
+        // Round buffer up to the whole number of aligned blocks
+        this->capacity = std::max(buffer_size, _direct_io_alignment);
+        this->capacity += (_direct_io_alignment - this->capacity % _direct_io_alignment) % _direct_io_alignment;
+
+        this->buffer.reset(new (std::align_val_t{_direct_io_alignment}) char[this->capacity]);
+
+        const bool append = (open_mode == OpenMode::APPEND);
+
+#ifdef O_DIRECT
+        // Appending with 'O_DIRECT' requires us to manage file position manually, 'O_APPEND' would ignore it
+        if (direct_io == DirectIO::ENABLE) {
+            this->fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT | (append ? 0 : O_TRUNC), 0644);
+            this->direct = (this->fd >= 0);
+        }
+
+        // When appending with direct I/O, existing file might end with an unaligned block, in which
+        // case we read it into the buffer so it gets rewritten as a part of the next aligned block
+        if (this->direct && append) {
+            const off_t end = ::lseek(this->fd, 0, SEEK_END);
+            this->offset      = end - end % static_cast<off_t>(_direct_io_alignment);
+            this->size        = static_cast<std::size_t>(end - this->offset);
+            this->synced_tail = this->size;
+
+            const bool preloaded =
+                (end >= 0) && (!this->size || ::pread(this->fd, this->buffer.get(), _direct_io_alignment,
+                                                      this->offset) == static_cast<ssize_t>(this->size));
+            if (!preloaded) {
+                ::close(this->fd);
+                this->direct      = false;
+                this->size        = 0;
+                this->synced_tail = 0;
+            }
+        }
+#endif
+        // Regular buffered output, also serves as a fallback when filesystem doesn't support 'O_DIRECT'
+        if (!this->direct)
+            this->fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+
+        if (this->fd < 0) throw std::runtime_error("Could not open log file {" + filename + "}.");
+    }
+
+    _fd_file(const _fd_file&) = delete;
+    _fd_file& operator=(const _fd_file&) = delete;
+    _fd_file& operator=(_fd_file&&) = delete;
+
+    _fd_file(_fd_file&& other) noexcept
+        : fd(other.fd), buffer(std::move(other.buffer)), capacity(other.capacity), size(other.size),
+          offset(other.offset), synced_tail(other.synced_tail), direct(other.direct), sync(other.sync),
+          error_reported(other.error_reported) {
+        other.fd = -1;
+    }
+
+    ~_fd_file() {
+        if (this->fd < 0) return;
+        this->flush();
+        ::close(this->fd);
+    }
+
+    void write(const char* data, std::size_t count) noexcept {
+        // Fast path, message fits into the buffer
+        if (this->size + count <= this->capacity) {
+            std::memcpy(this->buffer.get() + this->size, data, count);
+            this->size += count;
+            return;
+        }
+
+        // Buffered output, submit buffer & message in a single syscall
+        if (!this->direct) {
+            this->check(_fd_writev_all(this->fd, this->buffer.get(), this->size, data, count), "write");
+            this->size = 0;
+            return;
+        }
+
+        // Direct I/O, all writes have to go through the aligned buffer
+        while (count) {
+            const std::size_t chunk = std::min(this->capacity - this->size, count);
+            std::memcpy(this->buffer.get() + this->size, data, chunk);
+            this->size += chunk;
+            data += chunk;
+            count -= chunk;
+            if (this->size == this->capacity) this->write_aligned_blocks();
+        }
+    }
+
+    void flush() noexcept {
+        if (this->direct) {
+            this->write_aligned_blocks();
+            this->write_unaligned_tail();
+        } else {
+            this->check(_fd_write_all(this->fd, this->buffer.get(), this->size), "write");
+            this->size = 0;
+        }
+
+        if (this->sync == FileSync::FDATASYNC) this->check(_fd_sync(this->fd), "sync");
+    }
+};
+
+#endif
+
+// =======================
+// --- Flight recorder ---
+// =======================
+
+// An in-memory ring buffer of the most recent formatted records, which only gets written to the file when something
+// goes wrong. This allows us to keep full TRACE context around at the cost of a 'memcpy()' per message.
+//
+// Ring consists of fixed-size slots, each writer claims a ticket with a single 'fetch_add()' and copies the message
+// into the slot 'ticket % capacity'. Every slot has a sequence number that works like a seqlock: odd value means
+// the slot is being written, even value '2 * (ticket + 1)' means the slot contains a complete record of 'ticket'.
+// Writers never wait for each other, if the ring wraps around onto a slot that is still being written by someone
+// else (which requires 'capacity' messages to be logged during a single 'memcpy()') the newer record gets dropped.
+//
+// Dumping only needs 'write()' on a file descriptor that was opened upfront, which makes it async-signal-safe and
+// allows us to dump from a fatal signal handler. Every dump writes only the records that weren't dumped before,
+// so repeated dumps (for example, on every error) produce a continuous history without duplicates.
+//
+// Dump reads slots concurrently with the writers, which is only well-defined if both sides access the slot through
+// atomics. Records are stored as relaxed atomic words (which compile to regular loads & stores), dump copies the
+// length & data into a preallocated scratch buffer, re-checks the sequence after an acquire fence and only writes
+// the copy if the slot didn't change in the meantime. Records that get overwritten while the dump is in progress
+// get skipped, which is a price we pay for not locking.
+
+#ifdef UTL_LOG_HAS_POSIX_IO
+
+class _flight_recorder {
+private:
+    using word = std::uint64_t;
+
+    int                                           fd = -1;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> sequences;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> lengths;
+    std::unique_ptr<std::atomic<word>[]>          data;
+    std::unique_ptr<char[]>                       scratch;    // copy of the record being dumped
+    std::size_t                                   capacity{}; // always a power of 2
+    std::size_t                                   record_size{};
+    std::size_t                                   record_words{};
+    std::atomic<std::uint64_t>                    head{};
+    std::atomic<bool>                             dumping{};
+    std::uint64_t                                 dumped_until{}; // protected by 'dumping'
+    std::string                                   header;
+
+public:
+    Verbosity dump_verbosity;
+
+    _flight_recorder(const std::string& filename, OpenMode open_mode, std::size_t capacity, std::size_t record_size,
+                     Verbosity dump_verbosity)
+        : dump_verbosity(dump_verbosity) {
+        // Round capacity up to a power of 2 so slot index is just a bitmask
+        this->capacity = 1;
+        while (this->capacity < capacity) this->capacity <<= 1;
+        this->record_size  = std::max<std::size_t>(record_size, 2);
+        this->record_words = (this->record_size + sizeof(word) - 1) / sizeof(word);
+
+        this->sequences = std::make_unique<std::atomic<std::uint64_t>[]>(this->capacity);
+        this->lengths   = std::make_unique<std::atomic<std::uint32_t>[]>(this->capacity);
+        this->data      = std::make_unique<std::atomic<word>[]>(this->capacity * this->record_words);
+        this->scratch   = std::make_unique<char[]>(this->record_words * sizeof(word));
+
+        // File gets opened upfront, opening it in a signal handler would be a bad idea
+        const int mode_flag = (open_mode == OpenMode::APPEND) ? O_APPEND : O_TRUNC;
+        this->fd            = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | mode_flag, 0644);
+
+        if (this->fd < 0) throw std::runtime_error("Could not open flight recorder file {" + filename + "}.");
+    }
+
+    _flight_recorder(const _flight_recorder&) = delete;
+    _flight_recorder& operator=(const _flight_recorder&) = delete;
+    _flight_recorder& operator=(_flight_recorder&&) = delete;
+
+    // Only used to move the recorder into the sink, before any other thread can see it
+    _flight_recorder(_flight_recorder&& other) noexcept
+        : fd(other.fd), sequences(std::move(other.sequences)), lengths(std::move(other.lengths)),
+          data(std::move(other.data)), scratch(std::move(other.scratch)), capacity(other.capacity),
+          record_size(other.record_size), record_words(other.record_words), head(other.head.load()),
+          dumped_until(other.dumped_until), header(std::move(other.header)), dump_verbosity(other.dump_verbosity) {
+        other.fd = -1;
+    }
+
+    ~_flight_recorder() {
+        if (this->fd >= 0) ::close(this->fd);
+    }
+
+    void set_header(std::string header) { this->header = std::move(header); }
+
+    void record(const std::string& message) noexcept {
+        const std::uint64_t ticket = this->head.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t   slot   = static_cast<std::size_t>(ticket) & (this->capacity - 1);
+
+        // Claim the slot, unless it's busy or was already claimed by a newer ticket
+        std::uint64_t sequence = this->sequences[slot].load(std::memory_order_relaxed);
+        if (sequence & 1 || sequence > 2 * ticket + 1 ||
+            !this->sequences[slot].compare_exchange_strong(sequence, 2 * ticket + 1, std::memory_order_acquire,
+                                                           std::memory_order_relaxed))
+            return;
+        std::atomic_thread_fence(std::memory_order_release); // dump that sees any of the data also sees the claim
+
+        // Records that don't fit into the slot get truncated, but always end with a newline
+        std::atomic<word>* const dest   = this->data.get() + slot * this->record_words;
+        const std::size_t        length = std::min(message.size(), this->record_size);
+
+        for (std::size_t offset = 0; offset < length; offset += sizeof(word)) {
+            char bytes[sizeof(word)] = {};
+            std::memcpy(bytes, message.data() + offset, std::min(sizeof(word), length - offset));
+            if (length < message.size() && length - offset <= sizeof(word)) bytes[length - offset - 1] = '\n';
+
+            word value;
+            std::memcpy(&value, bytes, sizeof(word));
+            dest[offset / sizeof(word)].store(value, std::memory_order_relaxed);
+        }
+        this->lengths[slot].store(static_cast<std::uint32_t>(length), std::memory_order_relaxed);
+
+        this->sequences[slot].store(2 * ticket + 2, std::memory_order_release);
+    }
+
+    // Async-signal-safe, returns 'false' if some other dump is already in progress
+    bool dump() noexcept {
+        if (this->dumping.exchange(true, std::memory_order_acquire)) return false;
+
+        const std::uint64_t end   = this->head.load(std::memory_order_acquire);
+        const std::uint64_t begin = std::max(this->dumped_until, end > this->capacity ? end - this->capacity : 0);
+
+        if (begin < end) {
+            _fd_write_all(this->fd, this->header.data(), this->header.size());
+
+            for (std::uint64_t ticket = begin; ticket < end; ++ticket) {
+                const std::size_t   slot     = static_cast<std::size_t>(ticket) & (this->capacity - 1);
+                const std::uint64_t sequence = 2 * ticket + 2;
+
+                // Skip records that are still being written or were overwritten
+                if (this->sequences[slot].load(std::memory_order_acquire) != sequence) continue;
+
+                const std::atomic<word>* const source = this->data.get() + slot * this->record_words;
+                const std::size_t              length =
+                    std::min<std::size_t>(this->lengths[slot].load(std::memory_order_relaxed), this->record_size);
+
+                for (std::size_t offset = 0; offset < length; offset += sizeof(word)) {
+                    const word value = source[offset / sizeof(word)].load(std::memory_order_relaxed);
+                    std::memcpy(this->scratch.get() + offset, &value, sizeof(word));
+                }
+
+                // Same check after the copy, if the slot was claimed by another writer our copy might be torn
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (this->sequences[slot].load(std::memory_order_relaxed) != sequence) continue;
+
+                _fd_write_all(this->fd, this->scratch.get(), length);
+            }
+        }
+
+        this->dumped_until = end;
+        this->dumping.store(false, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
+
 // ==================
 // --- Sink class ---
 // ==================
@@ -642,14 +1256,20 @@ class Sink {
 private:
     using os_ref_wrapper = std::reference_wrapper<std::ostream>;
 
-    std::variant<os_ref_wrapper, std::ofstream> os_variant;
-    Verbosity                                   verbosity;
-    Colors                                      colors;
-    clock::duration                             flush_interval;
-    Columns                                     columns;
-    clock::time_point                           last_flushed;
-    bool                                        print_header = true;
-    mutable std::mutex                          ostream_mutex;
+#ifdef UTL_LOG_HAS_POSIX_IO
+    using output_variant = std::variant<os_ref_wrapper, std::ofstream, _fd_file, _flight_recorder>;
+#else
+    using output_variant = std::variant<os_ref_wrapper, std::ofstream>;
+#endif
+
+    output_variant     os_variant;
+    Verbosity          verbosity;
+    Colors             colors;
+    clock::duration    flush_interval;
+    Columns            columns;
+    clock::time_point  last_flushed;
+    bool               print_header = true;
+    mutable std::mutex ostream_mutex;
 
     friend struct _logger;
 
@@ -658,6 +1278,21 @@ class Sink {
         else return std::get<std::ofstream>(this->os_variant);
     }
 
+    void write_output(const std::string& str) {
+#ifdef UTL_LOG_HAS_POSIX_IO
+        if (const auto fd_file_ptr = std::get_if<_fd_file>(&this->os_variant))
+            return fd_file_ptr->write(str.data(), str.size());
+#endif
+        this->ostream_ref().write(str.data(), str.size());
+    }
+
+    void flush_output() {
+#ifdef UTL_LOG_HAS_POSIX_IO
+        if (const auto fd_file_ptr = std::get_if<_fd_file>(&this->os_variant)) return fd_file_ptr->flush();
+#endif
+        this->ostream_ref().flush();
+    }
+
 public:
     Sink()            = delete;
     Sink(const Sink&) = delete;
@@ -671,6 +1306,21 @@ class Sink {
          const Columns& columns)
         : os_variant(os), verbosity(verbosity), colors(colors), flush_interval(flush_interval), columns(columns) {}
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+    Sink(_fd_file&& file, Verbosity verbosity, Colors colors, clock::duration flush_interval, const Columns& columns)
+        : os_variant(std::move(file)), verbosity(verbosity), colors(colors), flush_interval(flush_interval),
+          columns(columns) {}
+
+    Sink(_flight_recorder&& recorder, Verbosity verbosity, Colors colors, const Columns& columns)
+        : os_variant(std::move(recorder)), verbosity(verbosity), colors(colors), flush_interval(), columns(columns) {
+        // flight recorder writes the header at the start of each dump rather than into the ring
+        std::string header;
+        this->format_header(header);
+        std::get<_flight_recorder>(this->os_variant).set_header(std::move(header));
+        this->print_header = false;
+    }
+#endif
+
     // We want a way of changing sink options using its handle / reference returned by the logger
     Sink& set_verbosity(Verbosity verbosity) {
         this->verbosity = verbosity;
@@ -693,6 +1343,14 @@ class Sink {
         return *this;
     }
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+    // Writes recent history of a flight recorder sink to its file, does nothing for other sinks
+    Sink& dump() {
+        if (const auto recorder_ptr = std::get_if<_flight_recorder>(&this->os_variant)) recorder_ptr->dump();
+        return *this;
+    }
+#endif
+
 private:
     template <class... Args>
     void format(const Callsite& callsite, const MessageMetadata& meta, const Args&... args) {
@@ -744,20 +1402,29 @@ class Sink {
 
         if (this->colors == Colors::ENABLE) buffer += _color_reset;
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+        // Flight recorder is lock-free and never flushes, it only gets dumped when something goes wrong
+        if (const auto recorder_ptr = std::get_if<_flight_recorder>(&this->os_variant)) {
+            recorder_ptr->record(buffer);
+            if (meta.verbosity <= recorder_ptr->dump_verbosity) recorder_ptr->dump();
+            return;
+        }
+#endif
+
         // 'std::ostream' isn't guaranteed to be thread-safe, even through many implementations seem to have
         // some thread-safety built into `std::cout` the same cannot be said about a generic 'std::ostream'
         const std::lock_guard ostream_lock(this->ostream_mutex);
 
-        this->ostream_ref().write(buffer.data(), buffer.size());
+        this->write_output(buffer);
 
         // flush every message immediately
         if (this->flush_interval.count() == 0) {
-            this->ostream_ref().flush();
+            this->flush_output();
         }
         // or flush periodically
         else if (now - this->last_flushed > this->flush_interval) {
             this->last_flushed = now;
-            this->ostream_ref().flush();
+            this->flush_output();
         }
     }
 
@@ -910,6 +1577,175 @@ inline Sink& add_file_sink(const std::string& filename, OpenMode open_mode = Ope
                                                   flush_interval, columns);
 }
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+inline Sink& add_posix_file_sink(const std::string& filename, OpenMode open_mode = OpenMode::REWRITE,
+                                 Verbosity verbosity = Verbosity::TRACE, Colors colors = Colors::DISABLE,
+                                 clock::duration flush_interval = ms{15}, const Columns& columns = Columns{},
+                                 std::size_t buffer_size = 1 << 20, DirectIO direct_io = DirectIO::DISABLE,
+                                 FileSync sync = FileSync::NONE) {
+    return _logger::instance().sinks.emplace_back(_fd_file(filename, open_mode, buffer_size, direct_io, sync),
+                                                  verbosity, colors, flush_interval, columns);
+}
+
+inline Sink& add_flight_recorder_sink(const std::string& filename, std::size_t capacity = 4096,
+                                      Verbosity dump_verbosity = Verbosity::ERR,
+                                      OpenMode open_mode = OpenMode::REWRITE, const Columns& columns = Columns{},
+                                      std::size_t record_size = 512) {
+    return _logger::instance().sinks.emplace_back(
+        _flight_recorder(filename, open_mode, capacity, record_size, dump_verbosity), Verbosity::TRACE,
+        Colors::DISABLE, columns);
+}
+
+inline void dump_flight_recorders() {
+    for (auto& sink : _logger::instance().sinks) sink.dump();
+}
+
+constexpr std::array<int, 5> _fatal_signals = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+// Handlers that were installed before ours, the signal gets passed on to them after dumping
+inline std::array<struct sigaction, _fatal_signals.size()> _previous_fatal_signal_actions{};
+
+inline void _flight_recorder_signal_handler(int signal, siginfo_t* info, void* context) {
+    for (auto& sink : _logger::sinks) sink.dump();
+
+    // Restoring the previous handler makes the dump happen only once, even if that handler returns and the fault
+    // repeats. Default & ignored dispositions are reproduced by re-raising the signal.
+    for (std::size_t i = 0; i < _fatal_signals.size(); ++i) {
+        if (_fatal_signals[i] != signal) continue;
+
+        const struct sigaction& previous = _previous_fatal_signal_actions[i];
+        ::sigaction(signal, &previous, nullptr);
+
+        if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) break;
+
+        if (previous.sa_flags & SA_SIGINFO) previous.sa_sigaction(signal, info, context);
+        else previous.sa_handler(signal);
+        return;
+    }
+
+    ::raise(signal);
+}
+
+inline void dump_flight_recorders_on_fatal_signals() {
+    struct sigaction action {};
+    action.sa_sigaction = _flight_recorder_signal_handler;
+    action.sa_flags     = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+
+    for (std::size_t i = 0; i < _fatal_signals.size(); ++i) {
+        struct sigaction previous {};
+        ::sigaction(_fatal_signals[i], &action, &previous);
+
+        // repeated calls shouldn't chain our handler to itself
+        const bool is_ours =
+            (previous.sa_flags & SA_SIGINFO) && previous.sa_sigaction == _flight_recorder_signal_handler;
+        if (!is_ours) _previous_fatal_signal_actions[i] = previous;
+    }
+}
+#endif
+
+// ==================================
+// --- Rate limiting and sampling ---
+// ==================================
+
+// A single noisy log statement in a tight loop can easily flood the sinks and slow down the whole program.
+// Rate-limited and sampled logging macros create a 'static' state for each callsite, which means all the
+// bookkeeping is reduced to a few relaxed atomic operations without any lookups or locks.
+
+constexpr std::int64_t _rate_limit_window_ns = 1'000'000'000;
+
+// Rate limiter only needs to notice that a window has passed, a coarse clock (~1-4 ms resolution on Linux)
+// is plenty for that and is several times cheaper to query than 'steady_clock'
+inline std::int64_t _coarse_now_ns() noexcept {
+#if defined(UTL_LOG_HAS_POSIX_IO) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::int64_t>(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+#endif
+}
+
+class _rate_limiter {
+public:
+    // Messages suppressed by an exhausted limit are counted by each thread on its own, this keeps the suppressed
+    // path free of shared writes. Local count gets flushed into the shared one once the thread notices that
+    // the window has passed, or when the thread exits.
+    struct thread_state {
+        _rate_limiter* owner      = nullptr;
+        std::uint64_t  suppressed = 0;
+
+        ~thread_state() {
+            if (this->owner && this->suppressed)
+                this->owner->suppressed.fetch_add(this->suppressed, std::memory_order_relaxed);
+        }
+    };
+
+private:
+    std::atomic<std::int64_t>  window_end{}; // in '_coarse_now_ns()' units
+    std::atomic<std::uint64_t> passed{};     // messages that went past the exhausted check, can overshoot 'limit'
+    std::atomic<std::uint64_t> suppressed{}; // overshoot of the previous windows & flushed thread counts
+    std::uint64_t              limit;
+
+    // Starts a new window if the current one has passed, only one of the racing threads gets to reset the counter
+    void roll_window(std::int64_t now) noexcept {
+        std::int64_t window_end = this->window_end.load(std::memory_order_relaxed);
+
+        if (now < window_end) return;
+
+        if (this->window_end.compare_exchange_strong(window_end, now + _rate_limit_window_ns,
+                                                     std::memory_order_relaxed)) {
+            const std::uint64_t attempts = this->passed.exchange(0, std::memory_order_relaxed);
+            if (attempts > this->limit) this->suppressed.fetch_add(attempts - this->limit, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    constexpr _rate_limiter(std::uint32_t messages_per_second) noexcept : limit(messages_per_second) {}
+
+    // Returns whether the message should be logged, in which case 'suppressed_count' is set to the
+    // number of messages that were suppressed since the last logged message from the same callsite
+    bool allow(thread_state& local, std::uint64_t& suppressed_count) noexcept {
+        const std::int64_t now = _coarse_now_ns();
+
+        // Fast path, limit is exhausted for the current window => relaxed loads of read-mostly values
+        if (this->passed.load(std::memory_order_relaxed) >= this->limit &&
+            now < this->window_end.load(std::memory_order_relaxed)) {
+            ++local.suppressed;
+            return false;
+        }
+
+        if (local.suppressed) {
+            this->suppressed.fetch_add(local.suppressed, std::memory_order_relaxed);
+            local.suppressed = 0;
+        }
+
+        this->roll_window(now);
+
+        // Messages that lose the race for the last slots of the window show up as an overshoot of 'passed',
+        // which gets added to the suppressed count when the window rolls over
+        if (this->passed.fetch_add(1, std::memory_order_relaxed) >= this->limit) return false;
+
+        suppressed_count = this->suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Sampling only needs a fast thread-local PRNG, no shared state is involved at all
+inline bool _sample(double probability) noexcept {
+    thread_local std::uint64_t state =
+        static_cast<std::uint64_t>(clock::now().time_since_epoch().count()) ^
+        static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    // SplitMix64, see https://prng.di.unimi.it/splitmix64.c
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+    z               = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z               = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z ^= z >> 31;
+
+    return static_cast<double>(z >> 11) * 0x1.0p-53 < probability; // top 53 bits -> uniform double in [0, 1)
+}
+
 // ======================
 // --- Logging macros ---
 // ======================
@@ -929,6 +1765,63 @@ inline Sink& add_file_sink(const std::string& filename, OpenMode open_mode = Ope
 #define UTL_LOG_TRACE(...)                                                                                             \
     utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::TRACE}, __VA_ARGS__)
 
+// --- Rate-limited logging ---
+// ----------------------------
+
+#define _utl_log_rate_limited(verbosity_, messages_per_second_, ...)                                                   \
+    do {                                                                                                               \
+        static utl::log::_rate_limiter                     utl_log_rate_limiter_(messages_per_second_);                \
+        thread_local utl::log::_rate_limiter::thread_state utl_log_rate_limiter_thread_{&utl_log_rate_limiter_};       \
+        std::uint64_t                                      utl_log_suppressed_ = 0;                                    \
+        if (!utl_log_rate_limiter_.allow(utl_log_rate_limiter_thread_, utl_log_suppressed_)) break;                    \
+        if (utl_log_suppressed_)                                                                                       \
+            utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__,               \
+                                                       " [suppressed ", utl_log_suppressed_, " messages]");            \
+        else utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__);             \
+    } while (false)
+// Note:
+// Suppressed message count gets reported with the next message that passes the limit. Since we don't have
+// a background thread, messages suppressed at the very end of the program will go unreported.
+
+#define UTL_LOG_ERR_LIMITED(messages_per_second_, ...)                                                                 \
+    _utl_log_rate_limited(utl::log::Verbosity::ERR, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_WARN_LIMITED(messages_per_second_, ...)                                                                \
+    _utl_log_rate_limited(utl::log::Verbosity::WARN, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_INFO_LIMITED(messages_per_second_, ...)                                                                \
+    _utl_log_rate_limited(utl::log::Verbosity::INFO, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_DEBUG_LIMITED(messages_per_second_, ...)                                                               \
+    _utl_log_rate_limited(utl::log::Verbosity::DEBUG, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_TRACE_LIMITED(messages_per_second_, ...)                                                               \
+    _utl_log_rate_limited(utl::log::Verbosity::TRACE, messages_per_second_, __VA_ARGS__)
+
+// --- Sampled logging ---
+// -----------------------
+
+#define _utl_log_sampled(verbosity_, probability_, ...)                                                                \
+    do {                                                                                                               \
+        if (utl::log::_sample(probability_))                                                                           \
+            utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__);              \
+    } while (false)
+
+#define UTL_LOG_ERR_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::ERR, probability_, __VA_ARGS__)
+
+#define UTL_LOG_WARN_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::WARN, probability_, __VA_ARGS__)
+
+#define UTL_LOG_INFO_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::INFO, probability_, __VA_ARGS__)
+
+#define UTL_LOG_DEBUG_SAMPLED(probability_, ...)                                                                       \
+    _utl_log_sampled(utl::log::Verbosity::DEBUG, probability_, __VA_ARGS__)
+
+#define UTL_LOG_TRACE_SAMPLED(probability_, ...)                                                                       \
+    _utl_log_sampled(utl::log::Verbosity::TRACE, probability_, __VA_ARGS__)
+
+// --- Debug-only logging ---
+// --------------------------
+
 #ifdef _DEBUG
 #define UTL_LOG_DERR(...) UTL_LOG_ERR(__VA_ARGS__)
 #define UTL_LOG_DWARN(...) UTL_LOG_WARN(__VA_ARGS__)
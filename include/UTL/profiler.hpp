@@ -14,18 +14,63 @@
 
 // _______________________ INCLUDES _______________________
 
-#include <algorithm>   // sort()
-#include <chrono>      // chrono::steady_clock, chrono::duration_cast<>, std::chrono::milliseconds
-#include <cstdlib>     // atexit()
-#include <fstream>     // ofstream
-#include <iomanip>     // setprecision(), setw()
-#include <ios>         // streamsize, fixed,
-#include <iostream>    // cout
-#include <ostream>     // ostream
-#include <sstream>     // ostringstream
-#include <string>      // string
-#include <string_view> // string_view
-#include <vector>      // vector<>
+#include <algorithm>          // sort(), max()
+#include <array>              // array<>
+#include <atomic>             // atomic<>
+#include <chrono>             // chrono::steady_clock, chrono::duration_cast<>, std::chrono::milliseconds
+#include <cerrno>             // errno, ENOSYS
+#include <cmath>              // ceil()
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <cstdlib>            // atexit(), malloc(), aligned_alloc(), free()
+#include <fstream>            // ofstream
+#include <functional>         // function<>
+#include <iomanip>            // setprecision(), setw()
+#include <ios>                // streamsize, fixed,
+#include <iostream>           // cout
+#include <iterator>           // next()
+#include <limits>             // numeric_limits<>
+#include <map>                // map<>
+#include <memory>             // unique_ptr<>, make_unique<>()
+#include <mutex>              // mutex, lock_guard<>
+#include <new>                // new_handler, get_new_handler(), bad_alloc, align_val_t, nothrow_t
+#include <ostream>            // ostream
+#include <sstream>            // ostringstream
+#include <string>             // string
+#include <string_view>        // string_view
+#include <system_error>       // system_category()
+#include <thread>             // thread
+#include <utility>            // pair<>, move(), exchange()
+#include <vector>             // vector<>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTL_PROFILER_HAS_x86_TSC
+#include <cpuid.h> // __get_cpuid()
+#endif
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define UTL_PROFILER_HAS_PERF_EVENTS
+#include <linux/perf_event.h>  // perf_event_attr, perf_event_mmap_page, PERF_...
+#include <sys/mman.h>          // mmap(), munmap()
+#include <sys/syscall.h>       // SYS_perf_event_open
+#include <unistd.h>            // syscall(), read(), close(), sysconf()
+#endif
+
+// IP sampling is an extension of the sampling mode and makes no sense without it
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && !defined(UTL_PROFILER_OPTION_SAMPLING)
+#define UTL_PROFILER_OPTION_SAMPLING
+#endif
+
+#if defined(__linux__)
+#define UTL_PROFILER_HAS_SAMPLING
+#include <link.h>         // dl_iterate_phdr()
+#include <signal.h>       // sigaction(), SIGPROF, SIGEV_THREAD_ID
+#include <sys/syscall.h>  // SYS_gettid
+#include <time.h>         // timer_create(), timer_settime(), timer_delete()
+#include <ucontext.h>     // ucontext_t
+#include <unistd.h>       // syscall()
+#endif
 
 // ____________________ DEVELOPER DOCS ____________________
 
@@ -44,6 +89,13 @@
 // this also took a bit of thinking but in the end there is a nice solution that uses static variables
 // to offload things that can only be done once to their initialization, and then links local variables
 // to 'static' markers of the callsite recording. See 'UTL_PROFILE' macro for some more details.
+//
+// Multithreading is handled by giving each thread its own set of records, which get created on the first visit of
+// a callsite by the thread and registered in a global list. Timers only ever touch records of their own thread, so
+// the hot path needs no locks, results from different threads get merged when formatting the report.
+//
+// Optional features (such as call tree tracking) hook into the scope entry & exit of '_timer_base' and are
+// enabled with 'UTL_PROFILER_OPTION_...' macros, so the default mode doesn't pay for the features it doesn't use.
 
 // ____________________ IMPLEMENTATION ____________________
 
@@ -59,24 +111,142 @@ inline std::string _format_call_site(std::string_view file, int line, std::strin
     return (std::ostringstream() << filename << ":" << line << ", " << func << "()").str();
 }
 
-#define UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY 3'300'000'000
+// --- x86 timestamp counter ---
+// -----------------------------
 
-#if !defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY)
-using clock = std::chrono::steady_clock;
+// Timestamp counter can be read in a few CPU cycles, which is a lot faster than 'std::chrono::steady_clock'
+// (which usually goes through 'clock_gettime()'). TSC ticks at a constant rate on any modern CPU, but that rate
+// is neither standardized nor reliably exposed by the CPU itself, which is why we calibrate it against the
+// 'std::chrono::steady_clock' at startup.
+//
+// Only the "invariant TSC" (CPUID.80000007H:EDX[8]) is guaranteed to tick at a constant rate regardless
+// of power states and to be synchronized across cores, without it we fall back to 'std::chrono::steady_clock'.
+//
+// Ticks get converted to nanoseconds with a fixed-point multiplication, which means TSC clocks have the same
+// 'duration' as regular std clocks and can be used with any <chrono> code.
+//
+// 'rdtsc' isn't a serializing instruction, CPU can execute it before preceding instructions are finished, which
+// is usually fine for profiling non-trivial code. 'rdtscp' waits for all preceding instructions to finish and
+// 'lfence; rdtsc' also prevents subsequent instructions from starting early, at the cost of a few more cycles.
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+
+struct _tsc_calibration {
+    bool          invariant  = false;
+    bool          has_rdtscp = false;
+    double        frequency  = 0;  // Hz
+    std::uint64_t multiplier = 0;  // 'ns = (ticks * multiplier) >> 32'
+};
+
+inline std::uint64_t _rdtsc() noexcept {
+    unsigned int low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high)); // GCC/clang asm intrinsic, MSVC uses __asm() with more overhead
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline std::uint64_t _rdtscp() noexcept {
+    unsigned int low, high;
+    asm volatile("rdtscp" : "=a"(low), "=d"(high)::"rcx"); // 'rdtscp' also writes processor id into 'ecx'
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline std::uint64_t _rdtsc_fenced() noexcept {
+    unsigned int low, high;
+    asm volatile("lfence\n\trdtsc" : "=a"(low), "=d"(high)::"memory");
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline _tsc_calibration _calibrate_tsc() {
+    _tsc_calibration calibration;
+
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) calibration.invariant = edx & (1u << 8);
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) calibration.has_rdtscp = edx & (1u << 27);
+
+    if (!calibration.invariant) return calibration;
+
+#ifdef UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY
+    calibration.frequency = static_cast<double>(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY);
+#else
+    // Measure TSC ticks over a known interval of 'steady_clock', 20 ms is enough to get the error into ~ppm range.
+    // Each timestamp pair is taken as close together as possible, so both clocks refer to the same moment.
+    constexpr auto calibration_interval = std::chrono::milliseconds(20);
+
+    const auto steady_start = std::chrono::steady_clock::now();
+    const auto ticks_start  = _rdtsc_fenced();
+
+    auto steady_end = steady_start;
+    auto ticks_end  = ticks_start;
+    while (steady_end - steady_start < calibration_interval) {
+        steady_end = std::chrono::steady_clock::now();
+        ticks_end  = _rdtsc_fenced();
+    }
+
+    const double elapsed_sec = std::chrono::duration<double>(steady_end - steady_start).count();
+    calibration.frequency    = static_cast<double>(ticks_end - ticks_start) / elapsed_sec;
+#endif
+
+    calibration.multiplier = static_cast<std::uint64_t>(1e9 * 4294967296.0 / calibration.frequency); // 1e9 * 2^32 / f
+    return calibration;
+}
+
+inline std::uint64_t _ticks_to_ns(std::uint64_t ticks, std::uint64_t multiplier) noexcept {
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128; // '__extension__' silences '-Wpedantic'
+    return static_cast<std::uint64_t>((static_cast<uint128>(ticks) * multiplier) >> 32);
 #else
-struct clock {
-    using rep                   = unsigned long long int;
-    using period                = std::ratio<1, UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY>;
-    using duration              = std::chrono::duration<rep, period>;
-    using time_point            = std::chrono::time_point<clock>;
+    // 64-bit emulation of the same thing, splits ticks into halves so the products don't overflow
+    const std::uint64_t high = ticks >> 32, low = ticks & 0xFFFFFFFF;
+    return high * multiplier + ((low * (multiplier & 0xFFFFFFFF)) >> 32) + low * (multiplier >> 32);
+#endif
+}
+
+inline const _tsc_calibration& _tsc() {
+    static const _tsc_calibration calibration = _calibrate_tsc();
+    return calibration;
+}
+
+template <std::uint64_t (*read_tsc)() noexcept, bool requires_rdtscp = false>
+struct _tsc_clock {
+    using duration              = std::chrono::nanoseconds;
+    using rep                   = duration::rep;
+    using period                = duration::period;
+    using time_point            = std::chrono::time_point<_tsc_clock>;
     static const bool is_steady = true;
 
     static time_point now() noexcept {
-        unsigned int low, high;
-        asm volatile("rdtsc" : "=a"(low), "=d"(high)); // GCC/clang asm intrinsic, MSVC uses __asm() with more overhead
-        return time_point(duration(static_cast<rep>(high) << 32 | low));
+        const _tsc_calibration& tsc = _tsc();
+
+        if (!tsc.invariant || (requires_rdtscp && !tsc.has_rdtscp))
+            return time_point(std::chrono::duration_cast<duration>(
+                std::chrono::steady_clock::now().time_since_epoch())); // fallback
+
+        return time_point(duration(static_cast<rep>(_ticks_to_ns(read_tsc(), tsc.multiplier))));
     }
 };
+
+using tsc_clock         = _tsc_clock<_rdtsc>;
+using tsc_clock_rdtscp  = _tsc_clock<_rdtscp, true>;
+using tsc_clock_fenced  = _tsc_clock<_rdtsc_fenced>;
+
+// Returns calibrated TSC frequency in Hz, or 0 if invariant TSC is not available and TSC clocks fall back to
+// 'std::chrono::steady_clock'
+inline double tsc_frequency() { return _tsc().frequency; }
+
+#endif
+
+// --- Profiler clock ---
+// ----------------------
+
+#if defined(UTL_PROFILER_HAS_x86_TSC) && defined(UTL_PROFILER_OPTION_USE_x86_RDTSCP)
+using clock = tsc_clock_rdtscp;
+#elif defined(UTL_PROFILER_HAS_x86_TSC) && defined(UTL_PROFILER_OPTION_USE_x86_FENCED_RDTSC)
+using clock = tsc_clock_fenced;
+#elif defined(UTL_PROFILER_HAS_x86_TSC) &&                                                                             \
+    (defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS) || defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY))
+using clock = tsc_clock;
+#else
+using clock = std::chrono::steady_clock;
 #endif
 
 using duration   = clock::duration;
@@ -84,251 +254,2080 @@ using time_point = clock::time_point;
 
 inline const time_point _program_entry_time_point = clock::now();
 
-struct _record {
+// Static data of the profiled callsite, 'file', 'func', 'label' are guaranteed to be string literals, since we want
+// to have as little overhead as possible during runtime, we can just save raw pointers and convert them to nicer
+// types like 'std::string_view' later in the formatting stage
+struct _callsite {
     const char* file;
     int         line;
     const char* func;
     const char* label;
-    duration    accumulated_time;
+};
+
+// --- Latency statistics ---
+// --------------------------
+
+// Log-linear latency histogram, same idea as HDR histogram. Durations are split into power-of-2 ranges, each range
+// is further split into 'sub_buckets' linear buckets, which keeps relative error of percentiles under 1 / sub_buckets
+// regardless of the magnitude. Durations below 'sub_buckets' nanoseconds get a bucket each, durations
+// above 2^max_bits nanoseconds (~18 minutes) get clamped to the last bucket.
+constexpr std::size_t _histogram_sub_bits    = 4;
+constexpr std::size_t _histogram_sub_buckets = std::size_t(1) << _histogram_sub_bits;
+constexpr std::size_t _histogram_max_bits    = 40;
+constexpr std::size_t _histogram_size = (_histogram_max_bits - _histogram_sub_bits + 1) * _histogram_sub_buckets;
+
+inline std::size_t _bit_width(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - static_cast<std::size_t>(__builtin_clzll(value)) : 0;
+#else
+    std::size_t width = 0;
+    for (; value; value >>= 1) ++width;
+    return width;
+#endif
+}
+
+inline std::size_t _histogram_bucket(std::uint64_t ns) noexcept {
+    if (ns < _histogram_sub_buckets) return static_cast<std::size_t>(ns);
+
+    const std::size_t exponent = _bit_width(ns) - 1;
+    if (exponent >= _histogram_max_bits) return _histogram_size - 1;
+
+    const std::size_t mantissa = static_cast<std::size_t>(ns >> (exponent - _histogram_sub_bits)) &
+                                 (_histogram_sub_buckets - 1);
+    return (exponent - _histogram_sub_bits + 1) * _histogram_sub_buckets + mantissa;
+}
+
+inline std::uint64_t _histogram_bucket_width(std::size_t bucket) noexcept {
+    return bucket < _histogram_sub_buckets ? 1 : std::uint64_t(1) << (bucket / _histogram_sub_buckets - 1);
+}
+
+inline std::uint64_t _histogram_bucket_lower(std::size_t bucket) noexcept {
+    if (bucket < _histogram_sub_buckets) return bucket;
+    return (_histogram_sub_buckets + bucket % _histogram_sub_buckets) * _histogram_bucket_width(bucket);
+}
+
+// Middle of the duration range covered by the bucket, used as a representative value for percentiles
+inline std::uint64_t _histogram_bucket_value(std::size_t bucket) noexcept {
+    return _histogram_bucket_lower(bucket) + _histogram_bucket_width(bucket) / 2;
+}
+
+inline duration _ns_to_duration(std::uint64_t ns) {
+    return std::chrono::duration_cast<duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(ns)));
+}
+
+// Statistics of a callsite, 'calls' count complete measurements, which means recursive calls of a scope
+// count as a single call, the same way they are counted in the accumulated time
+struct _statistics {
+    std::uint64_t                               calls = 0;
+    duration                                    min   = duration::max();
+    duration                                    max   = duration::zero();
+    std::array<std::uint64_t, _histogram_size> histogram{};
+
+    void merge(const _statistics& other) {
+        this->calls += other.calls;
+        this->min = std::min(this->min, other.min);
+        this->max = std::max(this->max, other.max);
+        for (std::size_t i = 0; i < _histogram_size; ++i) this->histogram[i] += other.histogram[i];
+    }
+
+    // Min & max can't be subtracted, instead we narrow them down to the range of buckets that are still non-empty
+    void subtract(const _statistics& baseline) {
+        if (!baseline.calls) return;
+
+        this->calls -= baseline.calls;
+        for (std::size_t i = 0; i < _histogram_size; ++i) this->histogram[i] -= baseline.histogram[i];
+
+        if (!this->calls) {
+            *this = _statistics{};
+            return;
+        }
+
+        std::size_t first = 0, last = _histogram_size - 1;
+        while (!this->histogram[first]) ++first;
+        while (!this->histogram[last]) --last;
+
+        this->min = std::max(this->min, _ns_to_duration(_histogram_bucket_lower(first)));
+        if (last + 1 < _histogram_size)
+            this->max = std::min(this->max, _ns_to_duration(_histogram_bucket_lower(last + 1) - 1));
+    }
+
+    duration percentile(double p) const {
+        if (!this->calls) return duration::zero();
+
+        const auto target = std::max(static_cast<std::uint64_t>(std::ceil(p * this->calls)), std::uint64_t(1));
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < _histogram_size; ++i) {
+            cumulative += this->histogram[i];
+            if (cumulative < target) continue;
+
+            // bucket middle can lie outside of the observed range
+            return std::clamp(_ns_to_duration(_histogram_bucket_value(i)), this->min, this->max);
+        }
+
+        return this->max;
+    }
+};
+
+// --- Hardware counters ---
+// -------------------------
+
+// Hardware counters are collected with Linux 'perf_event_open()', each thread opens its own group of counters
+// upon the first measurement. Group gets scheduled onto the PMU as a whole, so all counters in it cover the same
+// period of time.
+//
+// Reading counters with a 'read()' syscall costs about as much as the profiled scope in many cases, which is why
+// we map the counter page into memory and read the counter directly with 'rdpmc' instruction whenever the kernel
+// allows it (see 'perf_event_mmap_page' docs in <linux/perf_event.h>), 'read()' is only used as a fallback.
+
+constexpr std::size_t _counter_count = 4; // cycles, instructions, cache misses, branch misses
+
+using _counter_values = std::array<std::uint64_t, _counter_count>;
+
+// Measurements of a callsite, 'calls' count measurements in the same way as '_statistics'
+struct _counters {
+    std::uint64_t   calls = 0;
+    _counter_values values{};
+
+    void merge(const _counters& other) {
+        this->calls += other.calls;
+        for (std::size_t i = 0; i < _counter_count; ++i) this->values[i] += other.values[i];
+    }
+
+    void subtract(const _counters& baseline) {
+        this->calls -= baseline.calls;
+        for (std::size_t i = 0; i < _counter_count; ++i) this->values[i] -= baseline.values[i];
+    }
+};
+
+// Error of the first failed 'perf_event_open()', counters read as zeros when they are unavailable
+inline std::atomic<int> _counters_error{0};
+
+// Set once the kernel had to multiplex counters with other events, see '_scale_count()'
+inline std::atomic<bool> _counters_multiplexed{false};
+
+// When there are more events than hardware counters, kernel time-shares them and each count only covers 'running'
+// out of 'enabled' nanoseconds, the usual estimate is to scale it by 'enabled / running' (same as 'perf stat' does)
+inline std::uint64_t _scale_count(std::uint64_t count, std::uint64_t enabled, std::uint64_t running) noexcept {
+    if (enabled == running || !running) return count;
+    _counters_multiplexed.store(true, std::memory_order_relaxed);
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128; // '__extension__' silences '-Wpedantic'
+    return static_cast<std::uint64_t>(static_cast<uint128>(count) * enabled / running);
+#else
+    // Split into quotient & remainder so the products don't overflow, this is how the kernel docs do it
+    return count / running * enabled + count % running * enabled / running;
+#endif
+}
+
+#ifdef UTL_PROFILER_HAS_PERF_EVENTS
+
+class _perf_counters {
+private:
+    std::array<int, _counter_count>                         fds;
+    std::array<const perf_event_mmap_page*, _counter_count> pages{};
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    bool        available = false;
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+    // Sequence lock protocol from the kernel docs, page contents may change if we get rescheduled. Enabled & running
+    // times have to be read in the same critical section as the counter, they are only updated when the counter gets
+    // scheduled, so multiplexed counters extrapolate them to the current moment with TSC.
+    bool read_rdpmc(std::size_t i, std::uint64_t& value) const noexcept {
+        const volatile perf_event_mmap_page* page = this->pages[i];
+        if (!page) return false;
+
+        std::uint32_t sequence;
+        std::uint64_t count, enabled, running;
+        do {
+            sequence = page->lock;
+            asm volatile("" ::: "memory");
+
+            enabled = page->time_enabled;
+            running = page->time_running;
+            if (enabled != running) {
+                if (!page->cap_user_time) return false; // can't extrapolate times, 'read()' knows better
+
+                const std::uint64_t cycles = _rdtsc();
+                const std::uint16_t shift  = page->time_shift;
+                const std::uint64_t mult   = page->time_mult;
+                const std::uint64_t delta  = page->time_offset + (cycles >> shift) * mult +
+                                            (((cycles & ((std::uint64_t(1) << shift) - 1)) * mult) >> shift);
+                enabled += delta;
+                running += delta;
+            }
+
+            const std::uint32_t index = page->index;
+            if (!page->cap_user_rdpmc || !index) return false; // counter isn't active on this CPU right now
+
+            unsigned int low, high;
+            asm volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(index - 1));
+
+            // counter is 'pmc_width' bits wide and has to be sign-extended
+            const std::uint16_t width = page->pmc_width;
+            std::int64_t        pmc   = static_cast<std::int64_t>(static_cast<std::uint64_t>(high) << 32 | low);
+            pmc = static_cast<std::int64_t>(static_cast<std::uint64_t>(pmc) << (64 - width)) >> (64 - width);
+
+            count = page->offset + static_cast<std::uint64_t>(pmc);
+
+            asm volatile("" ::: "memory");
+        } while (page->lock != sequence);
+
+        if (!running) return false; // counter has never been scheduled, nothing to scale
+
+        value = _scale_count(count, enabled, running);
+        return true;
+    }
+#endif
+
+public:
+    _perf_counters() {
+        this->fds.fill(-1);
+
+        constexpr std::array<std::uint64_t, _counter_count> events = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES};
+
+        for (std::size_t i = 0; i < _counter_count; ++i) {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.config         = events[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid = 0, cpu = -1 => count this thread on any CPU, first counter is the group leader
+            this->fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i ? this->fds[0] : -1, 0));
+
+            if (this->fds[i] == -1) {
+                int expected = 0;
+                _counters_error.compare_exchange_strong(expected, errno);
+                return;
+            }
+
+            void* page = mmap(nullptr, this->page_size, PROT_READ, MAP_SHARED, this->fds[i], 0);
+            if (page != MAP_FAILED) this->pages[i] = static_cast<const perf_event_mmap_page*>(page);
+        }
+
+        this->available = true;
+    }
+
+    _perf_counters(const _perf_counters&)            = delete;
+    _perf_counters& operator=(const _perf_counters&) = delete;
+
+    ~_perf_counters() {
+        for (auto page : this->pages)
+            if (page) munmap(const_cast<perf_event_mmap_page*>(page), this->page_size);
+        for (auto fd : this->fds)
+            if (fd != -1) close(fd);
+    }
+
+    _counter_values read() const noexcept {
+        _counter_values result{};
+        if (!this->available) return result;
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+        bool success = true;
+        for (std::size_t i = 0; i < _counter_count && success; ++i) success = this->read_rdpmc(i, result[i]);
+        if (success) return result;
+#endif
+
+        // Group read returns the number of counters, enabled & running times of the group and counter values.
+        // Counters that were never scheduled read as zeros.
+        std::array<std::uint64_t, _counter_count + 3> buffer{};
+        if (::read(this->fds[0], buffer.data(), sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)) && buffer[2])
+            for (std::size_t i = 0; i < _counter_count; ++i)
+                result[i] = _scale_count(buffer[i + 3], buffer[1], buffer[2]);
+
+        return result;
+    }
+};
+
+inline _counter_values _read_counters() noexcept {
+    thread_local const _perf_counters counters;
+    return counters.read();
+}
+
+inline std::string _counters_status() {
+    const int error = _counters_error.load();
+    if (!error) return {};
+    return "perf_event_open() failed: " + std::system_category().message(error) +
+           (error == EACCES || error == EPERM ? " (see '/proc/sys/kernel/perf_event_paranoid')" : "");
+}
+
+#else
+
+inline _counter_values _read_counters() noexcept { return {}; }
+
+inline std::string _counters_status() { return "hardware counters are only supported on Linux"; }
+
+#endif
+
+// --- Allocation tracking ---
+// ---------------------------
+
+// Heap allocations made while the callsite was the innermost active profiled scope of the thread,
+// deallocations are attributed in the same way, which is not necessarily the scope that allocated the memory
+struct _allocations {
+    std::uint64_t count         = 0;
+    std::uint64_t bytes         = 0;
+    std::uint64_t deallocations = 0;
+
+    void merge(const _allocations& other) {
+        this->count += other.count;
+        this->bytes += other.bytes;
+        this->deallocations += other.deallocations;
+    }
+
+    void subtract(const _allocations& baseline) {
+        this->count -= baseline.count;
+        this->bytes -= baseline.bytes;
+        this->deallocations -= baseline.deallocations;
+    }
+};
+
+// --- Overhead compensation ---
+// ------------------------------
+
+// Every measurement includes a part of its own timer overhead, and the time of an enclosing scope includes the full
+// overhead of every nested profiled scope. Knowing the number of both we can subtract calibrated values afterwards.
+struct _overhead {
+    std::uint64_t calls        = 0;
+    std::uint64_t nested_calls = 0;  // profiled scopes entered during the measurement, at any depth
+    duration      raw_time     = {}; // time before the compensation
+
+    void merge(const _overhead& other) {
+        this->calls += other.calls;
+        this->nested_calls += other.nested_calls;
+        this->raw_time += other.raw_time;
+    }
+
+    void subtract(const _overhead& baseline) {
+        this->calls -= baseline.calls;
+        this->nested_calls -= baseline.nested_calls;
+        this->raw_time -= baseline.raw_time;
+    }
+};
+
+// Results of a callsite, either from a single thread or merged from all of them
+struct _record {
+    const _callsite* callsite;
+    std::size_t      thread;
+    duration         accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    _statistics statistics;
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    _counters counters;
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    _allocations allocations;
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    _overhead overhead;
+#endif
 };
 
 inline void _utl_profiler_atexit(); // predeclaration, implementation has circular dependency with 'RecordManager'
 
+struct _baseline;
+inline _baseline& _reset_baseline(); // same thing, needs to be constructed before the 'atexit()' registration
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+struct _timer_overhead;
+inline const _timer_overhead& _calibrated_overhead(); // calibration has to happen before the first measurement
+#endif
+
 // =========================
 // --- Profiler Classess ---
 // =========================
 
+// Single writer accumulation, owning thread is the only one that ever modifies the value, which means
+// we can avoid read-modify-write atomics and still allow other threads to read the value at any time
+template <class T>
+void _relaxed_add(std::atomic<T>& target, T value) noexcept {
+    target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Record of a single callsite in a single thread. Only the owning thread ever writes to it, which means we don't need
+// any read-modify-write atomics on a hot path, atomic is only there so that results can be safely read by another
+// thread at any time (which compiles down to a regular 'mov' with relaxed memory order)
+class _thread_record {
+private:
+    std::atomic<duration::rep> accumulated{};
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    std::atomic<std::uint64_t>                               calls{};
+    std::atomic<duration::rep>                               min{std::numeric_limits<duration::rep>::max()};
+    std::atomic<duration::rep>                               max{};
+    std::array<std::atomic<std::uint64_t>, _histogram_size> histogram{};
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    std::atomic<std::uint64_t>                              counted_calls{};
+    std::array<std::atomic<std::uint64_t>, _counter_count> counter_values{};
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    std::atomic<std::uint64_t> allocation_count{};
+    std::atomic<std::uint64_t> allocated_bytes{};
+    std::atomic<std::uint64_t> deallocation_count{};
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    std::atomic<std::uint64_t> measured_calls{};
+    std::atomic<std::uint64_t> nested_calls{};
+#endif
+
+public:
+    const _callsite* callsite;
+    int              recursion{};
+
+    _thread_record(const _callsite* callsite) : callsite(callsite) {}
+
+    void add_time(duration time) noexcept {
+        _relaxed_add(this->accumulated, time.count());
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+        const auto ns = std::max<std::chrono::nanoseconds::rep>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), 0);
+
+        _relaxed_add(this->calls, std::uint64_t(1));
+        _relaxed_add(this->histogram[_histogram_bucket(static_cast<std::uint64_t>(ns))], std::uint64_t(1));
+        if (time.count() < this->min.load(std::memory_order_relaxed))
+            this->min.store(time.count(), std::memory_order_relaxed);
+        if (time.count() > this->max.load(std::memory_order_relaxed))
+            this->max.store(time.count(), std::memory_order_relaxed);
+#endif
+    }
+
+    duration accumulated_time() const noexcept { return duration(this->accumulated.load(std::memory_order_relaxed)); }
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    void add_counters(const _counter_values& values) noexcept {
+        _relaxed_add(this->counted_calls, std::uint64_t(1));
+        for (std::size_t i = 0; i < _counter_count; ++i) _relaxed_add(this->counter_values[i], values[i]);
+    }
+
+    _counters counters() const noexcept {
+        _counters result;
+        result.calls = this->counted_calls.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < _counter_count; ++i)
+            result.values[i] = this->counter_values[i].load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    // Called from inside of the 'operator new' & 'operator delete', can't allocate anything by itself
+    void add_allocation(std::size_t size) noexcept {
+        _relaxed_add(this->allocation_count, std::uint64_t(1));
+        _relaxed_add(this->allocated_bytes, static_cast<std::uint64_t>(size));
+    }
+
+    void add_deallocation() noexcept { _relaxed_add(this->deallocation_count, std::uint64_t(1)); }
+
+    _allocations allocations() const noexcept {
+        _allocations result;
+        result.count         = this->allocation_count.load(std::memory_order_relaxed);
+        result.bytes         = this->allocated_bytes.load(std::memory_order_relaxed);
+        result.deallocations = this->deallocation_count.load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    void add_nested_calls(std::uint64_t nested) noexcept {
+        _relaxed_add(this->measured_calls, std::uint64_t(1));
+        _relaxed_add(this->nested_calls, nested);
+    }
+
+    _overhead overhead() const noexcept {
+        _overhead result;
+        result.calls        = this->measured_calls.load(std::memory_order_relaxed);
+        result.nested_calls = this->nested_calls.load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    _statistics statistics() const noexcept {
+        _statistics result;
+        result.calls = this->calls.load(std::memory_order_relaxed);
+        if (!result.calls) return result;
+
+        result.min = duration(this->min.load(std::memory_order_relaxed));
+        result.max = duration(this->max.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < _histogram_size; ++i)
+            result.histogram[i] = this->histogram[i].load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
+};
+
+// Same as '_thread_record::recursion' but shared between all callsites of the thread, see '_exclusive_scope_timer'
+inline thread_local int _exclusive_recursion = 0;
+
+// Number of measurements started on the thread, only used with 'UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION'.
+// Recursive entries of an already measured scope don't read the clock, so they aren't counted.
+inline thread_local std::uint64_t _scope_entries = 0;
+
+// Record of the innermost active profiled scope of the thread, only used with 'UTL_PROFILER_OPTION_ALLOCATIONS'.
+// Pointer is constant-initialized, so it can be safely accessed from the allocation hooks at any point.
+inline thread_local _thread_record* _current_record = nullptr;
+
+// Profiler's own bookkeeping shouldn't show up in the results, internal allocations are wrapped in this guard
+struct _untracked_allocations {
+    _thread_record* record = std::exchange(_current_record, nullptr);
+
+    ~_untracked_allocations() { _current_record = this->record; }
+};
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+
+inline void _track_allocation(std::size_t size) noexcept {
+    if (_thread_record* record = _current_record) record->add_allocation(size);
+}
+
+inline void _track_deallocation(void* ptr) noexcept {
+    if (_thread_record* record = _current_record; record && ptr) record->add_deallocation();
+}
+
+// Replacement 'operator new' has to follow the standard semantics, calling 'new_handler' on failure until it either
+// succeeds or runs out of handlers. Aligned allocations round the size up to the alignment, since that's what
+// 'std::aligned_alloc()' requires.
+inline void* _allocate(std::size_t size, std::size_t alignment = 0) {
+    _track_allocation(size);
+
+    const auto try_allocate = [&]() -> void* {
+        if (size == 0) size = 1;
+        if (!alignment) return std::malloc(size);
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    };
+
+    while (true) {
+        if (void* ptr = try_allocate()) return ptr;
+
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void* _allocate_nothrow(std::size_t size, std::size_t alignment = 0) noexcept {
+    try {
+        return _allocate(size, alignment);
+    } catch (...) { return nullptr; }
+}
+
+inline void _deallocate(void* ptr, [[maybe_unused]] bool aligned = false) noexcept {
+    _track_deallocation(ptr);
+#ifdef _WIN32
+    if (aligned) _aligned_free(ptr);
+    else std::free(ptr);
+#else
+    std::free(ptr); // memory from 'std::aligned_alloc()' is freed the same way
+#endif
+}
+
+#endif
+
+// Node of a per-thread call tree, tree only grows under the registry mutex and its values are written by the
+// owning thread, which allows us to read it from other threads in the same way as regular records
+struct _call_tree_node {
+    const _callsite*                              callsite = nullptr;
+    _call_tree_node*                              parent   = nullptr;
+    std::vector<std::unique_ptr<_call_tree_node>> children;
+    std::atomic<duration::rep>                    inclusive_time{};
+    std::atomic<std::uint64_t>                    calls{};
+    std::atomic<std::uint64_t>                    samples{}; // written from the signal handler of the owning thread
+};
+
+// Innermost call tree node of the thread, only used with 'UTL_PROFILER_OPTION_CALL_TREE' or '..._SAMPLING'
+inline thread_local _call_tree_node* _current_node = nullptr;
+
+// Sampled instruction address, 'callsite' is the innermost profiled scope of the first sample that hit it
+struct _ip_sample {
+    std::uintptr_t   ip;
+    const _callsite* callsite;
+    std::uint64_t    samples;
+};
+
+// Fixed-size open-addressing hash table of sampled instruction addresses. It only gets written from the signal
+// handler of the owning thread, which means it can neither allocate nor lock. Address of a slot gets published
+// last, so readers from other threads never see a partially filled slot.
+class _ip_table {
+private:
+    static constexpr std::size_t capacity = 4096;
+
+    struct slot {
+        std::atomic<std::uintptr_t>   ip{};
+        std::atomic<const _callsite*> callsite{};
+        std::atomic<std::uint64_t>    samples{};
+    };
+
+    std::array<slot, capacity> slots{};
+    std::atomic<std::uint64_t> dropped{};
+
+public:
+    void add(std::uintptr_t ip, const _callsite* callsite) noexcept {
+        std::size_t index = static_cast<std::size_t>((ip * 0x9E3779B97F4A7C15ull) >> 52) % capacity;
+
+        for (std::size_t probe = 0; probe < capacity; ++probe, index = (index + 1) % capacity) {
+            slot&                slot     = this->slots[index];
+            const std::uintptr_t existing = slot.ip.load(std::memory_order_relaxed);
+
+            if (existing == ip) {
+                _relaxed_add(slot.samples, std::uint64_t(1));
+                return;
+            }
+            if (existing) continue;
+
+            slot.callsite.store(callsite, std::memory_order_relaxed);
+            slot.samples.store(1, std::memory_order_relaxed);
+            slot.ip.store(ip, std::memory_order_release);
+            return;
+        }
+
+        _relaxed_add(this->dropped, std::uint64_t(1)); // table is full
+    }
+
+    std::vector<_ip_sample> collect() const {
+        std::vector<_ip_sample> result;
+        for (const auto& slot : this->slots)
+            if (const std::uintptr_t ip = slot.ip.load(std::memory_order_acquire))
+                result.push_back({ip, slot.callsite.load(std::memory_order_relaxed),
+                                  slot.samples.load(std::memory_order_relaxed)});
+        return result;
+    }
+};
+
+// Single execution of a profiled scope, only recorded with 'UTL_PROFILER_OPTION_TRACE'
+struct _trace_event {
+    const _callsite* callsite;
+    time_point       start;
+    duration         time;
+};
+
+// Append-only per-thread event buffer. Events are stored in fixed-size chunks that never get moved, owning thread
+// publishes the event count with a release store after writing the event, which allows other threads to read all
+// published events while the buffer keeps growing. Chunk list only changes once every 'chunk_size' events.
+class _trace_buffer {
+private:
+    static constexpr std::size_t chunk_size = 4096;
+    using chunk                             = std::array<_trace_event, chunk_size>;
+
+    std::mutex                          mutex;
+    std::vector<std::unique_ptr<chunk>> chunks;
+    std::atomic<std::size_t>            size{};
+
+public:
+    void push(const _trace_event& event) {
+        const std::size_t index = this->size.load(std::memory_order_relaxed);
+
+        if (index % chunk_size == 0) {
+            const _untracked_allocations guard;
+            auto                         new_chunk = std::make_unique<chunk>();
+
+            const std::lock_guard lock(this->mutex);
+            this->chunks.push_back(std::move(new_chunk));
+        }
+
+        (*this->chunks[index / chunk_size])[index % chunk_size] = event;
+        this->size.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<_trace_event> collect() {
+        const std::size_t size = this->size.load(std::memory_order_acquire);
+
+        std::vector<_trace_event> result;
+        result.reserve(size);
+
+        const std::lock_guard lock(this->mutex);
+        for (std::size_t i = 0; i < size; ++i) result.push_back((*this->chunks[i / chunk_size])[i % chunk_size]);
+
+        return result;
+    }
+};
+
+struct _thread_records {
+    std::size_t                                  thread_index{};
+    std::vector<std::unique_ptr<_thread_record>> records;
+    _call_tree_node                              call_tree_root;
+    _trace_buffer                                trace;
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    _ip_table ip_samples;
+#endif
+};
+
+// Records of the current thread, set when the thread visits its first callsite
+inline thread_local _thread_records* _current_thread = nullptr;
+
+// --- Sampling ---
+// ----------------
+
+// Sampling mode uses a per-thread POSIX timer that measures CPU time of the thread and sends it 'SIGPROF'
+// every 'UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US' microseconds. Signal handler runs on the sampled thread
+// and only increments the sample count of its current call tree node (which corresponds to the stack of
+// active profiled scopes), this requires no locking or allocation and is async-signal-safe.
+//
+// Call tree nodes only get created and never deallocated, which means '_current_node' always points to
+// a valid node regardless of the moment when the signal interrupts the thread.
+
+#ifndef UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US
+#define UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US 1000
+#endif
+
+// Error of the first failed sampling setup, 'ENOSYS' on platforms without sampling support
+inline std::atomic<int> _sampling_error{0};
+
+// Timers belong to thread-local objects, a detached thread that is still running during static destruction
+// can get a signal after the registry is gone. Registry destructor raises the flag and waits for the handlers
+// that are already running, this is a Dekker-style handshake, so both sides need sequentially consistent order.
+inline std::atomic<bool>     _sampling_shutdown{false};
+inline std::atomic<unsigned> _sampling_handlers_running{0};
+
+#if defined(UTL_PROFILER_OPTION_SAMPLING) && defined(UTL_PROFILER_HAS_SAMPLING)
+
+inline void _sampling_sample([[maybe_unused]] void* context) noexcept {
+    _call_tree_node* node = _current_node;
+    if (!node) return;
+
+    _relaxed_add(node->samples, std::uint64_t(1));
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    const ucontext_t* ucontext = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.pc);
+#else
+    const std::uintptr_t ip = 0;
+#endif
+    if (ip && _current_thread) _current_thread->ip_samples.add(ip, node->callsite);
+#endif
+}
+
+inline void _sampling_handler(int, siginfo_t*, void* context) noexcept {
+    _sampling_handlers_running.fetch_add(1);
+    if (!_sampling_shutdown.load()) _sampling_sample(context);
+    _sampling_handlers_running.fetch_sub(1);
+}
+
+class _sampling_timer {
+private:
+    timer_t timer{};
+    bool    created = false;
+
+    static void set_error(int error) {
+        int expected = 0;
+        _sampling_error.compare_exchange_strong(expected, error);
+    }
+
+public:
+    _sampling_timer() {
+        static const bool handler_installed = [] {
+            struct sigaction action {};
+            action.sa_sigaction = _sampling_handler;
+            action.sa_flags     = SA_SIGINFO | SA_RESTART; // don't make the sampled code deal with 'EINTR'
+            sigemptyset(&action.sa_mask);
+
+            if (sigaction(SIGPROF, &action, nullptr) == 0) return true;
+            set_error(errno);
+            return false;
+        }();
+        if (!handler_installed) return;
+
+        // Signal should be delivered to this specific thread, rather than to an arbitrary thread of the process
+        sigevent event{};
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo  = SIGPROF;
+#ifdef sigev_notify_thread_id
+        event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+#else
+        event._sigev_un._tid = static_cast<pid_t>(syscall(SYS_gettid));
+#endif
+
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &this->timer) != 0) {
+            set_error(errno);
+            return;
+        }
+        this->created = true;
+
+        constexpr long interval_ns = static_cast<long>(UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US) * 1000;
+
+        itimerspec spec{};
+        spec.it_interval.tv_sec  = interval_ns / 1'000'000'000;
+        spec.it_interval.tv_nsec = interval_ns % 1'000'000'000;
+        spec.it_value            = spec.it_interval;
+
+        if (timer_settime(this->timer, 0, &spec, nullptr) != 0) set_error(errno);
+    }
+
+    _sampling_timer(const _sampling_timer&)            = delete;
+    _sampling_timer& operator=(const _sampling_timer&) = delete;
+
+    ~_sampling_timer() {
+        if (this->created) timer_delete(this->timer);
+    }
+};
+
+// Timer lives until the thread exits
+inline void _start_sampling() { thread_local const _sampling_timer timer; }
+
+#else
+
+inline void _start_sampling() {
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    int expected = 0;
+    _sampling_error.compare_exchange_strong(expected, ENOSYS);
+#endif
+}
+
+#endif
+
+// Trace events of a single thread, sorted by their start time
+struct _thread_trace {
+    std::size_t               thread;
+    std::vector<_trace_event> events;
+};
+
+// Flattened call tree, nodes are listed depth-first with children sorted by their inclusive time
+struct _call_tree_row {
+    std::size_t            thread;
+    std::size_t            depth;
+    const _callsite*       callsite;
+    std::uint64_t          calls;
+    duration               inclusive_time;
+    duration               exclusive_time;
+    const _call_tree_node* node; // identifies the row across collections
+    std::uint64_t          self_samples;
+    std::uint64_t          total_samples; // includes samples of the nested scopes
+};
+
+// Global list of all per-thread records, records are never deallocated, which means results of finished threads
+// stay available and pointers cached by the profiling macros stay valid. Mutex is only locked when some thread
+// visits a callsite for the first time or when we collect results, neither of which happens on a hot path.
+class _registry {
+private:
+    std::mutex                                    mutex;
+    std::vector<std::unique_ptr<_thread_records>> threads;
+
+public:
+    static _registry& instance() {
+        static _registry registry;
+        return registry;
+    }
+
+#if defined(UTL_PROFILER_OPTION_SAMPLING) && defined(UTL_PROFILER_HAS_SAMPLING)
+    _registry() = default;
+
+    _registry(const _registry&)            = delete;
+    _registry& operator=(const _registry&) = delete;
+
+    // Signals of the threads that are still alive can no longer touch the call tree or the IP tables
+    ~_registry() {
+        _sampling_shutdown.store(true);
+        while (_sampling_handlers_running.load()) std::this_thread::yield();
+    }
+#endif
+
+    _thread_record* create_record(const _callsite* callsite) {
+        const _untracked_allocations guard;
+        const std::lock_guard        lock(this->mutex);
+
+        if (!_current_thread) {
+            _current_thread               = this->threads.emplace_back(std::make_unique<_thread_records>()).get();
+            _current_thread->thread_index = this->threads.size() - 1;
+            _current_node                 = &_current_thread->call_tree_root;
+            _start_sampling();
+        }
+
+        return _current_thread->records.emplace_back(std::make_unique<_thread_record>(callsite)).get();
+    }
+
+    // Returns cumulative per-thread records
+    std::vector<_record> collect_records() {
+        std::vector<_record> result;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads)
+            for (const auto& record : thread->records) {
+                _record& entry         = result.emplace_back();
+                entry.callsite         = record->callsite;
+                entry.thread           = thread->thread_index;
+                entry.accumulated_time = record->accumulated_time();
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+                entry.statistics = record->statistics();
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+                entry.counters = record->counters();
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+                entry.allocations = record->allocations();
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+                entry.overhead = record->overhead();
+#endif
+            }
+
+        return result;
+    }
+
+    std::size_t thread_count() {
+        const std::lock_guard lock(this->mutex);
+        return this->threads.size();
+    }
+
+    _call_tree_node* add_call_tree_node(_call_tree_node* parent, const _callsite* callsite) {
+        const _untracked_allocations guard;
+
+        auto node      = std::make_unique<_call_tree_node>();
+        node->callsite = callsite;
+        node->parent   = parent;
+
+        const std::lock_guard lock(this->mutex);
+        return parent->children.emplace_back(std::move(node)).get();
+    }
+
+    std::vector<_call_tree_row> collect_call_tree() {
+        std::vector<_call_tree_row> result;
+
+        // Returns total samples of the subtree, row gets pushed before its children so we fill that value later
+        const auto visit = [&](auto&& self, const _call_tree_node& node, std::size_t thread,
+                               std::size_t depth) -> std::uint64_t {
+            std::vector<const _call_tree_node*> children;
+            for (const auto& child : node.children) children.push_back(child.get());
+            std::stable_sort(children.begin(), children.end(), [](const _call_tree_node* l, const _call_tree_node* r) {
+                return l->inclusive_time.load(std::memory_order_relaxed) >
+                       r->inclusive_time.load(std::memory_order_relaxed);
+            });
+
+            std::uint64_t total_samples = node.samples.load(std::memory_order_relaxed);
+
+            for (const auto* child : children) {
+                const duration inclusive_time(child->inclusive_time.load(std::memory_order_relaxed));
+
+                duration children_time{};
+                for (const auto& grandchild : child->children)
+                    children_time += duration(grandchild->inclusive_time.load(std::memory_order_relaxed));
+
+                const std::uint64_t self_samples = child->samples.load(std::memory_order_relaxed);
+
+                const std::size_t row = result.size();
+                result.push_back({thread, depth, child->callsite, child->calls.load(std::memory_order_relaxed),
+                                  inclusive_time, inclusive_time - children_time, child, self_samples, 0});
+
+                const std::uint64_t child_samples = self(self, *child, thread, depth + 1);
+                result[row].total_samples         = child_samples;
+                total_samples += child_samples;
+            }
+
+            return total_samples;
+        };
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads) visit(visit, thread->call_tree_root, thread->thread_index, 0);
+
+        return result;
+    }
+
+    // Samples that landed outside of any profiled scope
+    std::uint64_t collect_unprofiled_samples() {
+        std::uint64_t result = 0;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads)
+            result += thread->call_tree_root.samples.load(std::memory_order_relaxed);
+
+        return result;
+    }
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    // Returns sampled instruction addresses merged across threads
+    std::vector<_ip_sample> collect_ip_samples() {
+        std::map<std::uintptr_t, _ip_sample> merged;
+        {
+            const std::lock_guard lock(this->mutex);
+            for (const auto& thread : this->threads)
+                for (const auto& sample : thread->ip_samples.collect()) {
+                    const auto [it, inserted] = merged.try_emplace(sample.ip, sample);
+                    if (!inserted) it->second.samples += sample.samples;
+                }
+        }
+
+        std::vector<_ip_sample> result;
+        for (const auto& [ip, sample] : merged) result.push_back(sample);
+        return result;
+    }
+#endif
+
+    // Parent scopes start no later than their children and last no shorter, sorting by start time with ties
+    // broken by duration puts parents first, which is the order expected by some of the trace viewers
+    std::vector<_thread_trace> collect_trace() {
+        std::vector<_thread_trace> result;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads) {
+            auto& trace  = result.emplace_back(_thread_trace{thread->thread_index, thread->trace.collect()});
+            auto& events = trace.events;
+            std::stable_sort(events.begin(), events.end(), [](const _trace_event& l, const _trace_event& r) {
+                return l.start < r.start || (l.start == r.start && l.time > r.time);
+            });
+        }
+
+        return result;
+    }
+};
+
+// Call tree tracking, a scope moves current node to a child with the same callsite, creating one if necessary.
+// Children lookup is a linear search, which is fast since the number of distinct children is usually small.
+inline _call_tree_node* _call_tree_enter(const _callsite* callsite) {
+    for (const auto& child : _current_node->children)
+        if (child->callsite == callsite) return _current_node = child.get();
+    return _current_node = _registry::instance().add_call_tree_node(_current_node, callsite);
+}
+
+inline void _call_tree_exit(_call_tree_node* node, duration time) noexcept {
+    _relaxed_add(node->inclusive_time, time.count());
+    _relaxed_add(node->calls, std::uint64_t(1));
+    _current_node = node->parent;
+}
+
+// Static marker of the callsite, creates a record for every thread that visits it
 class _record_manager {
 private:
-    _record data;
+    _callsite callsite;
+
+public:
+    _record_manager() = delete;
+
+    _record_manager(const char* file, int line, const char* func, const char* label)
+        : callsite({file, line, func, label}) {
+        // Profiler ever gets called => register result output at 'std::exit()', registry & baseline have to be
+        // constructed before that, so they get destroyed after the output is done
+        _registry::instance();
+        _reset_baseline();
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        _calibrated_overhead();
+#endif
+        [[maybe_unused]] static const bool registered = (std::atexit(_utl_profiler_atexit), true);
+    }
+
+    _thread_record* thread_record() { return _registry::instance().create_record(&this->callsite); }
+};
+
+// We need 4 slightly different timer classes, so might as well deduplicate some code by moving it into a base class
+struct _timer_base {
+protected:
+    time_point      start;
+    _thread_record* record;
+    // we could use 'std::optional<std::reference_wrapper<_thread_record>>',
+    // but that would inctroduce more dependencies for no real reason
+
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+    _call_tree_node* node;
+#endif
+
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+    time_point enter_time; // unlike 'start' this gets recorded on every entry, including the recursive ones
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    _counter_values start_counters;
+#endif
 
-public:
-    inline static std::vector<_record> records;
-    inline static int                  exclusive_recursion{};
-    int                                recursion{};
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    _thread_record* parent_record;
+#endif
 
-    void add_time(duration time) noexcept { this->data.accumulated_time += time; }
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    std::uint64_t start_entries = 0;
+#endif
 
-    _record_manager() = delete;
+    // Counters are read outside of the time measurement, so their overhead doesn't get included into the time
+    void start_measurement() {
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+        this->start_counters = _read_counters();
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        this->start_entries = ++_scope_entries;
+#endif
+        this->start = clock::now();
+    }
 
-    _record_manager(const char* file, int line, const char* func, const char* label)
-        : data({file, line, func, label, duration(0)}) {
-        // 'file', 'func', 'label' are guaranteed to be string literals, since we want to
-        // have as little overhead as possible during runtime, we can just save raw pointers
-        // and convert them to nicer types like 'std::string_view' later in the formatting stage
-
-        // Profiler ever gets called => register result output at 'std::exit()'
-        static bool first_call = true;
-        if (first_call) {
-            std::atexit(_utl_profiler_atexit);
-            first_call = false;
-        }
+    void finish_measurement() {
+        this->record->add_time(clock::now() - this->start);
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+        _counter_values values = _read_counters();
+        for (std::size_t i = 0; i < _counter_count; ++i) values[i] -= this->start_counters[i];
+        this->record->add_counters(values);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        this->record->add_nested_calls(_scope_entries - this->start_entries);
+#endif
     }
 
-    ~_record_manager() { records.emplace_back(this->data); }
-};
+    // Hooks for optional features, called upon entering & exiting the profiled scope regardless of recursion
+    void enter() {
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+        this->node = _call_tree_enter(this->record->callsite);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+        this->parent_record = _current_record;
+        _current_record     = this->record;
+#endif
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+        this->enter_time = clock::now();
+#endif
+    }
+
+    void exit() {
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+        const time_point exit_time = clock::now();
+#endif
+#if defined(UTL_PROFILER_OPTION_CALL_TREE)
+        _call_tree_exit(this->node, exit_time - this->enter_time);
+#elif defined(UTL_PROFILER_OPTION_SAMPLING)
+        _current_node = this->node->parent; // sampling only needs the tree structure, not the timing
+#endif
+#ifdef UTL_PROFILER_OPTION_TRACE
+        _current_thread->trace.push({this->record->callsite, this->enter_time, exit_time - this->enter_time});
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+        _current_record = this->parent_record;
+#endif
+    }
 
-// We need 4 slightly different timer classes, so might as well deduplicate some code by moving it into a base class
-struct _timer_base {
-protected:
-    time_point       start;
-    _record_manager* record_manager;
-    // we could use 'std::optional<std::reference_wrapper<RecordManager>>',
-    // but that would inctroduce more dependencies for no real reason
 public:
     constexpr operator bool() const noexcept { return true; }
 
-    _timer_base(_record_manager* manager) : record_manager(manager) {}
+    _timer_base(_thread_record* record) : record(record) {}
 };
 
-// Simple class that records the time of its creation and destruction and records it into the connected 'RecordManager'
+// Simple class that records the time of its creation and destruction and records it into the connected record
 struct _scope_timer : public _timer_base {
-    _scope_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->recursion++ == 0) this->start = clock::now();
+    _scope_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (this->record->recursion++ == 0) this->start_measurement();
         // this check prevent timer from double-counting time spent inside
         // of it's own scope due to recursive calls
     }
 
     ~_scope_timer() {
-        if (--this->record_manager->recursion == 0) this->record_manager->add_time(clock::now() - this->start);
+        if (--this->record->recursion == 0) this->finish_measurement();
+        this->exit();
     }
 };
 
-// Same thing as '_scope_timer' except it uses global static 'exclusive_recursion' instead of regular 'recursion' that
-// is specific to each '_record_manager'. This effecively means no '_exclusive_scope_timer''s will count time as long a
+// Same thing as '_scope_timer' except it uses thread-wide '_exclusive_recursion' instead of regular 'recursion' that
+// is specific to each record. This effecively means no '_exclusive_scope_timer''s will count time as long a
 // single instance of another exclusive timer exists. This allows us to resolve som tricky situations such as recursion
 struct _exclusive_scope_timer : public _timer_base {
-    _exclusive_scope_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->exclusive_recursion++ == 0) this->start = clock::now();
+    _exclusive_scope_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (_exclusive_recursion++ == 0) this->start_measurement();
     }
 
     ~_exclusive_scope_timer() {
-        if (--this->record_manager->exclusive_recursion == 0)
-            this->record_manager->add_time(clock::now() - this->start);
+        if (--_exclusive_recursion == 0) this->finish_measurement();
+        this->exit();
     }
 };
 
 // Same thing as '_scope_timer', except instead of destructor it uses an explicitly called method to record time.
 // We need it to implement code-segment profiling with 'UTL_PROFILER_BEGIN' and 'UTL_PROFILER_END'
 struct _segment_timer : public _timer_base {
-    _segment_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->recursion++ == 0) this->start = clock::now();
+    _segment_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (this->record->recursion++ == 0) this->start_measurement();
     }
 
     void finish() {
-        if (--this->record_manager->recursion == 0) this->record_manager->add_time(clock::now() - this->start);
+        if (--this->record->recursion == 0) this->finish_measurement();
+        this->exit();
     }
 };
 
 struct _exclusive_segment_timer : public _timer_base {
-    _exclusive_segment_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->exclusive_recursion++ == 0) this->start = clock::now();
+    _exclusive_segment_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (_exclusive_recursion++ == 0) this->start_measurement();
     }
 
     void finish() {
-        if (--this->record_manager->exclusive_recursion == 0)
-            this->record_manager->add_time(clock::now() - this->start);
+        if (--_exclusive_recursion == 0) this->finish_measurement();
+        this->exit();
     }
 };
 
-// ==================================
-// --- Profiler Exit & Formatting ---
-// ==================================
+// --- Overhead calibration ---
+// ----------------------------
 
-inline void _utl_profiler_atexit() {
-    // NOTE:
-    // Lots of ugly formatting stuff here, but it works, so a nicer rewrite is low-priority.
-    // Would make a lot more sense to format all the stuff into a `matrix` of strings first,
-    // and then do all the sorting/column width adjustment and etc. Should be faster (which
-    // doesn't really matter here) and more concise too.
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+
+struct _timer_overhead {
+    duration per_call{};   // part of the overhead that gets into the measurement of its own scope
+    duration per_nested{}; // full overhead of a nested measurement, as seen by the enclosing scope
+};
+
+// Runs the real '_scope_timer' on a detached record, median across batches filters out the noise from interrupts
+// & context switches. Takes ~1 ms at startup.
+//
+// Scope hooks of the optional features (call tree, trace, allocation & counter bookkeeping) are a part of the
+// overhead too, to include them calibration temporarily swaps the thread state for a private set of thread records
+// that never gets registered, so calibration scopes don't show up in the results. Calibration can happen inside
+// of another profiled scope (when the thread visits a new callsite), which is why scope entries are restored too.
+inline _timer_overhead _measure_timer_overhead() {
+    constexpr std::size_t batch_size  = 256;
+    constexpr std::size_t batch_count = 31;
+
+    const _untracked_allocations guard;
+
+    const _callsite callsite{"", 0, "", ""};
+    const auto      calibration_thread = std::make_unique<_thread_records>();
+
+    _thread_records* const thread        = std::exchange(_current_thread, calibration_thread.get());
+    _call_tree_node* const node          = std::exchange(_current_node, &calibration_thread->call_tree_root);
+    const std::uint64_t    scope_entries = _scope_entries;
+
+    std::vector<duration> per_call, per_nested;
+    for (std::size_t batch = 0; batch < batch_count; ++batch) {
+        _thread_record record(&callsite);
+
+        const time_point start = clock::now();
+        for (std::size_t i = 0; i < batch_size; ++i) _scope_timer timer(&record);
+        const duration elapsed = clock::now() - start;
+
+        per_call.push_back(record.accumulated_time() / batch_size);
+        per_nested.push_back(elapsed / batch_size);
+    }
+
+    _current_thread = thread;
+    _current_node   = node;
+    _scope_entries  = scope_entries;
+
+    const auto median = [](std::vector<duration>& values) {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    return {median(per_call), median(per_nested)};
+}
+
+inline const _timer_overhead& _calibrated_overhead() {
+    static const _timer_overhead overhead = _measure_timer_overhead();
+    return overhead;
+}
+
+// Applied to the difference of two collections rather than to each of them, otherwise clamping would make deltas wrong
+inline void _compensate_overhead(_record& record) {
+    const _timer_overhead& overhead = _calibrated_overhead();
+
+    const auto total = overhead.per_call * static_cast<duration::rep>(record.overhead.calls) +
+                       overhead.per_nested * static_cast<duration::rep>(record.overhead.nested_calls);
+
+    record.overhead.raw_time = record.accumulated_time;
+    record.accumulated_time  = std::max(record.accumulated_time - total, duration{});
+}
+
+#endif
+
+// ===========================
+// --- Profiler Formatting ---
+// ===========================
+
+inline double _duration_to_sec(duration duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1e9;
+}
+
+inline std::string _format_fixed(double value, std::streamsize precision, std::string_view postfix) {
+    return (std::ostringstream() << std::setprecision(precision) << std::fixed << value << postfix).str();
+}
+
+// Latencies of individual calls span many orders of magnitude, which is why we choose units adaptively
+inline std::string _format_latency(duration time) {
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+
+    if (ns < 1e3) return _format_fixed(ns, 0, " ns");
+    if (ns < 1e6) return _format_fixed(ns / 1e3, 2, " us");
+    if (ns < 1e9) return _format_fixed(ns / 1e6, 2, " ms");
+    return _format_fixed(ns / 1e9, 2, " s");
+}
+
+// Same for allocation volume, which can be anything from a few bytes to gigabytes
+inline std::string _format_bytes(std::uint64_t bytes) {
+    const double b = static_cast<double>(bytes);
+
+    if (b < 1024.) return _format_fixed(b, 0, " B");
+    if (b < 1024. * 1024.) return _format_fixed(b / 1024., 2, " KiB");
+    if (b < 1024. * 1024. * 1024.) return _format_fixed(b / (1024. * 1024.), 2, " MiB");
+    return _format_fixed(b / (1024. * 1024. * 1024.), 2, " GiB");
+}
+
+// Prints a table of strings with right-aligned columns, first row is used as a header
+inline void _print_table(std::ostream& os, const std::vector<std::vector<std::string>>& rows) {
+    if (rows.empty()) return;
+
+    std::vector<std::size_t> widths(rows.front().size(), 0);
+    for (const auto& row : rows)
+        for (std::size_t i = 0; i < row.size(); ++i) widths[i] = std::max(widths[i], row[i].size());
+
+    const auto print_row = [&](const std::vector<std::string>& row) {
+        os << " |";
+        for (std::size_t i = 0; i < row.size(); ++i)
+            os << ' ' << std::setw(static_cast<std::streamsize>(widths[i])) << row[i] << " |";
+        os << '\n';
+    };
+
+    print_row(rows.front());
+
+    os << " |";
+    for (const auto width : widths) os << std::string(width + 2, '-') << '|';
+    os << '\n';
+
+    for (auto it = std::next(rows.begin()); it != rows.end(); ++it) print_row(*it);
+}
+
+inline void _write_json_string(std::ostream& os, std::string_view str) {
+    constexpr std::string_view hex = "0123456789abcdef";
+
+    os << '"';
+    for (const char c : str) {
+        if (c == '"' || c == '\\') os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) os << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+        else os << c;
+    }
+    os << '"';
+}
+
+// Fields containing separators, quotes or line breaks get quoted, quotes inside of them get doubled (RFC 4180)
+inline void _write_csv_string(std::ostream& os, std::string_view str) {
+    if (str.find_first_of(",\"\r\n") == std::string_view::npos) {
+        os << str;
+        return;
+    }
+
+    os << '"';
+    for (const char c : str) os << (c == '"' ? "\"\"" : std::string_view(&c, 1));
+    os << '"';
+}
+
+inline std::int64_t _duration_to_ns(duration time) {
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+#ifdef UTL_PROFILER_HAS_SAMPLING
+// Formats address as 'module+offset', which can be resolved into a source line with 'addr2line -e <module> <offset>'
+// even for position-independent executables and shared libraries that get loaded at random addresses
+inline std::string _format_address(std::uintptr_t ip) {
+    struct search {
+        std::uintptr_t ip;
+        std::string    result;
+    } data{ip, {}};
+
+    dl_iterate_phdr(
+        [](dl_phdr_info* info, std::size_t, void* context) -> int {
+            search& data = *static_cast<search*>(context);
+
+            for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+                const auto& header = info->dlpi_phdr[i];
+                const auto  begin  = static_cast<std::uintptr_t>(info->dlpi_addr + header.p_vaddr);
+                if (header.p_type != PT_LOAD || data.ip < begin || data.ip >= begin + header.p_memsz) continue;
+
+                const std::string_view path = info->dlpi_name ? info->dlpi_name : "";
+                const std::string_view name = path.empty() ? "<executable>" : path.substr(path.find_last_of('/') + 1);
+
+                data.result = (std::ostringstream() << name << "+0x" << std::hex << data.ip - info->dlpi_addr).str();
+                return 1;
+            }
+            return 0;
+        },
+        &data);
+
+    if (data.result.empty()) return (std::ostringstream() << "0x" << std::hex << ip).str();
+    return data.result;
+}
+#endif
+
+// ========================
+// --- Profiler Reports ---
+// ========================
+
+// Cumulative results of all threads. Records can only be written by their owning thread, which is why instead of
+// resetting them we compute all reports as a difference of two collections, this gives us resets & deltas for free.
+struct _results {
+    time_point                  time = _program_entry_time_point;
+    std::size_t                 thread_count{};
+    std::vector<_record>        records;
+    std::vector<_call_tree_row> call_tree;
+    std::uint64_t               unprofiled_samples{};
+    std::vector<_ip_sample>     ip_samples;
+};
+
+inline _results _collect_results() {
+    _results results;
+    results.time         = clock::now();
+    results.thread_count = _registry::instance().thread_count();
+    results.records      = _registry::instance().collect_records();
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+    results.call_tree = _registry::instance().collect_call_tree();
+#endif
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    results.unprofiled_samples = _registry::instance().collect_unprofiled_samples();
+#endif
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    results.ip_samples = _registry::instance().collect_ip_samples();
+#endif
+    return results;
+}
+
+// Profiling results over some period of time
+struct snapshot {
+    duration                    runtime{};
+    std::size_t                 thread_count{};
+    std::vector<_record>        records;            // merged across threads, sorted by time
+    std::vector<_record>        per_thread_records; // sorted by time
+    std::vector<_call_tree_row> call_tree;          // empty unless call tree or sampling is enabled
+    std::uint64_t               unprofiled_samples{};
+    std::vector<_ip_sample>     ip_samples; // merged across threads, sorted by samples
+};
+
+inline void _sort_records(std::vector<_record>& records) {
+    std::stable_sort(records.begin(), records.end(),
+                     [](const _record& l, const _record& r) { return l.accumulated_time > r.accumulated_time; });
+}
+
+inline std::vector<_record> _merge_records(const std::vector<_record>& per_thread_records) {
+    std::vector<_record> result;
+    for (const auto& record : per_thread_records) {
+        const auto it = std::find_if(result.begin(), result.end(),
+                                     [&](const _record& e) { return e.callsite == record.callsite; });
+        if (it == result.end()) {
+            result.push_back(record);
+            result.back().thread = 0;
+        } else {
+            it->accumulated_time += record.accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+            it->statistics.merge(record.statistics);
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+            it->counters.merge(record.counters);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+            it->allocations.merge(record.allocations);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+            it->overhead.merge(record.overhead);
+#endif
+        }
+    }
+    return result;
+}
+
+inline snapshot _make_snapshot(const _results& current, const _results& baseline) {
+    snapshot result;
+    result.runtime      = current.time - baseline.time;
+    result.thread_count = current.thread_count;
+
+    // Records & call tree nodes are never removed, everything in the baseline is also present in current results
+    std::map<std::pair<const _callsite*, std::size_t>, const _record*> baseline_records;
+    for (const auto& record : baseline.records) baseline_records[{record.callsite, record.thread}] = &record;
+
+    for (auto record : current.records) {
+        if (const auto it = baseline_records.find({record.callsite, record.thread}); it != baseline_records.end()) {
+            record.accumulated_time -= it->second->accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+            record.statistics.subtract(it->second->statistics);
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+            record.counters.subtract(it->second->counters);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+            record.allocations.subtract(it->second->allocations);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+            record.overhead.subtract(it->second->overhead);
+#endif
+        }
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        _compensate_overhead(record);
+#endif
+        result.per_thread_records.push_back(record);
+    }
+
+    result.records = _merge_records(result.per_thread_records);
+    _sort_records(result.records);
+    _sort_records(result.per_thread_records);
+
+    std::map<const _call_tree_node*, const _call_tree_row*> baseline_nodes;
+    for (const auto& row : baseline.call_tree) baseline_nodes[row.node] = &row;
+
+    for (auto row : current.call_tree) {
+        if (const auto it = baseline_nodes.find(row.node); it != baseline_nodes.end()) {
+            row.calls -= it->second->calls;
+            row.inclusive_time -= it->second->inclusive_time;
+            row.exclusive_time -= it->second->exclusive_time;
+            row.self_samples -= it->second->self_samples;
+            row.total_samples -= it->second->total_samples;
+        }
+        result.call_tree.push_back(row);
+    }
+
+    result.unprofiled_samples = current.unprofiled_samples - baseline.unprofiled_samples;
+
+    std::map<std::uintptr_t, std::uint64_t> baseline_ip_samples;
+    for (const auto& sample : baseline.ip_samples) baseline_ip_samples[sample.ip] = sample.samples;
+
+    for (auto sample : current.ip_samples) {
+        if (const auto it = baseline_ip_samples.find(sample.ip); it != baseline_ip_samples.end())
+            sample.samples -= it->second;
+        if (sample.samples) result.ip_samples.push_back(sample);
+    }
+
+    std::stable_sort(result.ip_samples.begin(), result.ip_samples.end(),
+                     [](const _ip_sample& l, const _ip_sample& r) { return l.samples > r.samples; });
+
+    return result;
+}
 
-    const auto total_runtime = clock::now() - _program_entry_time_point;
+struct _baseline {
+    std::mutex mutex;
+    _results   results; // defaults to the program start
+};
+
+inline _baseline& _reset_baseline() {
+    static _baseline baseline;
+    return baseline;
+}
+
+// Returns results accumulated since the program start or the last 'reset()', can be called from any thread
+inline snapshot get_snapshot() {
+    const _results current = _collect_results();
+
+    _baseline&            baseline = _reset_baseline();
+    const std::lock_guard lock(baseline.mutex);
+    return _make_snapshot(current, baseline.results);
+}
+
+inline void reset() {
+    _results current = _collect_results();
+
+    _baseline&            baseline = _reset_baseline();
+    const std::lock_guard lock(baseline.mutex);
+    baseline.results = std::move(current);
+}
+
+// --- Optional columns ---
+// ------------------------
+
+// Optional features add the same set of values to every record. Machine-readable formats get call count,
+// durations in nanoseconds and total counter values, tables get human-readable per-call values instead.
+using _record_fields = std::vector<std::pair<std::string_view, std::int64_t>>;
+
+inline _record_fields _optional_fields([[maybe_unused]] const _record& record) {
+    _record_fields fields;
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    const _statistics& stats = record.statistics;
+    const auto         ns    = [&](duration time) { return stats.calls ? _duration_to_ns(time) : std::int64_t(0); };
+
+    fields.insert(fields.end(), {{"calls", static_cast<std::int64_t>(stats.calls)},
+                                 {"mean_ns", stats.calls ? _duration_to_ns(record.accumulated_time / stats.calls) : 0},
+                                 {"min_ns", ns(stats.min)},
+                                 {"p50_ns", ns(stats.percentile(0.50))},
+                                 {"p90_ns", ns(stats.percentile(0.90))},
+                                 {"p99_ns", ns(stats.percentile(0.99))},
+                                 {"max_ns", ns(stats.max)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    const _counters& counters = record.counters;
+    const auto       total    = [&](std::size_t i) { return static_cast<std::int64_t>(counters.values[i]); };
+
+#ifndef UTL_PROFILER_OPTION_STATISTICS
+    fields.push_back({"calls", static_cast<std::int64_t>(counters.calls)});
+#endif
+    fields.insert(fields.end(), {{"cycles", total(0)},
+                                 {"instructions", total(1)},
+                                 {"cache_misses", total(2)},
+                                 {"branch_misses", total(3)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    const _allocations& allocations = record.allocations;
+
+    fields.insert(fields.end(), {{"allocations", static_cast<std::int64_t>(allocations.count)},
+                                 {"allocated_bytes", static_cast<std::int64_t>(allocations.bytes)},
+                                 {"deallocations", static_cast<std::int64_t>(allocations.deallocations)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    fields.insert(fields.end(), {{"raw_time_ns", _duration_to_ns(record.overhead.raw_time)},
+                                 {"nested_calls", static_cast<std::int64_t>(record.overhead.nested_calls)}});
+#endif
+
+    return fields;
+}
+
+inline std::vector<std::string> _optional_header() {
+    std::vector<std::string> header;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    header.insert(header.end(), {"Calls", "Mean", "Min", "p50", "p90", "p99", "Max"});
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    header.insert(header.end(), {"Cycles/Call", "IPC", "Cache Misses/Call", "Branch Misses/Call"});
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    header.insert(header.end(), {"Allocations", "Allocated", "Deallocations"});
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    header.insert(header.end(), {"Raw Time", "Overhead %"});
+#endif
+    return header;
+}
 
-    std::ostream* os = &std::cout;
+inline std::vector<std::string> _optional_columns([[maybe_unused]] const _record& record) {
+    std::vector<std::string> columns;
 
-    // Convenience functions
-    const auto duration_to_sec = [](duration duration) -> double {
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1e9;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    const _statistics& stats = record.statistics;
+
+    if (stats.calls)
+        columns.insert(columns.end(),
+                       {std::to_string(stats.calls), _format_latency(record.accumulated_time / stats.calls),
+                        _format_latency(stats.min), _format_latency(stats.percentile(0.50)),
+                        _format_latency(stats.percentile(0.90)), _format_latency(stats.percentile(0.99)),
+                        _format_latency(stats.max)});
+    else columns.insert(columns.end(), {"0", "-", "-", "-", "-", "-", "-"});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    const _counters& counters = record.counters;
+    const auto       per_call = [&](std::size_t i) { return double(counters.values[i]) / double(counters.calls); };
+
+    if (counters.calls && counters.values[0])
+        columns.insert(columns.end(), {_format_fixed(per_call(0), 0, ""),
+                                       _format_fixed(double(counters.values[1]) / double(counters.values[0]), 2, ""),
+                                       _format_fixed(per_call(2), 1, ""), _format_fixed(per_call(3), 1, "")});
+    else columns.insert(columns.end(), {"-", "-", "-", "-"});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    const _allocations& allocations = record.allocations;
+
+    columns.insert(columns.end(), {std::to_string(allocations.count), _format_bytes(allocations.bytes),
+                                   std::to_string(allocations.deallocations)});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    const double raw_sec = _duration_to_sec(record.overhead.raw_time);
+    const double sec     = _duration_to_sec(record.accumulated_time);
+
+    columns.insert(columns.end(), {_format_fixed(raw_sec, 2, " s"),
+                                   raw_sec > 0. ? _format_fixed((raw_sec - sec) / raw_sec * 100., 1, "%") : "-"});
+#endif
+
+    return columns;
+}
+
+// --- Table format ---
+// --------------------
+
+inline std::string format_table(const snapshot& results) {
+    std::ostringstream os;
+
+    const auto runtime_sec = _duration_to_sec(results.runtime);
+
+    const auto format_time       = [](duration time) { return _format_fixed(_duration_to_sec(time), 2, " s"); };
+    const auto format_percentage = [&](duration time) -> std::string {
+        if (runtime_sec <= 0.) return "-"; // empty snapshot, for example right after a 'reset()'
+        return _format_fixed(_duration_to_sec(time) / runtime_sec * 100., 1, "%");
     };
 
-    const auto duration_percentage = [&](double duration_sec) -> double {
-        const double total_runtime_sec = duration_to_sec(total_runtime);
-        return (duration_sec / total_runtime_sec) * 100.;
+    const auto append = [](std::vector<std::string>& row, const std::vector<std::string>& columns) {
+        row.insert(row.end(), columns.begin(), columns.end());
     };
 
-    const auto float_printed_size = [](double value, std::streamsize precision, decltype(std::fixed) format,
-                                       std::string_view postfix) -> std::streamsize {
-        std::ostringstream ss;
-        ss << std::setprecision(precision) << format << value << postfix;
-        return ss.str().size(); // can be done faster but we don't really care here
+    // Build result tables
+    std::vector<std::vector<std::string>> merged_table = {{"Call Site", "Label", "Time", "Time %"}};
+    append(merged_table.front(), _optional_header());
+    for (const auto& record : results.records) {
+        merged_table.push_back({_format_call_site(record.callsite->file, record.callsite->line, record.callsite->func),
+                                record.callsite->label, format_time(record.accumulated_time),
+                                format_percentage(record.accumulated_time)});
+        append(merged_table.back(), _optional_columns(record));
+    }
+
+    std::vector<std::vector<std::string>> per_thread_table = {{"Thread", "Call Site", "Label", "Time", "Time %"}};
+    append(per_thread_table.front(), _optional_header());
+    for (const auto& record : results.per_thread_records) {
+        per_thread_table.push_back(
+            {std::to_string(record.thread),
+             _format_call_site(record.callsite->file, record.callsite->line, record.callsite->func),
+             record.callsite->label, format_time(record.accumulated_time),
+             format_percentage(record.accumulated_time)});
+        append(per_thread_table.back(), _optional_columns(record));
+    }
+
+    // Print formatted profiler header, + 1 makes header hline extend 1 character past the table on both sides
+    constexpr std::string_view header_text = " UTL PROFILING RESULTS ";
+
+    std::size_t table_length = 1;
+    for (std::size_t i = 0; i < merged_table.front().size(); ++i) {
+        std::size_t column_width = 0;
+        for (const auto& row : merged_table) column_width = std::max(column_width, row[i].size());
+        table_length += column_width + 3;
+    }
+
+    const std::size_t header_left_pad  = (std::max(table_length, header_text.size()) - header_text.size()) / 2;
+    const std::size_t header_right_pad = std::max(table_length, header_text.size()) - header_text.size() -
+                                         header_left_pad;
+
+    os << "\n"
+       << std::string(header_left_pad + 1, '-') << header_text << std::string(header_right_pad + 1, '-') << '\n'
+       << "\n"
+       << " Total runtime -> " << _format_fixed(runtime_sec, 2, " sec\n") << "\n";
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    os << " Timer overhead -> " << _format_latency(_calibrated_overhead().per_call) << " per call, "
+       << _format_latency(_calibrated_overhead().per_nested) << " per nested scope (subtracted from time)\n\n";
+#endif
+
+    _print_table(os, merged_table);
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    if (const std::string status = _counters_status(); !status.empty())
+        os << "\n Hardware counters are unavailable -> " << status << "\n";
+    else if (_counters_multiplexed.load())
+        os << "\n Hardware counters were multiplexed with other events, values are scaled estimates\n";
+#endif
+
+    // Per-thread breakdown only makes sense when several threads were profiled
+    if (results.thread_count > 1) {
+        os << "\n Per-thread results:\n\n";
+        _print_table(os, per_thread_table);
+    }
+
+    // Call tree labels are indented by depth and left-aligned, which we get by padding them to the same width,
+    // which has to be at least as wide as the column header, otherwise table would right-align them again
+    [[maybe_unused]] const auto tree_labels = [](const std::vector<_call_tree_row>& rows, std::string_view header) {
+        std::vector<std::string> labels;
+        std::size_t              width = header.size();
+        for (const auto& row : rows) {
+            labels.push_back(std::string(2 * row.depth, ' ') + row.callsite->label);
+            width = std::max(width, labels.back().size());
+        }
+        for (auto& label : labels) label.resize(width, ' ');
+        return labels;
     };
 
-    const auto repeat_hline_symbol = [](std::streamsize repeats) -> std::string {
-        return std::string(static_cast<size_t>(repeats), '-');
+#ifdef UTL_PROFILER_OPTION_CALL_TREE
+    const auto call_tree_labels = tree_labels(results.call_tree, "Call Tree");
+
+    std::vector<std::vector<std::string>> call_tree_table = {
+        {"Thread", "Call Tree", "Call Site", "Calls", "Inclusive", "Exclusive", "Inclusive %"}};
+    for (std::size_t i = 0; i < results.call_tree.size(); ++i) {
+        const auto& row = results.call_tree[i];
+        call_tree_table.push_back(
+            {std::to_string(row.thread), call_tree_labels[i],
+             _format_call_site(row.callsite->file, row.callsite->line, row.callsite->func), std::to_string(row.calls),
+             format_time(row.inclusive_time), format_time(row.exclusive_time), format_percentage(row.inclusive_time)});
+    }
+
+    os << "\n Call tree:\n\n";
+    _print_table(os, call_tree_table);
+#endif
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    // Only stacks that were actually sampled are worth showing
+    std::vector<_call_tree_row> sampled_rows;
+    std::uint64_t               total_samples = results.unprofiled_samples;
+    for (const auto& row : results.call_tree) {
+        if (row.total_samples) sampled_rows.push_back(row);
+        total_samples += row.self_samples;
+    }
+
+    const auto format_sample_percentage = [&](std::uint64_t samples) {
+        return _format_fixed(total_samples ? 100. * double(samples) / double(total_samples) : 0., 1, "%");
     };
 
-    constexpr std::streamsize  duration_precision = 2;
-    constexpr auto             duration_format    = std::fixed;
-    constexpr std::string_view duration_postfix   = " s";
+    os << "\n Sampling -> " << total_samples << " samples every " << UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US
+       << " us of CPU time, " << results.unprofiled_samples << " ("
+       << format_sample_percentage(results.unprofiled_samples) << ") outside of profiled scopes\n";
+
+    if (const int error = _sampling_error.load())
+        os << "\n Sampling is unavailable -> " << std::system_category().message(error) << "\n";
+
+    const auto sampled_labels = tree_labels(sampled_rows, "Sampled Stack");
+
+    std::vector<std::vector<std::string>> sampling_table = {
+        {"Thread", "Sampled Stack", "Call Site", "Samples", "Self %", "Total %"}};
+    for (std::size_t i = 0; i < sampled_rows.size(); ++i) {
+        const auto& row = sampled_rows[i];
+        sampling_table.push_back({std::to_string(row.thread), sampled_labels[i],
+                                  _format_call_site(row.callsite->file, row.callsite->line, row.callsite->func),
+                                  std::to_string(row.self_samples), format_sample_percentage(row.self_samples),
+                                  format_sample_percentage(row.total_samples)});
+    }
+
+    os << "\n";
+    _print_table(os, sampling_table);
+#endif
+
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && defined(UTL_PROFILER_HAS_SAMPLING)
+    constexpr std::size_t max_instructions = 20;
+
+    std::vector<std::vector<std::string>> instruction_table = {
+        {"Address", "Samples", "Samples %", "Innermost Scope"}};
+    for (std::size_t i = 0; i < std::min(results.ip_samples.size(), max_instructions); ++i) {
+        const auto& sample = results.ip_samples[i];
+        instruction_table.push_back({_format_address(sample.ip), std::to_string(sample.samples),
+                                     format_sample_percentage(sample.samples),
+                                     sample.callsite ? sample.callsite->label : "-"});
+    }
+
+    os << "\n Hottest instructions:\n\n";
+    _print_table(os, instruction_table);
+#endif
+
+    return os.str();
+}
+
+// --- JSON format ---
+// -------------------
+
+inline void _write_json_record(std::ostream& os, const _record& record, bool with_thread) {
+    const _callsite& callsite = *record.callsite;
+
+    os << "{";
+    if (with_thread) os << "\"thread\":" << record.thread << ",";
+    os << "\"call_site\":";
+    _write_json_string(os, _format_call_site(callsite.file, callsite.line, callsite.func));
+    os << ",\"file\":";
+    _write_json_string(os, callsite.file);
+    os << ",\"line\":" << callsite.line << ",\"function\":";
+    _write_json_string(os, callsite.func);
+    os << ",\"label\":";
+    _write_json_string(os, callsite.label);
+    os << ",\"time_ns\":" << _duration_to_ns(record.accumulated_time);
+
+    for (const auto& [name, value] : _optional_fields(record)) os << ",\"" << name << "\":" << value;
+    os << "}";
+}
 
-    constexpr std::streamsize  percentage_precision = 1;
-    constexpr auto             percentage_format    = std::fixed;
-    constexpr std::string_view percentage_postfix   = "%";
+// All durations are saved as integer nanoseconds, which keeps them exact
+inline std::string format_json(const snapshot& results) {
+    std::ostringstream os;
 
-    // Sort records by their accumulated time
-    std::sort(_record_manager::records.begin(), _record_manager::records.end(),
-              [](const _record& l, const _record& r) { return l.accumulated_time > r.accumulated_time; });
+    os << "{\n\"runtime_ns\":" << _duration_to_ns(results.runtime) << ",\n\"thread_count\":" << results.thread_count;
 
-    // Collect max length of each column (for proper formatting)
-    constexpr std::string_view column_name_call_site  = "Call Site";
-    constexpr std::string_view column_name_label      = "Label";
-    constexpr std::string_view column_name_duration   = "Time";
-    constexpr std::string_view column_name_percentage = "Time %";
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    os << ",\n\"timer_overhead\":{\"per_call_ns\":" << _duration_to_ns(_calibrated_overhead().per_call)
+       << ",\"per_nested_ns\":" << _duration_to_ns(_calibrated_overhead().per_nested) << '}';
+#endif
 
-    std::streamsize max_length_call_site  = column_name_call_site.size();
-    std::streamsize max_length_label      = column_name_label.size();
-    std::streamsize max_length_duration   = column_name_duration.size();
-    std::streamsize max_length_percentage = column_name_percentage.size();
+    os << ",\n\"records\":[";
+    for (std::size_t i = 0; i < results.records.size(); ++i) {
+        os << (i ? ",\n" : "\n");
+        _write_json_record(os, results.records[i], false);
+    }
 
-    for (const auto& record : _record_manager::records) {
-        const std::string call_site    = _format_call_site(record.file, record.line, record.func);
-        const std::string label        = record.label;
-        const double      duration_sec = duration_to_sec(record.accumulated_time);
+    os << "\n],\n\"per_thread_records\":[";
+    for (std::size_t i = 0; i < results.per_thread_records.size(); ++i) {
+        os << (i ? ",\n" : "\n");
+        _write_json_record(os, results.per_thread_records[i], true);
+    }
 
-        // 'Call Site' column
-        const std::streamsize length_call_site = call_site.size();
-        if (max_length_call_site < length_call_site) max_length_call_site = length_call_site;
+    os << "\n],\n\"call_tree\":[";
+    for (std::size_t i = 0; i < results.call_tree.size(); ++i) {
+        const auto&      row      = results.call_tree[i];
+        const _callsite& callsite = *row.callsite;
+
+        os << (i ? ",\n" : "\n") << "{\"thread\":" << row.thread << ",\"depth\":" << row.depth << ",\"call_site\":";
+        _write_json_string(os, _format_call_site(callsite.file, callsite.line, callsite.func));
+        os << ",\"label\":";
+        _write_json_string(os, callsite.label);
+        os << ",\"calls\":" << row.calls << ",\"inclusive_ns\":" << _duration_to_ns(row.inclusive_time)
+           << ",\"exclusive_ns\":" << _duration_to_ns(row.exclusive_time);
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+        os << ",\"self_samples\":" << row.self_samples << ",\"total_samples\":" << row.total_samples;
+#endif
+        os << "}";
+    }
+    os << "\n]";
 
-        // 'Label' column
-        const std::streamsize length_label = label.size();
-        if (max_length_label < length_label) max_length_label = length_label;
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    os << ",\n\"unprofiled_samples\":" << results.unprofiled_samples;
+#endif
 
-        // 'Time' column
-        const std::streamsize length_duration =
-            float_printed_size(duration_sec, duration_precision, duration_format, duration_postfix);
-        if (max_length_duration < length_duration) max_length_duration = length_duration;
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && defined(UTL_PROFILER_HAS_SAMPLING)
+    os << ",\n\"instructions\":[";
+    for (std::size_t i = 0; i < results.ip_samples.size(); ++i) {
+        const auto& sample = results.ip_samples[i];
 
-        // 'Time %' column
-        const auto            percentage = duration_percentage(duration_sec);
-        const std::streamsize length_percentage =
-            float_printed_size(percentage, percentage_precision, percentage_format, percentage_postfix);
-        if (max_length_percentage < length_percentage) max_length_percentage = length_percentage;
+        os << (i ? ",\n" : "\n") << "{\"address\":";
+        _write_json_string(os, _format_address(sample.ip));
+        os << ",\"label\":";
+        _write_json_string(os, sample.callsite ? sample.callsite->label : "");
+        os << ",\"samples\":" << sample.samples << "}";
     }
+    os << "\n]";
+#endif
+
+    os << "\n}\n";
+
+    return os.str();
+}
+
+// --- CSV format ---
+// ------------------
+
+// Per-thread records followed by the merged ones, merged records have 'all' in the thread column
+inline std::string format_csv(const snapshot& results) {
+    std::ostringstream os;
+
+    os << "thread,file,line,function,label,time_ns";
+    for (const auto& field : _optional_fields(_record{})) os << ',' << field.first;
+    os << '\n';
+
+    const auto write_record = [&](const _record& record, std::string_view thread) {
+        os << thread << ',';
+        _write_csv_string(os, record.callsite->file);
+        os << ',' << record.callsite->line << ',';
+        _write_csv_string(os, record.callsite->func);
+        os << ',';
+        _write_csv_string(os, record.callsite->label);
+        os << ',' << _duration_to_ns(record.accumulated_time);
+        for (const auto& field : _optional_fields(record)) os << ',' << field.second;
+        os << '\n';
+    };
+
+    for (const auto& record : results.per_thread_records) write_record(record, std::to_string(record.thread));
+    for (const auto& record : results.records) write_record(record, "all");
 
-    // Print formatted profiler header
-    constexpr std::string_view HEADER_TEXT = " UTL PROFILING RESULTS ";
+    return os.str();
+}
 
-    const std::streamsize total_table_length = sizeof("| ") - 1 + max_length_call_site + sizeof(" | ") - 1 +
-                                               max_length_label + sizeof(" | ") - 1 + max_length_duration +
-                                               sizeof(" | ") - 1 + max_length_percentage + sizeof(" |") -
-                                               1; // -1 because sizeof(char[]) accounts for invisible '\0' at the end
+// --- Periodic reporter ---
+// -------------------------
 
-    const std::streamsize header_text_length = HEADER_TEXT.size();
-    const std::streamsize header_left_pad    = (total_table_length - header_text_length) / 2;
-    const std::streamsize header_right_pad   = total_table_length - header_text_length - header_left_pad;
+// Calls 'callback' every 'period' with the results accumulated since the previous report, reporting stops upon
+// destruction. Reports are computed the same way as 'reset()' but don't affect it or any other reporters.
+class periodic_reporter {
+private:
+    std::mutex              mutex;
+    std::condition_variable stop_condition;
+    bool                    stop_requested = false;
+    std::thread             thread;
 
-    *os << "\n"
-        << repeat_hline_symbol(header_left_pad + 1) << HEADER_TEXT << repeat_hline_symbol(header_right_pad + 1)
-        << '\n'
-        // + 1 makes header hline extend 1 character past the table on both sides
-        << "\n"
-        << " Total runtime -> " << std::setprecision(duration_precision) << duration_format
-        << duration_to_sec(total_runtime) << " sec\n"
-        << "\n";
+    static void print_table(const snapshot& results) { std::cout << format_table(results) << std::flush; }
 
-    // Print formatted table header
-    *os << " | " << std::setw(max_length_call_site) << column_name_call_site << " | " << std::setw(max_length_label)
-        << column_name_label << " | " << std::setw(max_length_duration) << column_name_duration << " | "
-        << std::setw(max_length_percentage) << column_name_percentage << " |\n";
+public:
+    template <class Rep, class Period>
+    periodic_reporter(std::chrono::duration<Rep, Period>      period,
+                      std::function<void(const snapshot&)> callback = print_table) {
+        // Deadlines are scheduled from the start, so the period doesn't drift with the time spent on reports
+        const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+
+        this->thread = std::thread([this, step, callback = std::move(callback)] {
+            _results previous = _collect_results();
+            auto     deadline = std::chrono::steady_clock::now() + step;
+
+            std::unique_lock lock(this->mutex);
+            while (!this->stop_condition.wait_until(lock, deadline, [this] { return this->stop_requested; })) {
+                lock.unlock();
+
+                _results current = _collect_results();
+                callback(_make_snapshot(current, previous));
+                previous = std::move(current);
+                deadline += step;
+
+                lock.lock();
+            }
+        });
+    }
 
-    *os << " |"
-        << repeat_hline_symbol(max_length_call_site + 2) // add 2 to account for delimers not having spaces in hline
-        << "|" << repeat_hline_symbol(max_length_label + 2) << "|" << repeat_hline_symbol(max_length_duration + 2)
-        << "|" << repeat_hline_symbol(max_length_percentage + 2) << "|\n";
+    periodic_reporter(const periodic_reporter&)            = delete;
+    periodic_reporter& operator=(const periodic_reporter&) = delete;
 
-    *os << std::setfill(' '); // reset the fill so we don't mess with table contents
+    ~periodic_reporter() {
+        {
+            const std::lock_guard lock(this->mutex);
+            this->stop_requested = true;
+        }
+        this->stop_condition.notify_one();
+        this->thread.join();
+    }
+};
 
+// --- Trace export ---
+// --------------------
 
-    // Print formatted table contents
-    for (const auto& record : _record_manager::records) {
-        const std::string call_site    = _format_call_site(record.file, record.line, record.func);
-        const std::string label        = record.label;
-        const double      duration_sec = duration_to_sec(record.accumulated_time);
-        const double      percentage   = duration_percentage(duration_sec);
+#ifndef UTL_PROFILER_OPTION_TRACE_FILE
+#define UTL_PROFILER_OPTION_TRACE_FILE "profiler_trace.json"
+#endif
 
-        // Join floats with their postfixes into a single string so they are properly handled by std::setw()
-        // (which only affects the first value leading to a table misaligned by postfix size)
-        std::ostringstream ss_duration;
-        ss_duration << std::setprecision(duration_precision) << duration_format << duration_sec << duration_postfix;
+// Trace format expects microseconds, we print them with a fixed nanosecond precision using integer math,
+// which is both faster than float formatting and keeps large timestamps exact
+inline void _write_trace_microseconds(std::ostream& os, duration time) {
+    const auto ns = std::max(_duration_to_ns(time), std::int64_t(0));
 
-        std::ostringstream ss_percentage;
-        ss_percentage << std::setprecision(percentage_precision) << percentage_format << percentage
-                      << percentage_postfix;
+    const auto fraction = ns % 1000;
+    os << ns / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
 
-        *os << " | " << std::setw(max_length_call_site) << call_site << " | " << std::setw(max_length_label) << label
-            << " | " << std::setw(max_length_duration) << ss_duration.str() << " | " << std::setw(max_length_percentage)
-            << ss_percentage.str() << " |\n";
+// Writes all recorded events in a Chrome Trace Event format, which can be viewed with 'chrome://tracing',
+// 'https://ui.perfetto.dev' or 'https://www.speedscope.app'. Each scope execution gets saved as a single
+// "complete" event that contains both its start and its duration.
+inline void _write_trace(std::ostream& os) {
+    const auto traces = _registry::instance().collect_trace();
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& trace : traces) {
+        os << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace.thread
+           << ",\"args\":{\"name\":\"Thread " << trace.thread << "\"}}";
+        first = false;
+
+        for (const auto& event : trace.events) {
+            const _callsite& callsite  = *event.callsite;
+            const std::string call_site = _format_call_site(callsite.file, callsite.line, callsite.func);
+
+            os << ",\n{\"name\":";
+            _write_json_string(os, *callsite.label ? std::string_view(callsite.label) : std::string_view(call_site));
+            os << ",\"cat\":\"utl\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace.thread << ",\"ts\":";
+            _write_trace_microseconds(os, event.start - _program_entry_time_point);
+            os << ",\"dur\":";
+            _write_trace_microseconds(os, event.time);
+            os << ",\"args\":{\"call_site\":";
+            _write_json_string(os, call_site);
+            os << "}}";
+        }
     }
+
+    os << "\n]}\n";
+}
+
+inline void _utl_profiler_atexit() {
+    std::ostream& os = std::cout;
+
+    os << format_table(get_snapshot());
+
+#ifdef UTL_PROFILER_OPTION_TRACE
+    std::ofstream trace_file(UTL_PROFILER_OPTION_TRACE_FILE);
+    _write_trace(trace_file);
+
+    os << "\n Trace saved to -> " << UTL_PROFILER_OPTION_TRACE_FILE << "\n";
+#endif
 }
 
 // ========================
@@ -361,8 +2360,11 @@ inline void _utl_profiler_atexit() {
     static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
                                                                                                __func__, label_);      \
                                                                                                                        \
+    thread_local utl::profiler::_thread_record* _utl_profiler_add_uuid(utl_profiler_thread_record_) =                  \
+        _utl_profiler_add_uuid(utl_profiler_record_manager_).thread_record();                                          \
+                                                                                                                       \
     if constexpr (const utl::profiler::_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){                 \
-                      &_utl_profiler_add_uuid(utl_profiler_record_manager_)})
+                      _utl_profiler_add_uuid(utl_profiler_thread_record_)})
 // Note 1:
 //
 //    constexpr bool ... = true;
@@ -385,6 +2387,9 @@ inline void _utl_profiler_atexit() {
 // Static variable initializes its record once and timer does the bare minimum of work - 2 calls to 'now()' to get
 // timing, one addition to accumulated time and a check for recursion (so it can skip time appropriately).
 //
+// 'thread_local' pointer does the same thing for per-thread records, each thread creates its record for the callsite
+// once, after which the only overhead is the access to a thread-local variable.
+//
 //  Note 3:
 //
 // _utl_profiler_add_uuid(...) ensures no identifier collisions when several profilers exist in a single scope.
@@ -401,8 +2406,11 @@ inline void _utl_profiler_atexit() {
     static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
                                                                                                __func__, label_);      \
                                                                                                                        \
+    thread_local utl::profiler::_thread_record* _utl_profiler_add_uuid(utl_profiler_thread_record_) =                  \
+        _utl_profiler_add_uuid(utl_profiler_record_manager_).thread_record();                                          \
+                                                                                                                       \
     if constexpr (const utl::profiler::_exclusive_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){       \
-                      &_utl_profiler_add_uuid(utl_profiler_record_manager_)})
+                      _utl_profiler_add_uuid(utl_profiler_thread_record_)})
 // Note:
 //
 // Exact same thing as a regular UTL_PROFILER() but uses '_exclusive_scope_timer' instead.
@@ -412,10 +2420,12 @@ inline void _utl_profiler_atexit() {
 // -------------------------
 
 #define UTL_PROFILER_BEGIN(segment_label_, label_)                                                                     \
-    static utl::profiler::_record_manager utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__, __func__,   \
-                                                                                       label_);                        \
-    utl::profiler::_segment_timer         utl_profiler_segment_timer_##segment_label_(                                 \
-        &utl_profiler_record_manager_##segment_label_)
+    static utl::profiler::_record_manager       utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__,       \
+                                                                                             __func__, label_);        \
+    thread_local utl::profiler::_thread_record* utl_profiler_thread_record_##segment_label_ =                          \
+        utl_profiler_record_manager_##segment_label_.thread_record();                                                  \
+    utl::profiler::_segment_timer utl_profiler_segment_timer_##segment_label_(                                         \
+        utl_profiler_thread_record_##segment_label_)
 
 #define UTL_PROFILER_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
 // Note 1:
@@ -430,13 +2440,72 @@ inline void _utl_profiler_atexit() {
 // and have a nice 2-macro API for profiling segments without creating a scope.
 
 #define UTL_PROFILER_EXCLUSIVE_BEGIN(segment_label_, label_)                                                           \
-    static utl::profiler::_record_manager   utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__, __func__, \
-                                                                                         label_);                      \
+    static utl::profiler::_record_manager       utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__,       \
+                                                                                             __func__, label_);        \
+    thread_local utl::profiler::_thread_record* utl_profiler_thread_record_##segment_label_ =                          \
+        utl_profiler_record_manager_##segment_label_.thread_record();                                                  \
     utl::profiler::_exclusive_segment_timer utl_profiler_segment_timer_##segment_label_(                               \
-        &utl_profiler_record_manager_##segment_label_)
+        utl_profiler_thread_record_##segment_label_)
 
 #define UTL_PROFILER_EXCLUSIVE_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
 
+// --- Allocation hooks ---
+// ------------------------
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+#define UTL_PROFILER_ALLOCATION_HOOKS                                                                                  \
+    void* operator new(std::size_t size) { return utl::profiler::_allocate(size); }                                    \
+    void* operator new[](std::size_t size) { return utl::profiler::_allocate(size); }                                  \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                                             \
+        return utl::profiler::_allocate_nothrow(size);                                                                 \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {                                           \
+        return utl::profiler::_allocate_nothrow(size);                                                                 \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t align) {                                                     \
+        return utl::profiler::_allocate(size, static_cast<std::size_t>(align));                                        \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t align) {                                                   \
+        return utl::profiler::_allocate(size, static_cast<std::size_t>(align));                                        \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {                     \
+        return utl::profiler::_allocate_nothrow(size, static_cast<std::size_t>(align));                                \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {                   \
+        return utl::profiler::_allocate_nothrow(size, static_cast<std::size_t>(align));                                \
+    }                                                                                                                  \
+    void operator delete(void* ptr) noexcept { utl::profiler::_deallocate(ptr); }                                      \
+    void operator delete[](void* ptr) noexcept { utl::profiler::_deallocate(ptr); }                                    \
+    void operator delete(void* ptr, std::size_t) noexcept { utl::profiler::_deallocate(ptr); }                         \
+    void operator delete[](void* ptr, std::size_t) noexcept { utl::profiler::_deallocate(ptr); }                       \
+    void operator delete(void* ptr, const std::nothrow_t&) noexcept { utl::profiler::_deallocate(ptr); }               \
+    void operator delete[](void* ptr, const std::nothrow_t&) noexcept { utl::profiler::_deallocate(ptr); }             \
+    void operator delete(void* ptr, std::align_val_t) noexcept { utl::profiler::_deallocate(ptr, true); }              \
+    void operator delete[](void* ptr, std::align_val_t) noexcept { utl::profiler::_deallocate(ptr, true); }            \
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {                                          \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {                                        \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                                \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                              \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    static_assert(true)
+#else
+#define UTL_PROFILER_ALLOCATION_HOOKS static_assert(true)
+#endif
+// Note:
+//
+// Replacement 'operator new' & 'operator delete' can't be 'inline' and have to be defined in exactly one translation
+// unit, which is something a header can't do by itself, this is why hooks are a separate macro that should be
+// expanded once at the global scope of some '.cpp' file. Without hooks allocation tracking simply records nothing.
+//
+// Last 'static_assert(true)' is only there so the macro requires a semicolon at the end.
+
 } // namespace utl::profiler
 
 #endif
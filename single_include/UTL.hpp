@@ -1674,17 +1674,23 @@ void _assign_node_to_value_recursively(std::array<T, N>& value, const Node& node
 
 // _______________________ INCLUDES _______________________
 
+#include <algorithm>     // min(), max()
 #include <array>         // array<>
+#include <atomic>        // atomic<>
 #include <charconv>      // to_chars()
 #include <chrono>        // steady_clock
 #include <cstddef>       // size_t
+#include <cstdint>       // uint32_t, uint64_t
 #include <exception>     // exception
 #include <fstream>       // ofstream
+#include <functional>    // hash<>
 #include <iostream>      // cout
 #include <iterator>      // next()
 #include <limits>        // numeric_limits<>
 #include <list>          // list<>
+#include <memory>        // unique_ptr<>
 #include <mutex>         // lock_guard<>, mutex
+#include <new>           // align_val_t
 #include <ostream>       // ostream
 #include <sstream>       // std::ostringstream
 #include <stdexcept>     // std::runtime_error
@@ -1698,6 +1704,18 @@ void _assign_node_to_value_recursively(std::array<T, N>& value, const Node& node
 #include <utility>       // forward<>()
 #include <variant>       // variant<>
 
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define UTL_LOG_HAS_POSIX_IO
+#include <cerrno>      // errno, EINTR
+#include <cstring>     // memcpy(), memmove(), memset(), strerror()
+#include <fcntl.h>     // open(), O_WRONLY, O_CREAT, O_TRUNC, O_APPEND, O_DIRECT
+#include <signal.h>    // sigaction(), raise(), SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT
+#include <sys/types.h> // off_t, ssize_t
+#include <sys/uio.h>   // writev(), iovec
+#include <time.h>      // clock_gettime(), CLOCK_MONOTONIC_COARSE
+#include <unistd.h>    // write(), pwrite(), pread(), lseek(), close(), fdatasync(), ftruncate(), STDERR_FILENO
+#endif
+
 // ____________________ DEVELOPER DOCS ____________________
 
 // Reasonable performance and convenient logger.
@@ -1765,17 +1783,102 @@ inline std::size_t _get_thread_index(const std::thread::id id) {
     return it->second;
 }
 
+// --- Fast integer formatting ---
+// -------------------------------
+
+// Table-driven digit counting, bit width gives us an estimate of 'log10()' which
+// needs at most one correction that can be looked up in a table of powers of 10
+constexpr std::array<std::uint64_t, 20> _powers_of_10 = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+inline unsigned int _bit_width(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - static_cast<unsigned int>(__builtin_clzll(value)) : 0;
+#else
+    unsigned int width = 0;
+    while (value) value >>= 1, ++width;
+    return width;
+#endif
+}
+
+inline unsigned int _count_digits(std::uint64_t value) noexcept {
+    value |= 1; // zero has 1 digit, setting the lowest bit never changes the digit count otherwise
+    const unsigned int estimate = (_bit_width(value) * 1233) >> 12; // 1233 / 4096 ~ log10(2)
+    return estimate + (value >= _powers_of_10[estimate]);
+}
+
+// All 2-digit pairs, lets us write integers 2 digits at a time which halves the number of divisions
+constexpr char _digit_pairs[] = "00010203040506070809"
+                                "10111213141516171819"
+                                "20212223242526272829"
+                                "30313233343536373839"
+                                "40414243444546474849"
+                                "50515253545556575859"
+                                "60616263646566676869"
+                                "70717273747576777879"
+                                "80818283848586878889"
+                                "90919293949596979899";
+
+// Writes digits of 'value' backwards ending at 'end', caller has to reserve '_count_digits(value)' chars
+inline void _write_digits(char* end, std::uint64_t value) noexcept {
+    while (value >= 100) {
+        const std::size_t pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = _digit_pairs[pair + 1];
+        *--end = _digit_pairs[pair];
+    }
+    if (value >= 10) {
+        const std::size_t pair = static_cast<std::size_t>(value) * 2;
+        *--end                 = _digit_pairs[pair + 1];
+        *--end                 = _digit_pairs[pair];
+    } else *--end = static_cast<char>('0' + value);
+}
+
+template <class T>
+std::uint64_t _unsigned_abs(T value) noexcept {
+    if constexpr (std::is_signed_v<T>)
+        return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    else return static_cast<std::uint64_t>(value);
+}
+
+template <class T>
+std::string _stringify_int(T value) {
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+    const std::uint64_t abs    = _unsigned_abs(value);
+    const std::size_t   length = negative + _count_digits(abs);
+
+    std::string str(length, '-'); // leading '-' stays in place for negative numbers
+    _write_digits(str.data() + length, abs);
+    return str;
+}
+
 template <class IntType, std::enable_if_t<std::is_integral<IntType>::value, bool> = true>
 unsigned int _integer_digit_count(IntType value) {
-    unsigned int digits = (value <= 0) ? 1 : 0;
-    // (value <  0) => we add 1 digit because of '-' in front
-    // (value == 0) => we add 1 digit for '0' because the loop doesn't account for zero integers
-    while (value) {
-        value /= 10;
-        ++digits;
-    }
-    return digits;
-    // Note: There is probably a faster way of doing it
+    if constexpr (std::is_signed_v<IntType>) return (value < 0) + _count_digits(_unsigned_abs(value));
+    else return _count_digits(value);
+    // (value < 0) => we add 1 digit because of '-' in front
 }
 
 using clock = std::chrono::steady_clock;
@@ -1884,6 +1987,84 @@ const auto& _underlying_container_cref(const Adaptor& adaptor) {
     return Hack::get_container(adaptor);
 }
 
+// --- Fast float formatting ---
+// -----------------------------
+
+// Values that are logged in practice very often have a short exact decimal representation (0.5, 12.25, 3 and etc.),
+// such values can be formatted through an integer formatting which is several times faster than 'std::to_chars()'.
+//
+// Output has to be exactly the same as the one produced by 'std::to_chars()', which is the shortest representation
+// that round-trips, formatted as fixed or scientific depending on which one is shorter (fixed wins the ties).
+//
+// We check if 'value * 10^P' is an integer 'N' such that 'N / 10^P == value', where 'P' is the fixed precision limit.
+// Both 'N' and '10^P' are exactly representable and division is correctly rounded, which means the decimal
+// 'N * 10^-P' parses back into 'value'. Restricting 'N < 2^(mantissa_bits - 1)' ensures decimal grid is coarser than
+// the float spacing, making such 'N' unique. Stripping trailing zeroes of 'N' gives us the shortest representation.
+//
+// Values outside of the fast path domain (too large, too small, too many digits, zero, inf, NaN) return 'false'.
+
+template <class T>
+constexpr unsigned int _float_fast_path_precision = std::is_same_v<T, float> ? 3 : 6;
+
+template <class T>
+bool _append_short_float(std::string& buffer, T value) {
+    if constexpr (!std::is_same_v<T, float> && !std::is_same_v<T, double>) return false;
+    else {
+        constexpr unsigned int precision = _float_fast_path_precision<T>;
+        constexpr T            scale     = static_cast<T>(_powers_of_10[precision]);
+        constexpr T            max_abs   = static_cast<T>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+
+        const bool negative = value < T(0);
+        const T    abs      = negative ? -value : value;
+        const T    scaled   = abs * scale;
+
+        if (!(scaled >= T(1) && scaled < max_abs)) return false; // also rejects zero, inf & NaN
+
+        std::uint64_t mantissa = static_cast<std::uint64_t>(scaled + T(0.5));
+        if (static_cast<T>(mantissa) / scale != abs) return false;
+
+        // Strip trailing zeroes to get the shortest representation
+        int fraction_digits = static_cast<int>(precision);
+        while (fraction_digits > 0 && mantissa % 10 == 0) mantissa /= 10, --fraction_digits;
+        int trailing_zeroes = 0; // only integers can have trailing zeroes that are not a part of the fraction
+        std::uint64_t significant = mantissa;
+        while (fraction_digits == 0 && significant % 10 == 0) significant /= 10, ++trailing_zeroes;
+
+        const int mantissa_digits    = static_cast<int>(_count_digits(mantissa));
+        const int significant_digits = mantissa_digits - trailing_zeroes;
+
+        // Compare with the length of scientific notation, 'std::to_chars()' picks whichever is shorter
+        const int exponent        = mantissa_digits - 1 - fraction_digits;
+        const int exponent_digits = std::max(2, static_cast<int>(_count_digits(_unsigned_abs(exponent))));
+        const int sci_length      = significant_digits + (significant_digits > 1) + 2 + exponent_digits;
+        const int int_digits      = std::max(1, mantissa_digits - fraction_digits);
+        const int fixed_length    = int_digits + (fraction_digits ? 1 + fraction_digits : 0);
+
+        if (fixed_length > sci_length) return false;
+
+        // Format straight into the buffer
+        const std::size_t old_size = buffer.size();
+        buffer.resize(old_size + negative + fixed_length);
+
+        char* const begin = buffer.data() + old_size;
+        char* const end   = begin + negative + fixed_length;
+
+        if (negative) *begin = '-';
+
+        if (fraction_digits) {
+            char* const point = end - fraction_digits - 1;
+            const auto  div   = _powers_of_10[fraction_digits];
+            std::fill(begin + negative, point, '0');
+            std::fill(point + 1, end, '0');
+            _write_digits(point, mantissa / div);
+            *point = '.';
+            if (mantissa % div) _write_digits(end, mantissa % div);
+        } else _write_digits(end, mantissa);
+
+        return true;
+    }
+}
+
 // --- Alignment ---
 // -----------------
 
@@ -1939,11 +2120,28 @@ struct StringifierBase {
 
     template <class T>
     static void append_int(std::string& buffer, const T& value) {
-        std::array<char, _max_int_digits<T>> stbuff;
-        const auto [number_end_ptr, error_code] = std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
-        if (error_code != std::errc())
-            throw std::runtime_error("Stringifier encountered std::to_chars() error while serializing an integer.");
-        buffer.append(stbuff.data(), number_end_ptr - stbuff.data());
+        // Format straight into the buffer, 2 digits at a time
+        if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+            bool negative = false;
+            if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+            const std::uint64_t abs      = _unsigned_abs(value);
+            const std::size_t   old_size = buffer.size();
+            const std::size_t   length   = negative + _count_digits(abs);
+
+            buffer.resize(old_size + length);
+            if (negative) buffer[old_size] = '-';
+            _write_digits(buffer.data() + old_size + length, abs);
+        }
+        // Fallback for extended integer types
+        else {
+            std::array<char, _max_int_digits<T>> stbuff;
+            const auto [number_end_ptr, error_code] =
+                std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
+            if (error_code != std::errc())
+                throw std::runtime_error("Stringifier encountered std::to_chars() error while serializing an integer.");
+            buffer.append(stbuff.data(), number_end_ptr - stbuff.data());
+        }
     }
     
     template <class T>
@@ -1953,6 +2151,8 @@ struct StringifierBase {
 
     template <class T>
     static void append_float(std::string& buffer, const T& value) {
+        if (_append_short_float(buffer, value)) return;
+
         std::array<char, _max_float_digits<T>> stbuff;
         const auto [number_end_ptr, error_code] = std::to_chars(stbuff.data(), stbuff.data() + stbuff.size(), value);
         if (error_code != std::errc())
@@ -2132,14 +2332,13 @@ struct Stringifier : public StringifierBase<Stringifier> {
 
     using base::stringify;
 
-    [[nodiscard]] static std::string stringify(int arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(long long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned int arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned long arg) { return std::to_string(arg); }
-    [[nodiscard]] static std::string stringify(unsigned long long arg) { return std::to_string(arg); }
-    // for individual ints 'std::to_string()' beats 'append_int()' with <charconv> since any reasonable compiler
-    // implements it using the same <charconv> routine, but formatted directly into a string upon its creation
+    [[nodiscard]] static std::string stringify(int arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(long long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned int arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned long arg) { return _stringify_int(arg); }
+    [[nodiscard]] static std::string stringify(unsigned long long arg) { return _stringify_int(arg); }
+    // for individual ints we can format digits directly into a string upon its creation
 
     [[nodiscard]] static std::string stringify(std::string&& arg) { return arg; }
     // no need to do all the appending stuff for individual r-value strings, just forward them as is
@@ -2185,6 +2384,10 @@ enum class OpenMode { REWRITE, APPEND };
 
 enum class Colors { ENABLE, DISABLE };
 
+enum class DirectIO { DISABLE, ENABLE };
+
+enum class FileSync { NONE, FDATASYNC };
+
 struct Columns {
     bool datetime = true;
     bool uptime   = true;
@@ -2294,6 +2497,417 @@ constexpr std::string_view _color_info  = color::white;
 constexpr std::string_view _color_warn  = color::yellow;
 constexpr std::string_view _color_err   = color::bold_red;
 
+// =========================
+// --- POSIX file output ---
+// =========================
+
+// A file handle that bypasses 'std::ofstream' and writes straight to the file descriptor. Since sinks already
+// format each message into a 'std::string' buffer, going through 'std::ofstream' only adds its own buffering,
+// locking and locale handling on top of it. Here we accumulate messages in a large user-space buffer and hand it
+// to the OS in as few syscalls as possible.
+//
+// Messages that don't fit into the remaining buffer get submitted together with the buffer in a single 'writev()',
+// this saves both a syscall and a copy for unusually large messages.
+//
+// With 'DirectIO::ENABLE' file gets opened with 'O_DIRECT' (when the platform & filesystem support it), bypassing
+// the page cache. Direct I/O requires aligned buffers, sizes and offsets, which is why in this mode we only ever
+// submit whole aligned blocks. On flush the unaligned tail gets padded with zeroes to a whole block, written and
+// truncated back to its real size, the tail stays in the buffer and gets overwritten by the next block. This keeps
+// the descriptor in 'O_DIRECT' mode at all times. If 'O_DIRECT' isn't available we silently fall back to a regular
+// buffered output.
+//
+// With 'FileSync::FDATASYNC' every flush is followed by 'fdatasync()', which ensures that flushed messages survive
+// a system crash at the cost of a much slower flush.
+//
+// Writes retry on 'EINTR' and continue after short writes. Other errors can't be propagated out of the logging
+// calls, the first one gets reported to 'stderr', after which the file keeps trying to write (errors such as
+// a full disk can go away) without flooding the output.
+
+#ifdef UTL_LOG_HAS_POSIX_IO
+
+constexpr std::size_t _direct_io_alignment = 4096; // covers logical block size of pretty much any device
+
+struct _aligned_buffer_deleter {
+    void operator()(char* ptr) const noexcept { ::operator delete[](ptr, std::align_val_t{_direct_io_alignment}); }
+};
+
+// Zero-size writes don't set 'errno', without this check they would also loop forever
+inline bool _fd_write_all(int fd, const char* data, std::size_t count) noexcept {
+    while (count) {
+        const ssize_t written = ::write(fd, data, count);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            if (!written) errno = EIO;
+            return false;
+        }
+        data += written;
+        count -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+inline bool _fd_pwrite_all(int fd, const char* data, std::size_t count, off_t offset) noexcept {
+    while (count) {
+        const ssize_t written = ::pwrite(fd, data, count, offset);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            if (!written) errno = EIO;
+            return false;
+        }
+        data += written;
+        offset += written;
+        count -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+inline bool _fd_writev_all(int fd, const char* data_1, std::size_t count_1, const char* data_2,
+                           std::size_t count_2) noexcept {
+    iovec iov[2] = {{const_cast<char*>(data_1), count_1}, {const_cast<char*>(data_2), count_2}};
+
+    ssize_t written{};
+    do written = ::writev(fd, iov, 2);
+    while (written < 0 && errno == EINTR);
+
+    if (written < 0) return false;
+
+    // Partial writes are rare, but possible, in which case we just write the rest piece-by-piece
+    const std::size_t written_1 = std::min(static_cast<std::size_t>(written), count_1);
+    const std::size_t written_2 = static_cast<std::size_t>(written) - written_1;
+
+    return _fd_write_all(fd, data_1 + written_1, count_1 - written_1) &&
+           _fd_write_all(fd, data_2 + written_2, count_2 - written_2);
+}
+
+inline bool _fd_sync(int fd) noexcept {
+    int result{};
+#if defined(__APPLE__)
+    do result = ::fsync(fd); // no 'fdatasync()' on MacOS
+    while (result < 0 && errno == EINTR);
+#else
+    do result = ::fdatasync(fd);
+    while (result < 0 && errno == EINTR);
+#endif
+    return result == 0;
+}
+
+inline bool _fd_truncate(int fd, off_t size) noexcept {
+    int result{};
+    do result = ::ftruncate(fd, size);
+    while (result < 0 && errno == EINTR);
+    return result == 0;
+}
+
+class _fd_file {
+private:
+    int                                              fd = -1;
+    std::unique_ptr<char[], _aligned_buffer_deleter> buffer;
+    std::size_t                                      capacity{};
+    std::size_t                                      size{};
+    off_t                                            offset{}; // file position of the buffer start, direct I/O only
+    // part of the buffer that is already in the file, direct I/O only
+    std::size_t                                      synced_tail{};
+    bool                                             direct{};
+    FileSync                                         sync{};
+    bool                                             error_reported{};
+
+    void check(bool success, std::string_view operation) noexcept {
+        if (success || this->error_reported) return;
+        this->error_reported = true;
+
+        const std::string_view reason = std::strerror(errno);
+        for (const std::string_view str : {std::string_view("utl::log: POSIX file sink failed to "), operation,
+                                           std::string_view(": "), reason, std::string_view("\n")})
+            _fd_write_all(STDERR_FILENO, str.data(), str.size());
+    }
+
+    // Direct I/O: write all whole blocks, keep the unaligned tail at the front of the buffer
+    void write_aligned_blocks() noexcept {
+        const std::size_t aligned_size = this->size - this->size % _direct_io_alignment;
+        if (!aligned_size) return;
+
+        this->check(_fd_pwrite_all(this->fd, this->buffer.get(), aligned_size, this->offset), "write");
+
+        this->offset += static_cast<off_t>(aligned_size);
+        this->size -= aligned_size;
+        this->synced_tail = 0;
+        std::memmove(this->buffer.get(), this->buffer.get() + aligned_size, this->size);
+    }
+
+    // Direct I/O: unaligned tail is written as a zero-padded block & truncated back to its real size, it stays
+    // in the buffer and will be overwritten with a proper aligned block once it fills up. Tail that is already
+    // in the file doesn't get rewritten, flushing an idle file costs no syscalls.
+    void write_unaligned_tail() noexcept {
+        if (this->size == this->synced_tail) return;
+
+        std::memset(this->buffer.get() + this->size, 0, _direct_io_alignment - this->size);
+        const bool written = _fd_pwrite_all(this->fd, this->buffer.get(), _direct_io_alignment, this->offset) &&
+                             _fd_truncate(this->fd, this->offset + static_cast<off_t>(this->size));
+
+        this->check(written, "write");
+        if (written) this->synced_tail = this->size;
+    }
+
+public:
+    _fd_file(const std::string& filename, OpenMode open_mode, std::size_t buffer_size, DirectIO direct_io,
+             FileSync sync)
+        : sync(sync) {
+        // Round buffer up to the whole number of aligned blocks
+        this->capacity = std::max(buffer_size, _direct_io_alignment);
+        this->capacity += (_direct_io_alignment - this->capacity % _direct_io_alignment) % _direct_io_alignment;
+
+        this->buffer.reset(new (std::align_val_t{_direct_io_alignment}) char[this->capacity]);
+
+        const bool append = (open_mode == OpenMode::APPEND);
+
+#ifdef O_DIRECT
+        // Appending with 'O_DIRECT' requires us to manage file position manually, 'O_APPEND' would ignore it
+        if (direct_io == DirectIO::ENABLE) {
+            this->fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT | (append ? 0 : O_TRUNC), 0644);
+            this->direct = (this->fd >= 0);
+        }
+
+        // When appending with direct I/O, existing file might end with an unaligned block, in which
+        // case we read it into the buffer so it gets rewritten as a part of the next aligned block
+        if (this->direct && append) {
+            const off_t end = ::lseek(this->fd, 0, SEEK_END);
+            this->offset      = end - end % static_cast<off_t>(_direct_io_alignment);
+            this->size        = static_cast<std::size_t>(end - this->offset);
+            this->synced_tail = this->size;
+
+            const bool preloaded =
+                (end >= 0) && (!this->size || ::pread(this->fd, this->buffer.get(), _direct_io_alignment,
+                                                      this->offset) == static_cast<ssize_t>(this->size));
+            if (!preloaded) {
+                ::close(this->fd);
+                this->direct      = false;
+                this->size        = 0;
+                this->synced_tail = 0;
+            }
+        }
+#endif
+        // Regular buffered output, also serves as a fallback when filesystem doesn't support 'O_DIRECT'
+        if (!this->direct)
+            this->fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+
+        if (this->fd < 0) throw std::runtime_error("Could not open log file {" + filename + "}.");
+    }
+
+    _fd_file(const _fd_file&) = delete;
+    _fd_file& operator=(const _fd_file&) = delete;
+    _fd_file& operator=(_fd_file&&) = delete;
+
+    _fd_file(_fd_file&& other) noexcept
+        : fd(other.fd), buffer(std::move(other.buffer)), capacity(other.capacity), size(other.size),
+          offset(other.offset), synced_tail(other.synced_tail), direct(other.direct), sync(other.sync),
+          error_reported(other.error_reported) {
+        other.fd = -1;
+    }
+
+    ~_fd_file() {
+        if (this->fd < 0) return;
+        this->flush();
+        ::close(this->fd);
+    }
+
+    void write(const char* data, std::size_t count) noexcept {
+        // Fast path, message fits into the buffer
+        if (this->size + count <= this->capacity) {
+            std::memcpy(this->buffer.get() + this->size, data, count);
+            this->size += count;
+            return;
+        }
+
+        // Buffered output, submit buffer & message in a single syscall
+        if (!this->direct) {
+            this->check(_fd_writev_all(this->fd, this->buffer.get(), this->size, data, count), "write");
+            this->size = 0;
+            return;
+        }
+
+        // Direct I/O, all writes have to go through the aligned buffer
+        while (count) {
+            const std::size_t chunk = std::min(this->capacity - this->size, count);
+            std::memcpy(this->buffer.get() + this->size, data, chunk);
+            this->size += chunk;
+            data += chunk;
+            count -= chunk;
+            if (this->size == this->capacity) this->write_aligned_blocks();
+        }
+    }
+
+    void flush() noexcept {
+        if (this->direct) {
+            this->write_aligned_blocks();
+            this->write_unaligned_tail();
+        } else {
+            this->check(_fd_write_all(this->fd, this->buffer.get(), this->size), "write");
+            this->size = 0;
+        }
+
+        if (this->sync == FileSync::FDATASYNC) this->check(_fd_sync(this->fd), "sync");
+    }
+};
+
+#endif
+
+// =======================
+// --- Flight recorder ---
+// =======================
+
+// An in-memory ring buffer of the most recent formatted records, which only gets written to the file when something
+// goes wrong. This allows us to keep full TRACE context around at the cost of a 'memcpy()' per message.
+//
+// Ring consists of fixed-size slots, each writer claims a ticket with a single 'fetch_add()' and copies the message
+// into the slot 'ticket % capacity'. Every slot has a sequence number that works like a seqlock: odd value means
+// the slot is being written, even value '2 * (ticket + 1)' means the slot contains a complete record of 'ticket'.
+// Writers never wait for each other, if the ring wraps around onto a slot that is still being written by someone
+// else (which requires 'capacity' messages to be logged during a single 'memcpy()') the newer record gets dropped.
+//
+// Dumping only needs 'write()' on a file descriptor that was opened upfront, which makes it async-signal-safe and
+// allows us to dump from a fatal signal handler. Every dump writes only the records that weren't dumped before,
+// so repeated dumps (for example, on every error) produce a continuous history without duplicates.
+//
+// Dump reads slots concurrently with the writers, which is only well-defined if both sides access the slot through
+// atomics. Records are stored as relaxed atomic words (which compile to regular loads & stores), dump copies the
+// length & data into a preallocated scratch buffer, re-checks the sequence after an acquire fence and only writes
+// the copy if the slot didn't change in the meantime. Records that get overwritten while the dump is in progress
+// get skipped, which is a price we pay for not locking.
+
+#ifdef UTL_LOG_HAS_POSIX_IO
+
+class _flight_recorder {
+private:
+    using word = std::uint64_t;
+
+    int                                           fd = -1;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> sequences;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> lengths;
+    std::unique_ptr<std::atomic<word>[]>          data;
+    std::unique_ptr<char[]>                       scratch;    // copy of the record being dumped
+    std::size_t                                   capacity{}; // always a power of 2
+    std::size_t                                   record_size{};
+    std::size_t                                   record_words{};
+    std::atomic<std::uint64_t>                    head{};
+    std::atomic<bool>                             dumping{};
+    std::uint64_t                                 dumped_until{}; // protected by 'dumping'
+    std::string                                   header;
+
+public:
+    Verbosity dump_verbosity;
+
+    _flight_recorder(const std::string& filename, OpenMode open_mode, std::size_t capacity, std::size_t record_size,
+                     Verbosity dump_verbosity)
+        : dump_verbosity(dump_verbosity) {
+        // Round capacity up to a power of 2 so slot index is just a bitmask
+        this->capacity = 1;
+        while (this->capacity < capacity) this->capacity <<= 1;
+        this->record_size  = std::max<std::size_t>(record_size, 2);
+        this->record_words = (this->record_size + sizeof(word) - 1) / sizeof(word);
+
+        this->sequences = std::make_unique<std::atomic<std::uint64_t>[]>(this->capacity);
+        this->lengths   = std::make_unique<std::atomic<std::uint32_t>[]>(this->capacity);
+        this->data      = std::make_unique<std::atomic<word>[]>(this->capacity * this->record_words);
+        this->scratch   = std::make_unique<char[]>(this->record_words * sizeof(word));
+
+        // File gets opened upfront, opening it in a signal handler would be a bad idea
+        const int mode_flag = (open_mode == OpenMode::APPEND) ? O_APPEND : O_TRUNC;
+        this->fd            = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | mode_flag, 0644);
+
+        if (this->fd < 0) throw std::runtime_error("Could not open flight recorder file {" + filename + "}.");
+    }
+
+    _flight_recorder(const _flight_recorder&) = delete;
+    _flight_recorder& operator=(const _flight_recorder&) = delete;
+    _flight_recorder& operator=(_flight_recorder&&) = delete;
+
+    // Only used to move the recorder into the sink, before any other thread can see it
+    _flight_recorder(_flight_recorder&& other) noexcept
+        : fd(other.fd), sequences(std::move(other.sequences)), lengths(std::move(other.lengths)),
+          data(std::move(other.data)), scratch(std::move(other.scratch)), capacity(other.capacity),
+          record_size(other.record_size), record_words(other.record_words), head(other.head.load()),
+          dumped_until(other.dumped_until), header(std::move(other.header)), dump_verbosity(other.dump_verbosity) {
+        other.fd = -1;
+    }
+
+    ~_flight_recorder() {
+        if (this->fd >= 0) ::close(this->fd);
+    }
+
+    void set_header(std::string header) { this->header = std::move(header); }
+
+    void record(const std::string& message) noexcept {
+        const std::uint64_t ticket = this->head.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t   slot   = static_cast<std::size_t>(ticket) & (this->capacity - 1);
+
+        // Claim the slot, unless it's busy or was already claimed by a newer ticket
+        std::uint64_t sequence = this->sequences[slot].load(std::memory_order_relaxed);
+        if (sequence & 1 || sequence > 2 * ticket + 1 ||
+            !this->sequences[slot].compare_exchange_strong(sequence, 2 * ticket + 1, std::memory_order_acquire,
+                                                           std::memory_order_relaxed))
+            return;
+        std::atomic_thread_fence(std::memory_order_release); // dump that sees any of the data also sees the claim
+
+        // Records that don't fit into the slot get truncated, but always end with a newline
+        std::atomic<word>* const dest   = this->data.get() + slot * this->record_words;
+        const std::size_t        length = std::min(message.size(), this->record_size);
+
+        for (std::size_t offset = 0; offset < length; offset += sizeof(word)) {
+            char bytes[sizeof(word)] = {};
+            std::memcpy(bytes, message.data() + offset, std::min(sizeof(word), length - offset));
+            if (length < message.size() && length - offset <= sizeof(word)) bytes[length - offset - 1] = '\n';
+
+            word value;
+            std::memcpy(&value, bytes, sizeof(word));
+            dest[offset / sizeof(word)].store(value, std::memory_order_relaxed);
+        }
+        this->lengths[slot].store(static_cast<std::uint32_t>(length), std::memory_order_relaxed);
+
+        this->sequences[slot].store(2 * ticket + 2, std::memory_order_release);
+    }
+
+    // Async-signal-safe, returns 'false' if some other dump is already in progress
+    bool dump() noexcept {
+        if (this->dumping.exchange(true, std::memory_order_acquire)) return false;
+
+        const std::uint64_t end   = this->head.load(std::memory_order_acquire);
+        const std::uint64_t begin = std::max(this->dumped_until, end > this->capacity ? end - this->capacity : 0);
+
+        if (begin < end) {
+            _fd_write_all(this->fd, this->header.data(), this->header.size());
+
+            for (std::uint64_t ticket = begin; ticket < end; ++ticket) {
+                const std::size_t   slot     = static_cast<std::size_t>(ticket) & (this->capacity - 1);
+                const std::uint64_t sequence = 2 * ticket + 2;
+
+                // Skip records that are still being written or were overwritten
+                if (this->sequences[slot].load(std::memory_order_acquire) != sequence) continue;
+
+                const std::atomic<word>* const source = this->data.get() + slot * this->record_words;
+                const std::size_t              length =
+                    std::min<std::size_t>(this->lengths[slot].load(std::memory_order_relaxed), this->record_size);
+
+                for (std::size_t offset = 0; offset < length; offset += sizeof(word)) {
+                    const word value = source[offset / sizeof(word)].load(std::memory_order_relaxed);
+                    std::memcpy(this->scratch.get() + offset, &value, sizeof(word));
+                }
+
+                // Same check after the copy, if the slot was claimed by another writer our copy might be torn
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (this->sequences[slot].load(std::memory_order_relaxed) != sequence) continue;
+
+                _fd_write_all(this->fd, this->scratch.get(), length);
+            }
+        }
+
+        this->dumped_until = end;
+        this->dumping.store(false, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
+
 // ==================
 // --- Sink class ---
 // ==================
@@ -2302,14 +2916,20 @@ class Sink {
 private:
     using os_ref_wrapper = std::reference_wrapper<std::ostream>;
 
-    std::variant<os_ref_wrapper, std::ofstream> os_variant;
-    Verbosity                                   verbosity;
-    Colors                                      colors;
-    clock::duration                             flush_interval;
-    Columns                                     columns;
-    clock::time_point                           last_flushed;
-    bool                                        print_header = true;
-    mutable std::mutex                          ostream_mutex;
+#ifdef UTL_LOG_HAS_POSIX_IO
+    using output_variant = std::variant<os_ref_wrapper, std::ofstream, _fd_file, _flight_recorder>;
+#else
+    using output_variant = std::variant<os_ref_wrapper, std::ofstream>;
+#endif
+
+    output_variant     os_variant;
+    Verbosity          verbosity;
+    Colors             colors;
+    clock::duration    flush_interval;
+    Columns            columns;
+    clock::time_point  last_flushed;
+    bool               print_header = true;
+    mutable std::mutex ostream_mutex;
 
     friend struct _logger;
 
@@ -2318,6 +2938,21 @@ class Sink {
         else return std::get<std::ofstream>(this->os_variant);
     }
 
+    void write_output(const std::string& str) {
+#ifdef UTL_LOG_HAS_POSIX_IO
+        if (const auto fd_file_ptr = std::get_if<_fd_file>(&this->os_variant))
+            return fd_file_ptr->write(str.data(), str.size());
+#endif
+        this->ostream_ref().write(str.data(), str.size());
+    }
+
+    void flush_output() {
+#ifdef UTL_LOG_HAS_POSIX_IO
+        if (const auto fd_file_ptr = std::get_if<_fd_file>(&this->os_variant)) return fd_file_ptr->flush();
+#endif
+        this->ostream_ref().flush();
+    }
+
 public:
     Sink()            = delete;
     Sink(const Sink&) = delete;
@@ -2331,6 +2966,21 @@ class Sink {
          const Columns& columns)
         : os_variant(os), verbosity(verbosity), colors(colors), flush_interval(flush_interval), columns(columns) {}
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+    Sink(_fd_file&& file, Verbosity verbosity, Colors colors, clock::duration flush_interval, const Columns& columns)
+        : os_variant(std::move(file)), verbosity(verbosity), colors(colors), flush_interval(flush_interval),
+          columns(columns) {}
+
+    Sink(_flight_recorder&& recorder, Verbosity verbosity, Colors colors, const Columns& columns)
+        : os_variant(std::move(recorder)), verbosity(verbosity), colors(colors), flush_interval(), columns(columns) {
+        // flight recorder writes the header at the start of each dump rather than into the ring
+        std::string header;
+        this->format_header(header);
+        std::get<_flight_recorder>(this->os_variant).set_header(std::move(header));
+        this->print_header = false;
+    }
+#endif
+
     // We want a way of changing sink options using its handle / reference returned by the logger
     Sink& set_verbosity(Verbosity verbosity) {
         this->verbosity = verbosity;
@@ -2353,6 +3003,14 @@ class Sink {
         return *this;
     }
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+    // Writes recent history of a flight recorder sink to its file, does nothing for other sinks
+    Sink& dump() {
+        if (const auto recorder_ptr = std::get_if<_flight_recorder>(&this->os_variant)) recorder_ptr->dump();
+        return *this;
+    }
+#endif
+
 private:
     template <class... Args>
     void format(const Callsite& callsite, const MessageMetadata& meta, const Args&... args) {
@@ -2404,20 +3062,29 @@ class Sink {
 
         if (this->colors == Colors::ENABLE) buffer += _color_reset;
 
+#ifdef UTL_LOG_HAS_POSIX_IO
+        // Flight recorder is lock-free and never flushes, it only gets dumped when something goes wrong
+        if (const auto recorder_ptr = std::get_if<_flight_recorder>(&this->os_variant)) {
+            recorder_ptr->record(buffer);
+            if (meta.verbosity <= recorder_ptr->dump_verbosity) recorder_ptr->dump();
+            return;
+        }
+#endif
+
         // 'std::ostream' isn't guaranteed to be thread-safe, even through many implementations seem to have
         // some thread-safety built into `std::cout` the same cannot be said about a generic 'std::ostream'
         const std::lock_guard ostream_lock(this->ostream_mutex);
 
-        this->ostream_ref().write(buffer.data(), buffer.size());
+        this->write_output(buffer);
 
         // flush every message immediately
         if (this->flush_interval.count() == 0) {
-            this->ostream_ref().flush();
+            this->flush_output();
         }
         // or flush periodically
         else if (now - this->last_flushed > this->flush_interval) {
             this->last_flushed = now;
-            this->ostream_ref().flush();
+            this->flush_output();
         }
     }
 
@@ -2570,67 +3237,293 @@ inline Sink& add_file_sink(const std::string& filename, OpenMode open_mode = Ope
                                                   flush_interval, columns);
 }
 
-// ======================
-// --- Logging macros ---
-// ======================
+#ifdef UTL_LOG_HAS_POSIX_IO
+inline Sink& add_posix_file_sink(const std::string& filename, OpenMode open_mode = OpenMode::REWRITE,
+                                 Verbosity verbosity = Verbosity::TRACE, Colors colors = Colors::DISABLE,
+                                 clock::duration flush_interval = ms{15}, const Columns& columns = Columns{},
+                                 std::size_t buffer_size = 1 << 20, DirectIO direct_io = DirectIO::DISABLE,
+                                 FileSync sync = FileSync::NONE) {
+    return _logger::instance().sinks.emplace_back(_fd_file(filename, open_mode, buffer_size, direct_io, sync),
+                                                  verbosity, colors, flush_interval, columns);
+}
 
-#define UTL_LOG_ERR(...)                                                                                               \
-    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::ERR}, __VA_ARGS__)
+inline Sink& add_flight_recorder_sink(const std::string& filename, std::size_t capacity = 4096,
+                                      Verbosity dump_verbosity = Verbosity::ERR,
+                                      OpenMode open_mode = OpenMode::REWRITE, const Columns& columns = Columns{},
+                                      std::size_t record_size = 512) {
+    return _logger::instance().sinks.emplace_back(
+        _flight_recorder(filename, open_mode, capacity, record_size, dump_verbosity), Verbosity::TRACE,
+        Colors::DISABLE, columns);
+}
 
-#define UTL_LOG_WARN(...)                                                                                              \
-    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::WARN}, __VA_ARGS__)
+inline void dump_flight_recorders() {
+    for (auto& sink : _logger::instance().sinks) sink.dump();
+}
 
-#define UTL_LOG_INFO(...)                                                                                              \
-    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::INFO}, __VA_ARGS__)
+constexpr std::array<int, 5> _fatal_signals = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
 
-#define UTL_LOG_DEBUG(...)                                                                                             \
-    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::DEBUG}, __VA_ARGS__)
+// Handlers that were installed before ours, the signal gets passed on to them after dumping
+inline std::array<struct sigaction, _fatal_signals.size()> _previous_fatal_signal_actions{};
 
-#define UTL_LOG_TRACE(...)                                                                                             \
-    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::TRACE}, __VA_ARGS__)
+inline void _flight_recorder_signal_handler(int signal, siginfo_t* info, void* context) {
+    for (auto& sink : _logger::sinks) sink.dump();
 
-#ifdef _DEBUG
-#define UTL_LOG_DERR(...) UTL_LOG_ERR(__VA_ARGS__)
-#define UTL_LOG_DWARN(...) UTL_LOG_WARN(__VA_ARGS__)
-#define UTL_LOG_DINFO(...) UTL_LOG_INFO(__VA_ARGS__)
-#define UTL_LOG_DDEBUG(...) UTL_LOG_DEBUG(__VA_ARGS__)
-#define UTL_LOG_DTRACE(...) UTL_LOG_TRACE(__VA_ARGS__)
-#else
-#define UTL_LOG_DERR(...)
-#define UTL_LOG_DWARN(...)
-#define UTL_LOG_DINFO(...)
-#define UTL_LOG_DDEBUG(...)
-#define UTL_LOG_DTRACE(...)
-#endif
+    // Restoring the previous handler makes the dump happen only once, even if that handler returns and the fault
+    // repeats. Default & ignored dispositions are reproduced by re-raising the signal.
+    for (std::size_t i = 0; i < _fatal_signals.size(); ++i) {
+        if (_fatal_signals[i] != signal) continue;
 
+        const struct sigaction& previous = _previous_fatal_signal_actions[i];
+        ::sigaction(signal, &previous, nullptr);
 
-} // namespace utl::log
+        if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) break;
 
-#endif
-#endif // module utl::log
+        if (previous.sa_flags & SA_SIGINFO) previous.sa_sigaction(signal, info, context);
+        else previous.sa_handler(signal);
+        return;
+    }
 
+    ::raise(signal);
+}
 
+inline void dump_flight_recorders_on_fatal_signals() {
+    struct sigaction action {};
+    action.sa_sigaction = _flight_recorder_signal_handler;
+    action.sa_flags     = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
 
+    for (std::size_t i = 0; i < _fatal_signals.size(); ++i) {
+        struct sigaction previous {};
+        ::sigaction(_fatal_signals[i], &action, &previous);
 
+        // repeated calls shouldn't chain our handler to itself
+        const bool is_ours =
+            (previous.sa_flags & SA_SIGINFO) && previous.sa_sigaction == _flight_recorder_signal_handler;
+        if (!is_ours) _previous_fatal_signal_actions[i] = previous;
+    }
+}
+#endif
 
+// ==================================
+// --- Rate limiting and sampling ---
+// ==================================
 
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-//
-// Module:        utl::math
-// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_math.md
-// Source repo:   https://github.com/DmitriBogdanov/UTL
-//
-// This project is licensed under the MIT License
-//
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A single noisy log statement in a tight loop can easily flood the sinks and slow down the whole program.
+// Rate-limited and sampled logging macros create a 'static' state for each callsite, which means all the
+// bookkeeping is reduced to a few relaxed atomic operations without any lookups or locks.
 
-#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_MATH)
-#ifndef UTLHEADERGUARD_MATH
-#define UTLHEADERGUARD_MATH
+constexpr std::int64_t _rate_limit_window_ns = 1'000'000'000;
 
-// _______________________ INCLUDES _______________________
+// Rate limiter only needs to notice that a window has passed, a coarse clock (~1-4 ms resolution on Linux)
+// is plenty for that and is several times cheaper to query than 'steady_clock'
+inline std::int64_t _coarse_now_ns() noexcept {
+#if defined(UTL_LOG_HAS_POSIX_IO) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::int64_t>(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+#endif
+}
 
-#include <cassert>          // assert()
+class _rate_limiter {
+public:
+    // Messages suppressed by an exhausted limit are counted by each thread on its own, this keeps the suppressed
+    // path free of shared writes. Local count gets flushed into the shared one once the thread notices that
+    // the window has passed, or when the thread exits.
+    struct thread_state {
+        _rate_limiter* owner      = nullptr;
+        std::uint64_t  suppressed = 0;
+
+        ~thread_state() {
+            if (this->owner && this->suppressed)
+                this->owner->suppressed.fetch_add(this->suppressed, std::memory_order_relaxed);
+        }
+    };
+
+private:
+    std::atomic<std::int64_t>  window_end{}; // in '_coarse_now_ns()' units
+    std::atomic<std::uint64_t> passed{};     // messages that went past the exhausted check, can overshoot 'limit'
+    std::atomic<std::uint64_t> suppressed{}; // overshoot of the previous windows & flushed thread counts
+    std::uint64_t              limit;
+
+    // Starts a new window if the current one has passed, only one of the racing threads gets to reset the counter
+    void roll_window(std::int64_t now) noexcept {
+        std::int64_t window_end = this->window_end.load(std::memory_order_relaxed);
+
+        if (now < window_end) return;
+
+        if (this->window_end.compare_exchange_strong(window_end, now + _rate_limit_window_ns,
+                                                     std::memory_order_relaxed)) {
+            const std::uint64_t attempts = this->passed.exchange(0, std::memory_order_relaxed);
+            if (attempts > this->limit) this->suppressed.fetch_add(attempts - this->limit, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    constexpr _rate_limiter(std::uint32_t messages_per_second) noexcept : limit(messages_per_second) {}
+
+    // Returns whether the message should be logged, in which case 'suppressed_count' is set to the
+    // number of messages that were suppressed since the last logged message from the same callsite
+    bool allow(thread_state& local, std::uint64_t& suppressed_count) noexcept {
+        const std::int64_t now = _coarse_now_ns();
+
+        // Fast path, limit is exhausted for the current window => relaxed loads of read-mostly values
+        if (this->passed.load(std::memory_order_relaxed) >= this->limit &&
+            now < this->window_end.load(std::memory_order_relaxed)) {
+            ++local.suppressed;
+            return false;
+        }
+
+        if (local.suppressed) {
+            this->suppressed.fetch_add(local.suppressed, std::memory_order_relaxed);
+            local.suppressed = 0;
+        }
+
+        this->roll_window(now);
+
+        // Messages that lose the race for the last slots of the window show up as an overshoot of 'passed',
+        // which gets added to the suppressed count when the window rolls over
+        if (this->passed.fetch_add(1, std::memory_order_relaxed) >= this->limit) return false;
+
+        suppressed_count = this->suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Sampling only needs a fast thread-local PRNG, no shared state is involved at all
+inline bool _sample(double probability) noexcept {
+    thread_local std::uint64_t state =
+        static_cast<std::uint64_t>(clock::now().time_since_epoch().count()) ^
+        static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    // SplitMix64, see https://prng.di.unimi.it/splitmix64.c
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+    z               = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z               = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z ^= z >> 31;
+
+    return static_cast<double>(z >> 11) * 0x1.0p-53 < probability; // top 53 bits -> uniform double in [0, 1)
+}
+
+// ======================
+// --- Logging macros ---
+// ======================
+
+#define UTL_LOG_ERR(...)                                                                                               \
+    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::ERR}, __VA_ARGS__)
+
+#define UTL_LOG_WARN(...)                                                                                              \
+    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::WARN}, __VA_ARGS__)
+
+#define UTL_LOG_INFO(...)                                                                                              \
+    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::INFO}, __VA_ARGS__)
+
+#define UTL_LOG_DEBUG(...)                                                                                             \
+    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::DEBUG}, __VA_ARGS__)
+
+#define UTL_LOG_TRACE(...)                                                                                             \
+    utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {utl::log::Verbosity::TRACE}, __VA_ARGS__)
+
+// --- Rate-limited logging ---
+// ----------------------------
+
+#define _utl_log_rate_limited(verbosity_, messages_per_second_, ...)                                                   \
+    do {                                                                                                               \
+        static utl::log::_rate_limiter                     utl_log_rate_limiter_(messages_per_second_);                \
+        thread_local utl::log::_rate_limiter::thread_state utl_log_rate_limiter_thread_{&utl_log_rate_limiter_};       \
+        std::uint64_t                                      utl_log_suppressed_ = 0;                                    \
+        if (!utl_log_rate_limiter_.allow(utl_log_rate_limiter_thread_, utl_log_suppressed_)) break;                    \
+        if (utl_log_suppressed_)                                                                                       \
+            utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__,               \
+                                                       " [suppressed ", utl_log_suppressed_, " messages]");            \
+        else utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__);             \
+    } while (false)
+// Note:
+// Suppressed message count gets reported with the next message that passes the limit. Since we don't have
+// a background thread, messages suppressed at the very end of the program will go unreported.
+
+#define UTL_LOG_ERR_LIMITED(messages_per_second_, ...)                                                                 \
+    _utl_log_rate_limited(utl::log::Verbosity::ERR, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_WARN_LIMITED(messages_per_second_, ...)                                                                \
+    _utl_log_rate_limited(utl::log::Verbosity::WARN, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_INFO_LIMITED(messages_per_second_, ...)                                                                \
+    _utl_log_rate_limited(utl::log::Verbosity::INFO, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_DEBUG_LIMITED(messages_per_second_, ...)                                                               \
+    _utl_log_rate_limited(utl::log::Verbosity::DEBUG, messages_per_second_, __VA_ARGS__)
+
+#define UTL_LOG_TRACE_LIMITED(messages_per_second_, ...)                                                               \
+    _utl_log_rate_limited(utl::log::Verbosity::TRACE, messages_per_second_, __VA_ARGS__)
+
+// --- Sampled logging ---
+// -----------------------
+
+#define _utl_log_sampled(verbosity_, probability_, ...)                                                                \
+    do {                                                                                                               \
+        if (utl::log::_sample(probability_))                                                                           \
+            utl::log::_logger::instance().push_message({__FILE__, __LINE__}, {verbosity_}, __VA_ARGS__);              \
+    } while (false)
+
+#define UTL_LOG_ERR_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::ERR, probability_, __VA_ARGS__)
+
+#define UTL_LOG_WARN_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::WARN, probability_, __VA_ARGS__)
+
+#define UTL_LOG_INFO_SAMPLED(probability_, ...) _utl_log_sampled(utl::log::Verbosity::INFO, probability_, __VA_ARGS__)
+
+#define UTL_LOG_DEBUG_SAMPLED(probability_, ...)                                                                       \
+    _utl_log_sampled(utl::log::Verbosity::DEBUG, probability_, __VA_ARGS__)
+
+#define UTL_LOG_TRACE_SAMPLED(probability_, ...)                                                                       \
+    _utl_log_sampled(utl::log::Verbosity::TRACE, probability_, __VA_ARGS__)
+
+// --- Debug-only logging ---
+// --------------------------
+
+#ifdef _DEBUG
+#define UTL_LOG_DERR(...) UTL_LOG_ERR(__VA_ARGS__)
+#define UTL_LOG_DWARN(...) UTL_LOG_WARN(__VA_ARGS__)
+#define UTL_LOG_DINFO(...) UTL_LOG_INFO(__VA_ARGS__)
+#define UTL_LOG_DDEBUG(...) UTL_LOG_DEBUG(__VA_ARGS__)
+#define UTL_LOG_DTRACE(...) UTL_LOG_TRACE(__VA_ARGS__)
+#else
+#define UTL_LOG_DERR(...)
+#define UTL_LOG_DWARN(...)
+#define UTL_LOG_DINFO(...)
+#define UTL_LOG_DDEBUG(...)
+#define UTL_LOG_DTRACE(...)
+#endif
+
+
+} // namespace utl::log
+
+#endif
+#endif // module utl::log
+
+
+
+
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Module:        utl::math
+// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_math.md
+// Source repo:   https://github.com/DmitriBogdanov/UTL
+//
+// This project is licensed under the MIT License
+//
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_MATH)
+#ifndef UTLHEADERGUARD_MATH
+#define UTLHEADERGUARD_MATH
+
+// _______________________ INCLUDES _______________________
+
+#include <cassert>          // assert()
 #include <cstddef>          // size_t
 #include <functional>       // function<>
 #include <type_traits>      // enable_if_t<>, void_t<>, is_floating_point<>, is_arithmetic<>,
@@ -2975,10 +3868,12 @@ template <class IntType, std::enable_if_t<std::is_integral<IntType>::value, bool
 
 #include <algorithm>        // swap(), find(), count(), is_sorted(), min_element(),
                             // max_element(), sort(), stable_sort(), min(), max(), remove_if(), copy()
+#include <array>            // array<>
 #include <cassert>          // assert() // Note: Perhaps temporary
 #include <charconv>         // to_chars()
 #include <cmath>            // isfinite()
 #include <cstddef>          // size_t, ptrdiff_t, nullptr_t
+#include <cstdint>          // uint64_t
 #include <exception>        // exception
 #include <functional>       // reference_wrapper<>, multiplies<>
 #include <initializer_list> // initializer_list<>
@@ -3189,6 +4084,172 @@ constexpr int _max_float_digits =
 template <class T>
 constexpr int _max_int_digits = 2 + std::numeric_limits<T>::digits10;
 
+// --- Fast number formatting ---
+// ------------------------------
+
+// Table-driven digit counting, bit width gives us an estimate of 'log10()' which
+// needs at most one correction that can be looked up in a table of powers of 10
+constexpr std::array<std::uint64_t, 20> _powers_of_10 = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+inline unsigned int _bit_width(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - static_cast<unsigned int>(__builtin_clzll(value)) : 0;
+#else
+    unsigned int width = 0;
+    while (value) value >>= 1, ++width;
+    return width;
+#endif
+}
+
+inline unsigned int _count_digits(std::uint64_t value) noexcept {
+    value |= 1; // zero has 1 digit, setting the lowest bit never changes the digit count otherwise
+    const unsigned int estimate = (_bit_width(value) * 1233) >> 12; // 1233 / 4096 ~ log10(2)
+    return estimate + (value >= _powers_of_10[estimate]);
+}
+
+// All 2-digit pairs, lets us write integers 2 digits at a time which halves the number of divisions
+constexpr char _digit_pairs[] = "00010203040506070809"
+                                "10111213141516171819"
+                                "20212223242526272829"
+                                "30313233343536373839"
+                                "40414243444546474849"
+                                "50515253545556575859"
+                                "60616263646566676869"
+                                "70717273747576777879"
+                                "80818283848586878889"
+                                "90919293949596979899";
+
+// Writes digits of 'value' backwards ending at 'end', caller has to reserve '_count_digits(value)' chars
+inline void _write_digits(char* end, std::uint64_t value) noexcept {
+    while (value >= 100) {
+        const std::size_t pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = _digit_pairs[pair + 1];
+        *--end = _digit_pairs[pair];
+    }
+    if (value >= 10) {
+        const std::size_t pair = static_cast<std::size_t>(value) * 2;
+        *--end                 = _digit_pairs[pair + 1];
+        *--end                 = _digit_pairs[pair];
+    } else *--end = static_cast<char>('0' + value);
+}
+
+template <class T>
+std::uint64_t _unsigned_abs(T value) noexcept {
+    if constexpr (std::is_signed_v<T>)
+        return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    else return static_cast<std::uint64_t>(value);
+}
+
+template <class T>
+std::string _stringify_int(T value) {
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+    const std::uint64_t abs    = _unsigned_abs(value);
+    const std::size_t   length = negative + _count_digits(abs);
+
+    std::string str(length, '-'); // leading '-' stays in place for negative numbers
+    _write_digits(str.data() + length, abs);
+    return str;
+}
+
+// Values that are stringified in practice very often have a short exact decimal representation (0.5, 12.25, 3 and etc.),
+// such values can be formatted through an integer formatting which is several times faster than 'std::to_chars()'.
+//
+// Output has to be exactly the same as the one produced by 'std::to_chars()', which is the shortest representation
+// that round-trips, formatted as fixed or scientific depending on which one is shorter (fixed wins the ties).
+//
+// We check if 'value * 10^P' is an integer 'N' such that 'N / 10^P == value', where 'P' is the fixed precision limit.
+// Both 'N' and '10^P' are exactly representable and division is correctly rounded, which means the decimal
+// 'N * 10^-P' parses back into 'value'. Restricting 'N < 2^(mantissa_bits - 1)' ensures decimal grid is coarser than
+// the float spacing, making such 'N' unique. Stripping trailing zeroes of 'N' gives us the shortest representation.
+//
+// Values outside of the fast path domain (too large, too small, too many digits, zero, inf, NaN) return 'false'.
+
+template <class T>
+constexpr unsigned int _float_fast_path_precision = std::is_same_v<T, float> ? 3 : 6;
+
+template <class T>
+bool _append_short_float(std::string& buffer, T value) {
+    if constexpr (!std::is_same_v<T, float> && !std::is_same_v<T, double>) return false;
+    else {
+        constexpr unsigned int precision = _float_fast_path_precision<T>;
+        constexpr T            scale     = static_cast<T>(_powers_of_10[precision]);
+        constexpr T            max_abs   = static_cast<T>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+
+        const bool negative = value < T(0);
+        const T    abs      = negative ? -value : value;
+        const T    scaled   = abs * scale;
+
+        if (!(scaled >= T(1) && scaled < max_abs)) return false; // also rejects zero, inf & NaN
+
+        std::uint64_t mantissa = static_cast<std::uint64_t>(scaled + T(0.5));
+        if (static_cast<T>(mantissa) / scale != abs) return false;
+
+        // Strip trailing zeroes to get the shortest representation
+        int fraction_digits = static_cast<int>(precision);
+        while (fraction_digits > 0 && mantissa % 10 == 0) mantissa /= 10, --fraction_digits;
+        int trailing_zeroes = 0; // only integers can have trailing zeroes that are not a part of the fraction
+        std::uint64_t significant = mantissa;
+        while (fraction_digits == 0 && significant % 10 == 0) significant /= 10, ++trailing_zeroes;
+
+        const int mantissa_digits    = static_cast<int>(_count_digits(mantissa));
+        const int significant_digits = mantissa_digits - trailing_zeroes;
+
+        // Compare with the length of scientific notation, 'std::to_chars()' picks whichever is shorter
+        const int exponent        = mantissa_digits - 1 - fraction_digits;
+        const int exponent_digits = std::max(2, static_cast<int>(_count_digits(_unsigned_abs(exponent))));
+        const int sci_length      = significant_digits + (significant_digits > 1) + 2 + exponent_digits;
+        const int int_digits      = std::max(1, mantissa_digits - fraction_digits);
+        const int fixed_length    = int_digits + (fraction_digits ? 1 + fraction_digits : 0);
+
+        if (fixed_length > sci_length) return false;
+
+        // Format straight into the buffer
+        const std::size_t old_size = buffer.size();
+        buffer.resize(old_size + negative + fixed_length);
+
+        char* const begin = buffer.data() + old_size;
+        char* const end   = begin + negative + fixed_length;
+
+        if (negative) *begin = '-';
+
+        if (fraction_digits) {
+            char* const point = end - fraction_digits - 1;
+            const auto  div   = _powers_of_10[fraction_digits];
+            std::fill(begin + negative, point, '0');
+            std::fill(point + 1, end, '0');
+            _write_digits(point, mantissa / div);
+            *point = '.';
+            if (mantissa % div) _write_digits(end, mantissa % div);
+        } else _write_digits(end, mantissa);
+
+        return true;
+    }
+}
+
 // --- Stringifiers ---
 // --------------------
 
@@ -3199,16 +4260,34 @@ inline void _append_stringified_bool(std::string& str, bool value) { str += valu
 
 template <class T>
 void _append_stringified_integer(std::string& str, T value) {
-    std::array<char, _max_int_digits<T>> buffer;
-    const auto [number_end_ptr, error_code] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
-    if (error_code != std::errc())
-        throw std::runtime_error(
-            "Integer stringification encountered std::to_chars() formatting error while serializing a value.");
-    str.append(buffer.data(), number_end_ptr - buffer.data());
+    // Format straight into the string, 2 digits at a time
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>) negative = value < 0;
+
+        const std::uint64_t abs      = _unsigned_abs(value);
+        const std::size_t   old_size = str.size();
+        const std::size_t   length   = negative + _count_digits(abs);
+
+        str.resize(old_size + length);
+        if (negative) str[old_size] = '-';
+        _write_digits(str.data() + old_size + length, abs);
+    }
+    // Fallback for extended integer types
+    else {
+        std::array<char, _max_int_digits<T>> buffer;
+        const auto [number_end_ptr, error_code] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        if (error_code != std::errc())
+            throw std::runtime_error(
+                "Integer stringification encountered std::to_chars() formatting error while serializing a value.");
+        str.append(buffer.data(), number_end_ptr - buffer.data());
+    }
 }
 
 template <class T>
 void _append_stringified_float(std::string& str, T value) {
+    if (_append_short_float(str, value)) return;
+
     std::array<char, _max_float_digits<T>> buffer;
     const auto [number_end_ptr, error_code] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
     if (error_code != std::errc())
@@ -3298,12 +4377,12 @@ template <class... Args>
 }
 
 // Override "common special cases" that can be improved relative to a generic implementation
-[[nodiscard]] inline std::string stringify(int value) { return std::to_string(value); }
-[[nodiscard]] inline std::string stringify(long value) { return std::to_string(value); }
-[[nodiscard]] inline std::string stringify(long long value) { return std::to_string(value); }
-[[nodiscard]] inline std::string stringify(unsigned int value) { return std::to_string(value); }
-[[nodiscard]] inline std::string stringify(unsigned long value) { return std::to_string(value); }
-[[nodiscard]] inline std::string stringify(unsigned long long value) { return std::to_string(value); }
+[[nodiscard]] inline std::string stringify(int value) { return _stringify_int(value); }
+[[nodiscard]] inline std::string stringify(long value) { return _stringify_int(value); }
+[[nodiscard]] inline std::string stringify(long long value) { return _stringify_int(value); }
+[[nodiscard]] inline std::string stringify(unsigned int value) { return _stringify_int(value); }
+[[nodiscard]] inline std::string stringify(unsigned long value) { return _stringify_int(value); }
+[[nodiscard]] inline std::string stringify(unsigned long long value) { return _stringify_int(value); }
 
 // We wrap stringifying function in functor-class so we can use it a default template callable argument.
 // Templates can't infer template parameters from default arguments:
@@ -6698,18 +7777,63 @@ inline void _split_enum_args(const char* va_args, std::string* strings, int coun
 
 // _______________________ INCLUDES _______________________
 
-#include <algorithm>   // sort()
-#include <chrono>      // chrono::steady_clock, chrono::duration_cast<>, std::chrono::milliseconds
-#include <cstdlib>     // atexit()
-#include <fstream>     // ofstream
-#include <iomanip>     // setprecision(), setw()
-#include <ios>         // streamsize, fixed,
-#include <iostream>    // cout
-#include <ostream>     // ostream
-#include <sstream>     // ostringstream
-#include <string>      // string
-#include <string_view> // string_view
-#include <vector>      // vector<>
+#include <algorithm>          // sort(), max()
+#include <array>              // array<>
+#include <atomic>             // atomic<>
+#include <chrono>             // chrono::steady_clock, chrono::duration_cast<>, std::chrono::milliseconds
+#include <cerrno>             // errno, ENOSYS
+#include <cmath>              // ceil()
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <cstdlib>            // atexit(), malloc(), aligned_alloc(), free()
+#include <fstream>            // ofstream
+#include <functional>         // function<>
+#include <iomanip>            // setprecision(), setw()
+#include <ios>                // streamsize, fixed,
+#include <iostream>           // cout
+#include <iterator>           // next()
+#include <limits>             // numeric_limits<>
+#include <map>                // map<>
+#include <memory>             // unique_ptr<>, make_unique<>()
+#include <mutex>              // mutex, lock_guard<>
+#include <new>                // new_handler, get_new_handler(), bad_alloc, align_val_t, nothrow_t
+#include <ostream>            // ostream
+#include <sstream>            // ostringstream
+#include <string>             // string
+#include <string_view>        // string_view
+#include <system_error>       // system_category()
+#include <thread>             // thread
+#include <utility>            // pair<>, move(), exchange()
+#include <vector>             // vector<>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTL_PROFILER_HAS_x86_TSC
+#include <cpuid.h> // __get_cpuid()
+#endif
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define UTL_PROFILER_HAS_PERF_EVENTS
+#include <linux/perf_event.h>  // perf_event_attr, perf_event_mmap_page, PERF_...
+#include <sys/mman.h>          // mmap(), munmap()
+#include <sys/syscall.h>       // SYS_perf_event_open
+#include <unistd.h>            // syscall(), read(), close(), sysconf()
+#endif
+
+// IP sampling is an extension of the sampling mode and makes no sense without it
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && !defined(UTL_PROFILER_OPTION_SAMPLING)
+#define UTL_PROFILER_OPTION_SAMPLING
+#endif
+
+#if defined(__linux__)
+#define UTL_PROFILER_HAS_SAMPLING
+#include <link.h>         // dl_iterate_phdr()
+#include <signal.h>       // sigaction(), SIGPROF, SIGEV_THREAD_ID
+#include <sys/syscall.h>  // SYS_gettid
+#include <time.h>         // timer_create(), timer_settime(), timer_delete()
+#include <ucontext.h>     // ucontext_t
+#include <unistd.h>       // syscall()
+#endif
 
 // ____________________ DEVELOPER DOCS ____________________
 
@@ -6728,6 +7852,13 @@ inline void _split_enum_args(const char* va_args, std::string* strings, int coun
 // this also took a bit of thinking but in the end there is a nice solution that uses static variables
 // to offload things that can only be done once to their initialization, and then links local variables
 // to 'static' markers of the callsite recording. See 'UTL_PROFILE' macro for some more details.
+//
+// Multithreading is handled by giving each thread its own set of records, which get created on the first visit of
+// a callsite by the thread and registered in a global list. Timers only ever touch records of their own thread, so
+// the hot path needs no locks, results from different threads get merged when formatting the report.
+//
+// Optional features (such as call tree tracking) hook into the scope entry & exit of '_timer_base' and are
+// enabled with 'UTL_PROFILER_OPTION_...' macros, so the default mode doesn't pay for the features it doesn't use.
 
 // ____________________ IMPLEMENTATION ____________________
 
@@ -6743,24 +7874,142 @@ inline std::string _format_call_site(std::string_view file, int line, std::strin
     return (std::ostringstream() << filename << ":" << line << ", " << func << "()").str();
 }
 
-#define UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY 3'300'000'000
+// --- x86 timestamp counter ---
+// -----------------------------
 
-#if !defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY)
-using clock = std::chrono::steady_clock;
+// Timestamp counter can be read in a few CPU cycles, which is a lot faster than 'std::chrono::steady_clock'
+// (which usually goes through 'clock_gettime()'). TSC ticks at a constant rate on any modern CPU, but that rate
+// is neither standardized nor reliably exposed by the CPU itself, which is why we calibrate it against the
+// 'std::chrono::steady_clock' at startup.
+//
+// Only the "invariant TSC" (CPUID.80000007H:EDX[8]) is guaranteed to tick at a constant rate regardless
+// of power states and to be synchronized across cores, without it we fall back to 'std::chrono::steady_clock'.
+//
+// Ticks get converted to nanoseconds with a fixed-point multiplication, which means TSC clocks have the same
+// 'duration' as regular std clocks and can be used with any <chrono> code.
+//
+// 'rdtsc' isn't a serializing instruction, CPU can execute it before preceding instructions are finished, which
+// is usually fine for profiling non-trivial code. 'rdtscp' waits for all preceding instructions to finish and
+// 'lfence; rdtsc' also prevents subsequent instructions from starting early, at the cost of a few more cycles.
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+
+struct _tsc_calibration {
+    bool          invariant  = false;
+    bool          has_rdtscp = false;
+    double        frequency  = 0;  // Hz
+    std::uint64_t multiplier = 0;  // 'ns = (ticks * multiplier) >> 32'
+};
+
+inline std::uint64_t _rdtsc() noexcept {
+    unsigned int low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high)); // GCC/clang asm intrinsic, MSVC uses __asm() with more overhead
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline std::uint64_t _rdtscp() noexcept {
+    unsigned int low, high;
+    asm volatile("rdtscp" : "=a"(low), "=d"(high)::"rcx"); // 'rdtscp' also writes processor id into 'ecx'
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline std::uint64_t _rdtsc_fenced() noexcept {
+    unsigned int low, high;
+    asm volatile("lfence\n\trdtsc" : "=a"(low), "=d"(high)::"memory");
+    return static_cast<std::uint64_t>(high) << 32 | low;
+}
+
+inline _tsc_calibration _calibrate_tsc() {
+    _tsc_calibration calibration;
+
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) calibration.invariant = edx & (1u << 8);
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) calibration.has_rdtscp = edx & (1u << 27);
+
+    if (!calibration.invariant) return calibration;
+
+#ifdef UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY
+    calibration.frequency = static_cast<double>(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY);
+#else
+    // Measure TSC ticks over a known interval of 'steady_clock', 20 ms is enough to get the error into ~ppm range.
+    // Each timestamp pair is taken as close together as possible, so both clocks refer to the same moment.
+    constexpr auto calibration_interval = std::chrono::milliseconds(20);
+
+    const auto steady_start = std::chrono::steady_clock::now();
+    const auto ticks_start  = _rdtsc_fenced();
+
+    auto steady_end = steady_start;
+    auto ticks_end  = ticks_start;
+    while (steady_end - steady_start < calibration_interval) {
+        steady_end = std::chrono::steady_clock::now();
+        ticks_end  = _rdtsc_fenced();
+    }
+
+    const double elapsed_sec = std::chrono::duration<double>(steady_end - steady_start).count();
+    calibration.frequency    = static_cast<double>(ticks_end - ticks_start) / elapsed_sec;
+#endif
+
+    calibration.multiplier = static_cast<std::uint64_t>(1e9 * 4294967296.0 / calibration.frequency); // 1e9 * 2^32 / f
+    return calibration;
+}
+
+inline std::uint64_t _ticks_to_ns(std::uint64_t ticks, std::uint64_t multiplier) noexcept {
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128; // '__extension__' silences '-Wpedantic'
+    return static_cast<std::uint64_t>((static_cast<uint128>(ticks) * multiplier) >> 32);
 #else
-struct clock {
-    using rep                   = unsigned long long int;
-    using period                = std::ratio<1, UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY>;
-    using duration              = std::chrono::duration<rep, period>;
-    using time_point            = std::chrono::time_point<clock>;
+    // 64-bit emulation of the same thing, splits ticks into halves so the products don't overflow
+    const std::uint64_t high = ticks >> 32, low = ticks & 0xFFFFFFFF;
+    return high * multiplier + ((low * (multiplier & 0xFFFFFFFF)) >> 32) + low * (multiplier >> 32);
+#endif
+}
+
+inline const _tsc_calibration& _tsc() {
+    static const _tsc_calibration calibration = _calibrate_tsc();
+    return calibration;
+}
+
+template <std::uint64_t (*read_tsc)() noexcept, bool requires_rdtscp = false>
+struct _tsc_clock {
+    using duration              = std::chrono::nanoseconds;
+    using rep                   = duration::rep;
+    using period                = duration::period;
+    using time_point            = std::chrono::time_point<_tsc_clock>;
     static const bool is_steady = true;
 
     static time_point now() noexcept {
-        unsigned int low, high;
-        asm volatile("rdtsc" : "=a"(low), "=d"(high)); // GCC/clang asm intrinsic, MSVC uses __asm() with more overhead
-        return time_point(duration(static_cast<rep>(high) << 32 | low));
+        const _tsc_calibration& tsc = _tsc();
+
+        if (!tsc.invariant || (requires_rdtscp && !tsc.has_rdtscp))
+            return time_point(std::chrono::duration_cast<duration>(
+                std::chrono::steady_clock::now().time_since_epoch())); // fallback
+
+        return time_point(duration(static_cast<rep>(_ticks_to_ns(read_tsc(), tsc.multiplier))));
     }
 };
+
+using tsc_clock         = _tsc_clock<_rdtsc>;
+using tsc_clock_rdtscp  = _tsc_clock<_rdtscp, true>;
+using tsc_clock_fenced  = _tsc_clock<_rdtsc_fenced>;
+
+// Returns calibrated TSC frequency in Hz, or 0 if invariant TSC is not available and TSC clocks fall back to
+// 'std::chrono::steady_clock'
+inline double tsc_frequency() { return _tsc().frequency; }
+
+#endif
+
+// --- Profiler clock ---
+// ----------------------
+
+#if defined(UTL_PROFILER_HAS_x86_TSC) && defined(UTL_PROFILER_OPTION_USE_x86_RDTSCP)
+using clock = tsc_clock_rdtscp;
+#elif defined(UTL_PROFILER_HAS_x86_TSC) && defined(UTL_PROFILER_OPTION_USE_x86_FENCED_RDTSC)
+using clock = tsc_clock_fenced;
+#elif defined(UTL_PROFILER_HAS_x86_TSC) &&                                                                             \
+    (defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS) || defined(UTL_PROFILER_OPTION_USE_x86_INTRINSICS_FOR_FREQUENCY))
+using clock = tsc_clock;
+#else
+using clock = std::chrono::steady_clock;
 #endif
 
 using duration   = clock::duration;
@@ -6768,1347 +8017,6061 @@ using time_point = clock::time_point;
 
 inline const time_point _program_entry_time_point = clock::now();
 
-struct _record {
+// Static data of the profiled callsite, 'file', 'func', 'label' are guaranteed to be string literals, since we want
+// to have as little overhead as possible during runtime, we can just save raw pointers and convert them to nicer
+// types like 'std::string_view' later in the formatting stage
+struct _callsite {
     const char* file;
     int         line;
     const char* func;
     const char* label;
-    duration    accumulated_time;
 };
 
-inline void _utl_profiler_atexit(); // predeclaration, implementation has circular dependency with 'RecordManager'
+// --- Latency statistics ---
+// --------------------------
 
-// =========================
-// --- Profiler Classess ---
-// =========================
+// Log-linear latency histogram, same idea as HDR histogram. Durations are split into power-of-2 ranges, each range
+// is further split into 'sub_buckets' linear buckets, which keeps relative error of percentiles under 1 / sub_buckets
+// regardless of the magnitude. Durations below 'sub_buckets' nanoseconds get a bucket each, durations
+// above 2^max_bits nanoseconds (~18 minutes) get clamped to the last bucket.
+constexpr std::size_t _histogram_sub_bits    = 4;
+constexpr std::size_t _histogram_sub_buckets = std::size_t(1) << _histogram_sub_bits;
+constexpr std::size_t _histogram_max_bits    = 40;
+constexpr std::size_t _histogram_size = (_histogram_max_bits - _histogram_sub_bits + 1) * _histogram_sub_buckets;
 
-class _record_manager {
-private:
-    _record data;
+inline std::size_t _bit_width(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - static_cast<std::size_t>(__builtin_clzll(value)) : 0;
+#else
+    std::size_t width = 0;
+    for (; value; value >>= 1) ++width;
+    return width;
+#endif
+}
 
-public:
-    inline static std::vector<_record> records;
-    inline static int                  exclusive_recursion{};
-    int                                recursion{};
+inline std::size_t _histogram_bucket(std::uint64_t ns) noexcept {
+    if (ns < _histogram_sub_buckets) return static_cast<std::size_t>(ns);
 
-    void add_time(duration time) noexcept { this->data.accumulated_time += time; }
+    const std::size_t exponent = _bit_width(ns) - 1;
+    if (exponent >= _histogram_max_bits) return _histogram_size - 1;
 
-    _record_manager() = delete;
+    const std::size_t mantissa = static_cast<std::size_t>(ns >> (exponent - _histogram_sub_bits)) &
+                                 (_histogram_sub_buckets - 1);
+    return (exponent - _histogram_sub_bits + 1) * _histogram_sub_buckets + mantissa;
+}
 
-    _record_manager(const char* file, int line, const char* func, const char* label)
-        : data({file, line, func, label, duration(0)}) {
-        // 'file', 'func', 'label' are guaranteed to be string literals, since we want to
-        // have as little overhead as possible during runtime, we can just save raw pointers
-        // and convert them to nicer types like 'std::string_view' later in the formatting stage
-
-        // Profiler ever gets called => register result output at 'std::exit()'
-        static bool first_call = true;
-        if (first_call) {
-            std::atexit(_utl_profiler_atexit);
-            first_call = false;
-        }
-    }
+inline std::uint64_t _histogram_bucket_width(std::size_t bucket) noexcept {
+    return bucket < _histogram_sub_buckets ? 1 : std::uint64_t(1) << (bucket / _histogram_sub_buckets - 1);
+}
 
-    ~_record_manager() { records.emplace_back(this->data); }
-};
+inline std::uint64_t _histogram_bucket_lower(std::size_t bucket) noexcept {
+    if (bucket < _histogram_sub_buckets) return bucket;
+    return (_histogram_sub_buckets + bucket % _histogram_sub_buckets) * _histogram_bucket_width(bucket);
+}
 
-// We need 4 slightly different timer classes, so might as well deduplicate some code by moving it into a base class
-struct _timer_base {
-protected:
-    time_point       start;
-    _record_manager* record_manager;
-    // we could use 'std::optional<std::reference_wrapper<RecordManager>>',
-    // but that would inctroduce more dependencies for no real reason
-public:
-    constexpr operator bool() const noexcept { return true; }
+// Middle of the duration range covered by the bucket, used as a representative value for percentiles
+inline std::uint64_t _histogram_bucket_value(std::size_t bucket) noexcept {
+    return _histogram_bucket_lower(bucket) + _histogram_bucket_width(bucket) / 2;
+}
 
-    _timer_base(_record_manager* manager) : record_manager(manager) {}
-};
+inline duration _ns_to_duration(std::uint64_t ns) {
+    return std::chrono::duration_cast<duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(ns)));
+}
 
-// Simple class that records the time of its creation and destruction and records it into the connected 'RecordManager'
-struct _scope_timer : public _timer_base {
-    _scope_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->recursion++ == 0) this->start = clock::now();
-        // this check prevent timer from double-counting time spent inside
-        // of it's own scope due to recursive calls
-    }
+// Statistics of a callsite, 'calls' count complete measurements, which means recursive calls of a scope
+// count as a single call, the same way they are counted in the accumulated time
+struct _statistics {
+    std::uint64_t                               calls = 0;
+    duration                                    min   = duration::max();
+    duration                                    max   = duration::zero();
+    std::array<std::uint64_t, _histogram_size> histogram{};
 
-    ~_scope_timer() {
-        if (--this->record_manager->recursion == 0) this->record_manager->add_time(clock::now() - this->start);
+    void merge(const _statistics& other) {
+        this->calls += other.calls;
+        this->min = std::min(this->min, other.min);
+        this->max = std::max(this->max, other.max);
+        for (std::size_t i = 0; i < _histogram_size; ++i) this->histogram[i] += other.histogram[i];
     }
-};
 
-// Same thing as '_scope_timer' except it uses global static 'exclusive_recursion' instead of regular 'recursion' that
-// is specific to each '_record_manager'. This effecively means no '_exclusive_scope_timer''s will count time as long a
-// single instance of another exclusive timer exists. This allows us to resolve som tricky situations such as recursion
-struct _exclusive_scope_timer : public _timer_base {
-    _exclusive_scope_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->exclusive_recursion++ == 0) this->start = clock::now();
-    }
+    // Min & max can't be subtracted, instead we narrow them down to the range of buckets that are still non-empty
+    void subtract(const _statistics& baseline) {
+        if (!baseline.calls) return;
 
-    ~_exclusive_scope_timer() {
-        if (--this->record_manager->exclusive_recursion == 0)
-            this->record_manager->add_time(clock::now() - this->start);
-    }
-};
+        this->calls -= baseline.calls;
+        for (std::size_t i = 0; i < _histogram_size; ++i) this->histogram[i] -= baseline.histogram[i];
 
-// Same thing as '_scope_timer', except instead of destructor it uses an explicitly called method to record time.
-// We need it to implement code-segment profiling with 'UTL_PROFILER_BEGIN' and 'UTL_PROFILER_END'
-struct _segment_timer : public _timer_base {
-    _segment_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->recursion++ == 0) this->start = clock::now();
+        if (!this->calls) {
+            *this = _statistics{};
+            return;
+        }
+
+        std::size_t first = 0, last = _histogram_size - 1;
+        while (!this->histogram[first]) ++first;
+        while (!this->histogram[last]) --last;
+
+        this->min = std::max(this->min, _ns_to_duration(_histogram_bucket_lower(first)));
+        if (last + 1 < _histogram_size)
+            this->max = std::min(this->max, _ns_to_duration(_histogram_bucket_lower(last + 1) - 1));
     }
 
-    void finish() {
-        if (--this->record_manager->recursion == 0) this->record_manager->add_time(clock::now() - this->start);
+    duration percentile(double p) const {
+        if (!this->calls) return duration::zero();
+
+        const auto target = std::max(static_cast<std::uint64_t>(std::ceil(p * this->calls)), std::uint64_t(1));
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < _histogram_size; ++i) {
+            cumulative += this->histogram[i];
+            if (cumulative < target) continue;
+
+            // bucket middle can lie outside of the observed range
+            return std::clamp(_ns_to_duration(_histogram_bucket_value(i)), this->min, this->max);
+        }
+
+        return this->max;
     }
 };
 
-struct _exclusive_segment_timer : public _timer_base {
-    _exclusive_segment_timer(_record_manager* manager) : _timer_base(manager) {
-        if (this->record_manager->exclusive_recursion++ == 0) this->start = clock::now();
+// --- Hardware counters ---
+// -------------------------
+
+// Hardware counters are collected with Linux 'perf_event_open()', each thread opens its own group of counters
+// upon the first measurement. Group gets scheduled onto the PMU as a whole, so all counters in it cover the same
+// period of time.
+//
+// Reading counters with a 'read()' syscall costs about as much as the profiled scope in many cases, which is why
+// we map the counter page into memory and read the counter directly with 'rdpmc' instruction whenever the kernel
+// allows it (see 'perf_event_mmap_page' docs in <linux/perf_event.h>), 'read()' is only used as a fallback.
+
+constexpr std::size_t _counter_count = 4; // cycles, instructions, cache misses, branch misses
+
+using _counter_values = std::array<std::uint64_t, _counter_count>;
+
+// Measurements of a callsite, 'calls' count measurements in the same way as '_statistics'
+struct _counters {
+    std::uint64_t   calls = 0;
+    _counter_values values{};
+
+    void merge(const _counters& other) {
+        this->calls += other.calls;
+        for (std::size_t i = 0; i < _counter_count; ++i) this->values[i] += other.values[i];
     }
 
-    void finish() {
-        if (--this->record_manager->exclusive_recursion == 0)
-            this->record_manager->add_time(clock::now() - this->start);
+    void subtract(const _counters& baseline) {
+        this->calls -= baseline.calls;
+        for (std::size_t i = 0; i < _counter_count; ++i) this->values[i] -= baseline.values[i];
     }
 };
 
-// ==================================
-// --- Profiler Exit & Formatting ---
-// ==================================
-
-inline void _utl_profiler_atexit() {
-    // NOTE:
-    // Lots of ugly formatting stuff here, but it works, so a nicer rewrite is low-priority.
-    // Would make a lot more sense to format all the stuff into a `matrix` of strings first,
-    // and then do all the sorting/column width adjustment and etc. Should be faster (which
-    // doesn't really matter here) and more concise too.
+// Error of the first failed 'perf_event_open()', counters read as zeros when they are unavailable
+inline std::atomic<int> _counters_error{0};
 
-    const auto total_runtime = clock::now() - _program_entry_time_point;
+// Set once the kernel had to multiplex counters with other events, see '_scale_count()'
+inline std::atomic<bool> _counters_multiplexed{false};
 
-    std::ostream* os = &std::cout;
+// When there are more events than hardware counters, kernel time-shares them and each count only covers 'running'
+// out of 'enabled' nanoseconds, the usual estimate is to scale it by 'enabled / running' (same as 'perf stat' does)
+inline std::uint64_t _scale_count(std::uint64_t count, std::uint64_t enabled, std::uint64_t running) noexcept {
+    if (enabled == running || !running) return count;
+    _counters_multiplexed.store(true, std::memory_order_relaxed);
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128; // '__extension__' silences '-Wpedantic'
+    return static_cast<std::uint64_t>(static_cast<uint128>(count) * enabled / running);
+#else
+    // Split into quotient & remainder so the products don't overflow, this is how the kernel docs do it
+    return count / running * enabled + count % running * enabled / running;
+#endif
+}
 
-    // Convenience functions
-    const auto duration_to_sec = [](duration duration) -> double {
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1e9;
-    };
+#ifdef UTL_PROFILER_HAS_PERF_EVENTS
 
-    const auto duration_percentage = [&](double duration_sec) -> double {
-        const double total_runtime_sec = duration_to_sec(total_runtime);
-        return (duration_sec / total_runtime_sec) * 100.;
-    };
+class _perf_counters {
+private:
+    std::array<int, _counter_count>                         fds;
+    std::array<const perf_event_mmap_page*, _counter_count> pages{};
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    bool        available = false;
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+    // Sequence lock protocol from the kernel docs, page contents may change if we get rescheduled. Enabled & running
+    // times have to be read in the same critical section as the counter, they are only updated when the counter gets
+    // scheduled, so multiplexed counters extrapolate them to the current moment with TSC.
+    bool read_rdpmc(std::size_t i, std::uint64_t& value) const noexcept {
+        const volatile perf_event_mmap_page* page = this->pages[i];
+        if (!page) return false;
+
+        std::uint32_t sequence;
+        std::uint64_t count, enabled, running;
+        do {
+            sequence = page->lock;
+            asm volatile("" ::: "memory");
+
+            enabled = page->time_enabled;
+            running = page->time_running;
+            if (enabled != running) {
+                if (!page->cap_user_time) return false; // can't extrapolate times, 'read()' knows better
+
+                const std::uint64_t cycles = _rdtsc();
+                const std::uint16_t shift  = page->time_shift;
+                const std::uint64_t mult   = page->time_mult;
+                const std::uint64_t delta  = page->time_offset + (cycles >> shift) * mult +
+                                            (((cycles & ((std::uint64_t(1) << shift) - 1)) * mult) >> shift);
+                enabled += delta;
+                running += delta;
+            }
 
-    const auto float_printed_size = [](double value, std::streamsize precision, decltype(std::fixed) format,
-                                       std::string_view postfix) -> std::streamsize {
-        std::ostringstream ss;
-        ss << std::setprecision(precision) << format << value << postfix;
-        return ss.str().size(); // can be done faster but we don't really care here
-    };
+            const std::uint32_t index = page->index;
+            if (!page->cap_user_rdpmc || !index) return false; // counter isn't active on this CPU right now
 
-    const auto repeat_hline_symbol = [](std::streamsize repeats) -> std::string {
-        return std::string(static_cast<size_t>(repeats), '-');
-    };
+            unsigned int low, high;
+            asm volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(index - 1));
 
-    constexpr std::streamsize  duration_precision = 2;
-    constexpr auto             duration_format    = std::fixed;
-    constexpr std::string_view duration_postfix   = " s";
+            // counter is 'pmc_width' bits wide and has to be sign-extended
+            const std::uint16_t width = page->pmc_width;
+            std::int64_t        pmc   = static_cast<std::int64_t>(static_cast<std::uint64_t>(high) << 32 | low);
+            pmc = static_cast<std::int64_t>(static_cast<std::uint64_t>(pmc) << (64 - width)) >> (64 - width);
 
-    constexpr std::streamsize  percentage_precision = 1;
-    constexpr auto             percentage_format    = std::fixed;
-    constexpr std::string_view percentage_postfix   = "%";
+            count = page->offset + static_cast<std::uint64_t>(pmc);
 
-    // Sort records by their accumulated time
-    std::sort(_record_manager::records.begin(), _record_manager::records.end(),
-              [](const _record& l, const _record& r) { return l.accumulated_time > r.accumulated_time; });
+            asm volatile("" ::: "memory");
+        } while (page->lock != sequence);
 
-    // Collect max length of each column (for proper formatting)
-    constexpr std::string_view column_name_call_site  = "Call Site";
-    constexpr std::string_view column_name_label      = "Label";
-    constexpr std::string_view column_name_duration   = "Time";
-    constexpr std::string_view column_name_percentage = "Time %";
+        if (!running) return false; // counter has never been scheduled, nothing to scale
 
-    std::streamsize max_length_call_site  = column_name_call_site.size();
-    std::streamsize max_length_label      = column_name_label.size();
-    std::streamsize max_length_duration   = column_name_duration.size();
-    std::streamsize max_length_percentage = column_name_percentage.size();
+        value = _scale_count(count, enabled, running);
+        return true;
+    }
+#endif
 
-    for (const auto& record : _record_manager::records) {
-        const std::string call_site    = _format_call_site(record.file, record.line, record.func);
-        const std::string label        = record.label;
-        const double      duration_sec = duration_to_sec(record.accumulated_time);
+public:
+    _perf_counters() {
+        this->fds.fill(-1);
+
+        constexpr std::array<std::uint64_t, _counter_count> events = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES};
+
+        for (std::size_t i = 0; i < _counter_count; ++i) {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.config         = events[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid = 0, cpu = -1 => count this thread on any CPU, first counter is the group leader
+            this->fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i ? this->fds[0] : -1, 0));
+
+            if (this->fds[i] == -1) {
+                int expected = 0;
+                _counters_error.compare_exchange_strong(expected, errno);
+                return;
+            }
 
-        // 'Call Site' column
-        const std::streamsize length_call_site = call_site.size();
-        if (max_length_call_site < length_call_site) max_length_call_site = length_call_site;
+            void* page = mmap(nullptr, this->page_size, PROT_READ, MAP_SHARED, this->fds[i], 0);
+            if (page != MAP_FAILED) this->pages[i] = static_cast<const perf_event_mmap_page*>(page);
+        }
 
-        // 'Label' column
-        const std::streamsize length_label = label.size();
-        if (max_length_label < length_label) max_length_label = length_label;
+        this->available = true;
+    }
 
-        // 'Time' column
-        const std::streamsize length_duration =
-            float_printed_size(duration_sec, duration_precision, duration_format, duration_postfix);
-        if (max_length_duration < length_duration) max_length_duration = length_duration;
+    _perf_counters(const _perf_counters&)            = delete;
+    _perf_counters& operator=(const _perf_counters&) = delete;
 
-        // 'Time %' column
-        const auto            percentage = duration_percentage(duration_sec);
-        const std::streamsize length_percentage =
-            float_printed_size(percentage, percentage_precision, percentage_format, percentage_postfix);
-        if (max_length_percentage < length_percentage) max_length_percentage = length_percentage;
+    ~_perf_counters() {
+        for (auto page : this->pages)
+            if (page) munmap(const_cast<perf_event_mmap_page*>(page), this->page_size);
+        for (auto fd : this->fds)
+            if (fd != -1) close(fd);
     }
 
-    // Print formatted profiler header
-    constexpr std::string_view HEADER_TEXT = " UTL PROFILING RESULTS ";
+    _counter_values read() const noexcept {
+        _counter_values result{};
+        if (!this->available) return result;
+
+#ifdef UTL_PROFILER_HAS_x86_TSC
+        bool success = true;
+        for (std::size_t i = 0; i < _counter_count && success; ++i) success = this->read_rdpmc(i, result[i]);
+        if (success) return result;
+#endif
 
-    const std::streamsize total_table_length = sizeof("| ") - 1 + max_length_call_site + sizeof(" | ") - 1 +
-                                               max_length_label + sizeof(" | ") - 1 + max_length_duration +
-                                               sizeof(" | ") - 1 + max_length_percentage + sizeof(" |") -
-                                               1; // -1 because sizeof(char[]) accounts for invisible '\0' at the end
+        // Group read returns the number of counters, enabled & running times of the group and counter values.
+        // Counters that were never scheduled read as zeros.
+        std::array<std::uint64_t, _counter_count + 3> buffer{};
+        if (::read(this->fds[0], buffer.data(), sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)) && buffer[2])
+            for (std::size_t i = 0; i < _counter_count; ++i)
+                result[i] = _scale_count(buffer[i + 3], buffer[1], buffer[2]);
 
-    const std::streamsize header_text_length = HEADER_TEXT.size();
-    const std::streamsize header_left_pad    = (total_table_length - header_text_length) / 2;
-    const std::streamsize header_right_pad   = total_table_length - header_text_length - header_left_pad;
+        return result;
+    }
+};
 
-    *os << "\n"
-        << repeat_hline_symbol(header_left_pad + 1) << HEADER_TEXT << repeat_hline_symbol(header_right_pad + 1)
-        << '\n'
-        // + 1 makes header hline extend 1 character past the table on both sides
-        << "\n"
-        << " Total runtime -> " << std::setprecision(duration_precision) << duration_format
-        << duration_to_sec(total_runtime) << " sec\n"
-        << "\n";
+inline _counter_values _read_counters() noexcept {
+    thread_local const _perf_counters counters;
+    return counters.read();
+}
 
-    // Print formatted table header
-    *os << " | " << std::setw(max_length_call_site) << column_name_call_site << " | " << std::setw(max_length_label)
-        << column_name_label << " | " << std::setw(max_length_duration) << column_name_duration << " | "
-        << std::setw(max_length_percentage) << column_name_percentage << " |\n";
+inline std::string _counters_status() {
+    const int error = _counters_error.load();
+    if (!error) return {};
+    return "perf_event_open() failed: " + std::system_category().message(error) +
+           (error == EACCES || error == EPERM ? " (see '/proc/sys/kernel/perf_event_paranoid')" : "");
+}
 
-    *os << " |"
-        << repeat_hline_symbol(max_length_call_site + 2) // add 2 to account for delimers not having spaces in hline
-        << "|" << repeat_hline_symbol(max_length_label + 2) << "|" << repeat_hline_symbol(max_length_duration + 2)
-        << "|" << repeat_hline_symbol(max_length_percentage + 2) << "|\n";
+#else
 
-    *os << std::setfill(' '); // reset the fill so we don't mess with table contents
+inline _counter_values _read_counters() noexcept { return {}; }
 
+inline std::string _counters_status() { return "hardware counters are only supported on Linux"; }
 
-    // Print formatted table contents
-    for (const auto& record : _record_manager::records) {
-        const std::string call_site    = _format_call_site(record.file, record.line, record.func);
-        const std::string label        = record.label;
-        const double      duration_sec = duration_to_sec(record.accumulated_time);
-        const double      percentage   = duration_percentage(duration_sec);
+#endif
 
-        // Join floats with their postfixes into a single string so they are properly handled by std::setw()
-        // (which only affects the first value leading to a table misaligned by postfix size)
-        std::ostringstream ss_duration;
-        ss_duration << std::setprecision(duration_precision) << duration_format << duration_sec << duration_postfix;
+// --- Allocation tracking ---
+// ---------------------------
 
-        std::ostringstream ss_percentage;
-        ss_percentage << std::setprecision(percentage_precision) << percentage_format << percentage
-                      << percentage_postfix;
+// Heap allocations made while the callsite was the innermost active profiled scope of the thread,
+// deallocations are attributed in the same way, which is not necessarily the scope that allocated the memory
+struct _allocations {
+    std::uint64_t count         = 0;
+    std::uint64_t bytes         = 0;
+    std::uint64_t deallocations = 0;
 
-        *os << " | " << std::setw(max_length_call_site) << call_site << " | " << std::setw(max_length_label) << label
-            << " | " << std::setw(max_length_duration) << ss_duration.str() << " | " << std::setw(max_length_percentage)
-            << ss_percentage.str() << " |\n";
+    void merge(const _allocations& other) {
+        this->count += other.count;
+        this->bytes += other.bytes;
+        this->deallocations += other.deallocations;
     }
-}
 
-// ========================
-// --- Profiler Codegen ---
-// ========================
+    void subtract(const _allocations& baseline) {
+        this->count -= baseline.count;
+        this->bytes -= baseline.bytes;
+        this->deallocations -= baseline.deallocations;
+    }
+};
 
-#define _utl_profiler_concat_tokens(a, b) a##b
-#define _utl_profiler_concat_tokens_wrapper(a, b) _utl_profiler_concat_tokens(a, b)
-#define _utl_profiler_add_uuid(varname_) _utl_profiler_concat_tokens_wrapper(varname_, __LINE__)
-// This macro creates token 'varname_##__LINE__' from 'varname_'.
-//
-// The reason we can't just write it as is, is that function-macros only expands their macro-arguments
-// if neither the stringizing operator # nor the token-pasting operator ## are applied to the arguments
-// inside the macro body.
-//
-// Which means in a simple 'varname_##__LINE__' macro '__LINE__' doesn't expand to it's value.
-//
-// We can get around this fact by introducing indirection,
-// '__LINE__' gets expanded in '_utl_profiler_concat_tokens_wrapper()'
-// and then tokenized and concatenated in '_utl_profiler_concat_tokens()'
+// --- Overhead compensation ---
+// ------------------------------
 
-// --- Scope profiling ---
-// -----------------------
+// Every measurement includes a part of its own timer overhead, and the time of an enclosing scope includes the full
+// overhead of every nested profiled scope. Knowing the number of both we can subtract calibrated values afterwards.
+struct _overhead {
+    std::uint64_t calls        = 0;
+    std::uint64_t nested_calls = 0;  // profiled scopes entered during the measurement, at any depth
+    duration      raw_time     = {}; // time before the compensation
 
-#define UTL_PROFILER(label_)                                                                                           \
-    constexpr bool _utl_profiler_add_uuid(utl_profiler_macro_guard_) = true;                                           \
-                                                                                                                       \
-    static_assert(_utl_profiler_add_uuid(utl_profiler_macro_guard_), "UTL_PROFILE is a multi-line macro.");            \
-                                                                                                                       \
-    static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
-                                                                                               __func__, label_);      \
-                                                                                                                       \
-    if constexpr (const utl::profiler::_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){                 \
-                      &_utl_profiler_add_uuid(utl_profiler_record_manager_)})
-// Note 1:
-//
-//    constexpr bool ... = true;
-//    static_assert(..., "UTL_PROFILE is a multi-line macro.");
-//
-// is reponsible for preventing accidental errors caused by using macro like this:
-//
-//    for (...) UTL_PROFILER("") function(); // will only loop the first line of the multi-line macro
-//
-// If someone tries to write it like this, the constexpr bool variable will be "pulled" into a narrower scope,
-// causing 'static_assert()' to fail due to using undeclared identifier. Since the line with undeclared identifier
-// gets expanded, the user will be able to see the assert message.
-//
-// Note 2:
-//
-// By separating "record management" into a static variable and "actual timing" into a non-static one,
-// we can avoid additional overhead from having to locate the record, corresponding to the profiled source location.
-// (an operation that requires a non-trivial vector/map lookup with string comparisons)
-//
-// Static variable initializes its record once and timer does the bare minimum of work - 2 calls to 'now()' to get
-// timing, one addition to accumulated time and a check for recursion (so it can skip time appropriately).
-//
-//  Note 3:
-//
-// _utl_profiler_add_uuid(...) ensures no identifier collisions when several profilers exist in a single scope.
-// Since in this context 'uuid' is a line number, the only case in which ids can collide is when multiple profilers
-// are declated on the same line, which I assume no sane person would do. And even if they would, that would simply
-// lead to a compiler error. Can't really do better than that without resorting to non-standard macros like
-// '__COUNTER__' for 'uuid' creation
+    void merge(const _overhead& other) {
+        this->calls += other.calls;
+        this->nested_calls += other.nested_calls;
+        this->raw_time += other.raw_time;
+    }
 
-#define UTL_PROFILER_EXCLUSIVE(label_)                                                                                 \
-    constexpr bool _utl_profiler_add_uuid(utl_profiler_macro_guard_) = true;                                           \
-                                                                                                                       \
-    static_assert(_utl_profiler_add_uuid(utl_profiler_macro_guard_), "UTL_PROFILER_EXCLUSIVE is a multi-line macro."); \
-                                                                                                                       \
-    static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
-                                                                                               __func__, label_);      \
-                                                                                                                       \
-    if constexpr (const utl::profiler::_exclusive_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){       \
-                      &_utl_profiler_add_uuid(utl_profiler_record_manager_)})
-// Note:
-//
-// Exact same thing as a regular UTL_PROFILER() but uses '_exclusive_scope_timer' instead.
-// The reason we need this for recursion is nicely explained in the docs.
+    void subtract(const _overhead& baseline) {
+        this->calls -= baseline.calls;
+        this->nested_calls -= baseline.nested_calls;
+        this->raw_time -= baseline.raw_time;
+    }
+};
 
-// --- Segment profiling ---
-// -------------------------
+// Results of a callsite, either from a single thread or merged from all of them
+struct _record {
+    const _callsite* callsite;
+    std::size_t      thread;
+    duration         accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    _statistics statistics;
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    _counters counters;
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    _allocations allocations;
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    _overhead overhead;
+#endif
+};
 
-#define UTL_PROFILER_BEGIN(segment_label_, label_)                                                                     \
-    static utl::profiler::_record_manager utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__, __func__,   \
-                                                                                       label_);                        \
-    utl::profiler::_segment_timer         utl_profiler_segment_timer_##segment_label_(                                 \
-        &utl_profiler_record_manager_##segment_label_)
+inline void _utl_profiler_atexit(); // predeclaration, implementation has circular dependency with 'RecordManager'
 
-#define UTL_PROFILER_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
-// Note 1:
-//
-// Last semicolon is intentiomally skipped so macro requires it at the end and
-// doesn't mess up auto code formatters that have a dislike for statement macros.
-//
-// Note 2:
-//
-// The idea here exactly the same as with scope profiles, except instead of '_scope_timer' we use '_segment_timer'
-// that records time on a '.finish()' call instead of destructor. We can put this call inside the END macro
-// and have a nice 2-macro API for profiling segments without creating a scope.
+struct _baseline;
+inline _baseline& _reset_baseline(); // same thing, needs to be constructed before the 'atexit()' registration
 
-#define UTL_PROFILER_EXCLUSIVE_BEGIN(segment_label_, label_)                                                           \
-    static utl::profiler::_record_manager   utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__, __func__, \
-                                                                                         label_);                      \
-    utl::profiler::_exclusive_segment_timer utl_profiler_segment_timer_##segment_label_(                               \
-        &utl_profiler_record_manager_##segment_label_)
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+struct _timer_overhead;
+inline const _timer_overhead& _calibrated_overhead(); // calibration has to happen before the first measurement
+#endif
 
-#define UTL_PROFILER_EXCLUSIVE_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
+// =========================
+// --- Profiler Classess ---
+// =========================
 
-} // namespace utl::profiler
+// Single writer accumulation, owning thread is the only one that ever modifies the value, which means
+// we can avoid read-modify-write atomics and still allow other threads to read the value at any time
+template <class T>
+void _relaxed_add(std::atomic<T>& target, T value) noexcept {
+    target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Record of a single callsite in a single thread. Only the owning thread ever writes to it, which means we don't need
+// any read-modify-write atomics on a hot path, atomic is only there so that results can be safely read by another
+// thread at any time (which compiles down to a regular 'mov' with relaxed memory order)
+class _thread_record {
+private:
+    std::atomic<duration::rep> accumulated{};
 
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    std::atomic<std::uint64_t>                               calls{};
+    std::atomic<duration::rep>                               min{std::numeric_limits<duration::rep>::max()};
+    std::atomic<duration::rep>                               max{};
+    std::array<std::atomic<std::uint64_t>, _histogram_size> histogram{};
 #endif
-#endif // macro-module UTL_PROFILER
 
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    std::atomic<std::uint64_t>                              counted_calls{};
+    std::array<std::atomic<std::uint64_t>, _counter_count> counter_values{};
+#endif
 
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    std::atomic<std::uint64_t> allocation_count{};
+    std::atomic<std::uint64_t> allocated_bytes{};
+    std::atomic<std::uint64_t> deallocation_count{};
+#endif
 
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    std::atomic<std::uint64_t> measured_calls{};
+    std::atomic<std::uint64_t> nested_calls{};
+#endif
 
+public:
+    const _callsite* callsite;
+    int              recursion{};
 
+    _thread_record(const _callsite* callsite) : callsite(callsite) {}
 
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-//
-// Module:        utl::progressbar
-// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_progressbar.md
-// Source repo:   https://github.com/DmitriBogdanov/UTL
-//
-// This project is licensed under the MIT License
-//
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    void add_time(duration time) noexcept {
+        _relaxed_add(this->accumulated, time.count());
 
-#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_PROGRESSBAR)
-#ifndef UTLHEADERGUARD_PROGRESSBAR
-#define UTLHEADERGUARD_PROGRESSBAR
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+        const auto ns = std::max<std::chrono::nanoseconds::rep>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), 0);
 
-// _______________________ INCLUDES _______________________
+        _relaxed_add(this->calls, std::uint64_t(1));
+        _relaxed_add(this->histogram[_histogram_bucket(static_cast<std::uint64_t>(ns))], std::uint64_t(1));
+        if (time.count() < this->min.load(std::memory_order_relaxed))
+            this->min.store(time.count(), std::memory_order_relaxed);
+        if (time.count() > this->max.load(std::memory_order_relaxed))
+            this->max.store(time.count(), std::memory_order_relaxed);
+#endif
+    }
 
-#include <algorithm> // fill_n
-#include <chrono>    // chrono::steady_clock, chrono::time_point<>, chrono::duration_cast<>, chrono::seconds
-#include <cmath>     // floor()
-#include <cstddef>   // size_t
-#include <iomanip>   // setprecision()
-#include <ios>       // fixed
-#include <iostream>  // cout
-#include <iterator>  // ostreambuf_iterator<>
-#include <ostream>   // ostream
-#include <sstream>   // ostringstream
-#include <string>    // string
+    duration accumulated_time() const noexcept { return duration(this->accumulated.load(std::memory_order_relaxed)); }
 
-// ____________________ DEVELOPER DOCS ____________________
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    void add_counters(const _counter_values& values) noexcept {
+        _relaxed_add(this->counted_calls, std::uint64_t(1));
+        for (std::size_t i = 0; i < _counter_count; ++i) _relaxed_add(this->counter_values[i], values[i]);
+    }
 
-// Simple progress bars for terminal applications. Rendered in ASCII on the main thread with manual updates
-// for maximal compatibility. Perhaps can be extended with some fancier async options that display animations.
-//
-// # ::set_ostream() #
-// Sets ostream used for progress bars.
-//
-// # ::Percentage #
-// Proper progress bar, uses carriage return escape sequence (\r) to render new states in the same spot.
-// Shows an estimate of remaining time.
-//
-// # ::Ruler #
-// Primitive & lightweight progress bar, useful when terminal has no proper support for escape sequences.
+    _counters counters() const noexcept {
+        _counters result;
+        result.calls = this->counted_calls.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < _counter_count; ++i)
+            result.values[i] = this->counter_values[i].load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
 
-// ____________________ IMPLEMENTATION ____________________
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    // Called from inside of the 'operator new' & 'operator delete', can't allocate anything by itself
+    void add_allocation(std::size_t size) noexcept {
+        _relaxed_add(this->allocation_count, std::uint64_t(1));
+        _relaxed_add(this->allocated_bytes, static_cast<std::uint64_t>(size));
+    }
 
-namespace utl::progressbar {
+    void add_deallocation() noexcept { _relaxed_add(this->deallocation_count, std::uint64_t(1)); }
 
-inline std::ostream* _output_stream = &std::cout;
+    _allocations allocations() const noexcept {
+        _allocations result;
+        result.count         = this->allocation_count.load(std::memory_order_relaxed);
+        result.bytes         = this->allocated_bytes.load(std::memory_order_relaxed);
+        result.deallocations = this->deallocation_count.load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
 
-inline void set_ostream(std::ostream& new_ostream) { _output_stream = &new_ostream; }
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    void add_nested_calls(std::uint64_t nested) noexcept {
+        _relaxed_add(this->measured_calls, std::uint64_t(1));
+        _relaxed_add(this->nested_calls, nested);
+    }
 
-class Percentage {
-private:
-    char done_char;
-    char not_done_char;
-    bool show_time_estimate;
+    _overhead overhead() const noexcept {
+        _overhead result;
+        result.calls        = this->measured_calls.load(std::memory_order_relaxed);
+        result.nested_calls = this->nested_calls.load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
 
-    std::size_t length_total;   // full   bar length
-    std::size_t length_current; // filled bar length
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    _statistics statistics() const noexcept {
+        _statistics result;
+        result.calls = this->calls.load(std::memory_order_relaxed);
+        if (!result.calls) return result;
 
-    double last_update_percentage;
-    double update_rate;
+        result.min = duration(this->min.load(std::memory_order_relaxed));
+        result.max = duration(this->max.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < _histogram_size; ++i)
+            result.histogram[i] = this->histogram[i].load(std::memory_order_relaxed);
+        return result;
+    }
+#endif
+};
 
-    using Clock     = std::chrono::steady_clock;
-    using TimePoint = std::chrono::time_point<Clock>;
+// Same as '_thread_record::recursion' but shared between all callsites of the thread, see '_exclusive_scope_timer'
+inline thread_local int _exclusive_recursion = 0;
 
-    TimePoint timepoint_start; // used to estimate remaining time
-    TimePoint timepoint_current;
+// Number of measurements started on the thread, only used with 'UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION'.
+// Recursive entries of an already measured scope don't read the clock, so they aren't counted.
+inline thread_local std::uint64_t _scope_entries = 0;
 
-    int previous_string_length; // used to properly return the carriage when dealing with changed string size
+// Record of the innermost active profiled scope of the thread, only used with 'UTL_PROFILER_OPTION_ALLOCATIONS'.
+// Pointer is constant-initialized, so it can be safely accessed from the allocation hooks at any point.
+inline thread_local _thread_record* _current_record = nullptr;
 
-    void draw_progressbar(double percentage) {
-        const auto displayed_percentage = this->update_rate * std::floor(percentage / this->update_rate);
-        // floor percentage to a closest multiple of 'update_rate' for nicer display
-        // since actual updates are only required to happen no more ofter than 'update_rate'
-        // and don't have to correspond to exact multiples of it
+// Profiler's own bookkeeping shouldn't show up in the results, internal allocations are wrapped in this guard
+struct _untracked_allocations {
+    _thread_record* record = std::exchange(_current_record, nullptr);
 
-        // Estimate remaining time (linearly) and format it min + sec
-        const auto time_elapsed       = this->timepoint_current - this->timepoint_start;
-        const auto estimate_full      = time_elapsed / percentage;
-        const auto estimate_remaining = estimate_full - time_elapsed;
+    ~_untracked_allocations() { _current_record = this->record; }
+};
 
-        const auto estimate_remaining_sec = std::chrono::duration_cast<std::chrono::seconds>(estimate_remaining);
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
 
-        const auto displayed_min = (estimate_remaining_sec / 60ll).count();
-        const auto displayed_sec = (estimate_remaining_sec % 60ll).count();
+inline void _track_allocation(std::size_t size) noexcept {
+    if (_thread_record* record = _current_record) record->add_allocation(size);
+}
 
-        const bool show_min  = (displayed_min != 0);
-        const bool show_sec  = (displayed_sec != 0) && !show_min;
-        const bool show_time = (estimate_remaining_sec.count() > 0);
+inline void _track_deallocation(void* ptr) noexcept {
+    if (_thread_record* record = _current_record; record && ptr) record->add_deallocation();
+}
 
-        std::ostringstream ss;
+// Replacement 'operator new' has to follow the standard semantics, calling 'new_handler' on failure until it either
+// succeeds or runs out of handlers. Aligned allocations round the size up to the alignment, since that's what
+// 'std::aligned_alloc()' requires.
+inline void* _allocate(std::size_t size, std::size_t alignment = 0) {
+    _track_allocation(size);
 
-        // Print bar
-        ss << '[';
-        std::fill_n(std::ostreambuf_iterator<char>(ss), this->length_current, this->done_char);
-        std::fill_n(std::ostreambuf_iterator<char>(ss), this->length_total - this->length_current, this->not_done_char);
-        ss << ']';
+    const auto try_allocate = [&]() -> void* {
+        if (size == 0) size = 1;
+        if (!alignment) return std::malloc(size);
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    };
 
-        // Print percentage
-        ss << ' ' << std::fixed << std::setprecision(2) << 100. * displayed_percentage << '%';
+    while (true) {
+        if (void* ptr = try_allocate()) return ptr;
 
-        // Print time estimate
-        if (this->show_time_estimate && show_time) {
-            ss << " (remaining:";
-            if (show_min) ss << ' ' << displayed_min << " min";
-            if (show_sec) ss << ' ' << displayed_sec << " sec";
-            ss << ')';
-        }
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
 
-        const std::string bar_string = ss.str();
+inline void* _allocate_nothrow(std::size_t size, std::size_t alignment = 0) noexcept {
+    try {
+        return _allocate(size, alignment);
+    } catch (...) { return nullptr; }
+}
 
-        // Add spaces at the end to overwrite the previous string if it was longer that current
-        const int current_string_length = static_cast<int>(bar_string.length());
-        const int string_length_diff    = this->previous_string_length - current_string_length;
+inline void _deallocate(void* ptr, [[maybe_unused]] bool aligned = false) noexcept {
+    _track_deallocation(ptr);
+#ifdef _WIN32
+    if (aligned) _aligned_free(ptr);
+    else std::free(ptr);
+#else
+    std::free(ptr); // memory from 'std::aligned_alloc()' is freed the same way
+#endif
+}
 
-        if (string_length_diff > 0) { std::fill_n(std::ostreambuf_iterator<char>(ss), string_length_diff, ' '); }
+#endif
 
-        this->previous_string_length = current_string_length;
+// Node of a per-thread call tree, tree only grows under the registry mutex and its values are written by the
+// owning thread, which allows us to read it from other threads in the same way as regular records
+struct _call_tree_node {
+    const _callsite*                              callsite = nullptr;
+    _call_tree_node*                              parent   = nullptr;
+    std::vector<std::unique_ptr<_call_tree_node>> children;
+    std::atomic<duration::rep>                    inclusive_time{};
+    std::atomic<std::uint64_t>                    calls{};
+    std::atomic<std::uint64_t>                    samples{}; // written from the signal handler of the owning thread
+};
 
-        // Return the carriage
-        (*_output_stream) << ss.str(); // don't reuse 'bar_string', now 'ss' can also contain spaces at the end
-        (*_output_stream) << '\r';
-        (*_output_stream).flush();
-        // '\r' returns cursor to the beginning of the line => most sensible consoles will
-        // render render new lines over the last one. Otherwise every update produces a
-        // bar on a new line, which looks worse but isn't critical for the purpose.
-    }
+// Innermost call tree node of the thread, only used with 'UTL_PROFILER_OPTION_CALL_TREE' or '..._SAMPLING'
+inline thread_local _call_tree_node* _current_node = nullptr;
+
+// Sampled instruction address, 'callsite' is the innermost profiled scope of the first sample that hit it
+struct _ip_sample {
+    std::uintptr_t   ip;
+    const _callsite* callsite;
+    std::uint64_t    samples;
+};
+
+// Fixed-size open-addressing hash table of sampled instruction addresses. It only gets written from the signal
+// handler of the owning thread, which means it can neither allocate nor lock. Address of a slot gets published
+// last, so readers from other threads never see a partially filled slot.
+class _ip_table {
+private:
+    static constexpr std::size_t capacity = 4096;
+
+    struct slot {
+        std::atomic<std::uintptr_t>   ip{};
+        std::atomic<const _callsite*> callsite{};
+        std::atomic<std::uint64_t>    samples{};
+    };
+
+    std::array<slot, capacity> slots{};
+    std::atomic<std::uint64_t> dropped{};
 
 public:
-    Percentage(char done_char = '#', char not_done_char = '.', std::size_t bar_length = 30, double update_rate = 1e-2,
-               bool show_time_estimate = true)
-        : done_char(done_char), not_done_char(not_done_char), show_time_estimate(show_time_estimate),
-          length_total(bar_length), length_current(0), last_update_percentage(0), update_rate(update_rate),
-          timepoint_start(Clock::now()), previous_string_length(static_cast<int>(bar_length) + sizeof("[] 100.00%")) {}
+    void add(std::uintptr_t ip, const _callsite* callsite) noexcept {
+        std::size_t index = static_cast<std::size_t>((ip * 0x9E3779B97F4A7C15ull) >> 52) % capacity;
 
-    void start() {
-        this->last_update_percentage = 0.;
-        this->length_current         = 0;
-        this->timepoint_start        = Clock::now();
-        (*_output_stream) << '\n';
-    }
+        for (std::size_t probe = 0; probe < capacity; ++probe, index = (index + 1) % capacity) {
+            slot&                slot     = this->slots[index];
+            const std::uintptr_t existing = slot.ip.load(std::memory_order_relaxed);
 
-    void set_progress(double percentage) {
-        if (percentage - this->last_update_percentage <= this->update_rate) return;
+            if (existing == ip) {
+                _relaxed_add(slot.samples, std::uint64_t(1));
+                return;
+            }
+            if (existing) continue;
 
-        this->last_update_percentage = percentage;
-        this->length_current         = static_cast<std::size_t>(percentage * static_cast<double>(this->length_total));
-        this->timepoint_current      = Clock::now();
-        this->draw_progressbar(percentage);
+            slot.callsite.store(callsite, std::memory_order_relaxed);
+            slot.samples.store(1, std::memory_order_relaxed);
+            slot.ip.store(ip, std::memory_order_release);
+            return;
+        }
+
+        _relaxed_add(this->dropped, std::uint64_t(1)); // table is full
     }
 
-    void finish() {
-        this->last_update_percentage = 1.;
-        this->length_current         = this->length_total;
-        this->draw_progressbar(1.);
-        (*_output_stream) << '\n';
+    std::vector<_ip_sample> collect() const {
+        std::vector<_ip_sample> result;
+        for (const auto& slot : this->slots)
+            if (const std::uintptr_t ip = slot.ip.load(std::memory_order_acquire))
+                result.push_back({ip, slot.callsite.load(std::memory_order_relaxed),
+                                  slot.samples.load(std::memory_order_relaxed)});
+        return result;
     }
 };
 
-class Ruler {
+// Single execution of a profiled scope, only recorded with 'UTL_PROFILER_OPTION_TRACE'
+struct _trace_event {
+    const _callsite* callsite;
+    time_point       start;
+    duration         time;
+};
+
+// Append-only per-thread event buffer. Events are stored in fixed-size chunks that never get moved, owning thread
+// publishes the event count with a release store after writing the event, which allows other threads to read all
+// published events while the buffer keeps growing. Chunk list only changes once every 'chunk_size' events.
+class _trace_buffer {
 private:
-    char done_char;
+    static constexpr std::size_t chunk_size = 4096;
+    using chunk                             = std::array<_trace_event, chunk_size>;
 
-    std::size_t length_total;
-    std::size_t length_current;
+    std::mutex                          mutex;
+    std::vector<std::unique_ptr<chunk>> chunks;
+    std::atomic<std::size_t>            size{};
 
 public:
-    Ruler(char done_char = '#') : done_char(done_char), length_total(51), length_current(0) {}
-
-    void start() {
-        this->length_current = 0;
-
-        (*_output_stream) << '\n'
-                          << " 0    10   20   30   40   50   60   70   80   90   100%\n"
-                          << " |----|----|----|----|----|----|----|----|----|----|\n"
-                          << ' ';
-    }
+    void push(const _trace_event& event) {
+        const std::size_t index = this->size.load(std::memory_order_relaxed);
 
-    void set_progress(double percentage) {
-        const std::size_t length_new = static_cast<std::size_t>(percentage * static_cast<double>(this->length_total));
+        if (index % chunk_size == 0) {
+            const _untracked_allocations guard;
+            auto                         new_chunk = std::make_unique<chunk>();
 
-        if (length_new > length_current) {
-            const auto chars_to_add = length_new - this->length_current;
-            std::fill_n(std::ostreambuf_iterator<char>(*_output_stream), chars_to_add, this->done_char);
+            const std::lock_guard lock(this->mutex);
+            this->chunks.push_back(std::move(new_chunk));
         }
 
-        this->length_current = length_new;
+        (*this->chunks[index / chunk_size])[index % chunk_size] = event;
+        this->size.store(index + 1, std::memory_order_release);
     }
 
-    void finish() {
-        if (this->length_total > this->length_current) {
-            const auto chars_to_add = this->length_total - this->length_current;
-            std::fill_n(std::ostreambuf_iterator<char>(*_output_stream), chars_to_add, this->done_char);
-        }
+    std::vector<_trace_event> collect() {
+        const std::size_t size = this->size.load(std::memory_order_acquire);
 
-        this->length_current = this->length_total;
+        std::vector<_trace_event> result;
+        result.reserve(size);
 
-        (*_output_stream) << '\n';
+        const std::lock_guard lock(this->mutex);
+        for (std::size_t i = 0; i < size; ++i) result.push_back((*this->chunks[i / chunk_size])[i % chunk_size]);
+
+        return result;
     }
 };
 
-} // namespace utl::progressbar
+struct _thread_records {
+    std::size_t                                  thread_index{};
+    std::vector<std::unique_ptr<_thread_record>> records;
+    _call_tree_node                              call_tree_root;
+    _trace_buffer                                trace;
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    _ip_table ip_samples;
+#endif
+};
+
+// Records of the current thread, set when the thread visits its first callsite
+inline thread_local _thread_records* _current_thread = nullptr;
+
+// --- Sampling ---
+// ----------------
+
+// Sampling mode uses a per-thread POSIX timer that measures CPU time of the thread and sends it 'SIGPROF'
+// every 'UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US' microseconds. Signal handler runs on the sampled thread
+// and only increments the sample count of its current call tree node (which corresponds to the stack of
+// active profiled scopes), this requires no locking or allocation and is async-signal-safe.
+//
+// Call tree nodes only get created and never deallocated, which means '_current_node' always points to
+// a valid node regardless of the moment when the signal interrupts the thread.
 
+#ifndef UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US
+#define UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US 1000
 #endif
-#endif // module utl::progressbar
 
+// Error of the first failed sampling setup, 'ENOSYS' on platforms without sampling support
+inline std::atomic<int> _sampling_error{0};
 
+// Timers belong to thread-local objects, a detached thread that is still running during static destruction
+// can get a signal after the registry is gone. Registry destructor raises the flag and waits for the handlers
+// that are already running, this is a Dekker-style handshake, so both sides need sequentially consistent order.
+inline std::atomic<bool>     _sampling_shutdown{false};
+inline std::atomic<unsigned> _sampling_handlers_running{0};
 
+#if defined(UTL_PROFILER_OPTION_SAMPLING) && defined(UTL_PROFILER_HAS_SAMPLING)
 
+inline void _sampling_sample([[maybe_unused]] void* context) noexcept {
+    _call_tree_node* node = _current_node;
+    if (!node) return;
 
+    _relaxed_add(node->samples, std::uint64_t(1));
 
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-//
-// Module:        utl::random
-// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_random.md
-// Source repo:   https://github.com/DmitriBogdanov/UTL
-//
-// This project is licensed under the MIT License
-//
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    const ucontext_t* ucontext = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    const auto ip = static_cast<std::uintptr_t>(ucontext->uc_mcontext.pc);
+#else
+    const std::uintptr_t ip = 0;
+#endif
+    if (ip && _current_thread) _current_thread->ip_samples.add(ip, node->callsite);
+#endif
+}
 
-#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_RANDOM)
-#ifndef UTLHEADERGUARD_RANDOM
-#define UTLHEADERGUARD_RANDOM
+inline void _sampling_handler(int, siginfo_t*, void* context) noexcept {
+    _sampling_handlers_running.fetch_add(1);
+    if (!_sampling_shutdown.load()) _sampling_sample(context);
+    _sampling_handlers_running.fetch_sub(1);
+}
 
-// _______________________ INCLUDES _______________________
+class _sampling_timer {
+private:
+    timer_t timer{};
+    bool    created = false;
 
-#include <array>            // array<>
-#include <chrono>           // high_resolution_clock
-#include <cstdint>          // uint64_t
-#include <initializer_list> // initializer_list<>
-#include <limits>           // numeric_limits<>::digits, numeric_limits<>::min(), numeric_limits<>::max()
-#include <mutex>            // mutex, lock_guard<>
-#include <random>           // random_device, std::uniform_int_distribution<>,
-                            // std::uniform_real_distribution<>, generate_canonical<>
-#include <type_traits>      // is_integral_v<>
-#include <utility>          // declval<>()
+    static void set_error(int error) {
+        int expected = 0;
+        _sampling_error.compare_exchange_strong(expected, error);
+    }
 
-// ____________________ DEVELOPER DOCS ____________________
+public:
+    _sampling_timer() {
+        static const bool handler_installed = [] {
+            struct sigaction action {};
+            action.sa_sigaction = _sampling_handler;
+            action.sa_flags     = SA_SIGINFO | SA_RESTART; // don't make the sampled code deal with 'EINTR'
+            sigemptyset(&action.sa_mask);
+
+            if (sigaction(SIGPROF, &action, nullptr) == 0) return true;
+            set_error(errno);
+            return false;
+        }();
+        if (!handler_installed) return;
+
+        // Signal should be delivered to this specific thread, rather than to an arbitrary thread of the process
+        sigevent event{};
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo  = SIGPROF;
+#ifdef sigev_notify_thread_id
+        event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+#else
+        event._sigev_un._tid = static_cast<pid_t>(syscall(SYS_gettid));
+#endif
 
-// Implements a proper modern PRNG engine, compatible with std <random>.
-// Adds 'sensible std <random> wrappers' for people who aren't fond of writing
-// 3 lines code just to get a simple rand value.
-//
-// # XorShift64StarGenerator #
-// Random 'std::uint64_t' generator that satisfies uniform random number generator requirements
-// from '<random>' (see https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
-// Implementation "XorShift64* suggested by Marsaglia G. in 2003 "Journal of Statistical Software"
-// (see https://www.jstatsoft.org/article/view/v008i14).
-// Slightly faster than 'std::rand()', while providing higher quality random.
-// Significantly faster than 'std::mt19937'.
-// State consists of a single 'std::uint64_t', requires seed >= 1.
-//
-// # xorshift64star #
-// Global instance of XorShift64StarGenerator.
-//
-// # ::seed(), ::seed_with_time(), ::seed_with_random_device() #
-// Seeds random with value/current_time/random_device.
-// Random device is a better source of entropy, however it's more expensive to initialize
-// than just taking current time with <ctime>, in some cases a "worse by lightweigh" can
-// be prefered.
-//
-// # ::rand_int(), ::rand_uint(), ::rand_float(), ::rand_double() #
-// Random value in [min, max] range.
-// Floats with no parameters assume range [0, 1].
-//
-// # ::rand_bool() #
-// Randomly chooses 0 or 1.
-//
-// # ::rand_choise() #
-// Randomly chooses a value from initializer list.
-//
-// # ::rand_linear_combination() #
-// Produces "c A + (1-c) B" with random "0 < c < 1" assuming objects "A", "B" support arithmetic operations.
-// Useful for vector and color operations.
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &this->timer) != 0) {
+            set_error(errno);
+            return;
+        }
+        this->created = true;
 
-// ____________________ IMPLEMENTATION ____________________
+        constexpr long interval_ns = static_cast<long>(UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US) * 1000;
 
-namespace utl::random {
+        itimerspec spec{};
+        spec.it_interval.tv_sec  = interval_ns / 1'000'000'000;
+        spec.it_interval.tv_nsec = interval_ns % 1'000'000'000;
+        spec.it_value            = spec.it_interval;
 
-// ============================
-// --- Implementation utils ---
-// ============================
+        if (timer_settime(this->timer, 0, &spec, nullptr) != 0) set_error(errno);
+    }
 
-#define utl_random_define_trait(trait_name_, ...)                                                                      \
-    template <class T, class = void>                                                                                   \
-    struct trait_name_ : std::false_type {};                                                                           \
-                                                                                                                       \
-    template <class T>                                                                                                 \
-    struct trait_name_<T, std::void_t<decltype(__VA_ARGS__)>> : std::true_type {};                                     \
-                                                                                                                       \
-    template <class T>                                                                                                 \
-    constexpr bool trait_name_##_v = trait_name_<T>::value;                                                            \
-                                                                                                                       \
-    template <class T>                                                                                                 \
-    using trait_name_##_enable_if = std::enable_if_t<trait_name_<T>::value, bool>
+    _sampling_timer(const _sampling_timer&)            = delete;
+    _sampling_timer& operator=(const _sampling_timer&) = delete;
 
+    ~_sampling_timer() {
+        if (this->created) timer_delete(this->timer);
+    }
+};
 
-utl_random_define_trait(_is_seed_seq,
-                        std::declval<T>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()));
-// this type trait is necessary to restrict template constructors & seed function that take 'SeedSeq&& seq', otherwise
-// they will get pick instead of regular seeding methods for even for integer conversions. This is how standard library
-// seems to do it (based on GCC implementation) so we follow their API.
+// Timer lives until the thread exits
+inline void _start_sampling() { thread_local const _sampling_timer timer; }
 
-#undef utl_random_define_trait
+#else
 
-// A 'lightweight' PRNG used by some other engines to initialize their state
-constexpr std::uint32_t _splitmix32(std::uint32_t& state) noexcept {
-    uint32_t result = (state += 0x9e3779b9);
-    result          = (result ^ (result >> 16)) * 0x21f0aaad;
-    result          = (result ^ (result >> 15)) * 0x735a2d97;
-    return result ^ (result >> 15);
+inline void _start_sampling() {
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    int expected = 0;
+    _sampling_error.compare_exchange_strong(expected, ENOSYS);
+#endif
 }
 
-constexpr std::uint64_t _splitmix64(std::uint64_t& state) noexcept {
-    std::uint64_t result = (state += 0x9E3779B97f4A7C15);
-    result               = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
-    result               = (result ^ (result >> 27)) * 0x94D049BB133111EB;
-    return result ^ (result >> 31);
-}
+#endif
 
-// Merging integers into the bits of a larger one
-[[nodiscard]] constexpr std::uint64_t _merge_uint32_into_uint64(std::uint32_t a, std::uint32_t b) {
-    return static_cast<std::uint64_t>(a) | (static_cast<std::uint64_t>(b) << 32);
-}
+// Trace events of a single thread, sorted by their start time
+struct _thread_trace {
+    std::size_t               thread;
+    std::vector<_trace_event> events;
+};
 
-// Helper method to crush large uints to uint32_t,
-// inspired by Melissa E. O'Neil's randutils https://gist.github.com/imneme/540829265469e673d045
-template <class T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= 8, bool> = true>
-[[nodiscard]] constexpr std::uint32_t _crush_to_uint32(T value) {
-    if constexpr (sizeof(value) <= 4) {
-        return std::uint32_t(value);
-    } else {
-        std::uint64_t res = value;
-        res *= 0xbc2ad017d719504d;
-        return static_cast<std::uint32_t>(res ^ (res >> 32));
+// Flattened call tree, nodes are listed depth-first with children sorted by their inclusive time
+struct _call_tree_row {
+    std::size_t            thread;
+    std::size_t            depth;
+    const _callsite*       callsite;
+    std::uint64_t          calls;
+    duration               inclusive_time;
+    duration               exclusive_time;
+    const _call_tree_node* node; // identifies the row across collections
+    std::uint64_t          self_samples;
+    std::uint64_t          total_samples; // includes samples of the nested scopes
+};
+
+// Global list of all per-thread records, records are never deallocated, which means results of finished threads
+// stay available and pointers cached by the profiling macros stay valid. Mutex is only locked when some thread
+// visits a callsite for the first time or when we collect results, neither of which happens on a hot path.
+class _registry {
+private:
+    std::mutex                                    mutex;
+    std::vector<std::unique_ptr<_thread_records>> threads;
+
+public:
+    static _registry& instance() {
+        static _registry registry;
+        return registry;
     }
-}
 
-// Seed sequence helpers
-template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-std::uint32_t _seed_seq_to_uint32(SeedSeq&& seq) {
-    std::array<std::uint32_t, 1> temp;
-    seq.generate(temp.begin(), temp.end());
-    return temp[0];
-}
+#if defined(UTL_PROFILER_OPTION_SAMPLING) && defined(UTL_PROFILER_HAS_SAMPLING)
+    _registry() = default;
 
-template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-std::uint64_t _seed_seq_to_uint64(SeedSeq&& seq) {
-    std::array<std::uint32_t, 2> temp;
+    _registry(const _registry&)            = delete;
+    _registry& operator=(const _registry&) = delete;
+
+    // Signals of the threads that are still alive can no longer touch the call tree or the IP tables
+    ~_registry() {
+        _sampling_shutdown.store(true);
+        while (_sampling_handlers_running.load()) std::this_thread::yield();
+    }
+#endif
+
+    _thread_record* create_record(const _callsite* callsite) {
+        const _untracked_allocations guard;
+        const std::lock_guard        lock(this->mutex);
+
+        if (!_current_thread) {
+            _current_thread               = this->threads.emplace_back(std::make_unique<_thread_records>()).get();
+            _current_thread->thread_index = this->threads.size() - 1;
+            _current_node                 = &_current_thread->call_tree_root;
+            _start_sampling();
+        }
+
+        return _current_thread->records.emplace_back(std::make_unique<_thread_record>(callsite)).get();
+    }
+
+    // Returns cumulative per-thread records
+    std::vector<_record> collect_records() {
+        std::vector<_record> result;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads)
+            for (const auto& record : thread->records) {
+                _record& entry         = result.emplace_back();
+                entry.callsite         = record->callsite;
+                entry.thread           = thread->thread_index;
+                entry.accumulated_time = record->accumulated_time();
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+                entry.statistics = record->statistics();
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+                entry.counters = record->counters();
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+                entry.allocations = record->allocations();
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+                entry.overhead = record->overhead();
+#endif
+            }
+
+        return result;
+    }
+
+    std::size_t thread_count() {
+        const std::lock_guard lock(this->mutex);
+        return this->threads.size();
+    }
+
+    _call_tree_node* add_call_tree_node(_call_tree_node* parent, const _callsite* callsite) {
+        const _untracked_allocations guard;
+
+        auto node      = std::make_unique<_call_tree_node>();
+        node->callsite = callsite;
+        node->parent   = parent;
+
+        const std::lock_guard lock(this->mutex);
+        return parent->children.emplace_back(std::move(node)).get();
+    }
+
+    std::vector<_call_tree_row> collect_call_tree() {
+        std::vector<_call_tree_row> result;
+
+        // Returns total samples of the subtree, row gets pushed before its children so we fill that value later
+        const auto visit = [&](auto&& self, const _call_tree_node& node, std::size_t thread,
+                               std::size_t depth) -> std::uint64_t {
+            std::vector<const _call_tree_node*> children;
+            for (const auto& child : node.children) children.push_back(child.get());
+            std::stable_sort(children.begin(), children.end(), [](const _call_tree_node* l, const _call_tree_node* r) {
+                return l->inclusive_time.load(std::memory_order_relaxed) >
+                       r->inclusive_time.load(std::memory_order_relaxed);
+            });
+
+            std::uint64_t total_samples = node.samples.load(std::memory_order_relaxed);
+
+            for (const auto* child : children) {
+                const duration inclusive_time(child->inclusive_time.load(std::memory_order_relaxed));
+
+                duration children_time{};
+                for (const auto& grandchild : child->children)
+                    children_time += duration(grandchild->inclusive_time.load(std::memory_order_relaxed));
+
+                const std::uint64_t self_samples = child->samples.load(std::memory_order_relaxed);
+
+                const std::size_t row = result.size();
+                result.push_back({thread, depth, child->callsite, child->calls.load(std::memory_order_relaxed),
+                                  inclusive_time, inclusive_time - children_time, child, self_samples, 0});
+
+                const std::uint64_t child_samples = self(self, *child, thread, depth + 1);
+                result[row].total_samples         = child_samples;
+                total_samples += child_samples;
+            }
+
+            return total_samples;
+        };
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads) visit(visit, thread->call_tree_root, thread->thread_index, 0);
+
+        return result;
+    }
+
+    // Samples that landed outside of any profiled scope
+    std::uint64_t collect_unprofiled_samples() {
+        std::uint64_t result = 0;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads)
+            result += thread->call_tree_root.samples.load(std::memory_order_relaxed);
+
+        return result;
+    }
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    // Returns sampled instruction addresses merged across threads
+    std::vector<_ip_sample> collect_ip_samples() {
+        std::map<std::uintptr_t, _ip_sample> merged;
+        {
+            const std::lock_guard lock(this->mutex);
+            for (const auto& thread : this->threads)
+                for (const auto& sample : thread->ip_samples.collect()) {
+                    const auto [it, inserted] = merged.try_emplace(sample.ip, sample);
+                    if (!inserted) it->second.samples += sample.samples;
+                }
+        }
+
+        std::vector<_ip_sample> result;
+        for (const auto& [ip, sample] : merged) result.push_back(sample);
+        return result;
+    }
+#endif
+
+    // Parent scopes start no later than their children and last no shorter, sorting by start time with ties
+    // broken by duration puts parents first, which is the order expected by some of the trace viewers
+    std::vector<_thread_trace> collect_trace() {
+        std::vector<_thread_trace> result;
+
+        const std::lock_guard lock(this->mutex);
+        for (const auto& thread : this->threads) {
+            auto& trace  = result.emplace_back(_thread_trace{thread->thread_index, thread->trace.collect()});
+            auto& events = trace.events;
+            std::stable_sort(events.begin(), events.end(), [](const _trace_event& l, const _trace_event& r) {
+                return l.start < r.start || (l.start == r.start && l.time > r.time);
+            });
+        }
+
+        return result;
+    }
+};
+
+// Call tree tracking, a scope moves current node to a child with the same callsite, creating one if necessary.
+// Children lookup is a linear search, which is fast since the number of distinct children is usually small.
+inline _call_tree_node* _call_tree_enter(const _callsite* callsite) {
+    for (const auto& child : _current_node->children)
+        if (child->callsite == callsite) return _current_node = child.get();
+    return _current_node = _registry::instance().add_call_tree_node(_current_node, callsite);
+}
+
+inline void _call_tree_exit(_call_tree_node* node, duration time) noexcept {
+    _relaxed_add(node->inclusive_time, time.count());
+    _relaxed_add(node->calls, std::uint64_t(1));
+    _current_node = node->parent;
+}
+
+// Static marker of the callsite, creates a record for every thread that visits it
+class _record_manager {
+private:
+    _callsite callsite;
+
+public:
+    _record_manager() = delete;
+
+    _record_manager(const char* file, int line, const char* func, const char* label)
+        : callsite({file, line, func, label}) {
+        // Profiler ever gets called => register result output at 'std::exit()', registry & baseline have to be
+        // constructed before that, so they get destroyed after the output is done
+        _registry::instance();
+        _reset_baseline();
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        _calibrated_overhead();
+#endif
+        [[maybe_unused]] static const bool registered = (std::atexit(_utl_profiler_atexit), true);
+    }
+
+    _thread_record* thread_record() { return _registry::instance().create_record(&this->callsite); }
+};
+
+// We need 4 slightly different timer classes, so might as well deduplicate some code by moving it into a base class
+struct _timer_base {
+protected:
+    time_point      start;
+    _thread_record* record;
+    // we could use 'std::optional<std::reference_wrapper<_thread_record>>',
+    // but that would inctroduce more dependencies for no real reason
+
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+    _call_tree_node* node;
+#endif
+
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+    time_point enter_time; // unlike 'start' this gets recorded on every entry, including the recursive ones
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    _counter_values start_counters;
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    _thread_record* parent_record;
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    std::uint64_t start_entries = 0;
+#endif
+
+    // Counters are read outside of the time measurement, so their overhead doesn't get included into the time
+    void start_measurement() {
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+        this->start_counters = _read_counters();
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        this->start_entries = ++_scope_entries;
+#endif
+        this->start = clock::now();
+    }
+
+    void finish_measurement() {
+        this->record->add_time(clock::now() - this->start);
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+        _counter_values values = _read_counters();
+        for (std::size_t i = 0; i < _counter_count; ++i) values[i] -= this->start_counters[i];
+        this->record->add_counters(values);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        this->record->add_nested_calls(_scope_entries - this->start_entries);
+#endif
+    }
+
+    // Hooks for optional features, called upon entering & exiting the profiled scope regardless of recursion
+    void enter() {
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+        this->node = _call_tree_enter(this->record->callsite);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+        this->parent_record = _current_record;
+        _current_record     = this->record;
+#endif
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+        this->enter_time = clock::now();
+#endif
+    }
+
+    void exit() {
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_TRACE)
+        const time_point exit_time = clock::now();
+#endif
+#if defined(UTL_PROFILER_OPTION_CALL_TREE)
+        _call_tree_exit(this->node, exit_time - this->enter_time);
+#elif defined(UTL_PROFILER_OPTION_SAMPLING)
+        _current_node = this->node->parent; // sampling only needs the tree structure, not the timing
+#endif
+#ifdef UTL_PROFILER_OPTION_TRACE
+        _current_thread->trace.push({this->record->callsite, this->enter_time, exit_time - this->enter_time});
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+        _current_record = this->parent_record;
+#endif
+    }
+
+public:
+    constexpr operator bool() const noexcept { return true; }
+
+    _timer_base(_thread_record* record) : record(record) {}
+};
+
+// Simple class that records the time of its creation and destruction and records it into the connected record
+struct _scope_timer : public _timer_base {
+    _scope_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (this->record->recursion++ == 0) this->start_measurement();
+        // this check prevent timer from double-counting time spent inside
+        // of it's own scope due to recursive calls
+    }
+
+    ~_scope_timer() {
+        if (--this->record->recursion == 0) this->finish_measurement();
+        this->exit();
+    }
+};
+
+// Same thing as '_scope_timer' except it uses thread-wide '_exclusive_recursion' instead of regular 'recursion' that
+// is specific to each record. This effecively means no '_exclusive_scope_timer''s will count time as long a
+// single instance of another exclusive timer exists. This allows us to resolve som tricky situations such as recursion
+struct _exclusive_scope_timer : public _timer_base {
+    _exclusive_scope_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (_exclusive_recursion++ == 0) this->start_measurement();
+    }
+
+    ~_exclusive_scope_timer() {
+        if (--_exclusive_recursion == 0) this->finish_measurement();
+        this->exit();
+    }
+};
+
+// Same thing as '_scope_timer', except instead of destructor it uses an explicitly called method to record time.
+// We need it to implement code-segment profiling with 'UTL_PROFILER_BEGIN' and 'UTL_PROFILER_END'
+struct _segment_timer : public _timer_base {
+    _segment_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (this->record->recursion++ == 0) this->start_measurement();
+    }
+
+    void finish() {
+        if (--this->record->recursion == 0) this->finish_measurement();
+        this->exit();
+    }
+};
+
+struct _exclusive_segment_timer : public _timer_base {
+    _exclusive_segment_timer(_thread_record* record) : _timer_base(record) {
+        this->enter();
+        if (_exclusive_recursion++ == 0) this->start_measurement();
+    }
+
+    void finish() {
+        if (--_exclusive_recursion == 0) this->finish_measurement();
+        this->exit();
+    }
+};
+
+// --- Overhead calibration ---
+// ----------------------------
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+
+struct _timer_overhead {
+    duration per_call{};   // part of the overhead that gets into the measurement of its own scope
+    duration per_nested{}; // full overhead of a nested measurement, as seen by the enclosing scope
+};
+
+// Runs the real '_scope_timer' on a detached record, median across batches filters out the noise from interrupts
+// & context switches. Takes ~1 ms at startup.
+//
+// Scope hooks of the optional features (call tree, trace, allocation & counter bookkeeping) are a part of the
+// overhead too, to include them calibration temporarily swaps the thread state for a private set of thread records
+// that never gets registered, so calibration scopes don't show up in the results. Calibration can happen inside
+// of another profiled scope (when the thread visits a new callsite), which is why scope entries are restored too.
+inline _timer_overhead _measure_timer_overhead() {
+    constexpr std::size_t batch_size  = 256;
+    constexpr std::size_t batch_count = 31;
+
+    const _untracked_allocations guard;
+
+    const _callsite callsite{"", 0, "", ""};
+    const auto      calibration_thread = std::make_unique<_thread_records>();
+
+    _thread_records* const thread        = std::exchange(_current_thread, calibration_thread.get());
+    _call_tree_node* const node          = std::exchange(_current_node, &calibration_thread->call_tree_root);
+    const std::uint64_t    scope_entries = _scope_entries;
+
+    std::vector<duration> per_call, per_nested;
+    for (std::size_t batch = 0; batch < batch_count; ++batch) {
+        _thread_record record(&callsite);
+
+        const time_point start = clock::now();
+        for (std::size_t i = 0; i < batch_size; ++i) _scope_timer timer(&record);
+        const duration elapsed = clock::now() - start;
+
+        per_call.push_back(record.accumulated_time() / batch_size);
+        per_nested.push_back(elapsed / batch_size);
+    }
+
+    _current_thread = thread;
+    _current_node   = node;
+    _scope_entries  = scope_entries;
+
+    const auto median = [](std::vector<duration>& values) {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    return {median(per_call), median(per_nested)};
+}
+
+inline const _timer_overhead& _calibrated_overhead() {
+    static const _timer_overhead overhead = _measure_timer_overhead();
+    return overhead;
+}
+
+// Applied to the difference of two collections rather than to each of them, otherwise clamping would make deltas wrong
+inline void _compensate_overhead(_record& record) {
+    const _timer_overhead& overhead = _calibrated_overhead();
+
+    const auto total = overhead.per_call * static_cast<duration::rep>(record.overhead.calls) +
+                       overhead.per_nested * static_cast<duration::rep>(record.overhead.nested_calls);
+
+    record.overhead.raw_time = record.accumulated_time;
+    record.accumulated_time  = std::max(record.accumulated_time - total, duration{});
+}
+
+#endif
+
+// ===========================
+// --- Profiler Formatting ---
+// ===========================
+
+inline double _duration_to_sec(duration duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1e9;
+}
+
+inline std::string _format_fixed(double value, std::streamsize precision, std::string_view postfix) {
+    return (std::ostringstream() << std::setprecision(precision) << std::fixed << value << postfix).str();
+}
+
+// Latencies of individual calls span many orders of magnitude, which is why we choose units adaptively
+inline std::string _format_latency(duration time) {
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+
+    if (ns < 1e3) return _format_fixed(ns, 0, " ns");
+    if (ns < 1e6) return _format_fixed(ns / 1e3, 2, " us");
+    if (ns < 1e9) return _format_fixed(ns / 1e6, 2, " ms");
+    return _format_fixed(ns / 1e9, 2, " s");
+}
+
+// Same for allocation volume, which can be anything from a few bytes to gigabytes
+inline std::string _format_bytes(std::uint64_t bytes) {
+    const double b = static_cast<double>(bytes);
+
+    if (b < 1024.) return _format_fixed(b, 0, " B");
+    if (b < 1024. * 1024.) return _format_fixed(b / 1024., 2, " KiB");
+    if (b < 1024. * 1024. * 1024.) return _format_fixed(b / (1024. * 1024.), 2, " MiB");
+    return _format_fixed(b / (1024. * 1024. * 1024.), 2, " GiB");
+}
+
+// Prints a table of strings with right-aligned columns, first row is used as a header
+inline void _print_table(std::ostream& os, const std::vector<std::vector<std::string>>& rows) {
+    if (rows.empty()) return;
+
+    std::vector<std::size_t> widths(rows.front().size(), 0);
+    for (const auto& row : rows)
+        for (std::size_t i = 0; i < row.size(); ++i) widths[i] = std::max(widths[i], row[i].size());
+
+    const auto print_row = [&](const std::vector<std::string>& row) {
+        os << " |";
+        for (std::size_t i = 0; i < row.size(); ++i)
+            os << ' ' << std::setw(static_cast<std::streamsize>(widths[i])) << row[i] << " |";
+        os << '\n';
+    };
+
+    print_row(rows.front());
+
+    os << " |";
+    for (const auto width : widths) os << std::string(width + 2, '-') << '|';
+    os << '\n';
+
+    for (auto it = std::next(rows.begin()); it != rows.end(); ++it) print_row(*it);
+}
+
+inline void _write_json_string(std::ostream& os, std::string_view str) {
+    constexpr std::string_view hex = "0123456789abcdef";
+
+    os << '"';
+    for (const char c : str) {
+        if (c == '"' || c == '\\') os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) os << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+        else os << c;
+    }
+    os << '"';
+}
+
+// Fields containing separators, quotes or line breaks get quoted, quotes inside of them get doubled (RFC 4180)
+inline void _write_csv_string(std::ostream& os, std::string_view str) {
+    if (str.find_first_of(",\"\r\n") == std::string_view::npos) {
+        os << str;
+        return;
+    }
+
+    os << '"';
+    for (const char c : str) os << (c == '"' ? "\"\"" : std::string_view(&c, 1));
+    os << '"';
+}
+
+inline std::int64_t _duration_to_ns(duration time) {
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+#ifdef UTL_PROFILER_HAS_SAMPLING
+// Formats address as 'module+offset', which can be resolved into a source line with 'addr2line -e <module> <offset>'
+// even for position-independent executables and shared libraries that get loaded at random addresses
+inline std::string _format_address(std::uintptr_t ip) {
+    struct search {
+        std::uintptr_t ip;
+        std::string    result;
+    } data{ip, {}};
+
+    dl_iterate_phdr(
+        [](dl_phdr_info* info, std::size_t, void* context) -> int {
+            search& data = *static_cast<search*>(context);
+
+            for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+                const auto& header = info->dlpi_phdr[i];
+                const auto  begin  = static_cast<std::uintptr_t>(info->dlpi_addr + header.p_vaddr);
+                if (header.p_type != PT_LOAD || data.ip < begin || data.ip >= begin + header.p_memsz) continue;
+
+                const std::string_view path = info->dlpi_name ? info->dlpi_name : "";
+                const std::string_view name = path.empty() ? "<executable>" : path.substr(path.find_last_of('/') + 1);
+
+                data.result = (std::ostringstream() << name << "+0x" << std::hex << data.ip - info->dlpi_addr).str();
+                return 1;
+            }
+            return 0;
+        },
+        &data);
+
+    if (data.result.empty()) return (std::ostringstream() << "0x" << std::hex << ip).str();
+    return data.result;
+}
+#endif
+
+// ========================
+// --- Profiler Reports ---
+// ========================
+
+// Cumulative results of all threads. Records can only be written by their owning thread, which is why instead of
+// resetting them we compute all reports as a difference of two collections, this gives us resets & deltas for free.
+struct _results {
+    time_point                  time = _program_entry_time_point;
+    std::size_t                 thread_count{};
+    std::vector<_record>        records;
+    std::vector<_call_tree_row> call_tree;
+    std::uint64_t               unprofiled_samples{};
+    std::vector<_ip_sample>     ip_samples;
+};
+
+inline _results _collect_results() {
+    _results results;
+    results.time         = clock::now();
+    results.thread_count = _registry::instance().thread_count();
+    results.records      = _registry::instance().collect_records();
+#if defined(UTL_PROFILER_OPTION_CALL_TREE) || defined(UTL_PROFILER_OPTION_SAMPLING)
+    results.call_tree = _registry::instance().collect_call_tree();
+#endif
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    results.unprofiled_samples = _registry::instance().collect_unprofiled_samples();
+#endif
+#ifdef UTL_PROFILER_OPTION_SAMPLING_IP
+    results.ip_samples = _registry::instance().collect_ip_samples();
+#endif
+    return results;
+}
+
+// Profiling results over some period of time
+struct snapshot {
+    duration                    runtime{};
+    std::size_t                 thread_count{};
+    std::vector<_record>        records;            // merged across threads, sorted by time
+    std::vector<_record>        per_thread_records; // sorted by time
+    std::vector<_call_tree_row> call_tree;          // empty unless call tree or sampling is enabled
+    std::uint64_t               unprofiled_samples{};
+    std::vector<_ip_sample>     ip_samples; // merged across threads, sorted by samples
+};
+
+inline void _sort_records(std::vector<_record>& records) {
+    std::stable_sort(records.begin(), records.end(),
+                     [](const _record& l, const _record& r) { return l.accumulated_time > r.accumulated_time; });
+}
+
+inline std::vector<_record> _merge_records(const std::vector<_record>& per_thread_records) {
+    std::vector<_record> result;
+    for (const auto& record : per_thread_records) {
+        const auto it = std::find_if(result.begin(), result.end(),
+                                     [&](const _record& e) { return e.callsite == record.callsite; });
+        if (it == result.end()) {
+            result.push_back(record);
+            result.back().thread = 0;
+        } else {
+            it->accumulated_time += record.accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+            it->statistics.merge(record.statistics);
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+            it->counters.merge(record.counters);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+            it->allocations.merge(record.allocations);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+            it->overhead.merge(record.overhead);
+#endif
+        }
+    }
+    return result;
+}
+
+inline snapshot _make_snapshot(const _results& current, const _results& baseline) {
+    snapshot result;
+    result.runtime      = current.time - baseline.time;
+    result.thread_count = current.thread_count;
+
+    // Records & call tree nodes are never removed, everything in the baseline is also present in current results
+    std::map<std::pair<const _callsite*, std::size_t>, const _record*> baseline_records;
+    for (const auto& record : baseline.records) baseline_records[{record.callsite, record.thread}] = &record;
+
+    for (auto record : current.records) {
+        if (const auto it = baseline_records.find({record.callsite, record.thread}); it != baseline_records.end()) {
+            record.accumulated_time -= it->second->accumulated_time;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+            record.statistics.subtract(it->second->statistics);
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+            record.counters.subtract(it->second->counters);
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+            record.allocations.subtract(it->second->allocations);
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+            record.overhead.subtract(it->second->overhead);
+#endif
+        }
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+        _compensate_overhead(record);
+#endif
+        result.per_thread_records.push_back(record);
+    }
+
+    result.records = _merge_records(result.per_thread_records);
+    _sort_records(result.records);
+    _sort_records(result.per_thread_records);
+
+    std::map<const _call_tree_node*, const _call_tree_row*> baseline_nodes;
+    for (const auto& row : baseline.call_tree) baseline_nodes[row.node] = &row;
+
+    for (auto row : current.call_tree) {
+        if (const auto it = baseline_nodes.find(row.node); it != baseline_nodes.end()) {
+            row.calls -= it->second->calls;
+            row.inclusive_time -= it->second->inclusive_time;
+            row.exclusive_time -= it->second->exclusive_time;
+            row.self_samples -= it->second->self_samples;
+            row.total_samples -= it->second->total_samples;
+        }
+        result.call_tree.push_back(row);
+    }
+
+    result.unprofiled_samples = current.unprofiled_samples - baseline.unprofiled_samples;
+
+    std::map<std::uintptr_t, std::uint64_t> baseline_ip_samples;
+    for (const auto& sample : baseline.ip_samples) baseline_ip_samples[sample.ip] = sample.samples;
+
+    for (auto sample : current.ip_samples) {
+        if (const auto it = baseline_ip_samples.find(sample.ip); it != baseline_ip_samples.end())
+            sample.samples -= it->second;
+        if (sample.samples) result.ip_samples.push_back(sample);
+    }
+
+    std::stable_sort(result.ip_samples.begin(), result.ip_samples.end(),
+                     [](const _ip_sample& l, const _ip_sample& r) { return l.samples > r.samples; });
+
+    return result;
+}
+
+struct _baseline {
+    std::mutex mutex;
+    _results   results; // defaults to the program start
+};
+
+inline _baseline& _reset_baseline() {
+    static _baseline baseline;
+    return baseline;
+}
+
+// Returns results accumulated since the program start or the last 'reset()', can be called from any thread
+inline snapshot get_snapshot() {
+    const _results current = _collect_results();
+
+    _baseline&            baseline = _reset_baseline();
+    const std::lock_guard lock(baseline.mutex);
+    return _make_snapshot(current, baseline.results);
+}
+
+inline void reset() {
+    _results current = _collect_results();
+
+    _baseline&            baseline = _reset_baseline();
+    const std::lock_guard lock(baseline.mutex);
+    baseline.results = std::move(current);
+}
+
+// --- Optional columns ---
+// ------------------------
+
+// Optional features add the same set of values to every record. Machine-readable formats get call count,
+// durations in nanoseconds and total counter values, tables get human-readable per-call values instead.
+using _record_fields = std::vector<std::pair<std::string_view, std::int64_t>>;
+
+inline _record_fields _optional_fields([[maybe_unused]] const _record& record) {
+    _record_fields fields;
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    const _statistics& stats = record.statistics;
+    const auto         ns    = [&](duration time) { return stats.calls ? _duration_to_ns(time) : std::int64_t(0); };
+
+    fields.insert(fields.end(), {{"calls", static_cast<std::int64_t>(stats.calls)},
+                                 {"mean_ns", stats.calls ? _duration_to_ns(record.accumulated_time / stats.calls) : 0},
+                                 {"min_ns", ns(stats.min)},
+                                 {"p50_ns", ns(stats.percentile(0.50))},
+                                 {"p90_ns", ns(stats.percentile(0.90))},
+                                 {"p99_ns", ns(stats.percentile(0.99))},
+                                 {"max_ns", ns(stats.max)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    const _counters& counters = record.counters;
+    const auto       total    = [&](std::size_t i) { return static_cast<std::int64_t>(counters.values[i]); };
+
+#ifndef UTL_PROFILER_OPTION_STATISTICS
+    fields.push_back({"calls", static_cast<std::int64_t>(counters.calls)});
+#endif
+    fields.insert(fields.end(), {{"cycles", total(0)},
+                                 {"instructions", total(1)},
+                                 {"cache_misses", total(2)},
+                                 {"branch_misses", total(3)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    const _allocations& allocations = record.allocations;
+
+    fields.insert(fields.end(), {{"allocations", static_cast<std::int64_t>(allocations.count)},
+                                 {"allocated_bytes", static_cast<std::int64_t>(allocations.bytes)},
+                                 {"deallocations", static_cast<std::int64_t>(allocations.deallocations)}});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    fields.insert(fields.end(), {{"raw_time_ns", _duration_to_ns(record.overhead.raw_time)},
+                                 {"nested_calls", static_cast<std::int64_t>(record.overhead.nested_calls)}});
+#endif
+
+    return fields;
+}
+
+inline std::vector<std::string> _optional_header() {
+    std::vector<std::string> header;
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    header.insert(header.end(), {"Calls", "Mean", "Min", "p50", "p90", "p99", "Max"});
+#endif
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    header.insert(header.end(), {"Cycles/Call", "IPC", "Cache Misses/Call", "Branch Misses/Call"});
+#endif
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    header.insert(header.end(), {"Allocations", "Allocated", "Deallocations"});
+#endif
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    header.insert(header.end(), {"Raw Time", "Overhead %"});
+#endif
+    return header;
+}
+
+inline std::vector<std::string> _optional_columns([[maybe_unused]] const _record& record) {
+    std::vector<std::string> columns;
+
+#ifdef UTL_PROFILER_OPTION_STATISTICS
+    const _statistics& stats = record.statistics;
+
+    if (stats.calls)
+        columns.insert(columns.end(),
+                       {std::to_string(stats.calls), _format_latency(record.accumulated_time / stats.calls),
+                        _format_latency(stats.min), _format_latency(stats.percentile(0.50)),
+                        _format_latency(stats.percentile(0.90)), _format_latency(stats.percentile(0.99)),
+                        _format_latency(stats.max)});
+    else columns.insert(columns.end(), {"0", "-", "-", "-", "-", "-", "-"});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    const _counters& counters = record.counters;
+    const auto       per_call = [&](std::size_t i) { return double(counters.values[i]) / double(counters.calls); };
+
+    if (counters.calls && counters.values[0])
+        columns.insert(columns.end(), {_format_fixed(per_call(0), 0, ""),
+                                       _format_fixed(double(counters.values[1]) / double(counters.values[0]), 2, ""),
+                                       _format_fixed(per_call(2), 1, ""), _format_fixed(per_call(3), 1, "")});
+    else columns.insert(columns.end(), {"-", "-", "-", "-"});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+    const _allocations& allocations = record.allocations;
+
+    columns.insert(columns.end(), {std::to_string(allocations.count), _format_bytes(allocations.bytes),
+                                   std::to_string(allocations.deallocations)});
+#endif
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    const double raw_sec = _duration_to_sec(record.overhead.raw_time);
+    const double sec     = _duration_to_sec(record.accumulated_time);
+
+    columns.insert(columns.end(), {_format_fixed(raw_sec, 2, " s"),
+                                   raw_sec > 0. ? _format_fixed((raw_sec - sec) / raw_sec * 100., 1, "%") : "-"});
+#endif
+
+    return columns;
+}
+
+// --- Table format ---
+// --------------------
+
+inline std::string format_table(const snapshot& results) {
+    std::ostringstream os;
+
+    const auto runtime_sec = _duration_to_sec(results.runtime);
+
+    const auto format_time       = [](duration time) { return _format_fixed(_duration_to_sec(time), 2, " s"); };
+    const auto format_percentage = [&](duration time) -> std::string {
+        if (runtime_sec <= 0.) return "-"; // empty snapshot, for example right after a 'reset()'
+        return _format_fixed(_duration_to_sec(time) / runtime_sec * 100., 1, "%");
+    };
+
+    const auto append = [](std::vector<std::string>& row, const std::vector<std::string>& columns) {
+        row.insert(row.end(), columns.begin(), columns.end());
+    };
+
+    // Build result tables
+    std::vector<std::vector<std::string>> merged_table = {{"Call Site", "Label", "Time", "Time %"}};
+    append(merged_table.front(), _optional_header());
+    for (const auto& record : results.records) {
+        merged_table.push_back({_format_call_site(record.callsite->file, record.callsite->line, record.callsite->func),
+                                record.callsite->label, format_time(record.accumulated_time),
+                                format_percentage(record.accumulated_time)});
+        append(merged_table.back(), _optional_columns(record));
+    }
+
+    std::vector<std::vector<std::string>> per_thread_table = {{"Thread", "Call Site", "Label", "Time", "Time %"}};
+    append(per_thread_table.front(), _optional_header());
+    for (const auto& record : results.per_thread_records) {
+        per_thread_table.push_back(
+            {std::to_string(record.thread),
+             _format_call_site(record.callsite->file, record.callsite->line, record.callsite->func),
+             record.callsite->label, format_time(record.accumulated_time),
+             format_percentage(record.accumulated_time)});
+        append(per_thread_table.back(), _optional_columns(record));
+    }
+
+    // Print formatted profiler header, + 1 makes header hline extend 1 character past the table on both sides
+    constexpr std::string_view header_text = " UTL PROFILING RESULTS ";
+
+    std::size_t table_length = 1;
+    for (std::size_t i = 0; i < merged_table.front().size(); ++i) {
+        std::size_t column_width = 0;
+        for (const auto& row : merged_table) column_width = std::max(column_width, row[i].size());
+        table_length += column_width + 3;
+    }
+
+    const std::size_t header_left_pad  = (std::max(table_length, header_text.size()) - header_text.size()) / 2;
+    const std::size_t header_right_pad = std::max(table_length, header_text.size()) - header_text.size() -
+                                         header_left_pad;
+
+    os << "\n"
+       << std::string(header_left_pad + 1, '-') << header_text << std::string(header_right_pad + 1, '-') << '\n'
+       << "\n"
+       << " Total runtime -> " << _format_fixed(runtime_sec, 2, " sec\n") << "\n";
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    os << " Timer overhead -> " << _format_latency(_calibrated_overhead().per_call) << " per call, "
+       << _format_latency(_calibrated_overhead().per_nested) << " per nested scope (subtracted from time)\n\n";
+#endif
+
+    _print_table(os, merged_table);
+
+#ifdef UTL_PROFILER_OPTION_HARDWARE_COUNTERS
+    if (const std::string status = _counters_status(); !status.empty())
+        os << "\n Hardware counters are unavailable -> " << status << "\n";
+    else if (_counters_multiplexed.load())
+        os << "\n Hardware counters were multiplexed with other events, values are scaled estimates\n";
+#endif
+
+    // Per-thread breakdown only makes sense when several threads were profiled
+    if (results.thread_count > 1) {
+        os << "\n Per-thread results:\n\n";
+        _print_table(os, per_thread_table);
+    }
+
+    // Call tree labels are indented by depth and left-aligned, which we get by padding them to the same width,
+    // which has to be at least as wide as the column header, otherwise table would right-align them again
+    [[maybe_unused]] const auto tree_labels = [](const std::vector<_call_tree_row>& rows, std::string_view header) {
+        std::vector<std::string> labels;
+        std::size_t              width = header.size();
+        for (const auto& row : rows) {
+            labels.push_back(std::string(2 * row.depth, ' ') + row.callsite->label);
+            width = std::max(width, labels.back().size());
+        }
+        for (auto& label : labels) label.resize(width, ' ');
+        return labels;
+    };
+
+#ifdef UTL_PROFILER_OPTION_CALL_TREE
+    const auto call_tree_labels = tree_labels(results.call_tree, "Call Tree");
+
+    std::vector<std::vector<std::string>> call_tree_table = {
+        {"Thread", "Call Tree", "Call Site", "Calls", "Inclusive", "Exclusive", "Inclusive %"}};
+    for (std::size_t i = 0; i < results.call_tree.size(); ++i) {
+        const auto& row = results.call_tree[i];
+        call_tree_table.push_back(
+            {std::to_string(row.thread), call_tree_labels[i],
+             _format_call_site(row.callsite->file, row.callsite->line, row.callsite->func), std::to_string(row.calls),
+             format_time(row.inclusive_time), format_time(row.exclusive_time), format_percentage(row.inclusive_time)});
+    }
+
+    os << "\n Call tree:\n\n";
+    _print_table(os, call_tree_table);
+#endif
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    // Only stacks that were actually sampled are worth showing
+    std::vector<_call_tree_row> sampled_rows;
+    std::uint64_t               total_samples = results.unprofiled_samples;
+    for (const auto& row : results.call_tree) {
+        if (row.total_samples) sampled_rows.push_back(row);
+        total_samples += row.self_samples;
+    }
+
+    const auto format_sample_percentage = [&](std::uint64_t samples) {
+        return _format_fixed(total_samples ? 100. * double(samples) / double(total_samples) : 0., 1, "%");
+    };
+
+    os << "\n Sampling -> " << total_samples << " samples every " << UTL_PROFILER_OPTION_SAMPLING_INTERVAL_US
+       << " us of CPU time, " << results.unprofiled_samples << " ("
+       << format_sample_percentage(results.unprofiled_samples) << ") outside of profiled scopes\n";
+
+    if (const int error = _sampling_error.load())
+        os << "\n Sampling is unavailable -> " << std::system_category().message(error) << "\n";
+
+    const auto sampled_labels = tree_labels(sampled_rows, "Sampled Stack");
+
+    std::vector<std::vector<std::string>> sampling_table = {
+        {"Thread", "Sampled Stack", "Call Site", "Samples", "Self %", "Total %"}};
+    for (std::size_t i = 0; i < sampled_rows.size(); ++i) {
+        const auto& row = sampled_rows[i];
+        sampling_table.push_back({std::to_string(row.thread), sampled_labels[i],
+                                  _format_call_site(row.callsite->file, row.callsite->line, row.callsite->func),
+                                  std::to_string(row.self_samples), format_sample_percentage(row.self_samples),
+                                  format_sample_percentage(row.total_samples)});
+    }
+
+    os << "\n";
+    _print_table(os, sampling_table);
+#endif
+
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && defined(UTL_PROFILER_HAS_SAMPLING)
+    constexpr std::size_t max_instructions = 20;
+
+    std::vector<std::vector<std::string>> instruction_table = {
+        {"Address", "Samples", "Samples %", "Innermost Scope"}};
+    for (std::size_t i = 0; i < std::min(results.ip_samples.size(), max_instructions); ++i) {
+        const auto& sample = results.ip_samples[i];
+        instruction_table.push_back({_format_address(sample.ip), std::to_string(sample.samples),
+                                     format_sample_percentage(sample.samples),
+                                     sample.callsite ? sample.callsite->label : "-"});
+    }
+
+    os << "\n Hottest instructions:\n\n";
+    _print_table(os, instruction_table);
+#endif
+
+    return os.str();
+}
+
+// --- JSON format ---
+// -------------------
+
+inline void _write_json_record(std::ostream& os, const _record& record, bool with_thread) {
+    const _callsite& callsite = *record.callsite;
+
+    os << "{";
+    if (with_thread) os << "\"thread\":" << record.thread << ",";
+    os << "\"call_site\":";
+    _write_json_string(os, _format_call_site(callsite.file, callsite.line, callsite.func));
+    os << ",\"file\":";
+    _write_json_string(os, callsite.file);
+    os << ",\"line\":" << callsite.line << ",\"function\":";
+    _write_json_string(os, callsite.func);
+    os << ",\"label\":";
+    _write_json_string(os, callsite.label);
+    os << ",\"time_ns\":" << _duration_to_ns(record.accumulated_time);
+
+    for (const auto& [name, value] : _optional_fields(record)) os << ",\"" << name << "\":" << value;
+    os << "}";
+}
+
+// All durations are saved as integer nanoseconds, which keeps them exact
+inline std::string format_json(const snapshot& results) {
+    std::ostringstream os;
+
+    os << "{\n\"runtime_ns\":" << _duration_to_ns(results.runtime) << ",\n\"thread_count\":" << results.thread_count;
+
+#ifdef UTL_PROFILER_OPTION_OVERHEAD_COMPENSATION
+    os << ",\n\"timer_overhead\":{\"per_call_ns\":" << _duration_to_ns(_calibrated_overhead().per_call)
+       << ",\"per_nested_ns\":" << _duration_to_ns(_calibrated_overhead().per_nested) << '}';
+#endif
+
+    os << ",\n\"records\":[";
+    for (std::size_t i = 0; i < results.records.size(); ++i) {
+        os << (i ? ",\n" : "\n");
+        _write_json_record(os, results.records[i], false);
+    }
+
+    os << "\n],\n\"per_thread_records\":[";
+    for (std::size_t i = 0; i < results.per_thread_records.size(); ++i) {
+        os << (i ? ",\n" : "\n");
+        _write_json_record(os, results.per_thread_records[i], true);
+    }
+
+    os << "\n],\n\"call_tree\":[";
+    for (std::size_t i = 0; i < results.call_tree.size(); ++i) {
+        const auto&      row      = results.call_tree[i];
+        const _callsite& callsite = *row.callsite;
+
+        os << (i ? ",\n" : "\n") << "{\"thread\":" << row.thread << ",\"depth\":" << row.depth << ",\"call_site\":";
+        _write_json_string(os, _format_call_site(callsite.file, callsite.line, callsite.func));
+        os << ",\"label\":";
+        _write_json_string(os, callsite.label);
+        os << ",\"calls\":" << row.calls << ",\"inclusive_ns\":" << _duration_to_ns(row.inclusive_time)
+           << ",\"exclusive_ns\":" << _duration_to_ns(row.exclusive_time);
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+        os << ",\"self_samples\":" << row.self_samples << ",\"total_samples\":" << row.total_samples;
+#endif
+        os << "}";
+    }
+    os << "\n]";
+
+#ifdef UTL_PROFILER_OPTION_SAMPLING
+    os << ",\n\"unprofiled_samples\":" << results.unprofiled_samples;
+#endif
+
+#if defined(UTL_PROFILER_OPTION_SAMPLING_IP) && defined(UTL_PROFILER_HAS_SAMPLING)
+    os << ",\n\"instructions\":[";
+    for (std::size_t i = 0; i < results.ip_samples.size(); ++i) {
+        const auto& sample = results.ip_samples[i];
+
+        os << (i ? ",\n" : "\n") << "{\"address\":";
+        _write_json_string(os, _format_address(sample.ip));
+        os << ",\"label\":";
+        _write_json_string(os, sample.callsite ? sample.callsite->label : "");
+        os << ",\"samples\":" << sample.samples << "}";
+    }
+    os << "\n]";
+#endif
+
+    os << "\n}\n";
+
+    return os.str();
+}
+
+// --- CSV format ---
+// ------------------
+
+// Per-thread records followed by the merged ones, merged records have 'all' in the thread column
+inline std::string format_csv(const snapshot& results) {
+    std::ostringstream os;
+
+    os << "thread,file,line,function,label,time_ns";
+    for (const auto& field : _optional_fields(_record{})) os << ',' << field.first;
+    os << '\n';
+
+    const auto write_record = [&](const _record& record, std::string_view thread) {
+        os << thread << ',';
+        _write_csv_string(os, record.callsite->file);
+        os << ',' << record.callsite->line << ',';
+        _write_csv_string(os, record.callsite->func);
+        os << ',';
+        _write_csv_string(os, record.callsite->label);
+        os << ',' << _duration_to_ns(record.accumulated_time);
+        for (const auto& field : _optional_fields(record)) os << ',' << field.second;
+        os << '\n';
+    };
+
+    for (const auto& record : results.per_thread_records) write_record(record, std::to_string(record.thread));
+    for (const auto& record : results.records) write_record(record, "all");
+
+    return os.str();
+}
+
+// --- Periodic reporter ---
+// -------------------------
+
+// Calls 'callback' every 'period' with the results accumulated since the previous report, reporting stops upon
+// destruction. Reports are computed the same way as 'reset()' but don't affect it or any other reporters.
+class periodic_reporter {
+private:
+    std::mutex              mutex;
+    std::condition_variable stop_condition;
+    bool                    stop_requested = false;
+    std::thread             thread;
+
+    static void print_table(const snapshot& results) { std::cout << format_table(results) << std::flush; }
+
+public:
+    template <class Rep, class Period>
+    periodic_reporter(std::chrono::duration<Rep, Period>      period,
+                      std::function<void(const snapshot&)> callback = print_table) {
+        // Deadlines are scheduled from the start, so the period doesn't drift with the time spent on reports
+        const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+
+        this->thread = std::thread([this, step, callback = std::move(callback)] {
+            _results previous = _collect_results();
+            auto     deadline = std::chrono::steady_clock::now() + step;
+
+            std::unique_lock lock(this->mutex);
+            while (!this->stop_condition.wait_until(lock, deadline, [this] { return this->stop_requested; })) {
+                lock.unlock();
+
+                _results current = _collect_results();
+                callback(_make_snapshot(current, previous));
+                previous = std::move(current);
+                deadline += step;
+
+                lock.lock();
+            }
+        });
+    }
+
+    periodic_reporter(const periodic_reporter&)            = delete;
+    periodic_reporter& operator=(const periodic_reporter&) = delete;
+
+    ~periodic_reporter() {
+        {
+            const std::lock_guard lock(this->mutex);
+            this->stop_requested = true;
+        }
+        this->stop_condition.notify_one();
+        this->thread.join();
+    }
+};
+
+// --- Trace export ---
+// --------------------
+
+#ifndef UTL_PROFILER_OPTION_TRACE_FILE
+#define UTL_PROFILER_OPTION_TRACE_FILE "profiler_trace.json"
+#endif
+
+// Trace format expects microseconds, we print them with a fixed nanosecond precision using integer math,
+// which is both faster than float formatting and keeps large timestamps exact
+inline void _write_trace_microseconds(std::ostream& os, duration time) {
+    const auto ns = std::max(_duration_to_ns(time), std::int64_t(0));
+
+    const auto fraction = ns % 1000;
+    os << ns / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+
+// Writes all recorded events in a Chrome Trace Event format, which can be viewed with 'chrome://tracing',
+// 'https://ui.perfetto.dev' or 'https://www.speedscope.app'. Each scope execution gets saved as a single
+// "complete" event that contains both its start and its duration.
+inline void _write_trace(std::ostream& os) {
+    const auto traces = _registry::instance().collect_trace();
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& trace : traces) {
+        os << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace.thread
+           << ",\"args\":{\"name\":\"Thread " << trace.thread << "\"}}";
+        first = false;
+
+        for (const auto& event : trace.events) {
+            const _callsite& callsite  = *event.callsite;
+            const std::string call_site = _format_call_site(callsite.file, callsite.line, callsite.func);
+
+            os << ",\n{\"name\":";
+            _write_json_string(os, *callsite.label ? std::string_view(callsite.label) : std::string_view(call_site));
+            os << ",\"cat\":\"utl\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace.thread << ",\"ts\":";
+            _write_trace_microseconds(os, event.start - _program_entry_time_point);
+            os << ",\"dur\":";
+            _write_trace_microseconds(os, event.time);
+            os << ",\"args\":{\"call_site\":";
+            _write_json_string(os, call_site);
+            os << "}}";
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+inline void _utl_profiler_atexit() {
+    std::ostream& os = std::cout;
+
+    os << format_table(get_snapshot());
+
+#ifdef UTL_PROFILER_OPTION_TRACE
+    std::ofstream trace_file(UTL_PROFILER_OPTION_TRACE_FILE);
+    _write_trace(trace_file);
+
+    os << "\n Trace saved to -> " << UTL_PROFILER_OPTION_TRACE_FILE << "\n";
+#endif
+}
+
+// ========================
+// --- Profiler Codegen ---
+// ========================
+
+#define _utl_profiler_concat_tokens(a, b) a##b
+#define _utl_profiler_concat_tokens_wrapper(a, b) _utl_profiler_concat_tokens(a, b)
+#define _utl_profiler_add_uuid(varname_) _utl_profiler_concat_tokens_wrapper(varname_, __LINE__)
+// This macro creates token 'varname_##__LINE__' from 'varname_'.
+//
+// The reason we can't just write it as is, is that function-macros only expands their macro-arguments
+// if neither the stringizing operator # nor the token-pasting operator ## are applied to the arguments
+// inside the macro body.
+//
+// Which means in a simple 'varname_##__LINE__' macro '__LINE__' doesn't expand to it's value.
+//
+// We can get around this fact by introducing indirection,
+// '__LINE__' gets expanded in '_utl_profiler_concat_tokens_wrapper()'
+// and then tokenized and concatenated in '_utl_profiler_concat_tokens()'
+
+// --- Scope profiling ---
+// -----------------------
+
+#define UTL_PROFILER(label_)                                                                                           \
+    constexpr bool _utl_profiler_add_uuid(utl_profiler_macro_guard_) = true;                                           \
+                                                                                                                       \
+    static_assert(_utl_profiler_add_uuid(utl_profiler_macro_guard_), "UTL_PROFILE is a multi-line macro.");            \
+                                                                                                                       \
+    static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
+                                                                                               __func__, label_);      \
+                                                                                                                       \
+    thread_local utl::profiler::_thread_record* _utl_profiler_add_uuid(utl_profiler_thread_record_) =                  \
+        _utl_profiler_add_uuid(utl_profiler_record_manager_).thread_record();                                          \
+                                                                                                                       \
+    if constexpr (const utl::profiler::_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){                 \
+                      _utl_profiler_add_uuid(utl_profiler_thread_record_)})
+// Note 1:
+//
+//    constexpr bool ... = true;
+//    static_assert(..., "UTL_PROFILE is a multi-line macro.");
+//
+// is reponsible for preventing accidental errors caused by using macro like this:
+//
+//    for (...) UTL_PROFILER("") function(); // will only loop the first line of the multi-line macro
+//
+// If someone tries to write it like this, the constexpr bool variable will be "pulled" into a narrower scope,
+// causing 'static_assert()' to fail due to using undeclared identifier. Since the line with undeclared identifier
+// gets expanded, the user will be able to see the assert message.
+//
+// Note 2:
+//
+// By separating "record management" into a static variable and "actual timing" into a non-static one,
+// we can avoid additional overhead from having to locate the record, corresponding to the profiled source location.
+// (an operation that requires a non-trivial vector/map lookup with string comparisons)
+//
+// Static variable initializes its record once and timer does the bare minimum of work - 2 calls to 'now()' to get
+// timing, one addition to accumulated time and a check for recursion (so it can skip time appropriately).
+//
+// 'thread_local' pointer does the same thing for per-thread records, each thread creates its record for the callsite
+// once, after which the only overhead is the access to a thread-local variable.
+//
+//  Note 3:
+//
+// _utl_profiler_add_uuid(...) ensures no identifier collisions when several profilers exist in a single scope.
+// Since in this context 'uuid' is a line number, the only case in which ids can collide is when multiple profilers
+// are declated on the same line, which I assume no sane person would do. And even if they would, that would simply
+// lead to a compiler error. Can't really do better than that without resorting to non-standard macros like
+// '__COUNTER__' for 'uuid' creation
+
+#define UTL_PROFILER_EXCLUSIVE(label_)                                                                                 \
+    constexpr bool _utl_profiler_add_uuid(utl_profiler_macro_guard_) = true;                                           \
+                                                                                                                       \
+    static_assert(_utl_profiler_add_uuid(utl_profiler_macro_guard_), "UTL_PROFILER_EXCLUSIVE is a multi-line macro."); \
+                                                                                                                       \
+    static utl::profiler::_record_manager _utl_profiler_add_uuid(utl_profiler_record_manager_)(__FILE__, __LINE__,     \
+                                                                                               __func__, label_);      \
+                                                                                                                       \
+    thread_local utl::profiler::_thread_record* _utl_profiler_add_uuid(utl_profiler_thread_record_) =                  \
+        _utl_profiler_add_uuid(utl_profiler_record_manager_).thread_record();                                          \
+                                                                                                                       \
+    if constexpr (const utl::profiler::_exclusive_scope_timer _utl_profiler_add_uuid(utl_profiler_scope_timer_){       \
+                      _utl_profiler_add_uuid(utl_profiler_thread_record_)})
+// Note:
+//
+// Exact same thing as a regular UTL_PROFILER() but uses '_exclusive_scope_timer' instead.
+// The reason we need this for recursion is nicely explained in the docs.
+
+// --- Segment profiling ---
+// -------------------------
+
+#define UTL_PROFILER_BEGIN(segment_label_, label_)                                                                     \
+    static utl::profiler::_record_manager       utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__,       \
+                                                                                             __func__, label_);        \
+    thread_local utl::profiler::_thread_record* utl_profiler_thread_record_##segment_label_ =                          \
+        utl_profiler_record_manager_##segment_label_.thread_record();                                                  \
+    utl::profiler::_segment_timer utl_profiler_segment_timer_##segment_label_(                                         \
+        utl_profiler_thread_record_##segment_label_)
+
+#define UTL_PROFILER_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
+// Note 1:
+//
+// Last semicolon is intentiomally skipped so macro requires it at the end and
+// doesn't mess up auto code formatters that have a dislike for statement macros.
+//
+// Note 2:
+//
+// The idea here exactly the same as with scope profiles, except instead of '_scope_timer' we use '_segment_timer'
+// that records time on a '.finish()' call instead of destructor. We can put this call inside the END macro
+// and have a nice 2-macro API for profiling segments without creating a scope.
+
+#define UTL_PROFILER_EXCLUSIVE_BEGIN(segment_label_, label_)                                                           \
+    static utl::profiler::_record_manager       utl_profiler_record_manager_##segment_label_(__FILE__, __LINE__,       \
+                                                                                             __func__, label_);        \
+    thread_local utl::profiler::_thread_record* utl_profiler_thread_record_##segment_label_ =                          \
+        utl_profiler_record_manager_##segment_label_.thread_record();                                                  \
+    utl::profiler::_exclusive_segment_timer utl_profiler_segment_timer_##segment_label_(                               \
+        utl_profiler_thread_record_##segment_label_)
+
+#define UTL_PROFILER_EXCLUSIVE_END(segment_label_) utl_profiler_segment_timer_##segment_label_.finish()
+
+// --- Allocation hooks ---
+// ------------------------
+
+#ifdef UTL_PROFILER_OPTION_ALLOCATIONS
+#define UTL_PROFILER_ALLOCATION_HOOKS                                                                                  \
+    void* operator new(std::size_t size) { return utl::profiler::_allocate(size); }                                    \
+    void* operator new[](std::size_t size) { return utl::profiler::_allocate(size); }                                  \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                                             \
+        return utl::profiler::_allocate_nothrow(size);                                                                 \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {                                           \
+        return utl::profiler::_allocate_nothrow(size);                                                                 \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t align) {                                                     \
+        return utl::profiler::_allocate(size, static_cast<std::size_t>(align));                                        \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t align) {                                                   \
+        return utl::profiler::_allocate(size, static_cast<std::size_t>(align));                                        \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {                     \
+        return utl::profiler::_allocate_nothrow(size, static_cast<std::size_t>(align));                                \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {                   \
+        return utl::profiler::_allocate_nothrow(size, static_cast<std::size_t>(align));                                \
+    }                                                                                                                  \
+    void operator delete(void* ptr) noexcept { utl::profiler::_deallocate(ptr); }                                      \
+    void operator delete[](void* ptr) noexcept { utl::profiler::_deallocate(ptr); }                                    \
+    void operator delete(void* ptr, std::size_t) noexcept { utl::profiler::_deallocate(ptr); }                         \
+    void operator delete[](void* ptr, std::size_t) noexcept { utl::profiler::_deallocate(ptr); }                       \
+    void operator delete(void* ptr, const std::nothrow_t&) noexcept { utl::profiler::_deallocate(ptr); }               \
+    void operator delete[](void* ptr, const std::nothrow_t&) noexcept { utl::profiler::_deallocate(ptr); }             \
+    void operator delete(void* ptr, std::align_val_t) noexcept { utl::profiler::_deallocate(ptr, true); }              \
+    void operator delete[](void* ptr, std::align_val_t) noexcept { utl::profiler::_deallocate(ptr, true); }            \
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {                                          \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {                                        \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                                \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                              \
+        utl::profiler::_deallocate(ptr, true);                                                                         \
+    }                                                                                                                  \
+    static_assert(true)
+#else
+#define UTL_PROFILER_ALLOCATION_HOOKS static_assert(true)
+#endif
+// Note:
+//
+// Replacement 'operator new' & 'operator delete' can't be 'inline' and have to be defined in exactly one translation
+// unit, which is something a header can't do by itself, this is why hooks are a separate macro that should be
+// expanded once at the global scope of some '.cpp' file. Without hooks allocation tracking simply records nothing.
+//
+// Last 'static_assert(true)' is only there so the macro requires a semicolon at the end.
+
+} // namespace utl::profiler
+
+#endif
+#endif // macro-module UTL_PROFILER
+
+
+
+
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Module:        utl::progressbar
+// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_progressbar.md
+// Source repo:   https://github.com/DmitriBogdanov/UTL
+//
+// This project is licensed under the MIT License
+//
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_PROGRESSBAR)
+#ifndef UTLHEADERGUARD_PROGRESSBAR
+#define UTLHEADERGUARD_PROGRESSBAR
+
+// _______________________ INCLUDES _______________________
+
+#include <algorithm> // fill_n
+#include <chrono>    // chrono::steady_clock, chrono::time_point<>, chrono::duration_cast<>, chrono::seconds
+#include <cmath>     // floor()
+#include <cstddef>   // size_t
+#include <iomanip>   // setprecision()
+#include <ios>       // fixed
+#include <iostream>  // cout
+#include <iterator>  // ostreambuf_iterator<>
+#include <ostream>   // ostream
+#include <sstream>   // ostringstream
+#include <string>    // string
+
+// ____________________ DEVELOPER DOCS ____________________
+
+// Simple progress bars for terminal applications. Rendered in ASCII on the main thread with manual updates
+// for maximal compatibility. Perhaps can be extended with some fancier async options that display animations.
+//
+// # ::set_ostream() #
+// Sets ostream used for progress bars.
+//
+// # ::Percentage #
+// Proper progress bar, uses carriage return escape sequence (\r) to render new states in the same spot.
+// Shows an estimate of remaining time.
+//
+// # ::Ruler #
+// Primitive & lightweight progress bar, useful when terminal has no proper support for escape sequences.
+
+// ____________________ IMPLEMENTATION ____________________
+
+namespace utl::progressbar {
+
+inline std::ostream* _output_stream = &std::cout;
+
+inline void set_ostream(std::ostream& new_ostream) { _output_stream = &new_ostream; }
+
+class Percentage {
+private:
+    char done_char;
+    char not_done_char;
+    bool show_time_estimate;
+
+    std::size_t length_total;   // full   bar length
+    std::size_t length_current; // filled bar length
+
+    double last_update_percentage;
+    double update_rate;
+
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+
+    TimePoint timepoint_start; // used to estimate remaining time
+    TimePoint timepoint_current;
+
+    int previous_string_length; // used to properly return the carriage when dealing with changed string size
+
+    void draw_progressbar(double percentage) {
+        const auto displayed_percentage = this->update_rate * std::floor(percentage / this->update_rate);
+        // floor percentage to a closest multiple of 'update_rate' for nicer display
+        // since actual updates are only required to happen no more ofter than 'update_rate'
+        // and don't have to correspond to exact multiples of it
+
+        // Estimate remaining time (linearly) and format it min + sec
+        const auto time_elapsed       = this->timepoint_current - this->timepoint_start;
+        const auto estimate_full      = time_elapsed / percentage;
+        const auto estimate_remaining = estimate_full - time_elapsed;
+
+        const auto estimate_remaining_sec = std::chrono::duration_cast<std::chrono::seconds>(estimate_remaining);
+
+        const auto displayed_min = (estimate_remaining_sec / 60ll).count();
+        const auto displayed_sec = (estimate_remaining_sec % 60ll).count();
+
+        const bool show_min  = (displayed_min != 0);
+        const bool show_sec  = (displayed_sec != 0) && !show_min;
+        const bool show_time = (estimate_remaining_sec.count() > 0);
+
+        std::ostringstream ss;
+
+        // Print bar
+        ss << '[';
+        std::fill_n(std::ostreambuf_iterator<char>(ss), this->length_current, this->done_char);
+        std::fill_n(std::ostreambuf_iterator<char>(ss), this->length_total - this->length_current, this->not_done_char);
+        ss << ']';
+
+        // Print percentage
+        ss << ' ' << std::fixed << std::setprecision(2) << 100. * displayed_percentage << '%';
+
+        // Print time estimate
+        if (this->show_time_estimate && show_time) {
+            ss << " (remaining:";
+            if (show_min) ss << ' ' << displayed_min << " min";
+            if (show_sec) ss << ' ' << displayed_sec << " sec";
+            ss << ')';
+        }
+
+        const std::string bar_string = ss.str();
+
+        // Add spaces at the end to overwrite the previous string if it was longer that current
+        const int current_string_length = static_cast<int>(bar_string.length());
+        const int string_length_diff    = this->previous_string_length - current_string_length;
+
+        if (string_length_diff > 0) { std::fill_n(std::ostreambuf_iterator<char>(ss), string_length_diff, ' '); }
+
+        this->previous_string_length = current_string_length;
+
+        // Return the carriage
+        (*_output_stream) << ss.str(); // don't reuse 'bar_string', now 'ss' can also contain spaces at the end
+        (*_output_stream) << '\r';
+        (*_output_stream).flush();
+        // '\r' returns cursor to the beginning of the line => most sensible consoles will
+        // render render new lines over the last one. Otherwise every update produces a
+        // bar on a new line, which looks worse but isn't critical for the purpose.
+    }
+
+public:
+    Percentage(char done_char = '#', char not_done_char = '.', std::size_t bar_length = 30, double update_rate = 1e-2,
+               bool show_time_estimate = true)
+        : done_char(done_char), not_done_char(not_done_char), show_time_estimate(show_time_estimate),
+          length_total(bar_length), length_current(0), last_update_percentage(0), update_rate(update_rate),
+          timepoint_start(Clock::now()), previous_string_length(static_cast<int>(bar_length) + sizeof("[] 100.00%")) {}
+
+    void start() {
+        this->last_update_percentage = 0.;
+        this->length_current         = 0;
+        this->timepoint_start        = Clock::now();
+        (*_output_stream) << '\n';
+    }
+
+    void set_progress(double percentage) {
+        if (percentage - this->last_update_percentage <= this->update_rate) return;
+
+        this->last_update_percentage = percentage;
+        this->length_current         = static_cast<std::size_t>(percentage * static_cast<double>(this->length_total));
+        this->timepoint_current      = Clock::now();
+        this->draw_progressbar(percentage);
+    }
+
+    void finish() {
+        this->last_update_percentage = 1.;
+        this->length_current         = this->length_total;
+        this->draw_progressbar(1.);
+        (*_output_stream) << '\n';
+    }
+};
+
+class Ruler {
+private:
+    char done_char;
+
+    std::size_t length_total;
+    std::size_t length_current;
+
+public:
+    Ruler(char done_char = '#') : done_char(done_char), length_total(51), length_current(0) {}
+
+    void start() {
+        this->length_current = 0;
+
+        (*_output_stream) << '\n'
+                          << " 0    10   20   30   40   50   60   70   80   90   100%\n"
+                          << " |----|----|----|----|----|----|----|----|----|----|\n"
+                          << ' ';
+    }
+
+    void set_progress(double percentage) {
+        const std::size_t length_new = static_cast<std::size_t>(percentage * static_cast<double>(this->length_total));
+
+        if (length_new > length_current) {
+            const auto chars_to_add = length_new - this->length_current;
+            std::fill_n(std::ostreambuf_iterator<char>(*_output_stream), chars_to_add, this->done_char);
+        }
+
+        this->length_current = length_new;
+    }
+
+    void finish() {
+        if (this->length_total > this->length_current) {
+            const auto chars_to_add = this->length_total - this->length_current;
+            std::fill_n(std::ostreambuf_iterator<char>(*_output_stream), chars_to_add, this->done_char);
+        }
+
+        this->length_current = this->length_total;
+
+        (*_output_stream) << '\n';
+    }
+};
+
+} // namespace utl::progressbar
+
+#endif
+#endif // module utl::progressbar
+
+
+
+
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DmitriBogdanov/UTL ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Module:        utl::random
+// Documentation: https://github.com/DmitriBogdanov/UTL/blob/master/docs/module_random.md
+// Source repo:   https://github.com/DmitriBogdanov/UTL
+//
+// This project is licensed under the MIT License
+//
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if !defined(UTL_PICK_MODULES) || defined(UTLMODULE_RANDOM)
+#ifndef UTLHEADERGUARD_RANDOM
+#define UTLHEADERGUARD_RANDOM
+
+// _______________________ INCLUDES _______________________
+
+#include <algorithm>        // min(), max(), lower_bound(), upper_bound(), sort()
+#include <array>            // array<>
+#include <atomic>           // atomic<>
+#include <chrono>           // high_resolution_clock
+#include <cmath>            // exp(), log(), log1p(), floor(), abs(), pow()
+#include <cstddef>          // size_t
+#include <cstdint>          // uint64_t
+#include <initializer_list> // initializer_list<>
+#include <iterator>         // data(), size(), iterator_traits<>
+#include <limits>           // numeric_limits<>::digits, numeric_limits<>::min(), numeric_limits<>::max()
+#include <mutex>            // mutex, lock_guard<>
+#include <random>           // random_device, seed_seq
+#include <stdexcept>        // invalid_argument, out_of_range
+#include <string>           // to_string()
+#include <thread>           // thread, thread::hardware_concurrency()
+#include <type_traits>      // is_integral_v<>, remove_reference_t<>, is_trivially_copyable_v<>
+#include <utility>          // declval<>(), swap()
+#include <vector>           // vector<>
+
+// SIMD can't be used in 'constexpr' context, C++17 has no 'std::is_constant_evaluated()' so we rely on a builtin
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define UTL_RANDOM_HAS_IS_CONSTANT_EVALUATED
+#endif
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define UTL_RANDOM_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+#if defined(UTL_RANDOM_HAS_IS_CONSTANT_EVALUATED) && defined(__AVX2__)
+#define UTL_RANDOM_HAS_AVX2
+#include <immintrin.h> // __m256i, _mm256_...()
+#endif
+
+#if defined(UTL_RANDOM_HAS_IS_CONSTANT_EVALUATED) &&                                                                   \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UTL_RANDOM_HAS_SSE2
+#include <emmintrin.h> // __m128i, _mm_...()
+#endif
+
+// ____________________ DEVELOPER DOCS ____________________
+
+// Implements a proper modern PRNG engine, compatible with std <random>.
+// Adds 'sensible std <random> wrappers' for people who aren't fond of writing
+// 3 lines code just to get a simple rand value.
+//
+// # XorShift64StarGenerator #
+// Random 'std::uint64_t' generator that satisfies uniform random number generator requirements
+// from '<random>' (see https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+// Implementation "XorShift64* suggested by Marsaglia G. in 2003 "Journal of Statistical Software"
+// (see https://www.jstatsoft.org/article/view/v008i14).
+// Slightly faster than 'std::rand()', while providing higher quality random.
+// Significantly faster than 'std::mt19937'.
+// State consists of a single 'std::uint64_t', requires seed >= 1.
+//
+// # thread_generator(), default_generator #
+// Thread-local instance of the default generator, seeded from the global seed & thread index.
+// 'default_generator' is a handle that can be passed to the standard algorithms, it forwards to the same generator.
+//
+// # ::seed(), ::seed_with_time(), ::seed_with_random_device(), ::seed_thread() #
+// Seeds random with value/current_time/random_device, 'seed_thread()' pins the index of the current thread.
+// Random device is a better source of entropy, however it's more expensive to initialize
+// than just taking current time with <ctime>, in some cases a "worse by lightweigh" can
+// be prefered.
+//
+// # ::rand_int(), ::rand_uint(), ::rand_float(), ::rand_double() #
+// Random value in [min, max] range.
+// Floats with no parameters assume range [0, 1].
+//
+// # ::rand_bool() #
+// Randomly chooses 0 or 1.
+//
+// # ::rand_choise() #
+// Randomly chooses a value from initializer list.
+//
+// # ::rand_linear_combination() #
+// Produces "c A + (1-c) B" with random "0 < c < 1" assuming objects "A", "B" support arithmetic operations.
+// Useful for vector and color operations.
+
+// ____________________ IMPLEMENTATION ____________________
+
+namespace utl::random {
+
+// ============================
+// --- Implementation utils ---
+// ============================
+
+#define utl_random_define_trait(trait_name_, ...)                                                                      \
+    template <class T, class = void>                                                                                   \
+    struct trait_name_ : std::false_type {};                                                                           \
+                                                                                                                       \
+    template <class T>                                                                                                 \
+    struct trait_name_<T, std::void_t<decltype(__VA_ARGS__)>> : std::true_type {};                                     \
+                                                                                                                       \
+    template <class T>                                                                                                 \
+    constexpr bool trait_name_##_v = trait_name_<T>::value;                                                            \
+                                                                                                                       \
+    template <class T>                                                                                                 \
+    using trait_name_##_enable_if = std::enable_if_t<trait_name_<T>::value, bool>
+
+
+utl_random_define_trait(_is_seed_seq,
+                        std::declval<T>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()));
+// this type trait is necessary to restrict template constructors & seed function that take 'SeedSeq&& seq', otherwise
+// they will get pick instead of regular seeding methods for even for integer conversions. This is how standard library
+// seems to do it (based on GCC implementation) so we follow their API.
+
+utl_random_define_trait(_is_generator, typename T::result_type{}, std::declval<T&>()());
+utl_random_define_trait(_is_contiguous_container, std::data(std::declval<T&>()), std::size(std::declval<T&>()));
+utl_random_define_trait(_is_splittable, std::declval<T&>().split());
+
+#undef utl_random_define_trait
+
+// A 'lightweight' PRNG used by some other engines to initialize their state
+constexpr std::uint32_t _splitmix32(std::uint32_t& state) noexcept {
+    uint32_t result = (state += 0x9e3779b9);
+    result          = (result ^ (result >> 16)) * 0x21f0aaad;
+    result          = (result ^ (result >> 15)) * 0x735a2d97;
+    return result ^ (result >> 15);
+}
+
+constexpr std::uint64_t _splitmix64(std::uint64_t& state) noexcept {
+    std::uint64_t result = (state += 0x9E3779B97f4A7C15);
+    result               = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+    result               = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+    return result ^ (result >> 31);
+}
+
+// Merging integers into the bits of a larger one
+[[nodiscard]] constexpr std::uint64_t _merge_uint32_into_uint64(std::uint32_t a, std::uint32_t b) {
+    return static_cast<std::uint64_t>(a) | (static_cast<std::uint64_t>(b) << 32);
+}
+
+// Helper method to crush large uints to uint32_t,
+// inspired by Melissa E. O'Neil's randutils https://gist.github.com/imneme/540829265469e673d045
+template <class T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= 8, bool> = true>
+[[nodiscard]] constexpr std::uint32_t _crush_to_uint32(T value) {
+    if constexpr (sizeof(value) <= 4) {
+        return std::uint32_t(value);
+    } else {
+        std::uint64_t res = value;
+        res *= 0xbc2ad017d719504d;
+        return static_cast<std::uint32_t>(res ^ (res >> 32));
+    }
+}
+
+// Seed sequence helpers
+template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+std::uint32_t _seed_seq_to_uint32(SeedSeq&& seq) {
+    std::array<std::uint32_t, 1> temp;
+    seq.generate(temp.begin(), temp.end());
+    return temp[0];
+}
+
+template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+std::uint64_t _seed_seq_to_uint64(SeedSeq&& seq) {
+    std::array<std::uint32_t, 2> temp;
     seq.generate(temp.begin(), temp.end());
     return _merge_uint32_into_uint64(temp[0], temp[1]);
 }
 
-// 'std::rotl()' from C++20, used by many PRNGs
-template <class T>
-[[nodiscard]] constexpr T _rotl(T x, int k) noexcept {
-    return (x << k) | (x >> (std::numeric_limits<T>::digits - k));
+// 'std::rotl()' from C++20, used by many PRNGs
+template <class T>
+[[nodiscard]] constexpr T _rotate_left(T x, int k) noexcept {
+    return (x << k) | (x >> (std::numeric_limits<T>::digits - k));
+}
+
+// Full product of two integers, returns upper half and writes lower half into 'low'
+template <class T>
+[[nodiscard]] constexpr T _wide_multiply(T a, T b, T& low) noexcept {
+    if constexpr (sizeof(T) == 4) {
+        const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+        low                         = static_cast<T>(product);
+        return static_cast<T>(product >> 32);
+    } else {
+#ifdef __SIZEOF_INT128__
+        __extension__ using uint128 = unsigned __int128; // '__extension__' silences '-Wpedantic'
+        const uint128 product       = static_cast<uint128>(a) * b;
+        low                         = static_cast<T>(product);
+        return static_cast<T>(product >> 64);
+#else
+        // Schoolbook multiplication on 32-bit halves, none of the partial sums can overflow
+        const std::uint64_t a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+        const std::uint64_t b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+
+        const std::uint64_t low_low = a_low * b_low, low_high = a_low * b_high;
+        const std::uint64_t high_low = a_high * b_low, high_high = a_high * b_high;
+
+        const std::uint64_t middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+
+        low = (middle << 32) | (low_low & 0xFFFFFFFF);
+        return high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+#endif
+    }
+}
+
+template <class T>
+constexpr T _default_seed = std::numeric_limits<T>::max() / 2;
+// an "overall decent" default seed - doesn't gave too many zeroes,
+// unlikely to accidentaly match with a user-defined seed
+
+template <class T>
+[[nodiscard]] constexpr T _ensure_nonzero(T value) noexcept {
+    return (value) ? value : _default_seed<T> + 1;
+}
+// some generators shouldn't be zero initialized, in a perfect world the user would never
+// do that, but in case they happened to do so regardless we can remap 0 to some "weird"
+// value that isn't like to intersect with any other seeds generated by the user. Rejecting
+// zero seeds completely wouldn't be appropriate for compatibility reasons.
+
+// Moves the state to the next stream by hashing it, used by 'split()' & 'stream()' of generators that have no
+// mathematical jump-ahead. Such streams aren't guaranteed to not overlap, but with 64+ bits of state an overlap
+// is astronomically unlikely for any practical number of streams and their length. Different 'salt' values
+// produce unrelated families of streams.
+template <class T, std::size_t N>
+constexpr void _advance_stream(std::array<T, N>& state, std::uint64_t salt = 0) noexcept {
+    std::uint64_t hash = salt;
+    for (const T& e : state) {
+        std::uint64_t splitmix64_state = hash ^ static_cast<std::uint64_t>(e);
+        hash                           = _splitmix64(splitmix64_state);
+    }
+    for (T& e : state) e = _ensure_nonzero(static_cast<T>(_splitmix64(hash)));
+}
+
+// 'split()' moves the parent to the next stream and derives the child by hashing with this salt. If the child kept
+// the current stream, its own 'split()' would move it onto the next stream of the parent, which is already owned by
+// its next sibling. With a separate hash nested splits form a tree where every node gets an unrelated stream.
+constexpr std::uint64_t _child_stream_salt = 0xD1B54A32D192ED03;
+
+// =========================
+// --- Random Generators ---
+// =========================
+
+// Implementation of several "good" PRNGS.
+//
+// All generators meets uniform random number generator requirements
+// (C++17 and below, see https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator)
+// (C++20 and above, see https://en.cppreference.com/w/cpp/numeric/random/uniform_random_bit_generator)
+
+// Note 1:
+// As of C++17 there is little point in declaring generator constructors and methods as 'constexpr',
+// however in newer standards it would allow PRNGs to be used in constexpr context.
+//
+// Uniform distributions from 'random::distributions::' are 'constexpr' too, however "convenient random functions"
+// can't be since they advance the default 'thread_generator()'.
+
+// Note 2:
+// Here PRNGs take 'SeedSeq' as a forwaring reference 'SeedSeq&&', while standard PRNGS take 'SeedSeq&',
+// this is how it should've been done in the standard too, but for some reason they only standardized
+// l-value references. One of the many faults of <random>.
+
+// Multi-lane versions of some generators used for bulk generation, they need access to the internal state
+template <std::size_t lanes>
+struct _xoshiro256pp_lanes;
+template <std::size_t lanes>
+struct _romu_trio32_lanes;
+
+namespace generators {
+
+// --- 32-bit PRNGs ---
+// --------------------
+
+// Implementation of 32-bit Romu Trio engine from paper by "Mark A. Overton",
+// see https://www.romu-random.org/
+//     https://www.romu-random.org/romupaper.pdf
+//
+// Performance: Excellent
+// Quality:     3/5
+// State:       16 bytes
+//
+// Not the best one for general use, but provides bleeding edge performance.
+// Depending on 32/64-bit CPU instruction set can lead to huge speedup.
+//
+class RomuTrio32 {
+public:
+    using result_type = std::uint32_t;
+
+private:
+    std::array<result_type, 3> s{};
+
+    template <std::size_t>
+    friend struct random::_romu_trio32_lanes;
+
+public:
+    constexpr explicit RomuTrio32(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit RomuTrio32(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        result_type splitmix32_state = _ensure_nonzero(seed); // RomuTrio shouln't be zero-initialized
+        this->s[0]                   = _splitmix32(splitmix32_state);
+        this->s[1]                   = _splitmix32(splitmix32_state);
+        this->s[2]                   = _splitmix32(splitmix32_state);
+        // Like Xoshiro, Romu recommends using SplitMix32 to initialize its state
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        seq.generate(this->s.begin(), this->s.end());
+        this->s[0] = _ensure_nonzero(this->s[0]); // std::seed_seq can generate zeroes
+        this->s[1] = _ensure_nonzero(this->s[1]); // and we don't want a zero-state here
+        this->s[2] = _ensure_nonzero(this->s[2]);
+    }
+
+    constexpr result_type operator()() noexcept {
+        const result_type xp = this->s[0], yp = this->s[1], zp = this->s[2];
+        this->s[0] = 3323815723u * zp;
+        this->s[1] = yp - xp;
+        this->s[1] = _rotate_left(this->s[1], 6);
+        this->s[2] = zp - yp;
+        this->s[2] = _rotate_left(this->s[2], 22);
+        return xp;
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    [[nodiscard]] constexpr RomuTrio32 split() noexcept {
+        RomuTrio32 result = *this;
+        _advance_stream(result.s, _child_stream_salt);
+        _advance_stream(this->s);
+        return result;
+    }
+
+    [[nodiscard]] constexpr RomuTrio32 stream(std::uint64_t n) const noexcept {
+        RomuTrio32 result = *this;
+        for (; n; --n) _advance_stream(result.s);
+        _advance_stream(result.s, _child_stream_salt);
+        return result;
+    }
+};
+
+// Implementation of 32-bit Bob Jenkins' small prng ,
+// see https://burtleburtle.net/bob/rand/smallprng.html
+//     https://gist.github.com/imneme/85cff47d4bad8de6bdeb671f9c76c814
+//
+// Performance: Excellent
+// Quality:     3/5
+// State:       16 bytes
+//
+// Not the best one for general use, but provides bleeding edge performance.
+// Depending on 32/64-bit CPU instruction set can lead to huge speedup.
+//
+class JSF32 {
+public:
+    using result_type = std::uint32_t;
+
+private:
+    std::array<result_type, 4> s{};
+
+public:
+    constexpr explicit JSF32(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit JSF32(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        this->s[0] = 0xf1ea5eed;
+        this->s[1] = this->s[2] = this->s[3] = _ensure_nonzero(seed);
+        // JSF shouln't struggle with zero-seeding but just in case
+        for (int i = 0; i < 20; ++i) static_cast<void>(this->operator()());
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        seq.generate(this->s.begin(), this->s.end());
+    }
+
+    constexpr result_type operator()() noexcept {
+        const result_type e = this->s[0] - _rotate_left(this->s[1], 27);
+        this->s[0]          = this->s[1] ^ _rotate_left(this->s[2], 17);
+        this->s[1]          = this->s[2] + this->s[3];
+        this->s[2]          = this->s[3] + e;
+        this->s[3]          = e + this->s[0];
+        return this->s[3];
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    [[nodiscard]] constexpr JSF32 split() noexcept {
+        JSF32 result = *this;
+        _advance_stream(result.s, _child_stream_salt);
+        _advance_stream(this->s);
+        return result;
+    }
+
+    [[nodiscard]] constexpr JSF32 stream(std::uint64_t n) const noexcept {
+        JSF32 result = *this;
+        for (; n; --n) _advance_stream(result.s);
+        _advance_stream(result.s, _child_stream_salt);
+        return result;
+    }
+};
+
+// --- 64-bit PRNGs ---
+// --------------------
+
+// Implementation of Romu DuoJr engine from paper by "Mark A. Overton",
+// see https://www.romu-random.org/
+//     https://www.romu-random.org/romupaper.pdf
+//
+// Performance: Excellent
+// Quality:     3/5
+// State:       16 bytes
+//
+// Not the best one for general use, but provides bleeding edge performance.
+//
+class RomuDuoJr {
+public:
+    using result_type = std::uint64_t;
+
+private:
+    std::array<result_type, 2> s{};
+
+public:
+    constexpr explicit RomuDuoJr(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit RomuDuoJr(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        result_type splitmix64_state = _ensure_nonzero(seed); // RomuDuoJr shouln't be zero-initialized
+        this->s[0]                   = _splitmix64(splitmix64_state);
+        this->s[1]                   = _splitmix64(splitmix64_state);
+        // Like Xoshiro, Romu recommends using SplitMix64 to initialize its state
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        this->s[0] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // std::seed_seq can generate zeroes
+        this->s[1] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // and we don't want a zero-state here
+        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
+    }
+
+    constexpr result_type operator()() noexcept {
+        const result_type res = this->s[0];
+        this->s[0]            = 15241094284759029579u * this->s[1];
+        this->s[1]            = this->s[1] - res;
+        this->s[1]            = _rotate_left(this->s[1], 27);
+        return res;
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    [[nodiscard]] constexpr RomuDuoJr split() noexcept {
+        RomuDuoJr result = *this;
+        _advance_stream(result.s, _child_stream_salt);
+        _advance_stream(this->s);
+        return result;
+    }
+
+    [[nodiscard]] constexpr RomuDuoJr stream(std::uint64_t n) const noexcept {
+        RomuDuoJr result = *this;
+        for (; n; --n) _advance_stream(result.s);
+        _advance_stream(result.s, _child_stream_salt);
+        return result;
+    }
+};
+
+// Implementation of 64-bit Bob Jenkins' small prng ,
+// see https://burtleburtle.net/bob/rand/smallprng.html
+//     https://gist.github.com/imneme/85cff47d4bad8de6bdeb671f9c76c814
+//
+// Performance: Excellent
+// Quality:     4/5
+// State:       32 bytes
+//
+// Excellent choise as a general purpose PRNG.
+// Lack theoretical proof for period length, but brute-force testing indicates >= 2^64.
+//
+class JSF64 {
+public:
+    using result_type = std::uint64_t;
+
+private:
+    std::array<result_type, 4> s{};
+
+public:
+    constexpr explicit JSF64(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit JSF64(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        this->s[0] = 0xf1ea5eed;
+        this->s[1] = this->s[2] = this->s[3] = _ensure_nonzero(seed);
+        // JSF shouln't struggle with zero-seeding but just in case
+        for (int i = 0; i < 20; ++i) static_cast<void>(this->operator()());
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        this->s[0] = _seed_seq_to_uint64(seq);
+        this->s[1] = _seed_seq_to_uint64(seq);
+        this->s[2] = _seed_seq_to_uint64(seq);
+        this->s[3] = _seed_seq_to_uint64(seq);
+        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
+    }
+
+    constexpr result_type operator()() noexcept {
+        const result_type e = this->s[0] - _rotate_left(this->s[1], 7);
+        this->s[0]          = this->s[1] ^ _rotate_left(this->s[2], 13);
+        this->s[1]          = this->s[2] + _rotate_left(this->s[3], 37);
+        this->s[2]          = this->s[3] + e;
+        this->s[3]          = e + this->s[0];
+        return this->s[3];
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    [[nodiscard]] constexpr JSF64 split() noexcept {
+        JSF64 result = *this;
+        _advance_stream(result.s, _child_stream_salt);
+        _advance_stream(this->s);
+        return result;
+    }
+
+    [[nodiscard]] constexpr JSF64 stream(std::uint64_t n) const noexcept {
+        JSF64 result = *this;
+        for (; n; --n) _advance_stream(result.s);
+        _advance_stream(result.s, _child_stream_salt);
+        return result;
+    }
+};
+
+// Implementation of Xoshiro256++ suggested by David Blackman and Sebastiano Vigna,
+// see https://prng.di.unimi.it/
+//     https://prng.di.unimi.it/xoshiro256plusplus.c
+//
+// Performance: Excellent
+// Quality:     4/5
+// State:       32 bytes
+//
+// Excellent choise as a general purpose PRNG.
+// Used by several modern languages as their default.
+//
+class Xoshiro256PlusPlus {
+public:
+    using result_type = std::uint64_t;
+
+private:
+    std::array<result_type, 4> s{};
+
+    template <std::size_t>
+    friend struct random::_xoshiro256pp_lanes;
+
+public:
+    constexpr explicit Xoshiro256PlusPlus(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit Xoshiro256PlusPlus(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        result_type splitmix64_state = _ensure_nonzero(seed); // Xoshiro256++ shouln't be zero-initialized
+        this->s[0]                   = _splitmix64(splitmix64_state);
+        this->s[1]                   = _splitmix64(splitmix64_state);
+        this->s[2]                   = _splitmix64(splitmix64_state);
+        this->s[3]                   = _splitmix64(splitmix64_state);
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        this->s[0] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // std::seed_seq can generate zeroes
+        this->s[1] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // and we don't want a zero-state here
+        this->s[2] = _ensure_nonzero(_seed_seq_to_uint64(seq));
+        this->s[3] = _ensure_nonzero(_seed_seq_to_uint64(seq));
+        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
+    }
+
+    constexpr result_type operator()() noexcept {
+        const result_type result = _rotate_left(this->s[0] + this->s[3], 23) + this->s[0];
+        const result_type t      = this->s[1] << 17;
+        this->s[2] ^= this->s[0];
+        this->s[3] ^= this->s[1];
+        this->s[1] ^= this->s[2];
+        this->s[0] ^= this->s[3];
+        this->s[2] ^= t;
+        this->s[3] = _rotate_left(this->s[3], 45);
+        return result;
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    // Equivalent to 2^128 calls to 'operator()', generates 2^128 non-overlapping subsequences for parallel computations
+    constexpr void jump() noexcept {
+        this->jump_with_polynomial({0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c});
+    }
+
+    // Equivalent to 2^192 calls to 'operator()', generates 2^64 starting points, from each of which 'jump()'
+    // will generate 2^64 non-overlapping subsequences for distributed computations
+    constexpr void long_jump() noexcept {
+        this->jump_with_polynomial({0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635});
+    }
+
+    // Parent moves by 'jump()', while the child gets a hashed state. Jumps commute, so a child that kept the current
+    // stream would move onto the stream of its next sibling once it splits itself, hashing keeps nested splits apart.
+    [[nodiscard]] constexpr Xoshiro256PlusPlus split() noexcept {
+        Xoshiro256PlusPlus result = *this;
+        _advance_stream(result.s, _child_stream_salt);
+        this->jump();
+        return result;
+    }
+
+    [[nodiscard]] constexpr Xoshiro256PlusPlus stream(std::uint64_t n) const noexcept {
+        Xoshiro256PlusPlus result = *this;
+        for (; n; --n) result.jump();
+        _advance_stream(result.s, _child_stream_salt);
+        return result;
+    }
+
+private:
+    // Jump polynomials & algorithm are taken from the reference implementation,
+    // see https://prng.di.unimi.it/xoshiro256plusplus.c
+    constexpr void jump_with_polynomial(const std::array<std::uint64_t, 4>& polynomial) noexcept {
+        std::array<result_type, 4> jumped{};
+
+        for (const std::uint64_t word : polynomial)
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (std::uint64_t(1) << bit))
+                    for (std::size_t i = 0; i < 4; ++i) jumped[i] ^= this->s[i];
+                this->operator()();
+            }
+
+        this->s = jumped;
+    }
+};
+
+// Implementation XorShift64* suggested by Marsaglia G. in 2003 "Journal of Statistical Software",
+// see https://www.jstatsoft.org/article/view/v008i14
+//     https://en.wikipedia.org/wiki/Xorshift
+//
+// Performance: Good
+// Quality:     4/5
+// State:       8 bytes
+//
+// Generally overshadowed by newer PRNGs in quality & performance,
+// however it still quite good and seems to be among the best we can get at just 8 bytes of state.
+//
+class Xorshift64Star {
+public:
+    using result_type = std::uint64_t;
+
+private:
+    result_type s{};
+
+public:
+    constexpr explicit Xorshift64Star(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit Xorshift64Star(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) {
+        this->s = _ensure_nonzero(seed); // XorShift64* shouln't be zero-initialized
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        this->s = _ensure_nonzero(_seed_seq_to_uint64(seq));
+        // std::seed_seq can generate zeroes and we don't want a zero-state here
+    }
+
+    constexpr result_type operator()() noexcept {
+        this->s ^= this->s >> 12;
+        this->s ^= this->s << 25;
+        this->s ^= this->s >> 27;
+        return this->s * 0x2545F4914F6CDD1DULL;
+    }
+
+    constexpr void discard(unsigned long long z) noexcept {
+        for (; z; --z) this->operator()();
+    }
+
+    [[nodiscard]] constexpr Xorshift64Star split() noexcept {
+        Xorshift64Star             result = *this;
+        std::array<result_type, 1> state  = {this->s};
+        std::array<result_type, 1> child  = state;
+        _advance_stream(child, _child_stream_salt);
+        _advance_stream(state);
+        result.s = child[0];
+        this->s  = state[0];
+        return result;
+    }
+
+    [[nodiscard]] constexpr Xorshift64Star stream(std::uint64_t n) const noexcept {
+        Xorshift64Star             result = *this;
+        std::array<result_type, 1> state  = {result.s};
+        for (; n; --n) _advance_stream(state);
+        _advance_stream(state, _child_stream_salt);
+        result.s = state[0];
+        return result;
+    }
+};
+
+// --- CSPRNGs ---
+// ---------------
+
+// Implementation of ChaCha20 CPRNG conforming to RFC 7539 standard
+// see https://datatracker.ietf.org/doc/html/rfc7539
+//     https://www.rfc-editor.org/rfc/rfc7539#section-2.4
+//     https://en.wikipedia.org/wiki/Salsa20
+
+// Quarted-round operation for ChaCha20 stream cipher
+constexpr void _quarter_round(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c, std::uint32_t& d) {
+    a += b, d ^= a, d = _rotate_left(d, 16);
+    c += d, b ^= c, b = _rotate_left(b, 12);
+    a += b, d ^= a, d = _rotate_left(d, 8);
+    c += d, b ^= c, b = _rotate_left(b, 7);
+}
+
+[[nodiscard]] constexpr std::array<std::uint32_t, 16> _chacha20_rounds(const std::array<std::uint32_t, 16>& input) {
+    auto state = input;
+
+    constexpr std::size_t round_count = 10;
+    // standard number of ChaCha20 rounds as per RFC 7539
+    // (20 rounds total, alterating between column rounds and diagonal rounds)
+
+    for (std::size_t i = 0; i < round_count; ++i) {
+        // Column rounds
+        _quarter_round(state[0], state[4], state[8], state[12]);
+        _quarter_round(state[1], state[5], state[9], state[13]);
+        _quarter_round(state[2], state[6], state[10], state[14]);
+        _quarter_round(state[3], state[7], state[11], state[15]);
+
+        // Diagonal rounds
+        _quarter_round(state[0], state[5], state[10], state[15]);
+        _quarter_round(state[1], state[6], state[11], state[12]);
+        _quarter_round(state[2], state[7], state[8], state[13]);
+        _quarter_round(state[3], state[4], state[9], state[14]);
+    }
+
+    for (std::size_t i = 0; i < state.size(); ++i) state[i] += input[i];
+    return state;
+}
+
+// Multi-block kernels compute several consecutive blocks at once. Each SIMD register holds the same state word
+// of different blocks, which makes the rounds identical to the scalar ones with every lane doing its own block,
+// the only shuffling needed is the final transposition into the block order.
+#ifdef UTL_RANDOM_HAS_SSE2
+template <int k>
+[[nodiscard]] inline __m128i _rotate_left_sse2(__m128i x) noexcept {
+    if constexpr (k == 16) return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+    else return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+}
+
+inline void _quarter_round_sse2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) noexcept {
+    a = _mm_add_epi32(a, b), d = _rotate_left_sse2<16>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d), b = _rotate_left_sse2<12>(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(a, b), d = _rotate_left_sse2<8>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d), b = _rotate_left_sse2<7>(_mm_xor_si128(b, c));
+}
+
+// Computes 4 blocks with counters 'input[12] + 0...3'
+inline void _chacha20_blocks_sse2(const std::array<std::uint32_t, 16>& input, std::uint32_t* out) noexcept {
+    __m128i state[16], initial[16]; // 'std::array<>' would drop alignment attributes of SIMD types
+    for (std::size_t i = 0; i < 16; ++i) state[i] = _mm_set1_epi32(static_cast<int>(input[i]));
+    state[12] = _mm_add_epi32(state[12], _mm_set_epi32(3, 2, 1, 0));
+    for (std::size_t i = 0; i < 16; ++i) initial[i] = state[i];
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        _quarter_round_sse2(state[0], state[4], state[8], state[12]);
+        _quarter_round_sse2(state[1], state[5], state[9], state[13]);
+        _quarter_round_sse2(state[2], state[6], state[10], state[14]);
+        _quarter_round_sse2(state[3], state[7], state[11], state[15]);
+
+        _quarter_round_sse2(state[0], state[5], state[10], state[15]);
+        _quarter_round_sse2(state[1], state[6], state[11], state[12]);
+        _quarter_round_sse2(state[2], state[7], state[8], state[13]);
+        _quarter_round_sse2(state[3], state[4], state[9], state[14]);
+    }
+
+    for (std::size_t i = 0; i < 16; ++i) state[i] = _mm_add_epi32(state[i], initial[i]);
+
+    // Transpose 4x4 tiles of (words i...i+3) x (blocks 0...3)
+    for (std::size_t i = 0; i < 16; i += 4) {
+        const __m128i t0 = _mm_unpacklo_epi32(state[i + 0], state[i + 1]);
+        const __m128i t1 = _mm_unpacklo_epi32(state[i + 2], state[i + 3]);
+        const __m128i t2 = _mm_unpackhi_epi32(state[i + 0], state[i + 1]);
+        const __m128i t3 = _mm_unpackhi_epi32(state[i + 2], state[i + 3]);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0 * 16 + i), _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 1 * 16 + i), _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * 16 + i), _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * 16 + i), _mm_unpackhi_epi64(t2, t3));
+    }
+}
+#endif
+
+#ifdef UTL_RANDOM_HAS_AVX2
+// Rotations by whole bytes are a single shuffle
+template <int k>
+[[nodiscard]] inline __m256i _rotate_left_avx2(__m256i x) noexcept {
+    if constexpr (k == 16)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, //
+                                                      13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+    else if constexpr (k == 8)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3, //
+                                                      14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3));
+    else return _mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - k));
+}
+
+inline void _quarter_round_avx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) noexcept {
+    a = _mm256_add_epi32(a, b), d = _rotate_left_avx2<16>(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d), b = _rotate_left_avx2<12>(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi32(a, b), d = _rotate_left_avx2<8>(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d), b = _rotate_left_avx2<7>(_mm256_xor_si256(b, c));
+}
+
+// Computes 8 blocks with counters 'input[12] + 0...7'
+inline void _chacha20_blocks_avx2(const std::array<std::uint32_t, 16>& input, std::uint32_t* out) noexcept {
+    __m256i state[16], initial[16]; // 'std::array<>' would drop alignment attributes of SIMD types
+    for (std::size_t i = 0; i < 16; ++i) state[i] = _mm256_set1_epi32(static_cast<int>(input[i]));
+    state[12] = _mm256_add_epi32(state[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    for (std::size_t i = 0; i < 16; ++i) initial[i] = state[i];
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        _quarter_round_avx2(state[0], state[4], state[8], state[12]);
+        _quarter_round_avx2(state[1], state[5], state[9], state[13]);
+        _quarter_round_avx2(state[2], state[6], state[10], state[14]);
+        _quarter_round_avx2(state[3], state[7], state[11], state[15]);
+
+        _quarter_round_avx2(state[0], state[5], state[10], state[15]);
+        _quarter_round_avx2(state[1], state[6], state[11], state[12]);
+        _quarter_round_avx2(state[2], state[7], state[8], state[13]);
+        _quarter_round_avx2(state[3], state[4], state[9], state[14]);
+    }
+
+    for (std::size_t i = 0; i < 16; ++i) state[i] = _mm256_add_epi32(state[i], initial[i]);
+
+    // Transpose 4x4 tiles within each 128-bit half, lower halves hold blocks 0...3, upper ones hold blocks 4...7
+    for (std::size_t i = 0; i < 16; i += 4) {
+        const __m256i t0 = _mm256_unpacklo_epi32(state[i + 0], state[i + 1]);
+        const __m256i t1 = _mm256_unpacklo_epi32(state[i + 2], state[i + 3]);
+        const __m256i t2 = _mm256_unpackhi_epi32(state[i + 0], state[i + 1]);
+        const __m256i t3 = _mm256_unpackhi_epi32(state[i + 2], state[i + 3]);
+
+        const __m256i rows[4] = {_mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+                                 _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3)};
+
+        for (std::size_t j = 0; j < 4; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (j + 0) * 16 + i), _mm256_castsi256_si128(rows[j]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (j + 4) * 16 + i), _mm256_extracti128_si256(rows[j], 1));
+        }
+    }
+}
+#endif
+
+// Computes 'block_count' consecutive blocks starting from the counter 'input[12]', SIMD kernels are only
+// used at runtime, constant evaluation always takes the scalar path which produces the exact same output
+template <std::size_t block_count>
+constexpr void _chacha20_blocks(std::array<std::uint32_t, 16> input, std::array<std::uint32_t, 16 * block_count>& out) {
+#if defined(UTL_RANDOM_HAS_AVX2)
+    if constexpr (block_count % 8 == 0) {
+        if (!__builtin_is_constant_evaluated()) {
+            for (std::size_t i = 0; i < block_count; i += 8, input[12] += 8) _chacha20_blocks_avx2(input, &out[16 * i]);
+            return;
+        }
+    }
+#elif defined(UTL_RANDOM_HAS_SSE2)
+    if constexpr (block_count % 4 == 0) {
+        if (!__builtin_is_constant_evaluated()) {
+            for (std::size_t i = 0; i < block_count; i += 4, input[12] += 4) _chacha20_blocks_sse2(input, &out[16 * i]);
+            return;
+        }
+    }
+#endif
+
+    for (std::size_t i = 0; i < block_count; ++i, ++input[12]) {
+        const auto block = _chacha20_rounds(input);
+        for (std::size_t j = 0; j < 16; ++j) out[16 * i + j] = block[j];
+    }
+}
+
+class ChaCha20 {
+public:
+    using result_type = std::uint32_t;
+
+private:
+    // Initial state components
+    std::array<result_type, 8> key{};     // 256-bit key
+    std::array<result_type, 3> nonce{};   // 96-bit nonce
+    std::uint32_t              counter{}; // 32-bit counter, refers to the next block after the buffered ones
+
+    // Blocks are generated in batches to make use of SIMD, sequence is the same as with one block at a time
+    constexpr static std::size_t block_count = 8;
+
+    std::array<result_type, 16 * block_count> block{};    // holds next 128 random numbers
+    std::size_t                               position{}; // current position in the block buffer
+
+    constexpr static std::array<result_type, 4> constant = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    // "Magic constants" for ChaCha20 are defined through bit representations of the following char arrays:
+    // { "expa", "nd 3", "2-by", "te k" },
+    // what we have here is exactly that except written as 'std::uint32_t'
+
+    constexpr void generate_new_blocks() {
+        // Set ChaCha20 initial state as per RFC 7539
+        //
+        //          [ const   const const const ]
+        // State    [ key     key   key   key   ]
+        // matrix = [ key     key   key   key   ]
+        //          [ counter nonce nonce nonce ]
+        //
+        const std::array<std::uint32_t, 16> input = {
+            this->constant[0], this->constant[1], this->constant[2], this->constant[3], //
+            this->key[0],      this->key[1],      this->key[2],      this->key[3],      //
+            this->key[4],      this->key[5],      this->key[6],      this->key[7],      //
+            this->counter,     this->nonce[0],    this->nonce[1],    this->nonce[2]     //
+        };
+
+        // Fill new blocks
+        _chacha20_blocks<block_count>(input, this->block);
+        this->counter += block_count;
+    }
+
+public:
+    constexpr explicit ChaCha20(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit ChaCha20(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) {
+        // Use some other PRNG to setup initial state
+        result_type splitmix32_state = seed;
+
+        for (auto& e : this->key) e = _splitmix32(splitmix32_state);
+        for (auto& e : this->nonce) e = _splitmix32(splitmix32_state);
+        this->counter  = 0; // counter can be set to any number, but usually 0 or 1 is used
+        this->position = 0;
+
+        this->generate_new_blocks();
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        // Seed sequence allows user to introduce more entropy into the state
+
+        seq.generate(this->key.begin(), this->key.end());
+        seq.generate(this->nonce.begin(), this->nonce.end());
+
+        this->counter  = 0; // counter can be set to any number, but usually 0 or 1 is used
+        this->position = 0;
+
+        this->generate_new_blocks();
+    }
+
+    constexpr result_type operator()() noexcept {
+        // Generate new blocks if necessary
+        if (this->position >= this->block.size()) {
+            this->generate_new_blocks();
+            this->position = 0;
+        }
+
+        // Get random value from the block and advance position cursor
+        return this->block[this->position++];
+    }
+
+    // Block counter allows us to skip ahead in O(1), buffered blocks start at 'counter - block_count'
+    constexpr void discard(unsigned long long z) noexcept {
+        const unsigned long long target = this->position + z;
+        if (target < this->block.size()) {
+            this->position = static_cast<std::size_t>(target);
+            return;
+        }
+
+        // Wraps around like the cipher
+        this->counter = this->counter - block_count + static_cast<std::uint32_t>(target / 16);
+        this->generate_new_blocks();
+        this->position = static_cast<std::size_t>(target % 16);
+    }
+
+    // Parent streams differ in the nonce, lower 64 bits of which are treated as a stream counter. This gives us
+    // 2^64 non-overlapping keystreams of 2^36 values. Children get a key derived from the key & the nonce of the
+    // current stream, so they have their own families of streams and their splits never reuse the parent ones.
+    [[nodiscard]] constexpr ChaCha20 split() noexcept {
+        ChaCha20 result = *this;
+        result.derive_child_key();
+        this->advance_nonce(1);
+        return result;
+    }
+
+    [[nodiscard]] constexpr ChaCha20 stream(std::uint64_t n) const noexcept {
+        ChaCha20 result = *this;
+        result.advance_nonce(n);
+        result.derive_child_key();
+        return result;
+    }
+
+private:
+    constexpr void derive_child_key() noexcept {
+        std::array<std::uint32_t, 11> state{};
+        for (std::size_t i = 0; i < 8; ++i) state[i] = this->key[i];
+        for (std::size_t i = 0; i < 3; ++i) state[8 + i] = this->nonce[i];
+        _advance_stream(state, _child_stream_salt);
+        for (std::size_t i = 0; i < 8; ++i) this->key[i] = state[i];
+
+        // Regenerate buffered blocks with a new key, position stays the same
+        this->counter -= block_count;
+        this->generate_new_blocks();
+    }
+
+    constexpr void advance_nonce(std::uint64_t n) noexcept {
+        const std::uint64_t stream_index = _merge_uint32_into_uint64(this->nonce[0], this->nonce[1]) + n;
+        this->nonce[0]                   = static_cast<std::uint32_t>(stream_index);
+        this->nonce[1]                   = static_cast<std::uint32_t>(stream_index >> 32);
+
+        // Regenerate buffered blocks in a new stream, position stays the same
+        this->counter -= block_count;
+        this->generate_new_blocks();
+    }
+};
+
+// --- Counter-based PRNGs ---
+// ---------------------------
+
+// Implementation of Philox4x32-10 & Philox4x64-10 counter-based PRNGs,
+// see "Parallel Random Numbers: As Easy as 1, 2, 3" by J. K. Salmon, M. A. Moraes, R. O. Dror & D. E. Shaw
+//     https://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+//
+// Each block of 4 values is a keyed bijection of a 4-word counter, which means any value can be computed
+// directly from its position & stream without generating anything before it. This makes results independent
+// of how the work is split between threads.
+
+template <class T>
+struct _philox_constants;
+
+template <>
+struct _philox_constants<std::uint32_t> {
+    constexpr static std::uint32_t multiplier[2] = {0xD2511F53, 0xCD9E8D57};
+    constexpr static std::uint32_t weyl[2]       = {0x9E3779B9, 0xBB67AE85}; // golden ratio & sqrt(3) - 1
+};
+
+template <>
+struct _philox_constants<std::uint64_t> {
+    constexpr static std::uint64_t multiplier[2] = {0xD2E7470EE14C6C93, 0xCA5A826395121157};
+    constexpr static std::uint64_t weyl[2]       = {0x9E3779B97F4A7C15, 0xBB67AE8584CAA73B};
+};
+
+template <class T>
+[[nodiscard]] constexpr std::array<T, 4> _philox_rounds(std::array<T, 4> counter, std::array<T, 2> key) noexcept {
+    using constants = _philox_constants<T>;
+
+    constexpr std::size_t round_count = 10; // recommended number of rounds, 7 is the minimum to pass BigCrush
+
+    for (std::size_t i = 0; i < round_count; ++i) {
+        T       low_0{}, low_1{};
+        const T high_0 = _wide_multiply(constants::multiplier[0], counter[0], low_0);
+        const T high_1 = _wide_multiply(constants::multiplier[1], counter[2], low_1);
+
+        counter = {static_cast<T>(high_1 ^ counter[1] ^ key[0]), low_1, static_cast<T>(high_0 ^ counter[3] ^ key[1]),
+                   low_0};
+
+        key[0] += constants::weyl[0];
+        key[1] += constants::weyl[1];
+    }
+
+    return counter;
+}
+
+// Multi-block kernels evaluate 16 consecutive counters (only the lowest word changes), SIMD has no 64-bit
+// high multiplication, so only Philox4x32 gets them. Several independent groups of registers are evaluated
+// in the same loop to hide the multiplication latency, which is the bottleneck of a single group.
+#ifdef UTL_RANDOM_HAS_SSE2
+// High & low halves of 32-bit products, SSE2 only multiplies even lanes so odd ones are shifted into place
+inline void _wide_multiply_sse2(__m128i a, __m128i b, __m128i& high, __m128i& low) noexcept {
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+    const __m128i mask = _mm_set_epi32(-1, 0, -1, 0);
+
+    high = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, mask));
+    low  = _mm_or_si128(_mm_andnot_si128(mask, even), _mm_slli_epi64(odd, 32));
+}
+
+inline void _philox4x32_blocks_sse2(const std::array<std::uint32_t, 4>& counter, std::array<std::uint32_t, 2> key,
+                                    std::uint32_t* out) noexcept {
+    using constants = _philox_constants<std::uint32_t>;
+
+    constexpr int groups = 4;
+
+    __m128i x0[groups], x1[groups], x2[groups], x3[groups];
+    for (int g = 0; g < groups; ++g) {
+        x0[g] = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(counter[0])),
+                              _mm_set_epi32(4 * g + 3, 4 * g + 2, 4 * g + 1, 4 * g + 0));
+        x1[g] = _mm_set1_epi32(static_cast<int>(counter[1]));
+        x2[g] = _mm_set1_epi32(static_cast<int>(counter[2]));
+        x3[g] = _mm_set1_epi32(static_cast<int>(counter[3]));
+    }
+
+    const __m128i multiplier_0 = _mm_set1_epi32(static_cast<int>(constants::multiplier[0]));
+    const __m128i multiplier_1 = _mm_set1_epi32(static_cast<int>(constants::multiplier[1]));
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        const __m128i key_0 = _mm_set1_epi32(static_cast<int>(key[0]));
+        const __m128i key_1 = _mm_set1_epi32(static_cast<int>(key[1]));
+
+        for (int g = 0; g < groups; ++g) {
+            __m128i high_0, low_0, high_1, low_1;
+            _wide_multiply_sse2(x0[g], multiplier_0, high_0, low_0);
+            _wide_multiply_sse2(x2[g], multiplier_1, high_1, low_1);
+
+            x0[g] = _mm_xor_si128(_mm_xor_si128(high_1, x1[g]), key_0);
+            x1[g] = low_1;
+            x2[g] = _mm_xor_si128(_mm_xor_si128(high_0, x3[g]), key_1);
+            x3[g] = low_0;
+        }
+
+        key[0] += constants::weyl[0];
+        key[1] += constants::weyl[1];
+    }
+
+    // Transpose words into the block order, same as with ChaCha20
+    for (int g = 0; g < groups; ++g, out += 16) {
+        const __m128i t0 = _mm_unpacklo_epi32(x0[g], x1[g]);
+        const __m128i t1 = _mm_unpacklo_epi32(x2[g], x3[g]);
+        const __m128i t2 = _mm_unpackhi_epi32(x0[g], x1[g]);
+        const __m128i t3 = _mm_unpackhi_epi32(x2[g], x3[g]);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi64(t2, t3));
+    }
+}
+#endif
+
+#ifdef UTL_RANDOM_HAS_AVX2
+inline void _wide_multiply_avx2(__m256i a, __m256i b, __m256i& high, __m256i& low) noexcept {
+    const __m256i even = _mm256_mul_epu32(a, b);
+    const __m256i odd  = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000));
+
+    high = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_and_si256(odd, mask));
+    low  = _mm256_or_si256(_mm256_andnot_si256(mask, even), _mm256_slli_epi64(odd, 32));
+}
+
+inline void _philox4x32_blocks_avx2(const std::array<std::uint32_t, 4>& counter, std::array<std::uint32_t, 2> key,
+                                    std::uint32_t* out) noexcept {
+    using constants = _philox_constants<std::uint32_t>;
+
+    constexpr int groups = 2;
+
+    __m256i x0[groups], x1[groups], x2[groups], x3[groups];
+    for (int g = 0; g < groups; ++g) {
+        x0[g] = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(counter[0])),
+                                 _mm256_set_epi32(8 * g + 7, 8 * g + 6, 8 * g + 5, 8 * g + 4, //
+                                                  8 * g + 3, 8 * g + 2, 8 * g + 1, 8 * g + 0));
+        x1[g] = _mm256_set1_epi32(static_cast<int>(counter[1]));
+        x2[g] = _mm256_set1_epi32(static_cast<int>(counter[2]));
+        x3[g] = _mm256_set1_epi32(static_cast<int>(counter[3]));
+    }
+
+    const __m256i multiplier_0 = _mm256_set1_epi32(static_cast<int>(constants::multiplier[0]));
+    const __m256i multiplier_1 = _mm256_set1_epi32(static_cast<int>(constants::multiplier[1]));
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        const __m256i key_0 = _mm256_set1_epi32(static_cast<int>(key[0]));
+        const __m256i key_1 = _mm256_set1_epi32(static_cast<int>(key[1]));
+
+        for (int g = 0; g < groups; ++g) {
+            __m256i high_0, low_0, high_1, low_1;
+            _wide_multiply_avx2(x0[g], multiplier_0, high_0, low_0);
+            _wide_multiply_avx2(x2[g], multiplier_1, high_1, low_1);
+
+            x0[g] = _mm256_xor_si256(_mm256_xor_si256(high_1, x1[g]), key_0);
+            x1[g] = low_1;
+            x2[g] = _mm256_xor_si256(_mm256_xor_si256(high_0, x3[g]), key_1);
+            x3[g] = low_0;
+        }
+
+        key[0] += constants::weyl[0];
+        key[1] += constants::weyl[1];
+    }
+
+    // Lower halves hold blocks 0...3 of the group, upper ones hold blocks 4...7
+    for (int g = 0; g < groups; ++g, out += 32) {
+        const __m256i t0 = _mm256_unpacklo_epi32(x0[g], x1[g]);
+        const __m256i t1 = _mm256_unpacklo_epi32(x2[g], x3[g]);
+        const __m256i t2 = _mm256_unpackhi_epi32(x0[g], x1[g]);
+        const __m256i t3 = _mm256_unpackhi_epi32(x2[g], x3[g]);
+
+        const __m256i rows[4] = {_mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+                                 _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3)};
+
+        for (std::size_t j = 0; j < 4; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * j + 0), _mm256_castsi256_si128(rows[j]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * j + 16), _mm256_extracti128_si256(rows[j], 1));
+        }
+    }
+}
+#endif
+
+template <class T>
+constexpr void _philox_increment_carry(std::array<T, 4>& counter) noexcept {
+    for (std::size_t i = 1; i < 4; ++i)
+        if (++counter[i] != 0) break;
+}
+
+// Evaluates 'count' consecutive counters starting from 'counter', SIMD kernels are only used at runtime and
+// only for groups that don't carry into the second counter word, everything else takes the scalar path
+template <class T>
+constexpr void _philox_blocks(std::array<T, 4> counter, const std::array<T, 2>& key, T* out, std::size_t count) {
+#if defined(UTL_RANDOM_HAS_SSE2) || defined(UTL_RANDOM_HAS_AVX2)
+    if constexpr (std::is_same_v<T, std::uint32_t>) {
+        if (!__builtin_is_constant_evaluated()) {
+            constexpr std::size_t group = 16;
+
+            while (count >= group && counter[0] <= std::numeric_limits<T>::max() - (group - 1)) {
+#if defined(UTL_RANDOM_HAS_AVX2)
+                _philox4x32_blocks_avx2(counter, key, out);
+#else
+                _philox4x32_blocks_sse2(counter, key, out);
+#endif
+                counter[0] += group;
+                if (counter[0] == 0) _philox_increment_carry(counter);
+                out += 4 * group, count -= group;
+            }
+        }
+    }
+#endif
+
+    for (; count; --count, out += 4) {
+        const auto block = _philox_rounds(counter, key);
+        for (std::size_t j = 0; j < 4; ++j) out[j] = block[j];
+        if (++counter[0] == 0) _philox_increment_carry(counter);
+    }
+}
+
+// Shared implementation of Philox4x32 & Philox4x64, counter is made from a 64-bit block index (lower half)
+// and a 64-bit stream index (upper half), buffer holds 'block_count' blocks that are evaluated at once
+template <class T, std::size_t block_count>
+class _philox4 {
+public:
+    using result_type  = T;
+    using counter_type = std::array<T, 4>;
+    using key_type     = std::array<T, 2>;
+    using block_type   = std::array<T, 4>;
+
+private:
+    key_type      key{};
+    std::uint64_t block_index{};  // refers to the next block after the buffered ones
+    std::uint64_t stream_index{};
+
+    std::array<result_type, 4 * block_count> block{};    // holds next values
+    std::size_t                              position{}; // current position in the block buffer
+
+    [[nodiscard]] constexpr static counter_type make_counter(std::uint64_t index, std::uint64_t stream) noexcept {
+        if constexpr (sizeof(T) == 4)
+            return {static_cast<T>(index), static_cast<T>(index >> 32), static_cast<T>(stream),
+                    static_cast<T>(stream >> 32)};
+        else return {index, stream, 0, 0};
+    }
+
+    constexpr void generate_new_blocks() {
+        _philox_blocks(make_counter(this->block_index, this->stream_index), this->key, this->block.data(), block_count);
+        this->block_index += block_count;
+    }
+
+public:
+    constexpr explicit _philox4(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    explicit _philox4(SeedSeq&& seq) {
+        this->seed(seq);
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
+    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(result_type seed) noexcept {
+        if constexpr (sizeof(T) == 4) {
+            result_type splitmix32_state = seed;
+            for (auto& e : this->key) e = _splitmix32(splitmix32_state);
+        } else {
+            result_type splitmix64_state = seed;
+            for (auto& e : this->key) e = _splitmix64(splitmix64_state);
+        }
+        this->block_index  = 0;
+        this->stream_index = 0;
+        this->position     = 0;
+
+        this->generate_new_blocks();
+    }
+
+    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
+    void seed(SeedSeq&& seq) {
+        if constexpr (sizeof(T) == 4) {
+            seq.generate(this->key.begin(), this->key.end());
+        } else {
+            std::array<std::uint32_t, 4> temp;
+            seq.generate(temp.begin(), temp.end());
+            this->key = {_merge_uint32_into_uint64(temp[0], temp[1]), _merge_uint32_into_uint64(temp[2], temp[3])};
+        }
+        this->block_index  = 0;
+        this->stream_index = 0;
+        this->position     = 0;
+
+        this->generate_new_blocks();
+    }
+
+    constexpr result_type operator()() noexcept {
+        // Generate new blocks if necessary
+        if (this->position >= this->block.size()) {
+            this->generate_new_blocks();
+            this->position = 0;
+        }
+
+        // Get random value from the block and advance position cursor
+        return this->block[this->position++];
+    }
+
+    // Stateless access, same as taking values '4 * index' to '4 * index + 3' of the sequence this generator
+    // produces after 'stream' calls to 'split()'. Doesn't advance the generator, so it can be safely called
+    // from multiple threads at once.
+    [[nodiscard]] constexpr block_type at(const counter_type& counter) const noexcept {
+        return _philox_rounds(counter, this->key);
+    }
+
+    [[nodiscard]] constexpr block_type at(std::uint64_t index, std::uint64_t stream = 0) const noexcept {
+        return this->at(make_counter(index, stream));
+    }
+
+    // Batch version of the same thing, writes 'blocks' consecutive blocks starting from 'index' into 'out',
+    // which should have space for '4 * blocks' values. Uses SIMD when possible.
+    constexpr void at(std::uint64_t index, std::uint64_t stream, result_type* out, std::size_t blocks) const noexcept {
+        _philox_blocks(make_counter(index, stream), this->key, out, blocks);
+    }
+
+    // Counter allows us to skip ahead in O(1), buffered blocks start at 'block_index - block_count'
+    constexpr void discard(unsigned long long z) noexcept {
+        const unsigned long long target = this->position + z;
+        if (target < this->block.size()) {
+            this->position = static_cast<std::size_t>(target);
+            return;
+        }
+
+        this->block_index = this->block_index - block_count + target / 4;
+        this->generate_new_blocks();
+        this->position = static_cast<std::size_t>(target % 4);
+    }
+
+    // Parent streams differ in the upper half of the counter, each one has 2^64 blocks that can't overlap with others.
+    // Like with ChaCha20, children get a key derived from the key & the current stream, which gives them their own
+    // families of streams.
+    [[nodiscard]] constexpr _philox4 split() noexcept {
+        _philox4 result = *this;
+        result.derive_child_key();
+        this->advance_stream(1);
+        return result;
+    }
+
+    [[nodiscard]] constexpr _philox4 stream(std::uint64_t n) const noexcept {
+        _philox4 result = *this;
+        result.advance_stream(n);
+        result.derive_child_key();
+        return result;
+    }
+
+private:
+    constexpr void derive_child_key() noexcept {
+        _advance_stream(this->key, _child_stream_salt ^ this->stream_index);
+
+        // Regenerate buffered blocks with a new key, position stays the same
+        this->block_index -= block_count;
+        this->generate_new_blocks();
+    }
+
+    constexpr void advance_stream(std::uint64_t n) noexcept {
+        this->stream_index += n;
+
+        // Regenerate buffered blocks in a new stream, position stays the same
+        this->block_index -= block_count;
+        this->generate_new_blocks();
+    }
+};
+
+using Philox4x32 = _philox4<std::uint32_t, 16>;
+using Philox4x64 = _philox4<std::uint64_t, 4>;
+
+} // namespace generators
+
+// =====================
+// --- Distributions ---
+// =====================
+
+// Standard library distributions are implementation-defined, the same generator produces different values with
+// different compilers. Distributions below are fully specified by the library, which makes them reproducible
+// across platforms and noticeably faster. They use generator bits directly, which requires a generator with
+// full 32 or 64-bit range (all of the 'generators::', 'std::mt19937' and 'std::mt19937_64').
+
+// Some generators report 'min() == 1' since their output can't be zero, a single missing value out of 2^32+
+// has no practical effect on the distributions, so such generators are considered full range too
+template <class Generator>
+constexpr bool _is_full_range_generator =
+    Generator::min() <= 1 && (Generator::max() == std::numeric_limits<std::uint32_t>::max() ||
+                              Generator::max() == std::numeric_limits<std::uint64_t>::max());
+
+// Gets 32 or 64 random bits from any full range generator, 64-bit generators give the upper half
+// for 32-bit values since it has a better quality for some of them, 32-bit generators merge pairs
+template <class T, class Generator>
+[[nodiscard]] constexpr T _generate_bits(Generator& gen) {
+    static_assert(_is_full_range_generator<Generator>, "Generator should produce full range 32 or 64-bit values.");
+
+    constexpr bool is_64_bit = Generator::max() == std::numeric_limits<std::uint64_t>::max();
+
+    if constexpr (std::is_same_v<T, std::uint32_t>) {
+        if constexpr (is_64_bit) return static_cast<std::uint32_t>(static_cast<std::uint64_t>(gen()) >> 32);
+        else return static_cast<std::uint32_t>(gen());
+    } else {
+        static_assert(std::is_same_v<T, std::uint64_t>, "Bits can only be generated as 32 or 64-bit integers.");
+        if constexpr (is_64_bit) return static_cast<std::uint64_t>(gen());
+        else {
+            const auto low  = static_cast<std::uint32_t>(gen()); // separate statements since the order
+            const auto high = static_cast<std::uint32_t>(gen()); // of function argument evaluation is unspecified
+            return _merge_uint32_into_uint64(low, high);
+        }
+    }
+}
+
+// Lemire's nearly divisionless method, see https://arxiv.org/abs/1805.10941
+// Maps random bits to [0, range) with a multiplication, upper half of the product is the result and
+// the lower half tells us whether it falls into the biased region. Slow '%' is only needed in the rare
+// cases when we are close to that region. 'range == 0' stands for the full range of 'T'.
+template <class T, class Generator>
+[[nodiscard]] constexpr T _uniform_uint(Generator& gen, T range) {
+    if (range == 0) return _generate_bits<T>(gen);
+
+    T low{};
+    T high = _wide_multiply(_generate_bits<T>(gen), range, low);
+
+    if (low < range) {
+        const T threshold = static_cast<T>(T(0) - range) % range; // == 2^bits % range
+        while (low < threshold) high = _wide_multiply(_generate_bits<T>(gen), range, low);
+    }
+
+    return high;
+}
+
+// Floats are generated by taking the top 'digits' bits of an integer and scaling them to [0, 1),
+// this is the fastest uniform conversion that doesn't lose precision or introduce bias
+template <class T, class U>
+[[nodiscard]] constexpr T _bits_to_canonical(U bits) noexcept {
+    constexpr int digits = std::numeric_limits<T>::digits;
+    constexpr int width  = std::numeric_limits<U>::digits;
+    static_assert(digits < width, "Not enough bits to fill the mantissa.");
+
+    return static_cast<T>(bits >> (width - digits)) * (T(1) / static_cast<T>(U(1) << digits));
+}
+
+// Layer edges of the normal Ziggurat, 'x[0]' is the width of the base strip that includes the tail
+inline constexpr std::array<double, 129> _ziggurat_normal_x = {
+    3.7130862467425474,  3.442619855899,      3.2230849845811416,  3.083228858216868,   2.97869625264778,
+    2.894344007021529,   2.8231253505489105,  2.761169372387177,   2.7061135731218195,  2.6564064112613597,
+    2.6109722484318474,  2.5690336259249373,  2.5300096723888275,  2.493454522095372,   2.4590181774118305,
+    2.42642064553375,    2.3954342780110625,  2.3658713701176386,  2.3375752413392368,  2.310413683698763,
+    2.2842740596774718,  2.259059573869198,   2.234686395590979,   2.211081408878703,   2.1881804320760483,
+    2.1659267937489215,  2.144270182360395,   2.123165708673976,   2.1025731351892376,  2.0824562379920164,
+    2.062782274508308,   2.043521536655067,   2.0246469733773846,  2.006133869963471,   1.9879595741276188,
+    1.9701032608543254,  1.9525457295535555,  1.9352692282966217,  1.9182573008645087,  1.9014946531051502,
+    1.884967035707758,   1.8686611409944875,  1.8525645117280898,  1.8366654602584447,  1.8209529965961242,
+    1.8054167642192271,  1.7900469825998573,  1.7748343955860681,  1.7597702248995923,  1.744846128113799,
+    1.7300541605637292,  1.7153867407136663,  1.7008366185699155,  1.6863968467791668,  1.6720607540975998,
+    1.657821920954023,   1.6436741568628674,  1.6296114794706336,  1.6156280950431596,  1.6017183802213766,
+    1.5878768648905746,  1.5740982160229993,  1.5603772223661674,  1.5467087798599088,  1.5330878776740418,
+    1.5195095847659383,  1.5059690368632017,  1.4924614237813525,  1.4789819769899226,  1.4655259573427089,
+    1.4520886428892226,  1.4386653166845615,  1.425251254514058,   1.4118417124470557,  1.3984319141310033,
+    1.3850170377326498,  1.3715922024273406,  1.3581524543301413,  1.3446927517535447,  1.331207949665625,
+    1.3176927832094119,  1.3041418501286146,  1.2905495919261945,  1.2769102735601534,  1.2632179614546188,
+    1.2494664995730662,  1.2356494832633604,  1.2217602305399942,  1.2077917504159472,  1.1937367078331262,
+    1.1795873846639857,  1.16533563616475,    1.150972842148865,   1.1364898520131583,  1.1218769225825398,
+    1.1071236475340338,  1.0922188769072751,  1.0771506248928933,  1.0619059636948216,  1.0464709007640425,
+    1.0308302360681927,  1.0149673952513274,  0.9988642334929804,  0.9825008035154258,  0.9658550794011466,
+    0.948902625511303,   0.9316161966151473,  0.9139652510230287,  0.895915352580934,   0.8774274291129196,
+    0.8584568431938092,  0.8389522142975734,  0.8188539067003531,  0.7980920606440526,  0.7765839878947555,
+    0.7542306644540511,  0.7309119106424841,  0.7064796113354315,  0.6807479186691494,  0.6534786387399697,
+    0.6243585973360447,  0.5929629424714419,  0.5586921784081783,  0.5206560387620528,  0.4774378372966809,
+    0.42654798635541274, 0.36287143109701797, 0.2723208648139427,  0.0
+};
+
+// Layer edges of the exponential Ziggurat, same layout
+inline constexpr std::array<double, 257> _ziggurat_exponential_x = {
+    8.697117470131083,   7.69711747013105,    6.941033629377211,   6.478378493832567,   6.14416466577247,
+    5.882144315795396,   5.66641016745403,    5.482890627526059,   5.3230905057543945,  5.181487281301497,
+    5.0542884899813005,  4.938777085901248,   4.8329397410251085,  4.7352429966017375,  4.644491885420082,
+    4.559737061707347,   4.480211746528418,   4.405287693473569,   4.334443680317269,   4.267242480277361,
+    4.20331371373518,    4.142340865664047,   4.084051310408293,   4.028208544647932,   3.974606066673784,
+    3.9230625001354853,  3.8734176703995047,  3.8255294185223323,  3.7792709924116634,  3.734528894039793,
+    3.6912010902374144,  3.6491955157608493,  3.608428813128905,   3.5688252656483326,  3.5303158891293394,
+    3.4928376547740556,  3.456332821132756,   3.420748357251116,   3.386035442460297,   3.3521490309001054,
+    3.319047470970744,   3.2866921715990647,  3.2550473085704454,  3.2240795652862597,  3.193757903212236,
+    3.164053358025969,   3.134938858084436,   3.10638906233982,    3.078380215254086,   3.0508900166154507,
+    3.0238975044556717,  2.9973829495161257,  2.9713277599210848,  2.945714394895041,   2.920526286512736,
+    2.895747768600137,   2.8713640120155315,  2.847360965635184,   2.8237253024500304,  2.8004443702507333,
+    2.777506146439752,   2.75489919656234,    2.7326126361946956,  2.7106360958679243,  2.6889596887417992,
+    2.667573980773262,   2.6464699631518043,  2.6256390267977836,  2.6050729387408302,  2.5847638202141354,
+    2.5647041263169004,  2.544886627111865,   2.5253043900378227,  2.5059507635285887,  2.4868193617402046,
+    2.46790405029736,    2.449198932978245,   2.430698339264415,   2.4123968126888657,  2.394289099921453,
+    2.3763701405361357,  2.3586350574093324,  2.3410791477030295,  2.323697874390191,   2.3064868582835745,
+    2.289441870532264,   2.2725588255531495,  2.255833774367214,   2.2392628983129033,  2.222842503111031,
+    2.206569013257658,   2.1904389667232147,  2.174449009937769,   2.15859589304388,    2.1428764653998362,
+    2.1272876713173625,  2.1118265460190364,  2.0964902118017092,  2.0812758743932194,  2.06618081949057,
+    2.0512024094685795,  2.0363380802487643,  2.0215853383189204,  2.006941757894513,   1.9924049782135709,
+    1.9779727009573547,  1.9636426877895425,  1.949412758007179,   1.9352807862970456,  1.921244700591522,
+    1.9073024800183815,  1.893452152939302,   1.8796917950722052,  1.866019527692822,   1.8524335159111696,
+    1.8389319670188737,  1.8255131289035136,  1.8121752885263844,  1.7989167704602846,  1.7857359354841196,
+    1.7726311792312992,  1.7596009308890685,  1.7466436519460682,  1.7337578349855653,  1.7209420025219293,
+    1.7081947058780518,  1.695514524101532,   1.682900062917548,   1.670349953716446,   1.6578628525741665,
+    1.6454374393037174,  1.6330724165359853,  1.6207665088282517,  1.6085184617988522,  1.5963270412864772,
+    1.5841910325326827,  1.5721092393862235,  1.5600804835278819,  1.5481036037145073,  1.5361774550410259,
+    1.5243009082192198,  1.5124728488721106,  1.5006921768428103,  1.4889578055167394,  1.4772686611561272,
+    1.465623682245739,   1.454021818848787,   1.4424620319720058,  1.430943292938873,   1.4194645827699766,
+    1.408024891569529,   1.3966232179170353,  1.3852585682631153,  1.373929956328484,   1.3626364025050801,
+    1.3513769332583285,  1.3401505805294982,  1.32895638113711,    1.317793376176318,   1.3066606104151675,
+    1.2955571316865941,  1.284481990275006,   1.2734342382962345,  1.2624129290696087,  1.2514171164808459,
+    1.2404458543343997,  1.2294981956938424,  1.2185731922087835,  1.2076698934267545,  1.1967873460883964,
+    1.1859245934041955,  1.175080674310905,   1.1642546227056723,  1.1534454666557679,  1.142652227581666,
+    1.1318739194110716,  1.1211095477013235,  1.1103581087274044,  1.0996185885325906,  1.0888899619385402,
+    1.0781711915113656,  1.067461226479961,   1.0567590016025445,  1.0460634359770373,  1.0353734317905217,
+    1.0246878730026105,  1.0140056239570898,  1.00332552791569,    0.992646405507269,   0.9819670530850557,
+    0.9712862409838965,  0.9606027116686595,  0.949915177764069,   0.9392223199552553,  0.9285227847472034,
+    0.9178151820700372,  0.9070980827156833,  0.8963700155898828,  0.8856294647617444,  0.874874866291018,
+    0.8641046048109973,  0.853317009842366,   0.8425103518103612,  0.8316828377342658,  0.8208326065544043,
+    0.8099577240574108,  0.7990561773554795,  0.7881258688694849,  0.7771646097591219,  0.7661701127354269,
+    0.7551399841819743,  0.7440717155005001,  0.7329626735843573,  0.7218100903087481,  0.7106110509096468,
+    0.6993624811032236,  0.6880611327737395,  0.6767035680295143,  0.6652861413926693,  0.6538049798476563,
+    0.6422559604245276,  0.6306346849334814,  0.6189364513948671,  0.607156221620291,   0.5952885842914937,
+    0.5833277127487603,  0.5712673165325789,  0.559100585511531,   0.5468201251633007,  0.5344178812371556,
+    0.521885051592125,   0.5092119824436441,  0.4963880455186605,  0.483401491653451,   0.47023927508215796,
+    0.456886840931409,   0.443327866073541,   0.4295439402253991,  0.41551416960034454, 0.40121467889626555,
+    0.3866179779411071,  0.3716921453299044,  0.35639976025838055, 0.34069648106483547, 0.32452911701689524,
+    0.30783295467491745, 0.2905279554912151,  0.27251318547844866, 0.2536583633858951,  0.2337904830596567,
+    0.21267151063094725, 0.1899586896224108,  0.16512762256416394, 0.13730498093998594, 0.10483850756578662,
+    0.06385216381495827, 0.0
+};
+
+// Ratios 'x[i + 1] / x[i]', values below them fall into the rectangular part of the layer and get accepted
+// immediately, which happens ~99% of the time. IEEE division is correctly rounded and therefore deterministic,
+// so computing them at compile time gives the same values as at runtime.
+template <std::size_t N>
+[[nodiscard]] constexpr std::array<double, N - 1> _ziggurat_ratios(const std::array<double, N>& x) noexcept {
+    std::array<double, N - 1> ratios{};
+    for (std::size_t i = 0; i < N - 1; ++i) ratios[i] = x[i + 1] / x[i];
+    return ratios;
+}
+
+inline constexpr auto _ziggurat_normal_ratios      = _ziggurat_ratios(_ziggurat_normal_x);
+inline constexpr auto _ziggurat_exponential_ratios = _ziggurat_ratios(_ziggurat_exponential_x);
+
+// Ziggurat method by Marsaglia & Tsang with Doornik's layout, see https://www.doornik.com/research/ziggurat.pdf
+// Single 64-bit value provides both the layer (lowest bits) and the point within it (highest 53 bits)
+template <class Generator>
+[[nodiscard]] double _ziggurat_normal(Generator& gen) {
+    constexpr double r = 3.442619855899; // start of the tail
+    const auto&      x = _ziggurat_normal_x;
+    const auto       f = [](double v) { return std::exp(-0.5 * v * v); };
+
+    while (true) {
+        const std::uint64_t bits = _generate_bits<std::uint64_t>(gen);
+        const std::size_t   i    = bits & 0x7F;
+        const double        u    = 2. * _bits_to_canonical<double>(bits) - 1.;
+
+        if (std::abs(u) < _ziggurat_normal_ratios[i]) return u * x[i];
+
+        // Base strip, sample the tail with Marsaglia's method
+        if (i == 0) {
+            double tail, y;
+            do {
+                tail = std::log(1. - _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen))) / r;
+                y    = std::log(1. - _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen)));
+            } while (-2. * y < tail * tail);
+            return (u < 0.) ? tail - r : r - tail;
+        }
+
+        // Wedge between the layer rectangle and the curve
+        const double value = u * x[i];
+        const double f0 = f(x[i]), f1 = f(x[i + 1]);
+        if (f0 + _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen)) * (f1 - f0) < f(value)) return value;
+    }
+}
+
+template <class Generator>
+[[nodiscard]] double _ziggurat_exponential(Generator& gen) {
+    constexpr double r = 7.69711747013104972; // start of the tail
+    const auto&      x = _ziggurat_exponential_x;
+    const auto       f = [](double v) { return std::exp(-v); };
+
+    while (true) {
+        const std::uint64_t bits = _generate_bits<std::uint64_t>(gen);
+        const std::size_t   i    = bits & 0xFF;
+        const double        u    = _bits_to_canonical<double>(bits);
+
+        if (u < _ziggurat_exponential_ratios[i]) return u * x[i];
+
+        // Base strip, exponential tail is just a shifted exponential distribution
+        if (i == 0) return r - std::log(1. - _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen)));
+
+        // Wedge between the layer rectangle and the curve
+        const double value = u * x[i];
+        const double f0 = f(x[i]), f1 = f(x[i + 1]);
+        if (f0 + _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen)) * (f1 - f0) < f(value)) return value;
+    }
+}
+
+namespace distributions {
+
+template <class T, class Generator>
+[[nodiscard]] constexpr T generate_canonical(Generator& gen) {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Canonical values can be float or double.");
+
+    if constexpr (std::is_same_v<T, float>) return _bits_to_canonical<float>(_generate_bits<std::uint32_t>(gen));
+    else return _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen));
+}
+
+// Uniform integer in a [min, max] range
+template <class T = int>
+class UniformIntDistribution {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Distribution requires an integer type.");
+
+    using unsigned_type = std::conditional_t<(sizeof(T) > 4), std::uint64_t, std::uint32_t>;
+
+    T             min_value;
+    T             max_value;
+    unsigned_type range; // wraps around to 0 for the full range
+
+public:
+    using result_type = T;
+
+    constexpr UniformIntDistribution() noexcept : UniformIntDistribution(0) {}
+
+    constexpr explicit UniformIntDistribution(T min, T max = std::numeric_limits<T>::max()) noexcept
+        : min_value(min), max_value(max),
+          range(static_cast<unsigned_type>(static_cast<unsigned_type>(max) - static_cast<unsigned_type>(min) + 1)) {}
+
+    template <class Generator>
+    constexpr T operator()(Generator& gen) const {
+        // Adding in unsigned arithmetic avoids signed overflow, conversion back is a no-op on two's complement
+        return static_cast<T>(static_cast<unsigned_type>(this->min_value) + _uniform_uint(gen, this->range));
+    }
+
+    constexpr void reset() noexcept {}
+
+    [[nodiscard]] constexpr T a() const noexcept { return this->min_value; }
+    [[nodiscard]] constexpr T b() const noexcept { return this->max_value; }
+    [[nodiscard]] constexpr T min() const noexcept { return this->min_value; }
+    [[nodiscard]] constexpr T max() const noexcept { return this->max_value; }
+};
+
+// Uniform float in a [min, max) range
+template <class T = double>
+class UniformRealDistribution {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Distribution requires a float or double.");
+
+    T min_value;
+    T max_value;
+
+public:
+    using result_type = T;
+
+    constexpr explicit UniformRealDistribution(T min = 0, T max = 1) noexcept : min_value(min), max_value(max) {}
+
+    template <class Generator>
+    constexpr T operator()(Generator& gen) const {
+        return this->min_value + (this->max_value - this->min_value) * generate_canonical<T>(gen);
+    }
+
+    constexpr void reset() noexcept {}
+
+    [[nodiscard]] constexpr T a() const noexcept { return this->min_value; }
+    [[nodiscard]] constexpr T b() const noexcept { return this->max_value; }
+    [[nodiscard]] constexpr T min() const noexcept { return this->min_value; }
+    [[nodiscard]] constexpr T max() const noexcept { return this->max_value; }
+};
+
+// Normal distribution N(mean, stddev^2), sampled in double precision regardless of 'T'
+template <class T = double>
+class NormalDistribution {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Distribution requires a float or double.");
+
+    T mean_value;
+    T stddev_value;
+
+public:
+    using result_type = T;
+
+    constexpr explicit NormalDistribution(T mean = 0, T stddev = 1) noexcept
+        : mean_value(mean), stddev_value(stddev) {}
+
+    template <class Generator>
+    T operator()(Generator& gen) const {
+        return this->mean_value + this->stddev_value * static_cast<T>(_ziggurat_normal(gen));
+    }
+
+    constexpr void reset() noexcept {}
+
+    [[nodiscard]] constexpr T mean() const noexcept { return this->mean_value; }
+    [[nodiscard]] constexpr T stddev() const noexcept { return this->stddev_value; }
+    [[nodiscard]] constexpr T min() const noexcept { return std::numeric_limits<T>::lowest(); }
+    [[nodiscard]] constexpr T max() const noexcept { return std::numeric_limits<T>::max(); }
+};
+
+// Exponential distribution with a rate 'lambda', sampled in double precision regardless of 'T'
+template <class T = double>
+class ExponentialDistribution {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Distribution requires a float or double.");
+
+    T lambda_value;
+
+public:
+    using result_type = T;
+
+    constexpr explicit ExponentialDistribution(T lambda = 1) noexcept : lambda_value(lambda) {}
+
+    template <class Generator>
+    T operator()(Generator& gen) const {
+        return static_cast<T>(_ziggurat_exponential(gen)) / this->lambda_value;
+    }
+
+    constexpr void reset() noexcept {}
+
+    [[nodiscard]] constexpr T lambda() const noexcept { return this->lambda_value; }
+    [[nodiscard]] constexpr T min() const noexcept { return 0; }
+    [[nodiscard]] constexpr T max() const noexcept { return std::numeric_limits<T>::max(); }
+};
+
+} // namespace distributions
+
+// ===========================
+// --- Default global PRNG ---
+// ===========================
+
+using default_generator_type = generators::Xoshiro256PlusPlus;
+using default_result_type    = default_generator_type::result_type;
+
+// Global seed only gets read when a thread-local generator notices that the seed generation has changed, which means
+// seeding costs nothing for the threads that don't generate anything and 'rand_...()' functions never contend
+inline std::atomic<default_result_type> _global_seed{_default_seed<default_result_type>};
+inline std::atomic<std::uint64_t>       _global_seed_generation{0};
+inline std::atomic<std::uint64_t>       _thread_count{0};
+
+// Thread index is assigned in the order of the first 'rand_...()' call on each thread unless it was pinned with
+// 'seed_thread()', index 0 uses the global seed directly so single-threaded code gets the same sequence as
+// a generator seeded with the same value
+[[nodiscard]] constexpr default_result_type _thread_seed(default_result_type seed, std::uint64_t thread_index) {
+    if (!thread_index) return seed;
+    std::uint64_t splitmix64_state = seed ^ _splitmix64(thread_index);
+    return _splitmix64(splitmix64_state);
+}
+
+struct _thread_local_generator {
+    default_generator_type generator;
+    std::uint64_t          thread_index = _thread_count.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t          generation   = std::numeric_limits<std::uint64_t>::max(); // forces seeding on first use
+};
+
+inline thread_local _thread_local_generator _thread_generator;
+
+// Returns generator of the current thread, the only synchronization on each call is a single atomic load
+inline default_generator_type& thread_generator() noexcept {
+    _thread_local_generator& local = _thread_generator;
+
+    const std::uint64_t generation = _global_seed_generation.load(std::memory_order_acquire);
+    if (local.generation != generation) {
+        local.generation = generation;
+        local.generator.seed(_thread_seed(_global_seed.load(std::memory_order_relaxed), local.thread_index));
+    }
+
+    return local.generator;
+}
+
+inline std::seed_seq entropy_seq() {
+    // Ensure thread safery of our entropy source, it should generally work fine even without
+    // it, but with this we can be sure things never race
+    std::mutex                  entropy_mutex;
+    std::lock_guard<std::mutex> entropy_guard(entropy_mutex);
+
+    // Hardware entropy (if implemented),
+    // some platfroms (mainly MinGW) implements random device as a regular PRNG that
+    // doesn't change from run to run, this is horrible, but we can somewhat improve
+    // things by mixing other sources of entropy. Since hardware entropy is a rather
+    // limited resource we only call it once.
+    static std::uint32_t seed_rd          = std::random_device{}();
+    // after that we just scramble it with a regular PRNG
+    static std::uint32_t splitmix32_state = seed_rd;
+    seed_rd                               = _splitmix32(splitmix32_state);
+
+    // Time in nanoseconds (on some platforms microseconds)
+    const auto seed_time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+    // Counter that gets incremented each time
+    static std::uint32_t seed_counter = 0;
+    ++seed_counter;
+
+    // Note:
+    // There are other sources of entropy, such as memory space, heap/stack/function adresses,
+    // but those can be rather "constant" on some platforms, using intrinsics could also be good
+    // but that isn't portable
+
+    return {seed_rd, _crush_to_uint32(seed_time), seed_counter};
 }
 
-template <class T>
-constexpr T _default_seed = std::numeric_limits<T>::max() / 2;
-// an "overall decent" default seed - doesn't gave too many zeroes,
-// unlikely to accidentaly match with a user-defined seed
+inline std::uint32_t entropy() {
+    auto seq = entropy_seq();
+    return _seed_seq_to_uint32(seq);
+    // returns 'std::uint32_t' to mimic the return type of 'std::random_device', if we return uint64_t
+    // brace-initializers will complain about narrowing conversion on some generators. If someone want
+    // more entropy than that they can always use the whole sequence as a generic solution.
+    // Also having one 'random::entropy()' is much nicer than 'random::entropy_32()' & 'random::entropy_64()'.
+}
 
-template <class T>
-[[nodiscard]] constexpr T _ensure_nonzero(T value) noexcept {
-    return (value) ? value : _default_seed<T> + 1;
+// Reseeds default generators of all threads, each thread picks up the new seed on its next 'rand_...()' call
+inline void seed(default_result_type random_seed) {
+    _global_seed.store(random_seed, std::memory_order_relaxed);
+    _global_seed_generation.fetch_add(1, std::memory_order_release);
 }
-// some generators shouldn't be zero initialized, in a perfect world the user would never
-// do that, but in case they happened to do so regardless we can remap 0 to some "weird"
-// value that isn't like to intersect with any other seeds generated by the user. Rejecting
-// zero seeds completely wouldn't be appropriate for compatibility reasons.
 
-// =========================
-// --- Random Generators ---
-// =========================
+inline void seed_with_entropy() {
+    auto seq = entropy_seq();
+    seed(_seed_seq_to_uint64(seq));
+}
 
-// Implementation of several "good" PRNGS.
-//
-// All generators meets uniform random number generator requirements
-// (C++17 and below, see https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator)
-// (C++20 and above, see https://en.cppreference.com/w/cpp/numeric/random/uniform_random_bit_generator)
+// Pins the index of the current thread, its generator gets reseeded on the next use and no longer depends
+// on the order in which threads made their first 'rand_...()' call
+inline void seed_thread(std::uint64_t thread_index) noexcept {
+    _thread_local_generator& local = _thread_generator;
+    local.thread_index             = thread_index;
+    local.generation               = std::numeric_limits<std::uint64_t>::max();
+}
+
+// Global generator used to be a variable, it is kept as a stateless handle forwarding to the generator of
+// the current thread, so that code like 'std::shuffle(first, last, random::default_generator)' still works
+struct _default_generator_handle {
+    using result_type = default_result_type;
+
+    [[nodiscard]] static constexpr result_type min() noexcept { return default_generator_type::min(); }
+    [[nodiscard]] static constexpr result_type max() noexcept { return default_generator_type::max(); }
+
+    result_type operator()() noexcept { return thread_generator()(); }
+
+    void seed(result_type random_seed) { random::seed(random_seed); }
+};
+
+inline _default_generator_handle default_generator;
+
+// ========================
+// --- Random Functions ---
+// ========================
 
 // Note 1:
-// As of C++17 there is little point in declaring generator constructors and methods as 'constexpr',
-// however in newer standards it would allow PRNGs to be used in constexpr context.
-//
-// Unfortunately, we can't do the same for "convenient random functions"
-// since  they use std distributions which have no constexpr.
+// All functions use distributions from 'random::distributions::', which means the results are the same
+// on every platform, unlike with 'std::uniform_..._distribution<>' that is implementation-defined.
+// Distributions are trivial to construct, creating them on each call has no overhead.
 
 // Note 2:
-// Here PRNGs take 'SeedSeq' as a forwaring reference 'SeedSeq&&', while standard PRNGS take 'SeedSeq&',
-// this is how it should've been done in the standard too, but for some reason they only standardized
-// l-value references. One of the many faults of <random>.
+// No '[[nodiscard]]' since random functions inherently can't be pure due to advancing the generator state.
+// Discarding return values while not very sensible, can still be done for the sake of advancing state.
+// Ideally we would want users to advance the state directly, but I'm not sure how to communicate that in
+// '[[nodiscard]]' warnings.
 
-namespace generators {
+inline int rand_int(int min, int max) {
+    const distributions::UniformIntDistribution<int> distr{min, max};
+    return distr(thread_generator());
+}
 
-// --- 32-bit PRNGs ---
-// --------------------
+inline int rand_uint(unsigned int min, unsigned int max) {
+    const distributions::UniformIntDistribution<unsigned int> distr{min, max};
+    return distr(thread_generator());
+}
+
+inline float rand_float() { return distributions::generate_canonical<float>(thread_generator()); }
+
+inline float rand_float(float min, float max) {
+    const distributions::UniformRealDistribution<float> distr{min, max};
+    return distr(thread_generator());
+}
+
+inline float rand_normal_float() {
+    const distributions::NormalDistribution<float> distr;
+    return distr(thread_generator());
+}
+
+inline double rand_double() { return distributions::generate_canonical<double>(thread_generator()); }
+
+inline double rand_double(double min, double max) {
+    const distributions::UniformRealDistribution<double> distr{min, max};
+    return distr(thread_generator());
+}
+
+inline double rand_normal_double() {
+    const distributions::NormalDistribution<double> distr;
+    return distr(thread_generator());
+}
+
+inline bool rand_bool() { return static_cast<bool>(rand_uint(0, 1)); }
+
+template <class T>
+const T& rand_choise(std::initializer_list<T> objects) {
+    const int random_index = rand_int(0, static_cast<int>(objects.size()) - 1);
+    return objects.begin()[random_index];
+}
+
+template <class T>
+T rand_linear_combination(const T& A, const T& B) { // random linear combination of 2 colors/vectors/etc
+    const auto coef = rand_double();
+    return A * coef + B * (1. - coef);
+}
+
+// =======================
+// --- Bulk Generation ---
+// =======================
+
+// Generating values one 'operator()' at a time is limited by the latency of a single state update. Multi-lane
+// generators keep several interleaved states in a "structure of arrays" layout and advance all of them at once,
+// the inner loop over lanes has no dependencies between iterations which lets compilers turn it into SIMD code
+// for any instruction set (SSE2 / AVX2 / AVX-512 / NEON) without us having to write platform-specific intrinsics.
+//
+// Each lane is a separate stream of the original generator, output is interleaved between lanes. Lane streams
+// can't be the ones reachable through the public API ('split()', 'stream()', 'jump()', 'long_jump()'), otherwise
+// bulk generation with several split generators would repeat the same values in different children. Xoshiro256++
+// lanes are separated by 2^96 steps, which no combination of 2^128 and 2^192 jumps can produce, RomuTrio32 lanes
+// use a differently salted stream hash. After the generation original generator continues from the state of the
+// first lane. For Xoshiro256++ this means consecutive bulk calls continue the same lane streams instead of
+// overlapping with them.
+
+template <std::size_t lanes>
+struct _xoshiro256pp_lanes {
+    using result_type = std::uint64_t;
+    using generator   = generators::Xoshiro256PlusPlus;
+
+    constexpr static std::size_t size      = lanes;
+    constexpr static std::size_t threshold = 65536; // setting up lanes takes 'lanes - 1' jumps, ~10 us total
+
+    std::array<result_type, lanes> s0{}, s1{}, s2{}, s3{};
+
+    // Equivalent to 2^96 calls to 'operator()', computed as 'x^(2^96) mod P(x)' for the characteristic polynomial
+    // of the generator, the same way as reference polynomials of 'jump()' & 'long_jump()'
+    constexpr static std::array<std::uint64_t, 4> lane_jump = {0x148c356c3114b7a9, 0xcdb45d7def42c317,
+                                                               0xb27c05962ea56a13, 0x31eebb6c82a9615f};
+
+    explicit _xoshiro256pp_lanes(generator gen) noexcept {
+        for (std::size_t i = 0; i < lanes; ++i, gen.jump_with_polynomial(lane_jump))
+            s0[i] = gen.s[0], s1[i] = gen.s[1], s2[i] = gen.s[2], s3[i] = gen.s[3];
+    }
+
+    void store(generator& gen) const noexcept { gen.s = {s0[0], s1[0], s2[0], s3[0]}; }
+
+    // State is copied into locals so the compiler knows it can't alias with the output
+    void generate(result_type* out, std::size_t blocks) noexcept {
+        auto a = this->s0, b = this->s1, c = this->s2, d = this->s3;
+
+        for (std::size_t k = 0; k < blocks; ++k, out += lanes)
+            for (std::size_t i = 0; i < lanes; ++i) {
+                out[i]              = _rotate_left(a[i] + d[i], 23) + a[i];
+                const result_type t = b[i] << 17;
+                c[i] ^= a[i];
+                d[i] ^= b[i];
+                b[i] ^= c[i];
+                a[i] ^= d[i];
+                c[i] ^= t;
+                d[i] = _rotate_left(d[i], 45);
+            }
+
+        this->s0 = a, this->s1 = b, this->s2 = c, this->s3 = d;
+    }
+};
+
+template <std::size_t lanes>
+struct _romu_trio32_lanes {
+    using result_type = std::uint32_t;
+    using generator   = generators::RomuTrio32;
+
+    constexpr static std::size_t size      = lanes;
+    constexpr static std::size_t threshold = 256;
+
+    std::array<result_type, lanes> s0{}, s1{}, s2{};
+
+    constexpr static std::uint64_t salt = 0x9E3779B97F4A7C15; // anything but the salts used by 'split()'
+
+    explicit _romu_trio32_lanes(generator gen) noexcept {
+        for (std::size_t i = 0; i < lanes; ++i, _advance_stream(gen.s, salt))
+            s0[i] = gen.s[0], s1[i] = gen.s[1], s2[i] = gen.s[2];
+    }
+
+    void store(generator& gen) const noexcept { gen.s = {s0[0], s1[0], s2[0]}; }
+
+    void generate(result_type* out, std::size_t blocks) noexcept {
+        auto x = this->s0, y = this->s1, z = this->s2;
+
+        for (std::size_t k = 0; k < blocks; ++k, out += lanes)
+            for (std::size_t i = 0; i < lanes; ++i) {
+                const result_type xp = x[i], yp = y[i], zp = z[i];
+                out[i]               = xp;
+                x[i]                 = 3323815723u * zp;
+                y[i]                 = _rotate_left(result_type(yp - xp), 6);
+                z[i]                 = _rotate_left(result_type(zp - yp), 22);
+            }
+
+        this->s0 = x, this->s1 = y, this->s2 = z;
+    }
+};
+
+// 16 lanes fill a single AVX-512 register with 32-bit states or two with 64-bit ones, narrower instruction sets
+// just use more registers. Benchmarks show this to be the fastest option on all of them, as long as compiler
+// optimizations include the auto-vectorization ('-O3' for GCC, '-O2' for Clang).
+template <class Generator>
+using _lanes_of = std::conditional_t<std::is_same_v<Generator, generators::Xoshiro256PlusPlus>, _xoshiro256pp_lanes<16>,
+                                     std::conditional_t<std::is_same_v<Generator, generators::RomuTrio32>,
+                                                        _romu_trio32_lanes<16>, void>>;
+
+template <class Generator>
+void _generate(Generator& gen, typename Generator::result_type* data, std::size_t size) {
+    using lanes_type = _lanes_of<Generator>;
+
+    if constexpr (!std::is_void_v<lanes_type>) {
+        if (size >= lanes_type::threshold) {
+            lanes_type lanes(gen);
+
+            const std::size_t blocks    = size / lanes_type::size;
+            const std::size_t remainder = size % lanes_type::size;
+
+            lanes.generate(data, blocks);
+            if (remainder) {
+                std::array<typename Generator::result_type, lanes_type::size> tail;
+                lanes.generate(tail.data(), 1);
+                for (std::size_t i = 0; i < remainder; ++i) data[blocks * lanes_type::size + i] = tail[i];
+            }
+
+            lanes.store(gen);
+            return;
+        }
+    }
+
+    for (std::size_t i = 0; i < size; ++i) data[i] = gen();
+}
+
+// Same thing, except values are passed to 'consume(chunk, offset, count)' in chunks small enough to stay
+// in L1 cache, this way we can transform them without an additional pass over memory
+template <class Generator, class Consumer>
+void _generate_chunks(Generator& gen, std::size_t size, Consumer&& consume) {
+    using result_type = typename Generator::result_type;
+    using lanes_type  = _lanes_of<Generator>;
+
+    constexpr std::size_t chunk_size = 1024; // has to be a multiple of any lane count
+
+    std::array<result_type, chunk_size> chunk;
+
+    const auto for_each_chunk = [&](auto&& fill) {
+        for (std::size_t offset = 0; offset < size; offset += chunk_size) {
+            const std::size_t count = std::min(chunk_size, size - offset);
+            fill(chunk.data(), count);
+            consume(chunk.data(), offset, count);
+        }
+    };
+
+    if constexpr (!std::is_void_v<lanes_type>) {
+        if (size >= lanes_type::threshold) {
+            lanes_type lanes(gen);
+            for_each_chunk([&](result_type* out, std::size_t count) {
+                lanes.generate(out, (count + lanes_type::size - 1) / lanes_type::size);
+            });
+            lanes.store(gen);
+            return;
+        }
+    }
+
+    for_each_chunk([&](result_type* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = gen();
+    });
+}
+
+// Floats need 64 random bits, 32-bit generators merge pairs of values
+template <class Generator, class Consumer>
+void _generate_uint64_chunks(Generator& gen, std::size_t size, Consumer&& consume) {
+    using result_type = typename Generator::result_type;
+    static_assert(sizeof(result_type) == 8 || sizeof(result_type) == 4, "Generator should produce 32 or 64 bits.");
+
+    if constexpr (sizeof(result_type) == 8) {
+        _generate_chunks(gen, size, consume);
+    } else {
+        std::array<std::uint64_t, 512> merged;
+        _generate_chunks(gen, 2 * size, [&](const result_type* bits, std::size_t offset, std::size_t count) {
+            for (std::size_t i = 0; i < count / 2; ++i)
+                merged[i] = _merge_uint32_into_uint64(bits[2 * i], bits[2 * i + 1]);
+            consume(merged.data(), offset / 2, count / 2);
+        });
+    }
+}
+
+template <class Generator, class T>
+void _fill_uniform(Generator& gen, T* data, std::size_t size, T min, T max) {
+    static_assert(std::is_floating_point_v<T>, "Uniform fill requires a floating point container.");
+
+    _generate_uint64_chunks(gen, size, [&](const std::uint64_t* bits, std::size_t offset, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) data[offset + i] = min + (max - min) * _bits_to_canonical<T>(bits[i]);
+    });
+}
+
+// Ziggurat needs extra random values in ~1% of the cases, which doesn't fit into the lane-based generation,
+// so the fill is fully scalar. Transforms that would fit (polar method, Box-Muller) call 'log()' & 'sqrt()'
+// for every pair of values, which costs more than what multi-lane bits save.
+template <class Generator, class T>
+void _fill_normal(Generator& gen, T* data, std::size_t size, T mean, T stddev) {
+    static_assert(std::is_floating_point_v<T>, "Normal fill requires a floating point container.");
+
+    const distributions::NormalDistribution<T> distr(mean, stddev);
+    for (std::size_t i = 0; i < size; ++i) data[i] = distr(gen);
+}
+
+template <class Container>
+using _container_value_type = std::remove_reference_t<decltype(*std::data(std::declval<Container&>()))>;
+
+template <class Generator, class Container, _is_generator_enable_if<Generator> = true,
+          _is_contiguous_container_enable_if<Container> = true>
+void generate(Generator& gen, Container& container) {
+    static_assert(std::is_same_v<_container_value_type<Container>, typename Generator::result_type>,
+                  "Container should hold values of the generator 'result_type'.");
+    _generate(gen, std::data(container), std::size(container));
+}
+
+template <class Container, _is_contiguous_container_enable_if<Container> = true>
+void generate(Container& container) {
+    generate(thread_generator(), container);
+}
+
+template <class Generator, class Container, _is_generator_enable_if<Generator> = true,
+          _is_contiguous_container_enable_if<Container> = true>
+void fill_uniform(Generator& gen, Container& container, _container_value_type<Container> min = 0,
+                  _container_value_type<Container> max = 1) {
+    _fill_uniform(gen, std::data(container), std::size(container), min, max);
+}
+
+template <class Container, _is_contiguous_container_enable_if<Container> = true>
+void fill_uniform(Container& container, _container_value_type<Container> min = 0,
+                  _container_value_type<Container> max = 1) {
+    fill_uniform(thread_generator(), container, min, max);
+}
+
+template <class Generator, class Container, _is_generator_enable_if<Generator> = true,
+          _is_contiguous_container_enable_if<Container> = true>
+void fill_normal(Generator& gen, Container& container, _container_value_type<Container> mean = 0,
+                 _container_value_type<Container> stddev = 1) {
+    _fill_normal(gen, std::data(container), std::size(container), mean, stddev);
+}
+
+template <class Container, _is_contiguous_container_enable_if<Container> = true>
+void fill_normal(Container& container, _container_value_type<Container> mean = 0,
+                 _container_value_type<Container> stddev = 1) {
+    fill_normal(thread_generator(), container, mean, stddev);
+}
+
+// =========================
+// --- Discrete sampling ---
+// =========================
+
+// Splits 'block_count' independent blocks of work between hardware threads, 'func(block)' should only touch the
+// data of its own block. Results depend only on the block layout, never on the number of threads or their timing.
+// We spawn threads directly since 'utl::random' doesn't depend on other modules, this only gets used for O(N)
+// passes over large arrays where the cost of launching a few threads is negligible.
+template <class Func>
+void _parallel_for_blocks(std::size_t block_count, std::size_t thread_count, Func&& func) {
+    if (!thread_count) thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    thread_count = std::min(thread_count, block_count);
+
+    std::atomic<std::size_t> next_block{0};
+    const auto               worker = [&] {
+        for (std::size_t block; (block = next_block.fetch_add(1, std::memory_order_relaxed)) < block_count;)
+            func(block);
+    };
 
-// Implementation of 32-bit Romu Trio engine from paper by "Mark A. Overton",
-// see https://www.romu-random.org/
-//     https://www.romu-random.org/romupaper.pdf
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < thread_count; ++t) threads.emplace_back(worker);
+    worker(); // calling thread does its share of work too
+    for (auto& thread : threads) thread.join();
+}
+
+// Walker's alias method, see "An Efficient Method for Generating Discrete Random Variables with General
+// Distributions" by A. J. Walker, table construction is based on "A Linear Algorithm For Generating Random Numbers
+// With a Given Distribution" by M. D. Vose
+//     https://www.keithschwarz.com/darts-dice-coins/
 //
-// Performance: Excellent
-// Quality:     3/5
-// State:       16 bytes
+// Each of the N table entries holds a 'threshold' & an 'alias', sampling picks an entry uniformly and returns
+// either its own index or its alias based on a threshold, which means O(1) time & a single memory access.
 //
-// Not the best one for general use, but provides bleeding edge performance.
-// Depending on 32/64-bit CPU instruction set can lead to huge speedup.
+// Probabilities are converted to 32-bit fixed point relative to the average one, which makes all of the
+// arithmetic exact. Thanks to that the table can be built with prefix sums, which is parallel and always
+// produces the same table regardless of the thread count, unlike the floating point Vose algorithm.
 //
-class RomuTrio32 {
-public:
-    using result_type = std::uint32_t;
+// Weights are split into "light" ones (below average) that have a deficit and "heavy" ones that have an excess.
+// Each light takes its deficit from a heavy, once a heavy gives away enough to fall below average it takes
+// the rest from the next heavy. In terms of prefix sums of deficits 'D' & excesses 'E' in the index order:
+//    - light 'i' takes from the first heavy with 'E[j] > D[i - 1]'
+//    - heavy 'j' takes 'D[k] - E[j]' from the heavy 'j + 1', where 'k' is the first light with 'D[k] >= E[j]'
+// which is what Vose algorithm does with stacks, except in the index order. Since both prefix sums are monotonic,
+// each block of indices only needs to find its starting position in the other list, after that everything
+// is a linear sweep. We don't store any intermediate lists, which keeps memory traffic close to a single pass.
 
-private:
-    std::array<result_type, 3> s{};
+struct _alias_entry {
+    std::uint32_t threshold; // chance of keeping own index is 'threshold / 2^32'
+    std::uint32_t alias;
+};
 
-public:
-    constexpr explicit RomuTrio32(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+constexpr std::uint64_t _alias_unit        = std::uint64_t(1) << 32; // fixed point value of an average weight
+constexpr std::size_t   _alias_block_size  = std::size_t(1) << 16;
+constexpr std::size_t   _alias_max_entries = std::size_t(1) << 31; // keeps all of the sums below 2^63
+
+[[nodiscard]] constexpr _alias_entry _make_alias_entry(std::size_t index, std::uint64_t weight,
+                                                       std::size_t alias) noexcept {
+    if (weight >= _alias_unit) // always keeps own index
+        return {std::numeric_limits<std::uint32_t>::max(), static_cast<std::uint32_t>(index)};
+    return {static_cast<std::uint32_t>(weight), static_cast<std::uint32_t>(alias)};
+}
+
+// 'weight(i)' returns i-th weight as a double, 'thread_count == 0' means all hardware threads
+template <class WeightFunc>
+[[nodiscard]] std::vector<_alias_entry> _build_alias_table(std::size_t size, WeightFunc&& weight,
+                                                           std::size_t thread_count = 0) {
+    if (!size) throw std::invalid_argument("Discrete distribution requires at least one weight.");
+    if (size >= _alias_max_entries)
+        throw std::invalid_argument("Discrete distribution supports up to 2^31 - 1 weights, " + std::to_string(size) +
+                                    " were given.");
+
+    const std::size_t block_count = (size + _alias_block_size - 1) / _alias_block_size;
+    const auto        block_begin = [&](std::size_t block) { return block * _alias_block_size; };
+    const auto block_end = [&](std::size_t block) { return std::min(size, (block + 1) * _alias_block_size); };
+
+    // Floating point total, blocks are summed in a fixed order to keep it independent of threading
+    std::vector<double> block_sums(block_count);
+    std::vector<char>   block_valid(block_count);
+    _parallel_for_blocks(block_count, thread_count, [&](std::size_t block) {
+        double sum   = 0;
+        bool   valid = true;
+        for (std::size_t i = block_begin(block); i < block_end(block); ++i) {
+            const double w = weight(i);
+            valid &= (w >= 0 && w <= std::numeric_limits<double>::max()); // also rejects NaN
+            sum += w;
+        }
+        block_sums[block]  = sum;
+        block_valid[block] = valid;
+    });
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit RomuTrio32(SeedSeq&& seq) {
-        this->seed(seq);
+    double total = 0;
+    for (std::size_t block = 0; block < block_count; ++block) {
+        if (!block_valid[block]) throw std::invalid_argument("Discrete distribution weights should be finite & >= 0.");
+        total += block_sums[block];
     }
+    if (!(total > 0 && total <= std::numeric_limits<double>::max()))
+        throw std::invalid_argument("Discrete distribution weights should have a positive finite sum.");
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+    // Fixed point weights are recomputed on the fly, that's cheaper than storing them. Rounding error
+    // gets corrected on the largest weight (first one in case of ties) so that the sum is exact.
+    const std::uint64_t fixed_total = size * _alias_unit;
+    const double        scale       = static_cast<double>(fixed_total) / total;
 
-    constexpr void seed(result_type seed) noexcept {
-        result_type splitmix32_state = _ensure_nonzero(seed); // RomuTrio shouln't be zero-initialized
-        this->s[0]                   = _splitmix32(splitmix32_state);
-        this->s[1]                   = _splitmix32(splitmix32_state);
-        this->s[2]                   = _splitmix32(splitmix32_state);
-        // Like Xoshiro, Romu recommends using SplitMix32 to initialize its state
-    }
+    const auto rounded = [&](std::size_t i) {
+        return static_cast<std::uint64_t>(std::min(weight(i) * scale + 0.5, static_cast<double>(fixed_total)));
+    };
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        seq.generate(this->s.begin(), this->s.end());
-        this->s[0] = _ensure_nonzero(this->s[0]); // std::seed_seq can generate zeroes
-        this->s[1] = _ensure_nonzero(this->s[1]); // and we don't want a zero-state here
-        this->s[2] = _ensure_nonzero(this->s[2]);
-    }
+    std::vector<std::uint64_t> block_fixed_sums(block_count);
+    std::vector<std::size_t>   block_largest(block_count);
+    _parallel_for_blocks(block_count, thread_count, [&](std::size_t block) {
+        std::uint64_t sum = 0, largest_value = 0;
+        std::size_t   largest = block_begin(block);
+        for (std::size_t i = block_begin(block); i < block_end(block); ++i) {
+            const std::uint64_t value = rounded(i);
+            sum += value;
+            if (value > largest_value) largest = i, largest_value = value;
+        }
+        block_fixed_sums[block] = sum;
+        block_largest[block]    = largest;
+    });
 
-    constexpr result_type operator()() noexcept {
-        const result_type xp = this->s[0], yp = this->s[1], zp = this->s[2];
-        this->s[0] = 3323815723u * zp;
-        this->s[1] = yp - xp;
-        this->s[1] = _rotl(this->s[1], 6);
-        this->s[2] = zp - yp;
-        this->s[2] = _rotl(this->s[2], 22);
-        return xp;
+    std::uint64_t fixed_sum = 0;
+    std::size_t   largest   = 0;
+    for (std::size_t block = 0; block < block_count; ++block) {
+        fixed_sum += block_fixed_sums[block];
+        if (rounded(block_largest[block]) > rounded(largest)) largest = block_largest[block];
     }
-};
+    const std::uint64_t largest_fixed = rounded(largest) + (fixed_total - fixed_sum); // wraps around when needed
 
-// Implementation of 32-bit Bob Jenkins' small prng ,
-// see https://burtleburtle.net/bob/rand/smallprng.html
-//     https://gist.github.com/imneme/85cff47d4bad8de6bdeb671f9c76c814
-//
-// Performance: Excellent
-// Quality:     3/5
-// State:       16 bytes
-//
-// Not the best one for general use, but provides bleeding edge performance.
-// Depending on 32/64-bit CPU instruction set can lead to huge speedup.
-//
-class JSF32 {
-public:
-    using result_type = std::uint32_t;
+    const auto fixed   = [&](std::size_t i) { return i == largest ? largest_fixed : rounded(i); };
+    const auto deficit = [&](std::size_t i) { return _alias_unit - std::min(fixed(i), _alias_unit); };
+    const auto excess  = [&](std::size_t i) { return std::max(fixed(i), _alias_unit) - _alias_unit; };
 
-private:
-    std::array<result_type, 4> s{};
+    // Prefix sums of deficits & excesses at the block level
+    std::vector<std::uint64_t> block_deficits(block_count + 1), block_excesses(block_count + 1);
+    _parallel_for_blocks(block_count, thread_count, [&](std::size_t block) {
+        for (std::size_t i = block_begin(block); i < block_end(block); ++i) {
+            block_deficits[block + 1] += deficit(i);
+            block_excesses[block + 1] += excess(i);
+        }
+    });
+    for (std::size_t block = 0; block < block_count; ++block) {
+        block_deficits[block + 1] += block_deficits[block];
+        block_excesses[block + 1] += block_excesses[block];
+    }
+    // fixed point sums are exact, so total deficit always equals total excess
+
+    // Each block sweeps over its lights, the first heavy is found from block prefix sums, after that heavy
+    // pointer only moves forward. Every heavy gets exhausted by exactly one light, so blocks never write
+    // the same entries. Lights & heavies are interleaved unpredictably, branching on them would cause a lot
+    // of mispredictions, so both are collected into small buffers with branchless compaction.
+    std::vector<_alias_entry> table(size);
+    _parallel_for_blocks(block_count, thread_count, [&](std::size_t block) {
+        constexpr std::size_t chunk_size = 1024;
+
+        std::array<std::uint32_t, chunk_size> lights, heavies;
+        std::size_t                           heavy_count = 0, heavy_position = 0, heavy_scanned = 0;
+
+        const auto next_heavy = [&] { // returns 'size' once there are no heavies left
+            while (heavy_position == heavy_count && heavy_scanned < size) {
+                const std::size_t last = std::min(size, heavy_scanned + chunk_size);
+                heavy_count = heavy_position = 0;
+                for (std::size_t i = heavy_scanned; i < last; ++i) {
+                    heavies[heavy_count] = static_cast<std::uint32_t>(i);
+                    heavy_count += (fixed(i) > _alias_unit);
+                }
+                heavy_scanned = last;
+            }
+            return heavy_position < heavy_count ? std::size_t(heavies[heavy_position++]) : size;
+        };
 
-public:
-    constexpr explicit JSF32(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+        // First heavy with 'E[j] > D[i - 1]', where 'i' is the first light of the block
+        const std::uint64_t deficit_before = block_deficits[block];
+        const std::size_t   heavy_block    = static_cast<std::size_t>(
+            std::upper_bound(block_excesses.begin() + 1, block_excesses.end(), deficit_before) -
+            (block_excesses.begin() + 1));
+
+        std::size_t   heavy        = size;
+        std::uint64_t heavy_weight = 0; // what's left of the current heavy
+        if (heavy_block < block_count) {
+            heavy_scanned              = block_begin(heavy_block);
+            std::uint64_t heavy_excess = block_excesses[heavy_block];
+            do heavy = next_heavy(), heavy_excess += excess(heavy);
+            while (heavy_excess <= deficit_before);
+            heavy_weight = _alias_unit + (heavy_excess - deficit_before);
+        }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit JSF32(SeedSeq&& seq) {
-        this->seed(seq);
-    }
+        for (std::size_t first = block_begin(block); first < block_end(block); first += chunk_size) {
+            const std::size_t last        = std::min(block_end(block), first + chunk_size);
+            std::size_t       light_count = 0;
+            for (std::size_t i = first; i < last; ++i) {
+                lights[light_count] = static_cast<std::uint32_t>(i);
+                light_count += (fixed(i) <= _alias_unit);
+            }
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+            for (std::size_t l = 0; l < light_count; ++l) {
+                const std::size_t   i     = lights[l];
+                const std::uint64_t value = fixed(i);
 
-    constexpr void seed(result_type seed) noexcept {
-        this->s[0] = 0xf1ea5eed;
-        this->s[1] = this->s[2] = this->s[3] = _ensure_nonzero(seed);
-        // JSF shouln't struggle with zero-seeding but just in case
-        for (int i = 0; i < 20; ++i) static_cast<void>(this->operator()());
-    }
+                // lights with no deficit can end up past the last heavy, they don't need an alias
+                table[i] = _make_alias_entry(i, value, heavy < size ? heavy : i);
+                heavy_weight -= _alias_unit - value;
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        seq.generate(this->s.begin(), this->s.end());
-    }
+                // Exhausted heavy becomes a light that takes the rest from the next heavy
+                while (heavy < size && heavy_weight <= _alias_unit) {
+                    const std::size_t next = next_heavy();
+                    table[heavy]           = _make_alias_entry(heavy, heavy_weight, next < size ? next : heavy);
+                    heavy_weight           = (next < size) ? fixed(next) - (_alias_unit - heavy_weight) : 0;
+                    heavy                  = next;
+                }
+            }
+        }
+    });
 
-    constexpr result_type operator()() noexcept {
-        const result_type e = this->s[0] - _rotl(this->s[1], 27);
-        this->s[0]          = this->s[1] ^ _rotl(this->s[2], 17);
-        this->s[1]          = this->s[2] + this->s[3];
-        this->s[2]          = this->s[3] + e;
-        this->s[3]          = e + this->s[0];
-        return this->s[3];
-    }
-};
+    return table;
+}
 
-// --- 64-bit PRNGs ---
-// --------------------
+// High half of 'bits * N' picks the entry, low half is a uniform fraction that we compare to the threshold
+[[nodiscard]] inline std::uint64_t _alias_index(std::size_t size, std::uint64_t bits,
+                                                std::uint64_t& fraction) noexcept {
+    return _wide_multiply<std::uint64_t>(bits, size, fraction);
+}
 
-// Implementation of Romu DuoJr engine from paper by "Mark A. Overton",
-// see https://www.romu-random.org/
-//     https://www.romu-random.org/romupaper.pdf
-//
-// Performance: Excellent
-// Quality:     3/5
-// State:       16 bytes
-//
-// Not the best one for general use, but provides bleeding edge performance.
-//
-class RomuDuoJr {
-public:
-    using result_type = std::uint64_t;
+[[nodiscard]] inline std::uint32_t _alias_resolve(const _alias_entry& entry, std::uint64_t index,
+                                                  std::uint64_t fraction) noexcept {
+    return static_cast<std::uint32_t>(fraction >> 32) < entry.threshold ? static_cast<std::uint32_t>(index)
+                                                                        : entry.alias;
+}
 
-private:
-    std::array<result_type, 2> s{};
+inline void _prefetch(const void* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#elif defined(UTL_RANDOM_HAS_SSE2)
+    _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+    (void)ptr;
+#endif
+}
+
+namespace distributions {
+
+// Weighted choice of an index in a [0, N) range with O(N) construction & O(1) sampling, similar to
+// 'std::discrete_distribution<>', except much faster and produces the same values on every platform
+template <class T = std::size_t>
+class DiscreteDistribution {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Distribution requires an integer type.");
+
+    std::vector<_alias_entry> table;
 
 public:
-    constexpr explicit RomuDuoJr(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+    using result_type = T;
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit RomuDuoJr(SeedSeq&& seq) {
-        this->seed(seq);
-    }
+    DiscreteDistribution() : table{_make_alias_entry(0, _alias_unit, 0)} {}
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+    template <class InputIt>
+    DiscreteDistribution(InputIt first, InputIt last) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
 
-    constexpr void seed(result_type seed) noexcept {
-        result_type splitmix64_state = _ensure_nonzero(seed); // RomuDuoJr shouln't be zero-initialized
-        this->s[0]                   = _splitmix64(splitmix64_state);
-        this->s[1]                   = _splitmix64(splitmix64_state);
-        // Like Xoshiro, Romu recommends using SplitMix64 to initialize its state
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            const auto size = static_cast<std::size_t>(last - first);
+            this->table     = _build_alias_table(size, [&](std::size_t i) { return static_cast<double>(first[i]); });
+        } else {
+            const std::vector<double> weights(first, last);
+            this->table = _build_alias_table(weights.size(), [&](std::size_t i) { return weights[i]; });
+        }
     }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        this->s[0] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // std::seed_seq can generate zeroes
-        this->s[1] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // and we don't want a zero-state here
-        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
-    }
+    DiscreteDistribution(std::initializer_list<double> weights)
+        : DiscreteDistribution(weights.begin(), weights.end()) {}
 
-    constexpr result_type operator()() noexcept {
-        const result_type res = this->s[0];
-        this->s[0]            = 15241094284759029579u * this->s[1];
-        this->s[1]            = this->s[1] - res;
-        this->s[1]            = _rotl(this->s[1], 27);
-        return res;
+    template <class Generator>
+    T operator()(Generator& gen) const {
+        std::uint64_t       fraction = 0;
+        const std::uint64_t index    = _alias_index(this->table.size(), _generate_bits<std::uint64_t>(gen), fraction);
+        return static_cast<T>(_alias_resolve(this->table[index], index, fraction));
     }
-};
 
-// Implementation of 64-bit Bob Jenkins' small prng ,
-// see https://burtleburtle.net/bob/rand/smallprng.html
-//     https://gist.github.com/imneme/85cff47d4bad8de6bdeb671f9c76c814
-//
-// Performance: Excellent
-// Quality:     4/5
-// State:       32 bytes
-//
-// Excellent choise as a general purpose PRNG.
-// Lack theoretical proof for period length, but brute-force testing indicates >= 2^64.
-//
-class JSF64 {
-public:
-    using result_type = std::uint64_t;
+    // Bulk sampling, random bits are produced with multi-lane generation (see 'random::generate()') and table
+    // entries are prefetched ahead of time, large tables don't fit into cache so this hides most of the latency
+    template <class Generator, class Container, _is_generator_enable_if<Generator> = true,
+              _is_contiguous_container_enable_if<Container> = true>
+    void fill(Generator& gen, Container& container) const {
+        static_assert(std::is_same_v<_container_value_type<Container>, T>, "Container should hold 'result_type'.");
 
-private:
-    std::array<result_type, 4> s{};
+        constexpr std::size_t prefetch_distance = 16;
 
-public:
-    constexpr explicit JSF64(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+        T* data = std::data(container);
+        _generate_uint64_chunks(gen, std::size(container), [&](const std::uint64_t* bits, std::size_t offset,
+                                                               std::size_t count) {
+            std::array<std::uint64_t, 1024> indices, fractions; // chunks never exceed 1024 values
+            for (std::size_t i = 0; i < count; ++i)
+                indices[i] = _alias_index(this->table.size(), bits[i], fractions[i]);
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit JSF64(SeedSeq&& seq) {
-        this->seed(seq);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i + prefetch_distance < count) _prefetch(&this->table[indices[i + prefetch_distance]]);
+                data[offset + i] = static_cast<T>(_alias_resolve(this->table[indices[i]], indices[i], fractions[i]));
+            }
+        });
     }
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+    constexpr void reset() noexcept {}
 
-    constexpr void seed(result_type seed) noexcept {
-        this->s[0] = 0xf1ea5eed;
-        this->s[1] = this->s[2] = this->s[3] = _ensure_nonzero(seed);
-        // JSF shouln't struggle with zero-seeding but just in case
-        for (int i = 0; i < 20; ++i) static_cast<void>(this->operator()());
-    }
+    // Effective probabilities after rounding to fixed point, reconstructed from the table
+    [[nodiscard]] std::vector<double> probabilities() const {
+        std::vector<std::uint64_t> fixed(this->table.size());
+        for (std::size_t i = 0; i < this->table.size(); ++i) {
+            fixed[i] += this->table[i].threshold;
+            fixed[this->table[i].alias] += _alias_unit - this->table[i].threshold;
+        }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        this->s[0] = _seed_seq_to_uint64(seq);
-        this->s[1] = _seed_seq_to_uint64(seq);
-        this->s[2] = _seed_seq_to_uint64(seq);
-        this->s[3] = _seed_seq_to_uint64(seq);
-        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
+        const double        total = static_cast<double>(this->table.size() * _alias_unit);
+        std::vector<double> probabilities(this->table.size());
+        for (std::size_t i = 0; i < this->table.size(); ++i) probabilities[i] = static_cast<double>(fixed[i]) / total;
+        return probabilities;
     }
 
-    constexpr result_type operator()() noexcept {
-        const result_type e = this->s[0] - _rotl(this->s[1], 7);
-        this->s[0]          = this->s[1] ^ _rotl(this->s[2], 13);
-        this->s[1]          = this->s[2] + _rotl(this->s[3], 37);
-        this->s[2]          = this->s[3] + e;
-        this->s[3]          = e + this->s[0];
-        return this->s[3];
-    }
+    [[nodiscard]] T min() const noexcept { return 0; }
+    [[nodiscard]] T max() const noexcept { return static_cast<T>(this->table.size() - 1); }
 };
 
-// Implementation of Xoshiro256++ suggested by David Blackman and Sebastiano Vigna,
-// see https://prng.di.unimi.it/
-//     https://prng.di.unimi.it/xoshiro256plusplus.c
-//
-// Performance: Excellent
-// Quality:     4/5
-// State:       32 bytes
-//
-// Excellent choise as a general purpose PRNG.
-// Used by several modern languages as their default.
-//
-class Xoshiro256PlusPlus {
-public:
-    using result_type = std::uint64_t;
+} // namespace distributions
 
-private:
-    std::array<result_type, 4> s{};
+// ==============================
+// --- Quasi-random sequences ---
+// ==============================
 
-public:
-    constexpr explicit Xoshiro256PlusPlus(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+// Low-discrepancy sequences cover the space more evenly than random points, which makes Monte Carlo integration
+// converge as ~O(log(N)^d / N) instead of O(1 / sqrt(N)). All of the sequences support random access with
+// 'at(index)', parallel code can either compute points directly or 'discard()' its way to the start of a chunk.
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit Xoshiro256PlusPlus(SeedSeq&& seq) {
-        this->seed(seq);
-    }
+template <class Container>
+void _check_point_size(const Container& point, std::size_t dimensions) {
+    if (std::size(point) != dimensions)
+        throw std::invalid_argument("Point has " + std::to_string(std::size(point)) + " coordinates, sequence has " +
+                                    std::to_string(dimensions) + " dimensions.");
+}
+
+// Primitive polynomials & initial direction numbers of Sobol sequence for dimensions 2...1024, taken from
+// "new-joe-kuo-6.21201" by S. Joe & F. Y. Kuo, see "Constructing Sobol sequences with better two-dimensional
+// projections", SIAM J. Sci. Comput. 30, 2635-2654 (2008)
+//     https://web.maths.unsw.edu.au/~fkuo/sobol/
+// Polynomials include the leading & trailing terms, polynomial of degree 's' uses the next 's' initial values.
+inline constexpr std::array<std::uint16_t, 1023> _sobol_polynomials = {
+    3, 7, 11, 13, 19, 25, 37, 41, 47, 55, 59, 61, 67, 91, 97, 103, 109, 115, 131, 137, 143, 145, 157, 167, 171, 185,
+    191, 193, 203, 211, 213, 229, 239, 241, 247, 253, 285, 299, 301, 333, 351, 355, 357, 361, 369, 391, 397, 425, 451,
+    463, 487, 501, 529, 539, 545, 557, 563, 601, 607, 617, 623, 631, 637, 647, 661, 675, 677, 687, 695, 701, 719, 721,
+    731, 757, 761, 787, 789, 799, 803, 817, 827, 847, 859, 865, 875, 877, 883, 895, 901, 911, 949, 953, 967, 971, 973,
+    981, 985, 995, 1001, 1019, 1033, 1051, 1063, 1069, 1125, 1135, 1153, 1163, 1221, 1239, 1255, 1267, 1279, 1293,
+    1305, 1315, 1329, 1341, 1347, 1367, 1387, 1413, 1423, 1431, 1441, 1479, 1509, 1527, 1531, 1555, 1557, 1573, 1591,
+    1603, 1615, 1627, 1657, 1663, 1673, 1717, 1729, 1747, 1759, 1789, 1815, 1821, 1825, 1849, 1863, 1869, 1877, 1881,
+    1891, 1917, 1933, 1939, 1969, 2011, 2035, 2041, 2053, 2071, 2091, 2093, 2119, 2147, 2149, 2161, 2171, 2189, 2197,
+    2207, 2217, 2225, 2255, 2257, 2273, 2279, 2283, 2293, 2317, 2323, 2341, 2345, 2363, 2365, 2373, 2377, 2385, 2395,
+    2419, 2421, 2431, 2435, 2447, 2475, 2477, 2489, 2503, 2521, 2533, 2551, 2561, 2567, 2579, 2581, 2601, 2633, 2657,
+    2669, 2681, 2687, 2693, 2705, 2717, 2727, 2731, 2739, 2741, 2773, 2783, 2793, 2799, 2801, 2811, 2819, 2825, 2833,
+    2867, 2879, 2881, 2891, 2905, 2911, 2917, 2927, 2941, 2951, 2955, 2963, 2965, 2991, 2999, 3005, 3017, 3035, 3037,
+    3047, 3053, 3083, 3085, 3097, 3103, 3159, 3169, 3179, 3187, 3205, 3209, 3223, 3227, 3229, 3251, 3263, 3271, 3277,
+    3283, 3285, 3299, 3305, 3319, 3331, 3343, 3357, 3367, 3373, 3393, 3399, 3413, 3417, 3427, 3439, 3441, 3475, 3487,
+    3497, 3515, 3517, 3529, 3543, 3547, 3553, 3559, 3573, 3589, 3613, 3617, 3623, 3627, 3635, 3641, 3655, 3659, 3669,
+    3679, 3697, 3707, 3709, 3713, 3731, 3743, 3747, 3771, 3791, 3805, 3827, 3833, 3851, 3865, 3889, 3895, 3933, 3947,
+    3949, 3957, 3971, 3985, 3991, 3995, 4007, 4013, 4021, 4045, 4051, 4069, 4073, 4179, 4201, 4219, 4221, 4249, 4305,
+    4331, 4359, 4383, 4387, 4411, 4431, 4439, 4449, 4459, 4485, 4531, 4569, 4575, 4621, 4663, 4669, 4711, 4723, 4735,
+    4793, 4801, 4811, 4879, 4893, 4897, 4921, 4927, 4941, 4977, 5017, 5027, 5033, 5127, 5169, 5175, 5199, 5213, 5223,
+    5237, 5287, 5293, 5331, 5391, 5405, 5453, 5523, 5573, 5591, 5597, 5611, 5641, 5703, 5717, 5721, 5797, 5821, 5909,
+    5913, 5955, 5957, 6005, 6025, 6061, 6067, 6079, 6081, 6231, 6237, 6289, 6295, 6329, 6383, 6427, 6453, 6465, 6501,
+    6523, 6539, 6577, 6589, 6601, 6607, 6631, 6683, 6699, 6707, 6761, 6795, 6865, 6881, 6901, 6923, 6931, 6943, 6999,
+    7057, 7079, 7103, 7105, 7123, 7173, 7185, 7191, 7207, 7245, 7303, 7327, 7333, 7355, 7365, 7369, 7375, 7411, 7431,
+    7459, 7491, 7505, 7515, 7541, 7557, 7561, 7701, 7705, 7727, 7749, 7761, 7783, 7795, 7823, 7907, 7953, 7963, 7975,
+    8049, 8089, 8123, 8125, 8137, 8219, 8231, 8245, 8275, 8293, 8303, 8331, 8333, 8351, 8357, 8367, 8379, 8381, 8387,
+    8393, 8417, 8435, 8461, 8469, 8489, 8495, 8507, 8515, 8551, 8555, 8569, 8585, 8599, 8605, 8639, 8641, 8647, 8653,
+    8671, 8675, 8689, 8699, 8729, 8741, 8759, 8765, 8771, 8795, 8797, 8825, 8831, 8841, 8855, 8859, 8883, 8895, 8909,
+    8943, 8951, 8955, 8965, 8999, 9003, 9031, 9045, 9049, 9071, 9073, 9085, 9095, 9101, 9109, 9123, 9129, 9137, 9143,
+    9147, 9185, 9197, 9209, 9227, 9235, 9247, 9253, 9257, 9277, 9297, 9303, 9313, 9325, 9343, 9347, 9371, 9373, 9397,
+    9407, 9409, 9415, 9419, 9443, 9481, 9495, 9501, 9505, 9517, 9529, 9555, 9557, 9571, 9585, 9591, 9607, 9611, 9621,
+    9625, 9631, 9647, 9661, 9669, 9679, 9687, 9707, 9731, 9733, 9745, 9773, 9791, 9803, 9811, 9817, 9833, 9847, 9851,
+    9863, 9875, 9881, 9905, 9911, 9917, 9923, 9963, 9973, 10003, 10025, 10043, 10063, 10071, 10077, 10091, 10099,
+    10105, 10115, 10129, 10145, 10169, 10183, 10187, 10207, 10223, 10225, 10247, 10265, 10271, 10275, 10289, 10299,
+    10301, 10309, 10343, 10357, 10373, 10411, 10413, 10431, 10445, 10453, 10463, 10467, 10473, 10491, 10505, 10511,
+    10513, 10523, 10539, 10549, 10559, 10561, 10571, 10581, 10615, 10621, 10625, 10643, 10655, 10671, 10679, 10685,
+    10691, 10711, 10739, 10741, 10755, 10767, 10781, 10785, 10803, 10805, 10829, 10857, 10863, 10865, 10875, 10877,
+    10917, 10921, 10929, 10949, 10967, 10971, 10987, 10995, 11009, 11029, 11043, 11045, 11055, 11063, 11075, 11081,
+    11117, 11135, 11141, 11159, 11163, 11181, 11187, 11225, 11237, 11261, 11279, 11297, 11307, 11309, 11327, 11329,
+    11341, 11377, 11403, 11405, 11413, 11427, 11439, 11453, 11461, 11473, 11479, 11489, 11495, 11499, 11533, 11545,
+    11561, 11567, 11575, 11579, 11589, 11611, 11623, 11637, 11657, 11663, 11687, 11691, 11701, 11747, 11761, 11773,
+    11783, 11795, 11797, 11817, 11849, 11855, 11867, 11869, 11873, 11883, 11919, 11921, 11927, 11933, 11947, 11955,
+    11961, 11999, 12027, 12029, 12037, 12041, 12049, 12055, 12095, 12097, 12107, 12109, 12121, 12127, 12133, 12137,
+    12181, 12197, 12207, 12209, 12239, 12253, 12263, 12269, 12277, 12287, 12295, 12309, 12313, 12335, 12361, 12367,
+    12391, 12409, 12415, 12433, 12449, 12469, 12479, 12481, 12499, 12505, 12517, 12527, 12549, 12559, 12597, 12615,
+    12621, 12639, 12643, 12657, 12667, 12707, 12713, 12727, 12741, 12745, 12763, 12769, 12779, 12781, 12787, 12799,
+    12809, 12815, 12829, 12839, 12857, 12875, 12883, 12889, 12901, 12929, 12947, 12953, 12959, 12969, 12983, 12987,
+    12995, 13015, 13019, 13031, 13063, 13077, 13103, 13137, 13149, 13173, 13207, 13211, 13227, 13241, 13249, 13255,
+    13269, 13283, 13285, 13303, 13307, 13321, 13339, 13351, 13377, 13389, 13407, 13417, 13431, 13435, 13447, 13459,
+    13465, 13477, 13501, 13513, 13531, 13543, 13561, 13581, 13599, 13605, 13617, 13623, 13637, 13647, 13661, 13677,
+    13683, 13695, 13725, 13729, 13753, 13773, 13781, 13785, 13795, 13801, 13807, 13825, 13835, 13855, 13861, 13871,
+    13883, 13897, 13905, 13915, 13939, 13941, 13969, 13979, 13981, 13997, 14027, 14035, 14037, 14051, 14063, 14085,
+    14095, 14107, 14113, 14125, 14137, 14145, 14151, 14163, 14193, 14199, 14219, 14229, 14233, 14243, 14277, 14287,
+    14289, 14295, 14301, 14305, 14323, 14339, 14341, 14359, 14365, 14375, 14387, 14411, 14425, 14441, 14449, 14499,
+    14513, 14523, 14537, 14543, 14561, 14579, 14585, 14593, 14599, 14603, 14611, 14641, 14671, 14695, 14701, 14723,
+    14725, 14743, 14753, 14759, 14765, 14795, 14797, 14803, 14831, 14839, 14845, 14855, 14889, 14895, 14909, 14929,
+    14941, 14945, 14951, 14963, 14965, 14985, 15033, 15039, 15053, 15059, 15061, 15071, 15077, 15081, 15099, 15121,
+    15147, 15149, 15157, 15167, 15187, 15193, 15203, 15205, 15215, 15217, 15223, 15243, 15257, 15269
+};
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+inline constexpr std::array<std::uint16_t, 12092> _sobol_initial_directions = {
+    1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, 3, 3, 1, 3, 5, 13, 1, 1, 5, 5, 17, 1, 1, 5, 5, 5, 1, 1, 7, 11, 19, 1, 1, 5, 1, 1,
+    1, 1, 1, 3, 11, 1, 3, 5, 5, 31, 1, 3, 3, 9, 7, 49, 1, 1, 1, 15, 21, 21, 1, 3, 1, 13, 27, 49, 1, 1, 1, 15, 7, 5, 1,
+    3, 1, 15, 13, 25, 1, 1, 5, 5, 19, 61, 1, 3, 7, 11, 23, 15, 103, 1, 3, 7, 13, 13, 15, 69, 1, 1, 3, 13, 7, 35, 63, 1,
+    3, 5, 9, 1, 25, 53, 1, 3, 1, 13, 9, 35, 107, 1, 3, 1, 5, 27, 61, 31, 1, 1, 5, 11, 19, 41, 61, 1, 3, 5, 3, 3, 13,
+    69, 1, 1, 7, 13, 1, 19, 1, 1, 3, 7, 5, 13, 19, 59, 1, 1, 3, 9, 25, 29, 41, 1, 3, 5, 13, 23, 1, 55, 1, 3, 7, 3, 13,
+    59, 17, 1, 3, 1, 3, 5, 53, 69, 1, 1, 5, 5, 23, 33, 13, 1, 1, 7, 7, 1, 61, 123, 1, 1, 7, 9, 13, 61, 49, 1, 3, 3, 5,
+    3, 55, 33, 1, 3, 1, 15, 31, 13, 49, 245, 1, 3, 5, 15, 31, 59, 63, 97, 1, 3, 1, 11, 11, 11, 77, 249, 1, 3, 1, 11,
+    27, 43, 71, 9, 1, 1, 7, 15, 21, 11, 81, 45, 1, 3, 7, 3, 25, 31, 65, 79, 1, 3, 1, 1, 19, 11, 3, 205, 1, 1, 5, 9, 19,
+    21, 29, 157, 1, 3, 7, 11, 1, 33, 89, 185, 1, 3, 3, 3, 15, 9, 79, 71, 1, 3, 7, 11, 15, 39, 119, 27, 1, 1, 3, 1, 11,
+    31, 97, 225, 1, 1, 1, 3, 23, 43, 57, 177, 1, 3, 7, 7, 17, 17, 37, 71, 1, 3, 1, 5, 27, 63, 123, 213, 1, 1, 3, 5, 11,
+    43, 53, 133, 1, 3, 5, 5, 29, 17, 47, 173, 479, 1, 3, 3, 11, 3, 1, 109, 9, 69, 1, 1, 1, 5, 17, 39, 23, 5, 343, 1, 3,
+    1, 5, 25, 15, 31, 103, 499, 1, 1, 1, 11, 11, 17, 63, 105, 183, 1, 1, 5, 11, 9, 29, 97, 231, 363, 1, 1, 5, 15, 19,
+    45, 41, 7, 383, 1, 3, 7, 7, 31, 19, 83, 137, 221, 1, 1, 1, 3, 23, 15, 111, 223, 83, 1, 1, 5, 13, 31, 15, 55, 25,
+    161, 1, 1, 3, 13, 25, 47, 39, 87, 257, 1, 1, 1, 11, 21, 53, 125, 249, 293, 1, 1, 7, 11, 11, 7, 57, 79, 323, 1, 1,
+    5, 5, 17, 13, 81, 3, 131, 1, 1, 7, 13, 23, 7, 65, 251, 475, 1, 3, 5, 1, 9, 43, 3, 149, 11, 1, 1, 3, 13, 31, 13, 13,
+    255, 487, 1, 3, 3, 1, 5, 63, 89, 91, 127, 1, 1, 3, 3, 1, 19, 123, 127, 237, 1, 1, 5, 7, 23, 31, 37, 243, 289, 1, 1,
+    5, 11, 17, 53, 117, 183, 491, 1, 1, 1, 5, 1, 13, 13, 209, 345, 1, 1, 3, 15, 1, 57, 115, 7, 33, 1, 3, 1, 11, 7, 43,
+    81, 207, 175, 1, 3, 1, 1, 15, 27, 63, 255, 49, 1, 3, 5, 3, 27, 61, 105, 171, 305, 1, 1, 5, 3, 1, 3, 57, 249, 149,
+    1, 1, 3, 5, 5, 57, 15, 13, 159, 1, 1, 1, 11, 7, 11, 105, 141, 225, 1, 3, 3, 5, 27, 59, 121, 101, 271, 1, 3, 5, 9,
+    11, 49, 51, 59, 115, 1, 1, 7, 1, 23, 45, 125, 71, 419, 1, 1, 3, 5, 23, 5, 105, 109, 75, 1, 1, 7, 15, 7, 11, 67,
+    121, 453, 1, 3, 7, 3, 9, 13, 31, 27, 449, 1, 3, 1, 15, 19, 39, 39, 89, 15, 1, 1, 1, 1, 1, 33, 73, 145, 379, 1, 3,
+    1, 15, 15, 43, 29, 13, 483, 1, 1, 7, 3, 19, 27, 85, 131, 431, 1, 3, 3, 3, 5, 35, 23, 195, 349, 1, 3, 3, 7, 9, 27,
+    39, 59, 297, 1, 1, 3, 9, 11, 17, 13, 241, 157, 1, 3, 7, 15, 25, 57, 33, 189, 213, 1, 1, 7, 1, 9, 55, 73, 83, 217,
+    1, 3, 3, 13, 19, 27, 23, 113, 249, 1, 3, 5, 3, 23, 43, 3, 253, 479, 1, 1, 5, 5, 11, 5, 45, 117, 217, 1, 3, 3, 7,
+    29, 37, 33, 123, 147, 1, 3, 1, 15, 5, 5, 37, 227, 223, 459, 1, 1, 7, 5, 5, 39, 63, 255, 135, 487, 1, 3, 1, 7, 9, 7,
+    87, 249, 217, 599, 1, 1, 3, 13, 9, 47, 7, 225, 363, 247, 1, 3, 7, 13, 19, 13, 9, 67, 9, 737, 1, 3, 5, 5, 19, 59, 7,
+    41, 319, 677, 1, 1, 5, 3, 31, 63, 15, 43, 207, 789, 1, 1, 7, 9, 13, 39, 3, 47, 497, 169, 1, 3, 1, 7, 21, 17, 97,
+    19, 415, 905, 1, 3, 7, 1, 3, 31, 71, 111, 165, 127, 1, 1, 5, 11, 1, 61, 83, 119, 203, 847, 1, 3, 3, 13, 9, 61, 19,
+    97, 47, 35, 1, 1, 7, 7, 15, 29, 63, 95, 417, 469, 1, 3, 1, 9, 25, 9, 71, 57, 213, 385, 1, 3, 5, 13, 31, 47, 101,
+    57, 39, 341, 1, 1, 3, 3, 31, 57, 125, 173, 365, 551, 1, 3, 7, 1, 13, 57, 67, 157, 451, 707, 1, 1, 1, 7, 21, 13,
+    105, 89, 429, 965, 1, 1, 5, 9, 17, 51, 45, 119, 157, 141, 1, 3, 7, 7, 13, 45, 91, 9, 129, 741, 1, 3, 7, 1, 23, 57,
+    67, 141, 151, 571, 1, 1, 3, 11, 17, 47, 93, 107, 375, 157, 1, 3, 3, 5, 11, 21, 43, 51, 169, 915, 1, 1, 5, 3, 15,
+    55, 101, 67, 455, 625, 1, 3, 5, 9, 1, 23, 29, 47, 345, 595, 1, 3, 7, 7, 5, 49, 29, 155, 323, 589, 1, 3, 3, 7, 5,
+    41, 127, 61, 261, 717, 1, 3, 7, 7, 17, 23, 117, 67, 129, 1009, 1, 1, 3, 13, 11, 39, 21, 207, 123, 305, 1, 1, 3, 9,
+    29, 3, 95, 47, 231, 73, 1, 3, 1, 9, 1, 29, 117, 21, 441, 259, 1, 3, 1, 13, 21, 39, 125, 211, 439, 723, 1, 1, 7, 3,
+    17, 63, 115, 89, 49, 773, 1, 3, 7, 13, 11, 33, 101, 107, 63, 73, 1, 1, 5, 5, 13, 57, 63, 135, 437, 177, 1, 1, 3, 7,
+    27, 63, 93, 47, 417, 483, 1, 1, 3, 1, 23, 29, 1, 191, 49, 23, 1, 1, 3, 15, 25, 55, 9, 101, 219, 607, 1, 3, 1, 7, 7,
+    19, 51, 251, 393, 307, 1, 3, 3, 3, 25, 55, 17, 75, 337, 3, 1, 1, 1, 13, 25, 17, 65, 45, 479, 413, 1, 1, 7, 7, 27,
+    49, 99, 161, 213, 727, 1, 3, 5, 1, 23, 5, 43, 41, 251, 857, 1, 3, 3, 7, 11, 61, 39, 87, 383, 835, 1, 1, 3, 15, 13,
+    7, 29, 7, 505, 923, 1, 3, 7, 1, 5, 31, 47, 157, 445, 501, 1, 1, 3, 7, 1, 43, 9, 147, 115, 605, 1, 3, 3, 13, 5, 1,
+    119, 211, 455, 1001, 1, 1, 3, 5, 13, 19, 3, 243, 75, 843, 1, 3, 7, 7, 1, 19, 91, 249, 357, 589, 1, 1, 1, 9, 1, 25,
+    109, 197, 279, 411, 1, 3, 1, 15, 23, 57, 59, 135, 191, 75, 1, 1, 5, 15, 29, 21, 39, 253, 383, 349, 1, 3, 3, 5, 19,
+    45, 61, 151, 199, 981, 1, 3, 5, 13, 9, 61, 107, 141, 141, 1, 1, 3, 1, 11, 27, 25, 85, 105, 309, 979, 1, 3, 3, 11,
+    19, 7, 115, 223, 349, 43, 1, 1, 7, 9, 21, 39, 123, 21, 275, 927, 1, 1, 7, 13, 15, 41, 47, 243, 303, 437, 1, 1, 1,
+    7, 7, 3, 15, 99, 409, 719, 1, 3, 3, 15, 27, 49, 113, 123, 113, 67, 469, 1, 3, 7, 11, 3, 23, 87, 169, 119, 483, 199,
+    1, 1, 5, 15, 7, 17, 109, 229, 179, 213, 741, 1, 1, 5, 13, 11, 17, 25, 135, 403, 557, 1433, 1, 3, 1, 1, 1, 61, 67,
+    215, 189, 945, 1243, 1, 1, 7, 13, 17, 33, 9, 221, 429, 217, 1679, 1, 1, 3, 11, 27, 3, 15, 93, 93, 865, 1049, 1, 3,
+    7, 7, 25, 41, 121, 35, 373, 379, 1547, 1, 3, 3, 9, 11, 35, 45, 205, 241, 9, 59, 1, 3, 1, 7, 3, 51, 7, 177, 53, 975,
+    89, 1, 1, 3, 5, 27, 1, 113, 231, 299, 759, 861, 1, 3, 3, 15, 25, 29, 5, 255, 139, 891, 2031, 1, 3, 1, 1, 13, 9,
+    109, 193, 419, 95, 17, 1, 1, 7, 9, 3, 7, 29, 41, 135, 839, 867, 1, 1, 7, 9, 25, 49, 123, 217, 113, 909, 215, 1, 1,
+    7, 3, 23, 15, 43, 133, 217, 327, 901, 1, 1, 3, 3, 13, 53, 63, 123, 477, 711, 1387, 1, 1, 3, 15, 7, 29, 75, 119,
+    181, 957, 247, 1, 1, 1, 11, 27, 25, 109, 151, 267, 99, 1461, 1, 3, 7, 15, 5, 5, 53, 145, 11, 725, 1501, 1, 3, 7, 1,
+    9, 43, 71, 229, 157, 607, 1835, 1, 3, 3, 13, 25, 1, 5, 27, 471, 349, 127, 1, 1, 1, 1, 23, 37, 9, 221, 269, 897,
+    1685, 1, 1, 3, 3, 31, 29, 51, 19, 311, 553, 1969, 1, 3, 7, 5, 5, 55, 17, 39, 475, 671, 1529, 1, 1, 7, 1, 1, 35, 47,
+    27, 437, 395, 1635, 1, 1, 7, 3, 13, 23, 43, 135, 327, 139, 389, 1, 3, 7, 3, 9, 25, 91, 25, 429, 219, 513, 1, 1, 3,
+    5, 13, 29, 119, 201, 277, 157, 2043, 1, 3, 5, 3, 29, 57, 13, 17, 167, 739, 1031, 1, 3, 3, 5, 29, 21, 95, 27, 255,
+    679, 1531, 1, 3, 7, 15, 9, 5, 21, 71, 61, 961, 1201, 1, 3, 5, 13, 15, 57, 33, 93, 459, 867, 223, 1, 1, 1, 15, 17,
+    43, 127, 191, 67, 177, 1073, 1, 1, 1, 15, 23, 7, 21, 199, 75, 293, 1611, 1, 3, 7, 13, 15, 39, 21, 149, 65, 741,
+    319, 1, 3, 7, 11, 23, 13, 101, 89, 277, 519, 711, 1, 3, 7, 15, 19, 27, 85, 203, 441, 97, 1895, 1, 3, 1, 3, 29, 25,
+    21, 155, 11, 191, 197, 1, 1, 7, 5, 27, 11, 81, 101, 457, 675, 1687, 1, 3, 1, 5, 25, 5, 65, 193, 41, 567, 781, 1, 3,
+    1, 5, 11, 15, 113, 77, 411, 695, 1111, 1, 1, 3, 9, 11, 53, 119, 171, 55, 297, 509, 1, 1, 1, 1, 11, 39, 113, 139,
+    165, 347, 595, 1, 3, 7, 11, 9, 17, 101, 13, 81, 325, 1733, 1, 3, 1, 1, 21, 43, 115, 9, 113, 907, 645, 1, 1, 7, 3,
+    9, 25, 117, 197, 159, 471, 475, 1, 3, 1, 9, 11, 21, 57, 207, 485, 613, 1661, 1, 1, 7, 7, 27, 55, 49, 223, 89, 85,
+    1523, 1, 1, 5, 3, 19, 41, 45, 51, 447, 299, 1355, 1, 3, 1, 13, 1, 33, 117, 143, 313, 187, 1073, 1, 1, 7, 7, 5, 11,
+    65, 97, 377, 377, 1501, 1, 3, 1, 1, 21, 35, 95, 65, 99, 23, 1239, 1, 1, 5, 9, 3, 37, 95, 167, 115, 425, 867, 1, 3,
+    3, 13, 1, 37, 27, 189, 81, 679, 773, 1, 1, 3, 11, 1, 61, 99, 233, 429, 969, 49, 1, 1, 1, 7, 25, 63, 99, 165, 245,
+    793, 1143, 1, 1, 5, 11, 11, 43, 55, 65, 71, 283, 273, 1, 1, 5, 5, 9, 3, 101, 251, 355, 379, 1611, 1, 1, 1, 15, 21,
+    63, 85, 99, 49, 749, 1335, 1, 1, 5, 13, 27, 9, 121, 43, 255, 715, 289, 1, 3, 1, 5, 27, 19, 17, 223, 77, 571, 1415,
+    1, 1, 5, 3, 13, 59, 125, 251, 195, 551, 1737, 1, 3, 3, 15, 13, 27, 49, 105, 389, 971, 755, 1, 3, 5, 15, 23, 43, 35,
+    107, 447, 763, 253, 1, 3, 5, 11, 21, 3, 17, 39, 497, 407, 611, 1, 1, 7, 13, 15, 31, 113, 17, 23, 507, 1995, 1, 1,
+    7, 15, 3, 15, 31, 153, 423, 79, 503, 1, 1, 7, 9, 19, 25, 23, 171, 505, 923, 1989, 1, 1, 5, 9, 21, 27, 121, 223,
+    133, 87, 697, 1, 1, 5, 5, 9, 19, 107, 99, 319, 765, 1461, 1, 1, 3, 3, 19, 25, 3, 101, 171, 729, 187, 1, 1, 3, 1,
+    13, 23, 85, 93, 291, 209, 37, 1, 1, 1, 15, 25, 25, 77, 253, 333, 947, 1073, 1, 1, 3, 9, 17, 29, 55, 47, 255, 305,
+    2037, 1, 3, 3, 9, 29, 63, 9, 103, 489, 939, 1523, 1, 3, 7, 15, 7, 31, 89, 175, 369, 339, 595, 1, 3, 7, 13, 25, 5,
+    71, 207, 251, 367, 665, 1, 3, 3, 3, 21, 25, 75, 35, 31, 321, 1603, 1, 1, 1, 9, 11, 1, 65, 5, 11, 329, 535, 1, 1, 5,
+    3, 19, 13, 17, 43, 379, 485, 383, 1, 3, 5, 13, 13, 9, 85, 147, 489, 787, 1133, 1, 3, 1, 1, 5, 51, 37, 129, 195,
+    297, 1783, 1, 1, 3, 15, 19, 57, 59, 181, 455, 697, 2033, 1, 3, 7, 1, 27, 9, 65, 145, 325, 189, 201, 1, 3, 1, 15,
+    31, 23, 19, 5, 485, 581, 539, 1, 1, 7, 13, 11, 15, 65, 83, 185, 847, 831, 1, 3, 5, 7, 7, 55, 73, 15, 303, 511,
+    1905, 1, 3, 5, 9, 7, 21, 45, 15, 397, 385, 597, 1, 3, 7, 3, 23, 13, 73, 221, 511, 883, 1265, 1, 1, 3, 11, 1, 51,
+    73, 185, 33, 975, 1441, 1, 3, 3, 9, 19, 59, 21, 39, 339, 37, 143, 1, 1, 7, 1, 31, 33, 19, 167, 117, 635, 639, 1, 1,
+    1, 3, 5, 13, 59, 83, 355, 349, 1967, 1, 1, 1, 5, 19, 3, 53, 133, 97, 863, 983, 1, 3, 1, 13, 9, 41, 91, 105, 173,
+    97, 625, 1, 1, 5, 3, 7, 49, 115, 133, 71, 231, 1063, 1, 1, 7, 5, 17, 43, 47, 45, 497, 547, 757, 1, 3, 5, 15, 21,
+    61, 123, 191, 249, 31, 631, 1, 3, 7, 9, 17, 7, 11, 185, 127, 169, 1951, 1, 1, 5, 13, 11, 11, 9, 49, 29, 125, 791,
+    1, 1, 1, 15, 31, 41, 13, 167, 273, 429, 57, 1, 3, 5, 3, 27, 7, 35, 209, 65, 265, 1393, 1, 3, 1, 13, 31, 19, 53,
+    143, 135, 9, 1021, 1, 1, 7, 13, 31, 5, 115, 153, 143, 957, 623, 1, 1, 5, 11, 25, 19, 29, 31, 297, 943, 443, 1, 3,
+    3, 5, 21, 11, 127, 81, 479, 25, 699, 1, 1, 3, 11, 25, 31, 97, 19, 195, 781, 705, 1, 1, 5, 5, 31, 11, 75, 207, 197,
+    885, 2037, 1, 1, 1, 11, 9, 23, 29, 231, 307, 17, 1497, 1, 1, 5, 11, 11, 43, 111, 233, 307, 523, 1259, 1, 1, 7, 5,
+    1, 21, 107, 229, 343, 933, 217, 1, 1, 1, 11, 3, 21, 125, 131, 405, 599, 1469, 1, 3, 5, 5, 9, 39, 33, 81, 389, 151,
+    811, 1, 1, 7, 7, 7, 1, 59, 223, 265, 529, 2021, 1, 3, 1, 3, 9, 23, 85, 181, 47, 265, 49, 1, 3, 5, 11, 19, 23, 9, 7,
+    157, 299, 1983, 1, 3, 1, 5, 15, 5, 21, 105, 29, 339, 1041, 1, 1, 1, 1, 5, 33, 65, 85, 111, 705, 479, 1, 1, 1, 7, 9,
+    35, 77, 87, 151, 321, 101, 1, 1, 5, 7, 17, 1, 51, 197, 175, 811, 1229, 1, 3, 3, 15, 23, 37, 85, 185, 239, 543, 731,
+    1, 3, 1, 7, 7, 55, 111, 109, 289, 439, 243, 1, 1, 7, 11, 17, 53, 35, 217, 259, 853, 1667, 1, 3, 1, 9, 1, 63, 87,
+    17, 73, 565, 1091, 1, 1, 3, 3, 11, 41, 1, 57, 295, 263, 1029, 1, 1, 5, 1, 27, 45, 109, 161, 411, 421, 1395, 1, 3,
+    5, 11, 25, 35, 47, 191, 339, 417, 1727, 1, 1, 5, 15, 21, 1, 93, 251, 351, 217, 1767, 1, 3, 3, 11, 3, 7, 75, 155,
+    313, 211, 491, 1, 3, 3, 5, 11, 9, 101, 161, 453, 913, 1067, 1, 1, 3, 1, 15, 45, 127, 141, 163, 727, 1597, 1, 3, 3,
+    7, 1, 33, 63, 73, 73, 341, 1691, 1, 3, 5, 13, 15, 39, 53, 235, 77, 99, 949, 1, 1, 5, 13, 31, 17, 97, 13, 215, 301,
+    1927, 1, 1, 7, 1, 1, 37, 91, 93, 441, 251, 1131, 1, 3, 7, 9, 25, 5, 105, 69, 81, 943, 1459, 1, 3, 7, 11, 31, 43,
+    13, 209, 27, 1017, 501, 1, 1, 7, 15, 1, 33, 31, 233, 161, 507, 387, 1, 3, 3, 5, 5, 53, 33, 177, 503, 627, 1927, 1,
+    1, 7, 11, 7, 61, 119, 31, 457, 229, 1875, 1, 1, 5, 15, 19, 5, 53, 201, 157, 885, 1057, 1, 3, 7, 9, 1, 35, 51, 113,
+    249, 425, 1009, 1, 3, 5, 7, 21, 53, 37, 155, 119, 345, 631, 1, 3, 5, 7, 15, 31, 109, 69, 503, 595, 1879, 1, 3, 3,
+    1, 25, 35, 65, 131, 403, 705, 503, 1, 3, 7, 7, 19, 33, 11, 153, 45, 633, 499, 1, 3, 3, 5, 11, 3, 29, 93, 487, 33,
+    703, 1, 1, 3, 15, 21, 53, 107, 179, 387, 927, 1757, 1, 1, 3, 7, 21, 45, 51, 147, 175, 317, 361, 1, 1, 1, 7, 7, 13,
+    15, 243, 269, 795, 1965, 1, 1, 3, 5, 19, 33, 57, 115, 443, 537, 627, 1, 3, 3, 9, 3, 39, 25, 61, 185, 717, 1049, 1,
+    3, 7, 3, 7, 37, 107, 153, 7, 269, 1581, 1, 1, 7, 3, 7, 41, 91, 41, 145, 489, 1245, 1, 1, 5, 9, 7, 7, 105, 81, 403,
+    407, 283, 1, 1, 7, 9, 27, 55, 29, 77, 193, 963, 949, 1, 1, 5, 3, 25, 51, 107, 63, 403, 917, 815, 1, 1, 7, 3, 7, 61,
+    19, 51, 457, 599, 535, 1, 3, 7, 1, 23, 51, 105, 153, 239, 215, 1847, 1, 1, 3, 5, 27, 23, 79, 49, 495, 45, 1935, 1,
+    1, 1, 11, 11, 47, 55, 133, 495, 999, 1461, 1, 1, 3, 15, 27, 51, 93, 17, 355, 763, 1675, 1, 3, 1, 3, 1, 3, 79, 119,
+    499, 17, 995, 1, 1, 1, 1, 15, 43, 45, 17, 167, 973, 799, 1, 1, 1, 3, 27, 49, 89, 29, 483, 913, 2023, 1, 1, 3, 3, 5,
+    11, 75, 7, 41, 851, 611, 1, 3, 1, 3, 7, 57, 39, 123, 257, 283, 507, 1, 3, 3, 11, 27, 23, 113, 229, 187, 299, 133,
+    1, 1, 3, 13, 9, 63, 101, 77, 451, 169, 337, 1, 3, 7, 3, 3, 59, 45, 195, 229, 415, 409, 1, 3, 5, 3, 11, 19, 71, 93,
+    43, 857, 369, 1, 3, 7, 9, 19, 33, 115, 19, 241, 703, 247, 1, 3, 5, 11, 5, 35, 21, 155, 463, 1005, 1073, 1, 3, 7, 3,
+    25, 15, 109, 83, 93, 69, 1189, 1, 3, 5, 7, 5, 21, 93, 133, 135, 167, 903, 1, 1, 7, 7, 3, 59, 121, 161, 285, 815,
+    1769, 3705, 1, 3, 1, 1, 3, 47, 103, 171, 381, 609, 185, 373, 1, 3, 3, 15, 23, 33, 107, 131, 441, 445, 689, 2059, 1,
+    3, 3, 11, 7, 53, 101, 167, 435, 803, 1255, 3781, 1, 1, 5, 11, 15, 59, 41, 19, 135, 835, 1263, 505, 1, 1, 7, 11, 21,
+    49, 23, 219, 127, 961, 1065, 385, 1, 3, 5, 15, 7, 47, 117, 217, 45, 731, 1639, 733, 1, 1, 7, 11, 27, 57, 91, 87,
+    81, 35, 1269, 1007, 1, 1, 3, 11, 15, 37, 53, 219, 193, 937, 1899, 3733, 1, 3, 5, 3, 13, 11, 27, 19, 199, 393, 965,
+    2195, 1, 3, 1, 3, 5, 1, 37, 173, 413, 1023, 553, 409, 1, 3, 1, 7, 15, 29, 123, 95, 255, 373, 1799, 3841, 1, 3, 5,
+    13, 21, 57, 51, 17, 511, 195, 1157, 1831, 1, 1, 1, 15, 29, 19, 7, 73, 295, 519, 587, 3523, 1, 1, 5, 13, 13, 35,
+    115, 191, 123, 535, 717, 1661, 1, 3, 3, 5, 23, 21, 47, 251, 379, 921, 1119, 297, 1, 3, 3, 9, 29, 53, 121, 201, 135,
+    193, 523, 2943, 1, 1, 1, 7, 29, 45, 125, 9, 99, 867, 425, 601, 1, 3, 1, 9, 13, 15, 67, 181, 109, 293, 1305, 3079,
+    1, 3, 3, 9, 5, 35, 15, 209, 305, 87, 767, 2795, 1, 3, 3, 11, 27, 57, 113, 123, 179, 643, 149, 523, 1, 1, 3, 15, 11,
+    17, 67, 223, 63, 657, 335, 3309, 1, 1, 1, 9, 25, 29, 109, 159, 39, 513, 571, 1761, 1, 1, 3, 1, 5, 63, 75, 19, 455,
+    601, 123, 691, 1, 1, 1, 3, 21, 5, 45, 169, 377, 513, 1951, 2565, 1, 1, 3, 11, 3, 33, 119, 69, 253, 907, 805, 1449,
+    1, 1, 5, 13, 31, 15, 17, 7, 499, 61, 687, 1867, 1, 3, 7, 11, 17, 33, 73, 77, 299, 243, 641, 2345, 1, 1, 7, 11, 9,
+    35, 31, 235, 359, 647, 379, 1161, 1, 3, 3, 15, 31, 25, 5, 67, 33, 45, 437, 4067, 1, 1, 3, 11, 7, 17, 37, 87, 333,
+    253, 1517, 2921, 1, 1, 7, 15, 7, 15, 107, 189, 153, 769, 1521, 3427, 1, 3, 5, 13, 5, 61, 113, 37, 293, 393, 113,
+    43, 1, 1, 1, 15, 29, 43, 107, 31, 167, 147, 301, 1021, 1, 1, 1, 13, 3, 1, 35, 93, 195, 181, 2027, 1491, 1, 3, 3, 3,
+    13, 33, 77, 199, 153, 221, 1699, 3671, 1, 3, 5, 13, 7, 49, 123, 155, 495, 681, 819, 809, 1, 3, 5, 15, 27, 61, 117,
+    189, 183, 887, 617, 4053, 1, 1, 1, 7, 31, 59, 125, 235, 389, 369, 447, 1039, 1, 3, 5, 1, 5, 39, 115, 89, 249, 377,
+    431, 3747, 1, 1, 1, 5, 7, 47, 59, 157, 77, 445, 699, 3439, 1, 1, 3, 5, 11, 21, 19, 75, 11, 599, 1575, 735, 1, 3, 5,
+    3, 19, 13, 41, 69, 199, 143, 1761, 3215, 1, 3, 5, 7, 19, 43, 25, 41, 41, 11, 1647, 2783, 1, 3, 1, 9, 19, 45, 111,
+    97, 405, 399, 457, 3219, 1, 1, 3, 1, 23, 15, 65, 121, 59, 985, 829, 2259, 1, 1, 3, 7, 17, 13, 107, 229, 75, 551,
+    1299, 2363, 1, 1, 5, 5, 21, 57, 23, 199, 509, 139, 2007, 3875, 1, 3, 1, 11, 19, 53, 15, 229, 215, 741, 695, 823, 1,
+    3, 7, 1, 29, 3, 17, 163, 417, 559, 549, 319, 1, 3, 1, 13, 17, 9, 47, 133, 365, 7, 1937, 1071, 1, 3, 5, 7, 19, 37,
+    55, 163, 301, 249, 689, 2327, 1, 3, 5, 13, 11, 23, 61, 205, 257, 377, 615, 1457, 1, 3, 5, 1, 23, 37, 13, 75, 331,
+    495, 579, 3367, 1, 1, 1, 9, 1, 23, 49, 129, 475, 543, 883, 2531, 1, 3, 1, 5, 23, 59, 51, 35, 343, 695, 219, 369, 1,
+    3, 3, 1, 27, 17, 63, 97, 71, 507, 1929, 613, 1, 1, 5, 1, 21, 31, 11, 109, 247, 409, 1817, 2173, 1, 1, 3, 15, 23, 9,
+    7, 209, 301, 23, 147, 1691, 1, 1, 7, 5, 5, 19, 37, 229, 249, 277, 1115, 2309, 1, 1, 1, 5, 5, 63, 5, 249, 285, 431,
+    343, 2467, 1, 1, 1, 11, 7, 45, 35, 75, 505, 537, 29, 2919, 1, 3, 5, 15, 11, 39, 15, 63, 263, 9, 199, 445, 1, 3, 3,
+    3, 27, 63, 53, 171, 227, 63, 1049, 827, 1, 1, 3, 13, 7, 11, 115, 183, 179, 937, 1785, 381, 1, 3, 1, 11, 13, 15,
+    107, 81, 53, 295, 1785, 3757, 1, 3, 3, 13, 11, 5, 109, 243, 3, 505, 323, 1373, 1, 3, 3, 11, 21, 51, 17, 177, 381,
+    937, 1263, 3889, 1, 3, 5, 9, 27, 25, 85, 193, 143, 573, 1189, 2995, 1, 3, 5, 11, 13, 9, 81, 21, 159, 953, 91, 1751,
+    1, 1, 3, 3, 27, 61, 11, 253, 391, 333, 1105, 635, 1, 3, 3, 15, 9, 57, 95, 81, 419, 735, 251, 1141, 1, 1, 5, 9, 31,
+    39, 59, 13, 319, 807, 1241, 2433, 1, 3, 3, 5, 27, 13, 107, 141, 423, 937, 2027, 3233, 1, 3, 3, 9, 9, 25, 125, 23,
+    443, 835, 1245, 847, 1, 1, 7, 15, 17, 17, 83, 107, 411, 285, 847, 1571, 1, 1, 3, 13, 29, 61, 37, 81, 349, 727,
+    1453, 1957, 1, 3, 7, 11, 31, 13, 59, 77, 273, 591, 1265, 1533, 1, 1, 7, 7, 13, 17, 25, 25, 187, 329, 347, 1473, 1,
+    3, 7, 7, 5, 51, 37, 99, 221, 153, 503, 2583, 1, 3, 1, 13, 19, 27, 11, 69, 181, 479, 1183, 3229, 1, 3, 3, 13, 23,
+    21, 103, 147, 323, 909, 947, 315, 1, 3, 1, 3, 23, 1, 31, 59, 93, 513, 45, 2271, 1, 3, 5, 1, 7, 43, 109, 59, 231,
+    41, 1515, 2385, 1, 3, 1, 5, 31, 57, 49, 223, 283, 1013, 11, 701, 1, 1, 5, 1, 19, 53, 55, 31, 31, 299, 495, 693, 1,
+    3, 3, 9, 5, 33, 77, 253, 427, 791, 731, 1019, 1, 3, 7, 11, 1, 9, 119, 203, 53, 877, 1707, 3499, 1, 1, 3, 7, 13, 39,
+    55, 159, 423, 113, 1653, 3455, 1, 1, 3, 5, 21, 47, 51, 59, 55, 411, 931, 251, 1, 3, 7, 3, 31, 25, 81, 115, 405,
+    239, 741, 455, 1, 1, 5, 1, 31, 3, 101, 83, 479, 491, 1779, 2225, 1, 3, 3, 3, 9, 37, 107, 161, 203, 503, 767, 3435,
+    1, 3, 7, 9, 1, 27, 61, 119, 233, 39, 1375, 4089, 1, 1, 5, 9, 1, 31, 45, 51, 369, 587, 383, 2813, 1, 3, 7, 5, 31, 7,
+    49, 119, 487, 591, 1627, 53, 1, 1, 7, 1, 9, 47, 1, 223, 369, 711, 1603, 1917, 1, 3, 5, 3, 21, 37, 111, 17, 483,
+    739, 1193, 2775, 1, 3, 3, 7, 17, 11, 51, 117, 455, 191, 1493, 3821, 1, 1, 5, 9, 23, 39, 99, 181, 343, 485, 99,
+    1931, 1, 3, 1, 7, 29, 49, 31, 71, 489, 527, 1763, 2909, 1, 1, 5, 11, 5, 5, 73, 189, 321, 57, 1191, 3685, 1, 1, 5,
+    15, 13, 45, 125, 207, 371, 415, 315, 983, 1, 3, 3, 5, 25, 59, 33, 31, 239, 919, 1859, 2709, 1, 3, 5, 13, 27, 61,
+    23, 115, 61, 413, 1275, 3559, 1, 3, 7, 15, 5, 59, 101, 81, 47, 967, 809, 3189, 1, 1, 5, 11, 31, 15, 39, 25, 173,
+    505, 809, 2677, 1, 1, 5, 9, 19, 13, 95, 89, 511, 127, 1395, 2935, 1, 1, 5, 5, 31, 45, 9, 57, 91, 303, 1295, 3215,
+    1, 3, 3, 3, 19, 15, 113, 187, 217, 489, 1285, 1803, 1, 1, 3, 1, 13, 29, 57, 139, 255, 197, 537, 2183, 1, 3, 1, 15,
+    11, 7, 53, 255, 467, 9, 757, 3167, 1, 3, 3, 15, 21, 13, 9, 189, 359, 323, 49, 333, 1, 3, 7, 11, 7, 37, 21, 119,
+    401, 157, 1659, 1069, 1, 1, 5, 7, 17, 33, 115, 229, 149, 151, 2027, 279, 1, 1, 5, 15, 5, 49, 77, 155, 383, 385,
+    1985, 945, 1, 3, 7, 3, 7, 55, 85, 41, 357, 527, 1715, 1619, 1, 1, 3, 1, 21, 45, 115, 21, 199, 967, 1581, 3807, 1,
+    1, 3, 7, 21, 39, 117, 191, 169, 73, 413, 3417, 1, 1, 1, 13, 1, 31, 57, 195, 231, 321, 367, 1027, 1, 3, 7, 3, 11,
+    29, 47, 161, 71, 419, 1721, 437, 1, 1, 7, 3, 11, 9, 43, 65, 157, 1, 1851, 823, 1, 1, 1, 5, 21, 15, 31, 101, 293,
+    299, 127, 1321, 1, 1, 7, 1, 27, 1, 11, 229, 241, 705, 43, 1475, 1, 3, 7, 1, 5, 15, 73, 183, 193, 55, 1345, 49, 1,
+    3, 3, 3, 19, 3, 55, 21, 169, 663, 1675, 137, 1, 1, 1, 13, 7, 21, 69, 67, 373, 965, 1273, 2279, 1, 1, 7, 7, 21, 23,
+    17, 43, 341, 845, 465, 3355, 1, 3, 5, 5, 25, 5, 81, 101, 233, 139, 359, 2057, 1, 1, 3, 11, 15, 39, 55, 3, 471, 765,
+    1143, 3941, 1, 1, 7, 15, 9, 57, 81, 79, 215, 433, 333, 3855, 1, 1, 5, 5, 19, 45, 83, 31, 209, 363, 701, 1303, 1, 3,
+    7, 5, 1, 13, 55, 163, 435, 807, 287, 2031, 1, 3, 3, 7, 3, 3, 17, 197, 39, 169, 489, 1769, 1, 1, 3, 5, 29, 43, 87,
+    161, 289, 339, 1233, 2353, 1, 3, 3, 9, 21, 9, 77, 1, 453, 167, 1643, 2227, 1, 1, 7, 1, 15, 7, 67, 33, 193, 241,
+    1031, 2339, 1, 3, 1, 11, 1, 63, 45, 65, 265, 661, 849, 1979, 1, 3, 1, 13, 19, 49, 3, 11, 159, 213, 659, 2839, 1, 3,
+    5, 11, 9, 29, 27, 227, 253, 449, 1403, 3427, 1, 1, 3, 1, 7, 3, 77, 143, 277, 779, 1499, 475, 1, 1, 1, 5, 11, 23,
+    87, 131, 393, 849, 193, 3189, 1, 3, 5, 11, 3, 3, 89, 9, 449, 243, 1501, 1739, 1, 3, 1, 9, 29, 29, 113, 15, 65, 611,
+    135, 3687, 1, 1, 1, 9, 21, 19, 39, 151, 395, 501, 1339, 959, 2725, 1, 3, 7, 1, 7, 35, 45, 33, 119, 225, 1631, 1695,
+    1459, 1, 1, 1, 3, 25, 55, 37, 79, 167, 907, 1075, 271, 4059, 1, 3, 5, 13, 5, 13, 53, 165, 437, 67, 1705, 3177,
+    8095, 1, 3, 3, 13, 27, 57, 95, 55, 443, 245, 1945, 1725, 1929, 1, 3, 1, 9, 5, 33, 109, 35, 99, 827, 341, 2401,
+    2411, 1, 1, 5, 9, 7, 33, 43, 39, 87, 799, 635, 3481, 7159, 1, 3, 1, 1, 31, 15, 45, 27, 337, 113, 987, 2065, 2529,
+    1, 1, 5, 9, 5, 15, 105, 123, 479, 289, 1609, 2177, 4629, 1, 3, 5, 11, 31, 47, 97, 87, 385, 195, 1041, 651, 3271, 1,
+    1, 3, 7, 17, 3, 101, 55, 87, 629, 1687, 1387, 2745, 1, 3, 5, 5, 7, 21, 9, 237, 313, 549, 1107, 117, 6183, 1, 1, 3,
+    9, 9, 5, 55, 201, 487, 851, 1103, 2993, 4055, 1, 1, 5, 9, 31, 19, 59, 7, 363, 381, 1167, 2057, 5715, 1, 3, 3, 15,
+    23, 63, 19, 227, 387, 827, 487, 1049, 7471, 1, 3, 1, 5, 23, 25, 61, 245, 363, 863, 963, 3583, 6475, 1, 1, 5, 1, 5,
+    27, 81, 85, 275, 49, 235, 3291, 1195, 1, 1, 5, 7, 23, 53, 85, 107, 511, 779, 1265, 1093, 7859, 1, 3, 3, 1, 9, 21,
+    75, 219, 59, 485, 1739, 3845, 1109, 1, 3, 5, 1, 13, 41, 19, 143, 293, 391, 2023, 1791, 4399, 1, 3, 7, 15, 21, 13,
+    21, 195, 215, 413, 523, 2099, 2341, 1, 1, 1, 3, 29, 51, 47, 57, 135, 575, 943, 1673, 541, 1, 3, 5, 1, 9, 13, 113,
+    175, 447, 115, 657, 4077, 5973, 1, 1, 1, 11, 17, 41, 37, 95, 297, 579, 911, 2207, 2387, 1, 3, 5, 3, 23, 11, 23,
+    231, 93, 667, 711, 1563, 7961, 1, 1, 7, 3, 17, 59, 13, 181, 141, 991, 1817, 457, 1711, 1, 3, 3, 5, 31, 59, 81, 205,
+    245, 537, 1049, 997, 1815, 1, 3, 7, 5, 17, 13, 9, 79, 17, 185, 5, 2211, 6263, 1, 3, 7, 13, 7, 53, 61, 145, 13, 285,
+    1203, 947, 2933, 1, 1, 7, 3, 31, 19, 69, 217, 47, 441, 1893, 673, 4451, 1, 1, 1, 1, 25, 9, 23, 225, 385, 629, 603,
+    3747, 4241, 1, 3, 1, 9, 5, 37, 31, 237, 431, 79, 1521, 459, 2523, 1, 3, 7, 3, 9, 43, 105, 179, 5, 225, 799, 1777,
+    4893, 1, 1, 3, 1, 29, 45, 29, 159, 267, 247, 455, 847, 3909, 1, 1, 3, 7, 25, 21, 121, 57, 467, 275, 719, 1521,
+    7319, 1, 3, 1, 3, 11, 35, 119, 123, 81, 979, 1187, 3623, 4293, 1, 1, 1, 7, 15, 25, 121, 235, 25, 487, 873, 1787,
+    1977, 1, 1, 1, 11, 3, 7, 17, 135, 345, 353, 383, 4011, 2573, 1, 3, 7, 15, 27, 13, 97, 123, 65, 675, 951, 1285,
+    6559, 1, 3, 7, 3, 7, 1, 71, 19, 325, 765, 337, 1197, 2697, 1, 3, 5, 1, 31, 37, 11, 71, 169, 283, 83, 3801, 7083, 1,
+    1, 3, 15, 17, 29, 83, 65, 275, 679, 1749, 4007, 7749, 1, 1, 3, 1, 21, 11, 41, 95, 237, 361, 1819, 2783, 2383, 1, 3,
+    7, 11, 29, 57, 111, 187, 465, 145, 605, 1987, 8109, 1, 1, 3, 3, 19, 15, 55, 83, 357, 1001, 643, 1517, 6529, 1, 3,
+    1, 5, 29, 35, 73, 23, 77, 619, 1523, 1725, 8145, 1, 1, 5, 5, 19, 23, 7, 197, 449, 337, 717, 2921, 315, 1, 3, 5, 9,
+    7, 63, 117, 97, 97, 813, 1925, 2817, 1579, 1, 1, 1, 11, 31, 7, 25, 235, 231, 133, 1007, 1371, 1553, 1, 1, 7, 5, 19,
+    7, 47, 171, 267, 243, 1331, 567, 6033, 1, 1, 5, 1, 7, 49, 55, 89, 109, 735, 1455, 3193, 6239, 1, 1, 1, 7, 1, 61, 9,
+    103, 3, 929, 1481, 2927, 2957, 1, 1, 5, 13, 17, 21, 75, 49, 255, 1019, 1161, 2133, 1177, 1, 3, 1, 3, 13, 15, 41,
+    247, 211, 409, 1163, 523, 2635, 1, 3, 7, 7, 21, 59, 91, 149, 479, 391, 681, 2311, 6249, 1, 1, 5, 11, 27, 53, 21,
+    211, 197, 815, 719, 1605, 255, 1, 1, 3, 3, 9, 33, 59, 3, 323, 1, 101, 1135, 8105, 1, 3, 3, 1, 29, 5, 17, 141, 51,
+    991, 841, 327, 3859, 1, 3, 1, 5, 11, 19, 23, 89, 175, 173, 165, 2881, 1881, 1, 1, 1, 15, 13, 51, 87, 39, 495, 611,
+    1341, 1531, 7029, 1, 1, 3, 11, 13, 55, 75, 185, 57, 61, 1917, 2051, 5965, 1, 1, 5, 5, 7, 53, 11, 217, 213, 933,
+    921, 3607, 5175, 1, 3, 3, 5, 17, 53, 103, 251, 369, 781, 1319, 3717, 4439, 1, 3, 5, 13, 1, 39, 25, 235, 321, 773,
+    251, 3111, 6397, 1, 1, 7, 3, 31, 5, 25, 29, 325, 385, 1313, 127, 4705, 1, 1, 5, 15, 15, 27, 15, 85, 239, 243, 1633,
+    3473, 2621, 1, 3, 3, 3, 9, 19, 113, 13, 137, 165, 25, 2957, 7549, 1, 3, 1, 3, 11, 21, 3, 97, 417, 183, 1205, 1437,
+    247, 1, 1, 7, 3, 17, 21, 125, 55, 67, 387, 385, 2323, 887, 1, 3, 5, 5, 29, 11, 103, 223, 233, 641, 133, 415, 1297,
+    1, 3, 3, 11, 1, 9, 5, 189, 235, 1007, 1363, 3985, 889, 1, 3, 7, 9, 23, 19, 19, 183, 269, 403, 1643, 3559, 5189, 1,
+    3, 7, 3, 29, 45, 17, 69, 475, 149, 1291, 2689, 7625, 1, 3, 7, 3, 27, 37, 41, 73, 253, 1001, 431, 1111, 7887, 1, 1,
+    7, 5, 3, 7, 87, 143, 289, 495, 631, 3011, 6151, 1, 1, 1, 13, 5, 45, 17, 167, 23, 975, 801, 1975, 6833, 1, 3, 1, 11,
+    7, 21, 39, 23, 213, 429, 1301, 2059, 197, 1, 3, 3, 15, 3, 57, 121, 133, 29, 711, 1961, 2497, 189, 1, 1, 3, 5, 11,
+    55, 115, 137, 233, 673, 985, 2849, 5911, 1, 1, 7, 15, 29, 45, 1, 241, 329, 323, 925, 2821, 3331, 1, 1, 5, 7, 13,
+    31, 81, 105, 199, 145, 195, 1365, 5119, 1, 3, 7, 11, 3, 55, 11, 31, 117, 343, 1265, 1837, 2451, 1, 1, 3, 7, 29, 57,
+    61, 179, 429, 591, 177, 1945, 2159, 1, 3, 5, 11, 23, 49, 101, 137, 339, 323, 1035, 1749, 7737, 1, 3, 1, 13, 21, 35,
+    55, 79, 19, 269, 1055, 2651, 7083, 1, 3, 3, 11, 9, 9, 95, 167, 437, 361, 1185, 4083, 603, 1, 1, 1, 7, 31, 61, 77,
+    65, 489, 657, 691, 2423, 4147, 1, 3, 5, 7, 21, 37, 87, 191, 311, 453, 2013, 829, 2619, 1, 1, 5, 9, 17, 47, 35, 101,
+    5, 813, 1157, 1279, 7365, 1, 1, 5, 3, 11, 35, 113, 199, 369, 721, 901, 1471, 7801, 1, 3, 1, 5, 9, 61, 83, 157, 391,
+    739, 1957, 2123, 4341, 1, 3, 5, 11, 19, 19, 111, 225, 383, 219, 997, 717, 7505, 1, 3, 1, 11, 13, 63, 35, 127, 209,
+    831, 501, 3017, 3507, 1, 3, 7, 9, 29, 7, 11, 163, 81, 563, 1445, 3215, 6377, 1, 3, 7, 11, 25, 3, 39, 195, 491, 45,
+    839, 4021, 4899, 1, 3, 7, 15, 13, 5, 67, 143, 117, 505, 1281, 3679, 5695, 1, 3, 7, 9, 9, 19, 21, 221, 147, 763,
+    683, 2211, 589, 1, 1, 3, 5, 21, 47, 53, 109, 299, 807, 1153, 1209, 7961, 1, 3, 7, 11, 9, 31, 45, 43, 505, 647,
+    1127, 2681, 4917, 1, 1, 5, 15, 31, 41, 63, 113, 399, 727, 673, 2587, 5259, 1, 1, 1, 13, 17, 53, 35, 99, 57, 243,
+    1447, 1919, 2831, 1, 3, 7, 11, 23, 51, 13, 9, 49, 449, 997, 3073, 4407, 1, 3, 5, 7, 23, 33, 89, 41, 415, 53, 697,
+    1113, 1489, 1, 1, 3, 7, 1, 13, 29, 13, 255, 749, 77, 3463, 1761, 1, 3, 3, 7, 13, 15, 93, 191, 309, 869, 739, 1041,
+    3053, 1, 3, 5, 13, 5, 19, 109, 211, 347, 839, 893, 2947, 7735, 1, 3, 1, 13, 27, 3, 119, 157, 485, 99, 1703, 3895,
+    573, 1, 3, 7, 11, 1, 23, 123, 105, 31, 359, 275, 1775, 3685, 1, 3, 3, 5, 27, 11, 125, 3, 413, 199, 2043, 2895,
+    2945, 1, 3, 3, 3, 15, 49, 121, 159, 233, 543, 193, 4007, 321, 1, 1, 3, 5, 9, 47, 87, 1, 51, 1011, 1595, 2239, 6467,
+    1, 3, 7, 9, 1, 33, 87, 137, 469, 749, 1413, 805, 6817, 1, 3, 1, 13, 19, 45, 95, 227, 29, 677, 1275, 3395, 4451, 1,
+    1, 7, 5, 7, 63, 33, 71, 443, 561, 1311, 3069, 6943, 1, 1, 1, 13, 9, 37, 23, 69, 13, 415, 1479, 1197, 861, 1, 3, 3,
+    13, 27, 21, 13, 233, 105, 777, 345, 2443, 1105, 1, 1, 7, 11, 23, 13, 21, 147, 221, 549, 73, 2729, 6279, 1, 1, 7, 7,
+    25, 27, 15, 45, 227, 39, 75, 1191, 3563, 1, 1, 5, 7, 13, 49, 99, 167, 227, 13, 353, 1047, 8075, 1, 1, 3, 13, 31, 9,
+    27, 7, 461, 737, 1559, 3243, 53, 1, 3, 1, 1, 21, 41, 97, 165, 171, 821, 587, 2137, 2293, 1, 3, 1, 11, 17, 41, 29,
+    187, 87, 599, 1467, 1395, 5931, 1, 1, 1, 9, 9, 49, 89, 205, 409, 453, 61, 1923, 1257, 1, 3, 7, 3, 9, 43, 89, 143,
+    431, 83, 1243, 1795, 3599, 1, 3, 5, 13, 3, 25, 59, 219, 43, 223, 797, 2651, 6015, 1, 1, 5, 15, 7, 55, 65, 207, 213,
+    311, 1287, 1269, 6467, 1, 3, 7, 11, 21, 57, 31, 183, 351, 857, 911, 1683, 7155, 1, 3, 5, 11, 27, 1, 21, 47, 387,
+    383, 1593, 115, 3805, 1, 3, 1, 1, 13, 23, 87, 173, 181, 619, 1653, 3931, 6073, 1, 1, 7, 5, 17, 43, 37, 61, 307,
+    621, 1785, 55, 115, 1, 3, 7, 15, 25, 61, 123, 15, 237, 671, 1473, 467, 1907, 1, 1, 7, 5, 29, 57, 75, 237, 85, 699,
+    159, 3577, 4771, 1, 1, 1, 11, 25, 19, 51, 1, 147, 31, 895, 2617, 625, 1, 3, 7, 5, 29, 15, 115, 175, 395, 391, 1141,
+    1827, 1181, 1, 3, 5, 7, 17, 7, 11, 193, 89, 243, 561, 3787, 4551, 1, 3, 1, 11, 7, 57, 7, 125, 403, 947, 1261, 409,
+    8083, 1, 1, 5, 13, 21, 63, 115, 233, 231, 921, 1747, 3635, 2519, 1, 1, 5, 11, 3, 27, 15, 91, 505, 591, 1451, 3881,
+    2997, 1, 1, 3, 11, 21, 9, 109, 153, 317, 533, 593, 3967, 2797, 1, 3, 3, 13, 9, 57, 121, 245, 219, 867, 967, 791,
+    7095, 1, 1, 1, 9, 29, 21, 99, 35, 375, 959, 329, 4087, 7171, 1, 1, 1, 9, 11, 17, 17, 97, 89, 135, 631, 3809, 3253,
+    1, 1, 1, 15, 21, 51, 91, 249, 459, 801, 757, 2353, 2033, 1, 3, 5, 9, 23, 29, 77, 53, 399, 767, 1817, 2171, 1629, 1,
+    1, 3, 5, 29, 5, 43, 121, 17, 859, 1479, 3785, 6641, 1, 1, 3, 7, 7, 61, 45, 109, 371, 833, 91, 153, 4553, 1, 1, 3,
+    11, 7, 55, 81, 123, 389, 139, 1933, 891, 1789, 1, 3, 7, 15, 25, 17, 93, 165, 503, 717, 1553, 1475, 1627, 1, 1, 1,
+    13, 13, 63, 13, 225, 357, 571, 33, 4073, 3795, 1, 1, 3, 11, 1, 31, 107, 145, 407, 961, 501, 2987, 103, 1, 1, 7, 1,
+    23, 63, 49, 193, 173, 281, 25, 2465, 5927, 1, 1, 7, 1, 1, 1, 85, 77, 273, 693, 349, 1239, 4503, 1, 1, 5, 11, 7, 61,
+    9, 121, 25, 357, 1443, 405, 7827, 1, 1, 7, 13, 11, 53, 11, 207, 145, 211, 1703, 1081, 2117, 1, 1, 3, 11, 27, 23,
+    19, 9, 297, 279, 1481, 2273, 6387, 1, 3, 3, 5, 15, 45, 3, 41, 305, 87, 1815, 3461, 5349, 1, 3, 3, 13, 9, 37, 79,
+    125, 259, 561, 1087, 4091, 793, 1, 3, 5, 7, 31, 55, 7, 145, 347, 929, 589, 2783, 5905, 1, 1, 7, 15, 3, 25, 1, 181,
+    13, 243, 653, 2235, 7445, 1, 3, 5, 5, 17, 53, 65, 7, 33, 583, 1363, 1313, 2319, 1, 3, 3, 7, 27, 47, 97, 201, 187,
+    321, 63, 1515, 7917, 1, 1, 3, 5, 23, 9, 3, 165, 61, 19, 1789, 3783, 3037, 1, 3, 1, 13, 15, 43, 125, 191, 67, 273,
+    1551, 2227, 5253, 1, 1, 1, 13, 25, 53, 107, 33, 299, 249, 1475, 2233, 907, 1, 3, 5, 1, 23, 37, 85, 17, 207, 643,
+    665, 2933, 5199, 1, 1, 7, 7, 25, 57, 59, 41, 15, 751, 751, 1749, 7053, 1, 3, 3, 1, 13, 25, 127, 93, 281, 613, 875,
+    2223, 6345, 1, 1, 5, 3, 29, 55, 79, 249, 43, 317, 533, 995, 1991, 1, 3, 3, 15, 17, 49, 79, 31, 193, 233, 1437,
+    2615, 819, 1, 1, 5, 15, 25, 3, 123, 145, 377, 9, 455, 1191, 3953, 1, 3, 5, 3, 15, 19, 41, 231, 81, 393, 3, 19,
+    2409, 1, 1, 3, 1, 27, 43, 113, 179, 7, 853, 947, 2731, 297, 1, 1, 1, 11, 29, 39, 53, 191, 443, 689, 529, 3329,
+    7431, 1, 3, 7, 5, 3, 29, 19, 67, 441, 113, 949, 2769, 4169, 1, 3, 5, 11, 11, 55, 85, 169, 215, 815, 803, 2345,
+    3967, 1, 1, 7, 9, 5, 45, 111, 5, 419, 375, 303, 1725, 4489, 1, 3, 5, 15, 29, 43, 79, 19, 23, 417, 381, 541, 4923,
+    1, 1, 3, 15, 3, 31, 117, 39, 117, 305, 1227, 1223, 143, 1, 1, 5, 9, 5, 47, 87, 239, 181, 353, 1561, 3313, 1921, 1,
+    3, 3, 1, 3, 15, 53, 221, 441, 987, 1997, 2529, 8059, 1, 1, 7, 11, 15, 57, 111, 139, 137, 883, 1881, 2823, 5661, 1,
+    3, 5, 5, 21, 11, 5, 13, 27, 973, 587, 1331, 1373, 1, 1, 7, 11, 29, 51, 93, 29, 217, 221, 55, 2477, 1979, 1, 3, 3,
+    13, 3, 11, 49, 75, 379, 371, 1441, 793, 7633, 1, 1, 1, 13, 19, 45, 89, 249, 91, 649, 1695, 915, 5619, 1, 3, 1, 7,
+    7, 29, 1, 77, 313, 895, 519, 771, 295, 1, 3, 1, 15, 5, 3, 1, 57, 331, 109, 485, 2853, 6831, 1, 1, 1, 15, 17, 3, 35,
+    99, 245, 971, 839, 2509, 2803, 1, 3, 3, 3, 9, 37, 57, 251, 325, 317, 529, 1313, 6379, 1, 1, 1, 15, 25, 59, 1, 119,
+    95, 15, 795, 2375, 6463, 1, 3, 1, 5, 1, 49, 117, 21, 47, 179, 863, 85, 1669, 1, 3, 7, 3, 9, 37, 19, 221, 455, 973,
+    571, 1427, 817, 1, 1, 1, 15, 17, 9, 67, 213, 127, 887, 1299, 2913, 7451, 1, 3, 1, 13, 27, 27, 41, 43, 171, 623,
+    691, 391, 4885, 1, 3, 1, 13, 17, 17, 123, 239, 143, 227, 1151, 519, 6543, 1, 3, 7, 5, 7, 63, 97, 39, 101, 555,
+    1057, 381, 7891, 1, 3, 5, 1, 3, 27, 85, 129, 161, 875, 1945, 3541, 695, 1, 3, 3, 5, 21, 59, 25, 183, 35, 25, 987,
+    1459, 181, 1, 3, 5, 13, 1, 15, 127, 237, 349, 337, 1491, 2383, 7811, 1, 3, 5, 5, 31, 5, 109, 51, 409, 733, 1395,
+    3207, 6049, 1, 1, 5, 7, 13, 35, 113, 25, 263, 389, 299, 2521, 1783, 1, 3, 7, 11, 15, 47, 97, 73, 55, 75, 113, 2695,
+    1023, 1, 3, 1, 1, 3, 13, 69, 211, 289, 483, 1335, 787, 677, 1, 1, 3, 3, 17, 7, 37, 77, 505, 137, 1113, 345, 2975,
+    1, 1, 1, 13, 3, 11, 95, 199, 453, 109, 479, 3725, 239, 1, 1, 7, 15, 19, 53, 3, 145, 359, 863, 347, 3833, 3043, 1,
+    1, 7, 15, 25, 63, 127, 129, 125, 195, 155, 2211, 8153, 1, 1, 7, 13, 9, 49, 121, 115, 73, 119, 1851, 727, 47, 1, 3,
+    3, 13, 13, 11, 71, 7, 45, 591, 133, 2407, 5563, 1, 1, 1, 13, 23, 29, 87, 89, 501, 71, 1759, 1119, 687, 1, 1, 7, 7,
+    13, 7, 13, 183, 53, 951, 1877, 3991, 6771, 1, 3, 7, 11, 7, 1, 27, 47, 61, 21, 919, 961, 1091, 1, 3, 5, 5, 1, 27, 1,
+    5, 63, 157, 1297, 1049, 5893, 1, 3, 7, 9, 19, 33, 17, 133, 425, 797, 1721, 153, 119, 1, 3, 3, 7, 13, 37, 1, 215,
+    509, 1003, 61, 2353, 7511, 1, 1, 7, 1, 29, 19, 31, 79, 199, 555, 1209, 1603, 6089, 1, 3, 1, 1, 5, 31, 111, 127,
+    333, 429, 1863, 3925, 5411, 1, 1, 7, 5, 5, 5, 123, 191, 47, 993, 269, 4051, 2111, 1, 1, 5, 15, 1, 9, 87, 5, 47,
+    463, 865, 1813, 7357, 1, 3, 1, 3, 23, 63, 123, 83, 511, 777, 63, 1285, 4537, 1, 3, 3, 7, 27, 25, 31, 65, 441, 529,
+    1815, 1893, 323, 1, 3, 7, 5, 11, 19, 7, 5, 397, 811, 755, 2883, 4217, 1, 3, 1, 13, 9, 21, 13, 7, 271, 539, 1769,
+    3243, 5325, 1, 1, 7, 1, 31, 13, 47, 131, 181, 457, 1559, 2663, 6653, 1, 3, 3, 7, 29, 55, 25, 203, 419, 91, 437,
+    1159, 5691, 1, 1, 3, 13, 29, 19, 71, 217, 337, 329, 501, 939, 2205, 1, 1, 3, 1, 1, 27, 17, 201, 97, 285, 1269,
+    4043, 2207, 1, 1, 1, 1, 3, 41, 13, 199, 141, 129, 1515, 3129, 5969, 1, 3, 3, 9, 3, 17, 119, 41, 271, 933, 877, 701,
+    2197, 1, 1, 1, 7, 15, 47, 3, 195, 115, 821, 725, 843, 6071, 1, 3, 5, 15, 17, 33, 85, 65, 297, 571, 1123, 2743,
+    5727, 1, 1, 5, 11, 27, 15, 37, 235, 415, 293, 1439, 2739, 4171, 1, 3, 7, 7, 1, 55, 71, 35, 307, 11, 401, 1881, 933,
+    1, 3, 1, 11, 21, 37, 3, 177, 119, 339, 559, 3991, 3437, 1, 3, 3, 9, 17, 17, 97, 119, 301, 169, 157, 3267, 2261, 1,
+    3, 3, 9, 29, 3, 111, 101, 355, 869, 375, 2609, 7377, 1, 3, 5, 9, 7, 21, 123, 99, 343, 693, 1927, 1605, 4923, 1, 1,
+    3, 5, 13, 31, 99, 17, 75, 385, 1539, 1553, 7077, 1, 3, 3, 5, 31, 35, 107, 11, 407, 1019, 1317, 3593, 7203, 1, 3, 3,
+    13, 17, 33, 99, 245, 401, 957, 157, 1949, 1571, 1, 3, 1, 11, 27, 15, 11, 109, 429, 307, 1911, 2701, 861, 1, 1, 5,
+    13, 13, 35, 55, 255, 311, 957, 1803, 2673, 5195, 1, 1, 1, 11, 19, 3, 89, 37, 211, 783, 1355, 3567, 7135, 1, 1, 5,
+    5, 21, 49, 79, 17, 509, 331, 183, 3831, 855, 1, 3, 7, 5, 29, 19, 85, 109, 105, 523, 845, 3385, 7477, 1, 1, 1, 7,
+    25, 17, 125, 131, 53, 757, 253, 2989, 2939, 1, 3, 3, 9, 19, 23, 105, 39, 351, 677, 211, 401, 8103, 1, 3, 5, 1, 5,
+    11, 17, 3, 405, 469, 1569, 2865, 3133, 1, 1, 3, 13, 15, 5, 117, 179, 139, 145, 477, 1137, 2537, 1, 1, 7, 9, 5, 21,
+    9, 93, 211, 963, 1207, 3343, 4911, 1, 1, 1, 9, 13, 43, 17, 53, 81, 793, 1571, 2523, 3683, 1, 3, 3, 13, 25, 21, 5,
+    59, 489, 987, 1941, 171, 6009, 1, 3, 3, 7, 1, 39, 89, 171, 403, 467, 1767, 3423, 2791, 1, 1, 3, 9, 19, 49, 91, 125,
+    163, 1013, 89, 2849, 6785, 1, 1, 5, 9, 9, 11, 15, 241, 43, 297, 1719, 1541, 1821, 1, 3, 7, 15, 29, 23, 103, 239,
+    191, 33, 1043, 3649, 6579, 1, 3, 3, 9, 21, 51, 123, 55, 223, 645, 1463, 4021, 5891, 1, 1, 5, 7, 3, 41, 27, 235,
+    391, 303, 2021, 3187, 7607, 1, 1, 1, 9, 5, 49, 49, 29, 377, 251, 1887, 1017, 1301, 1, 1, 3, 3, 13, 41, 27, 47, 223,
+    23, 517, 3227, 6731, 1, 1, 7, 1, 31, 25, 47, 9, 511, 623, 2047, 1263, 1511, 1, 1, 3, 15, 15, 23, 53, 1, 261, 595,
+    85, 241, 7047, 1, 3, 3, 11, 17, 5, 81, 73, 149, 781, 2035, 3163, 4247, 1, 3, 7, 7, 29, 59, 49, 79, 397, 901, 1105,
+    2191, 6277, 1, 3, 3, 11, 13, 27, 25, 173, 107, 73, 1265, 585, 5251, 1, 1, 7, 15, 29, 23, 73, 229, 235, 887, 1469,
+    4073, 2591, 1, 1, 3, 9, 17, 15, 83, 173, 207, 879, 1701, 1509, 11, 1, 1, 3, 5, 5, 37, 65, 161, 39, 421, 1153, 2007,
+    5355, 1, 1, 7, 11, 23, 37, 5, 11, 9, 499, 17, 157, 5747, 1, 3, 7, 13, 25, 9, 49, 7, 39, 945, 1349, 1759, 1441, 1,
+    1, 5, 3, 21, 15, 113, 81, 265, 837, 333, 3625, 6133, 1, 3, 1, 11, 13, 27, 73, 109, 297, 327, 299, 3253, 6957, 1, 1,
+    3, 13, 19, 39, 123, 73, 65, 5, 1061, 2187, 5055, 1, 1, 3, 1, 11, 31, 21, 115, 453, 857, 711, 495, 549, 1, 3, 7, 7,
+    15, 29, 79, 103, 47, 713, 1735, 3121, 6321, 1, 1, 5, 5, 29, 9, 97, 33, 471, 705, 329, 1501, 1349, 1, 3, 3, 1, 21,
+    9, 111, 209, 71, 47, 491, 2143, 1797, 1, 3, 3, 3, 11, 39, 21, 135, 445, 259, 607, 3811, 5449, 1, 1, 7, 9, 11, 25,
+    113, 251, 395, 317, 317, 91, 1979, 1, 3, 1, 9, 3, 21, 103, 133, 389, 943, 1235, 1749, 7063, 1, 1, 3, 7, 1, 11, 5,
+    15, 497, 477, 479, 3079, 6969, 1, 1, 3, 3, 15, 39, 105, 131, 475, 465, 181, 865, 3813, 1, 1, 7, 9, 19, 63, 123,
+    131, 415, 525, 457, 2471, 3135, 1, 3, 7, 15, 25, 35, 123, 45, 341, 805, 485, 4049, 7065, 1, 1, 1, 5, 29, 9, 47,
+    227, 51, 867, 1873, 1593, 2271, 1, 1, 7, 15, 31, 9, 71, 117, 285, 711, 837, 1435, 6275, 1, 3, 1, 1, 5, 19, 79, 25,
+    301, 415, 1871, 645, 3251, 1, 3, 1, 3, 17, 51, 99, 185, 447, 43, 523, 219, 429, 1, 3, 1, 13, 29, 13, 51, 93, 7,
+    995, 757, 3017, 6865, 1, 1, 3, 15, 7, 25, 75, 17, 155, 981, 1231, 1229, 1995, 1, 3, 5, 3, 27, 45, 71, 73, 225, 763,
+    377, 1139, 2863, 1, 1, 3, 1, 1, 39, 69, 113, 29, 371, 1051, 793, 3749, 1, 1, 3, 13, 23, 61, 27, 183, 307, 431,
+    1345, 2757, 4031, 1, 3, 7, 5, 5, 59, 117, 197, 303, 721, 877, 723, 1601, 1, 3, 5, 1, 27, 33, 99, 237, 485, 711,
+    665, 3077, 5105, 1, 1, 3, 1, 13, 9, 103, 201, 23, 951, 2029, 165, 2093, 1, 3, 5, 13, 5, 29, 55, 85, 221, 677, 611,
+    3613, 4567, 1, 1, 1, 1, 7, 61, 9, 233, 261, 561, 953, 4023, 2443, 1, 3, 3, 13, 1, 17, 103, 71, 223, 213, 833, 1747,
+    6999, 1, 3, 5, 15, 25, 53, 57, 187, 25, 695, 1207, 4089, 2877, 1, 1, 7, 1, 7, 31, 87, 129, 493, 519, 1555, 1155,
+    4637, 1, 1, 1, 15, 21, 17, 23, 29, 19, 255, 927, 1791, 3093, 1, 1, 3, 9, 17, 33, 95, 129, 175, 461, 287, 2633,
+    2325, 1, 3, 5, 7, 23, 19, 63, 209, 249, 583, 1373, 2039, 2225, 1, 3, 3, 5, 5, 19, 79, 241, 459, 355, 1455, 3313,
+    3639, 1, 1, 7, 9, 21, 41, 97, 119, 129, 769, 1541, 3495, 7741, 1, 1, 7, 11, 9, 29, 35, 255, 141, 937, 1763, 41,
+    1393, 1, 3, 7, 1, 13, 51, 61, 157, 177, 847, 1829, 3539, 285, 1, 1, 1, 15, 21, 13, 9, 55, 397, 19, 1495, 1255,
+    7235, 1, 1, 7, 7, 25, 37, 53, 237, 319, 197, 269, 1205, 1485, 1, 1, 5, 15, 23, 17, 35, 247, 323, 807, 233, 3681,
+    4407, 1, 1, 3, 7, 9, 59, 85, 105, 493, 763, 1639, 391, 1451, 1, 3, 3, 9, 15, 33, 5, 253, 129, 625, 1527, 2793,
+    6057, 1, 3, 1, 1, 7, 47, 21, 161, 235, 83, 397, 3563, 5953, 1, 3, 7, 11, 3, 41, 25, 117, 375, 779, 1297, 3715,
+    8117, 1, 1, 3, 7, 31, 19, 103, 173, 475, 189, 2035, 2921, 1107, 1, 1, 7, 3, 25, 7, 93, 255, 307, 113, 1893, 2233,
+    6919, 1, 3, 5, 15, 9, 57, 79, 143, 165, 5, 1389, 193, 693, 1, 3, 5, 1, 29, 45, 91, 49, 189, 461, 439, 1283, 7835,
+    1, 1, 3, 13, 11, 61, 41, 231, 373, 695, 395, 915, 5393, 1, 3, 7, 11, 5, 51, 67, 53, 483, 95, 1943, 247, 5653, 1, 3,
+    7, 5, 5, 57, 45, 235, 137, 793, 1069, 1661, 1557, 1, 3, 5, 3, 25, 55, 103, 177, 81, 861, 1151, 143, 7655, 1, 1, 3,
+    1, 21, 41, 67, 131, 253, 431, 1269, 3181, 3429, 1, 3, 1, 1, 21, 7, 77, 221, 257, 663, 71, 2949, 2481, 1, 3, 5, 3,
+    3, 23, 45, 107, 299, 739, 1013, 3, 3165, 1, 1, 5, 1, 3, 37, 109, 37, 243, 983, 1221, 1691, 3869, 1, 1, 5, 5, 31, 7,
+    5, 193, 397, 867, 1495, 3435, 7441, 1, 1, 1, 1, 17, 59, 97, 233, 389, 597, 1013, 1631, 483, 1, 1, 1, 11, 7, 41,
+    107, 53, 111, 125, 1513, 1921, 7647, 1, 3, 3, 3, 31, 29, 117, 3, 365, 971, 1139, 2123, 5913, 1, 1, 1, 13, 23, 3, 1,
+    167, 475, 639, 1811, 3841, 3081, 1, 1, 5, 3, 5, 47, 65, 123, 275, 783, 95, 119, 7591, 1, 3, 1, 15, 13, 33, 93, 237,
+    467, 431, 705, 4013, 4035, 1, 3, 5, 1, 19, 7, 101, 231, 155, 737, 1381, 3343, 2051, 1, 1, 5, 9, 15, 49, 45, 163,
+    433, 765, 2031, 201, 2589, 1, 3, 7, 9, 19, 41, 31, 89, 93, 623, 105, 745, 4409, 1, 1, 5, 1, 11, 45, 127, 85, 389,
+    439, 829, 477, 7965, 1, 3, 3, 15, 13, 41, 1, 207, 435, 585, 311, 1725, 2737, 1, 3, 3, 3, 13, 49, 21, 31, 197, 799,
+    1411, 2959, 7133, 1, 3, 1, 3, 7, 43, 9, 141, 133, 579, 1059, 93, 957, 1, 3, 7, 1, 15, 51, 23, 213, 381, 851, 699,
+    2261, 3419, 1, 3, 5, 9, 25, 35, 67, 141, 35, 409, 1423, 365, 1645, 1, 3, 3, 11, 15, 33, 27, 181, 93, 87, 1761,
+    3511, 1353, 1, 3, 5, 3, 25, 63, 111, 137, 321, 819, 705, 1547, 7271, 1, 3, 1, 1, 5, 57, 99, 59, 411, 757, 1371,
+    3953, 3695, 1, 3, 5, 11, 11, 21, 25, 147, 239, 455, 709, 953, 7175, 1, 3, 3, 15, 5, 53, 91, 205, 341, 63, 723,
+    1565, 7135, 1, 1, 7, 15, 11, 21, 99, 79, 63, 593, 2007, 3629, 5271, 1, 3, 3, 1, 9, 21, 45, 175, 453, 435, 1855,
+    2649, 6959, 1, 1, 3, 15, 15, 33, 121, 121, 251, 431, 1127, 3305, 4199, 1, 1, 1, 9, 31, 15, 71, 29, 345, 391, 1159,
+    2809, 345, 1, 3, 7, 1, 23, 29, 95, 151, 327, 727, 647, 1623, 2971, 1, 1, 7, 7, 9, 29, 79, 91, 127, 909, 1293, 1315,
+    5315, 1, 1, 5, 11, 13, 37, 89, 73, 149, 477, 1909, 3343, 525, 1, 3, 5, 7, 5, 59, 55, 255, 223, 459, 2027, 237,
+    4205, 1, 1, 1, 7, 27, 11, 95, 65, 325, 835, 907, 3801, 3787, 1, 1, 1, 11, 27, 33, 99, 175, 51, 913, 331, 1851,
+    4133, 1, 3, 5, 5, 13, 37, 31, 99, 273, 409, 1827, 3845, 5491, 1, 1, 3, 7, 23, 19, 107, 85, 283, 523, 509, 451, 421,
+    1, 3, 5, 7, 13, 9, 51, 81, 87, 619, 61, 2803, 5271, 1, 1, 1, 15, 9, 45, 35, 219, 401, 271, 953, 649, 6847, 1, 1, 7,
+    11, 9, 45, 17, 219, 169, 837, 1483, 1605, 2901, 1, 1, 7, 7, 21, 43, 37, 33, 291, 359, 71, 2899, 7037, 1, 3, 3, 13,
+    31, 53, 37, 15, 149, 949, 551, 3445, 5455, 1, 3, 1, 5, 19, 45, 81, 223, 193, 439, 2047, 3879, 789, 1, 1, 7, 3, 11,
+    63, 35, 61, 255, 563, 459, 2991, 3359, 1, 1, 5, 9, 13, 49, 47, 185, 239, 221, 1533, 3635, 2045, 1, 3, 7, 3, 25, 37,
+    127, 223, 51, 357, 483, 3837, 6873, 1, 1, 7, 9, 31, 37, 113, 31, 387, 833, 1243, 1543, 5535, 1, 3, 1, 9, 23, 59,
+    119, 221, 73, 185, 2007, 2885, 2563, 1, 1, 1, 13, 7, 33, 53, 179, 67, 185, 1541, 1807, 4659, 1, 3, 1, 11, 31, 37,
+    23, 215, 269, 357, 207, 645, 4219, 1, 3, 3, 13, 19, 27, 107, 55, 91, 71, 1695, 1815, 89, 1, 1, 3, 15, 3, 19, 35,
+    247, 49, 529, 1523, 3317, 6151, 1, 1, 7, 7, 23, 25, 107, 139, 483, 503, 1277, 243, 7879, 1, 3, 3, 13, 3, 15, 11,
+    197, 135, 839, 985, 275, 5527, 1, 3, 5, 3, 25, 47, 95, 21, 113, 307, 1001, 3065, 295, 1, 1, 3, 9, 19, 19, 99, 213,
+    363, 449, 735, 2851, 2521, 1, 1, 3, 9, 5, 49, 63, 61, 157, 857, 497, 2801, 6987, 1, 1, 1, 9, 1, 41, 109, 119, 499,
+    939, 867, 3675, 8023, 1, 3, 1, 1, 13, 33, 109, 123, 289, 3, 1271, 2773, 4265, 1, 3, 1, 11, 9, 57, 83, 221, 95, 43,
+    1189, 457, 7133, 1, 1, 7, 3, 11, 49, 33, 219, 229, 289, 685, 3359, 4495, 1, 3, 1, 3, 19, 43, 67, 193, 41, 771, 407,
+    81, 3891, 1, 1, 7, 11, 5, 29, 51, 175, 297, 539, 1, 2245, 6439, 1, 3, 7, 15, 21, 33, 117, 183, 511, 489, 1283,
+    3281, 5979, 1, 3, 7, 5, 9, 3, 125, 147, 359, 549, 369, 3049, 2405, 1, 3, 5, 7, 19, 5, 65, 97, 483, 377, 1523, 1457,
+    2995, 1, 1, 5, 1, 11, 21, 41, 113, 277, 131, 1475, 1043, 2367, 1, 3, 3, 1, 15, 17, 101, 69, 443, 865, 817, 1421,
+    5231, 1, 1, 3, 3, 3, 55, 95, 99, 75, 195, 1929, 3931, 5855, 1, 3, 1, 3, 19, 23, 93, 213, 241, 551, 1307, 585, 7729,
+    1, 3, 1, 11, 23, 15, 53, 249, 467, 519, 95, 741, 409, 1, 1, 1, 15, 29, 37, 43, 203, 233, 877, 77, 1933, 2729, 1, 3,
+    7, 11, 27, 39, 43, 161, 255, 15, 1463, 833, 495, 1, 1, 7, 11, 3, 53, 81, 67, 375, 823, 1903, 3061, 395, 1, 1, 1, 1,
+    15, 37, 93, 233, 247, 501, 1321, 3275, 5409, 1, 3, 3, 7, 7, 11, 5, 105, 139, 983, 1239, 531, 3881, 1, 1, 5, 3, 19,
+    49, 107, 227, 361, 101, 355, 2649, 7383, 1, 1, 7, 5, 25, 41, 101, 121, 209, 293, 1937, 2259, 5557, 1, 1, 3, 7, 7,
+    1, 9, 13, 463, 1019, 995, 3159, 107, 1, 3, 5, 11, 5, 35, 127, 97, 261, 789, 807, 807, 6257, 1, 1, 7, 5, 11, 13, 45,
+    91, 417, 101, 1973, 3645, 2107, 1, 1, 3, 7, 5, 63, 57, 49, 203, 157, 115, 1393, 8117, 1, 3, 5, 5, 3, 43, 15, 155,
+    127, 489, 1165, 3701, 4867, 1, 1, 7, 7, 29, 29, 69, 215, 415, 367, 371, 1901, 6075, 1, 1, 1, 3, 11, 33, 89, 149,
+    433, 705, 1437, 1597, 505, 1, 3, 5, 1, 13, 37, 19, 119, 5, 581, 2037, 1633, 2099, 1, 3, 7, 13, 5, 49, 103, 245,
+    215, 515, 133, 2007, 1933, 1, 3, 1, 9, 1, 3, 25, 197, 253, 387, 1683, 2267, 221, 1, 3, 5, 15, 21, 9, 73, 201, 405,
+    999, 437, 3877, 6045, 1, 1, 3, 1, 31, 55, 25, 83, 421, 395, 1807, 2129, 7797, 1, 1, 3, 1, 23, 21, 121, 183, 125,
+    347, 143, 3685, 4317, 1, 3, 3, 3, 17, 45, 17, 223, 267, 795, 1815, 1309, 155, 1, 1, 1, 15, 17, 59, 5, 133, 15, 715,
+    1503, 153, 2887, 1, 1, 1, 1, 27, 13, 119, 77, 243, 995, 1851, 3719, 4695, 1, 3, 1, 5, 31, 49, 43, 165, 49, 609,
+    1265, 1141, 505, 1, 1, 7, 13, 11, 63, 21, 253, 229, 585, 1543, 3719, 4141, 1, 3, 7, 11, 23, 27, 17, 131, 295, 895,
+    1493, 1411, 3247, 1, 1, 5, 9, 29, 7, 97, 15, 113, 445, 859, 1483, 1121, 1, 3, 1, 9, 13, 49, 99, 107, 323, 201, 681,
+    3071, 5281, 1, 1, 1, 15, 9, 19, 61, 161, 7, 87, 587, 2199, 2811, 1, 3, 3, 15, 15, 19, 95, 45, 299, 829, 981, 3479,
+    487, 1, 1, 1, 9, 3, 37, 7, 19, 227, 13, 397, 513, 1257, 1, 1, 5, 15, 15, 13, 17, 111, 135, 929, 1145, 811, 1801, 1,
+    3, 1, 3, 27, 57, 31, 19, 279, 103, 693, 631, 3409, 1, 1, 1, 1, 15, 13, 67, 83, 23, 799, 1735, 2063, 3363, 1, 3, 3,
+    7, 3, 1, 61, 31, 41, 533, 2025, 4067, 6963, 1, 1, 5, 7, 17, 27, 81, 79, 107, 205, 29, 97, 4883, 1, 1, 1, 5, 19, 49,
+    91, 201, 283, 949, 651, 3819, 5073, 1, 1, 7, 9, 11, 13, 73, 197, 37, 219, 1931, 3369, 6017, 1, 1, 7, 15, 11, 7, 75,
+    205, 7, 819, 399, 661, 6487, 1, 3, 3, 3, 27, 37, 95, 41, 307, 165, 1077, 3485, 563, 1, 3, 5, 3, 21, 49, 57, 179,
+    109, 627, 1789, 431, 2941, 1, 1, 7, 5, 11, 19, 43, 137, 149, 679, 1543, 245, 1381, 1, 3, 5, 5, 15, 3, 69, 81, 135,
+    159, 1363, 3401, 6355, 1, 3, 5, 1, 9, 61, 49, 53, 319, 25, 1647, 1297, 615, 1, 3, 5, 11, 31, 43, 9, 101, 71, 919,
+    335, 3147, 5823, 1, 3, 1, 1, 15, 5, 29, 109, 511, 945, 867, 3677, 6915, 1, 3, 3, 15, 17, 49, 91, 111, 215, 29,
+    1879, 97, 2505, 1, 3, 1, 13, 19, 61, 11, 111, 163, 777, 533, 1113, 5339, 1, 1, 7, 9, 17, 55, 117, 91, 455, 289,
+    557, 913, 4455, 1, 3, 1, 7, 25, 19, 123, 37, 1, 277, 717, 2965, 4469, 1, 3, 7, 3, 19, 23, 87, 235, 209, 457, 2041,
+    2893, 1805, 1, 3, 3, 5, 5, 43, 23, 61, 351, 791, 59, 2009, 2909, 1, 1, 3, 7, 5, 1, 27, 231, 385, 257, 1261, 2701,
+    1807, 1, 3, 1, 1, 27, 19, 87, 253, 131, 685, 1743, 3983, 2651, 1, 3, 7, 11, 21, 17, 11, 81, 191, 641, 1821, 3005,
+    7251, 1, 3, 3, 5, 15, 31, 41, 213, 55, 931, 1953, 49, 6037, 1, 1, 7, 15, 7, 27, 65, 223, 113, 79, 1875, 911, 5445,
+    1, 3, 7, 7, 23, 55, 51, 167, 495, 25, 1585, 3447, 799, 1, 1, 3, 7, 27, 15, 95, 193, 337, 415, 975, 3085, 967, 1, 1,
+    7, 15, 19, 7, 93, 41, 433, 551, 401, 3169, 3971, 1, 1, 7, 11, 13, 15, 53, 69, 433, 59, 1117, 3359, 6231, 1, 1, 7,
+    3, 23, 5, 115, 201, 225, 109, 1903, 3897, 6265, 1, 1, 1, 11, 17, 1, 39, 143, 361, 659, 1105, 23, 4923, 1, 1, 1, 9,
+    27, 57, 85, 227, 261, 119, 1881, 3965, 6999, 1, 3, 7, 7, 15, 7, 107, 17, 315, 49, 1591, 905, 7789, 1, 3, 1, 7, 29,
+    3, 47, 237, 157, 769, 839, 3199, 3195, 1, 1, 3, 15, 25, 39, 63, 15, 111, 857, 881, 1505, 7671, 1, 1, 7, 1, 3, 35,
+    41, 215, 99, 895, 1025, 1483, 4707, 1, 3, 5, 1, 1, 31, 25, 247, 113, 841, 397, 1825, 6969, 1, 1, 3, 5, 19, 41, 49,
+    243, 225, 973, 241, 175, 1041, 1, 1, 1, 7, 15, 15, 105, 141, 83, 75, 1675, 3523, 5219, 1, 1, 7, 5, 13, 27, 47, 199,
+    445, 841, 959, 1157, 2209, 1, 3, 5, 15, 23, 31, 31, 81, 85, 33, 785, 2639, 7799, 1, 1, 5, 13, 21, 3, 47, 99, 235,
+    943, 1731, 2467, 7891, 1, 1, 1, 3, 17, 53, 85, 219, 73, 131, 1339, 875, 1191, 1, 1, 5, 7, 17, 63, 113, 7, 185, 557,
+    749, 3563, 4973, 1, 3, 3, 15, 15, 21, 43, 111, 155, 689, 345, 423, 3597, 1, 1, 5, 1, 15, 29, 93, 5, 361, 713, 695,
+    3937, 425, 1, 3, 7, 7, 13, 41, 115, 175, 315, 937, 123, 2841, 4457, 1, 1, 3, 11, 25, 5, 103, 53, 423, 811, 657,
+    399, 7257, 1, 1, 1, 1, 1, 13, 101, 211, 383, 325, 97, 1703, 4429, 1, 3, 7, 9, 31, 45, 83, 157, 509, 701, 841, 1105,
+    3643, 1, 1, 1, 7, 1, 9, 69, 17, 129, 281, 1161, 2945, 7693, 1, 3, 7, 1, 11, 29, 51, 143, 77, 433, 1723, 2317, 5641,
+    1, 1, 1, 1, 21, 43, 13, 67, 177, 505, 1629, 1267, 4885, 1, 1, 3, 11, 27, 63, 111, 47, 233, 781, 453, 1679, 3209, 1,
+    1, 3, 13, 29, 27, 119, 141, 493, 971, 461, 1159, 633, 1, 1, 3, 15, 23, 5, 79, 215, 163, 149, 1805, 2399, 61, 1, 3,
+    5, 13, 19, 5, 1, 39, 409, 561, 709, 829, 1357, 1, 3, 3, 13, 19, 43, 9, 177, 449, 447, 73, 2107, 5669, 1, 3, 5, 1,
+    23, 13, 63, 109, 203, 593, 829, 4017, 6881, 1, 1, 5, 7, 3, 9, 53, 175, 391, 169, 1283, 3793, 4451, 1, 1, 5, 7, 29,
+    43, 9, 5, 209, 77, 927, 2941, 8145, 1, 3, 5, 15, 17, 49, 5, 143, 131, 771, 1685, 925, 2175, 1, 1, 3, 11, 27, 27,
+    27, 159, 161, 1015, 1587, 4049, 1983, 1, 3, 1, 3, 23, 57, 119, 67, 481, 577, 389, 3319, 5325, 1, 3, 5, 1, 19, 39,
+    87, 61, 329, 657, 1773, 31, 1707, 1, 1, 3, 1, 5, 25, 15, 241, 131, 815, 1751, 3029, 8039, 1, 3, 3, 13, 27, 13, 77,
+    87, 437, 57, 621, 1031, 7891, 1, 3, 1, 13, 23, 51, 117, 37, 331, 745, 605, 3179, 4713, 1, 1, 5, 5, 19, 17, 99, 167,
+    87, 721, 737, 789, 2165, 1, 3, 5, 13, 1, 51, 119, 211, 165, 299, 1327, 3053, 3343, 1, 1, 5, 15, 29, 45, 17, 129,
+    67, 345, 1553, 2705, 7369, 1, 1, 1, 9, 23, 7, 13, 209, 7, 407, 317, 3077, 7287, 1, 1, 1, 5, 9, 59, 89, 3, 487, 451,
+    505, 2499, 7563, 1, 3, 1, 7, 21, 1, 21, 203, 101, 417, 1389, 2751, 1397, 1, 3, 7, 13, 7, 31, 3, 247, 349, 485,
+    1259, 549, 6321, 1, 1, 7, 7, 27, 33, 107, 197, 293, 729, 1753, 2571, 103, 1, 3, 5, 9, 25, 35, 5, 253, 137, 213,
+    2041, 3387, 1809, 1, 1, 7, 13, 15, 35, 67, 83, 295, 175, 839, 2831, 839, 1, 3, 3, 11, 3, 17, 55, 141, 247, 991,
+    117, 3799, 1221, 1, 1, 5, 1, 11, 37, 87, 233, 457, 653, 899, 2933, 3105, 1, 1, 3, 15, 3, 31, 67, 167, 437, 9, 651,
+    1109, 1139, 1, 1, 3, 1, 7, 63, 67, 17, 11, 883, 1855, 1941, 4751, 1, 3, 7, 9, 19, 33, 113, 117, 495, 39, 1795,
+    2561, 5519, 1, 1, 7, 5, 1, 3, 103, 37, 201, 223, 1101, 877, 6483, 1, 1, 5, 9, 29, 49, 51, 33, 439, 917, 861, 1321,
+    2135, 1, 1, 3, 3, 1, 5, 17, 93, 217, 619, 613, 1357, 6095, 1, 3, 1, 11, 3, 21, 5, 41, 15, 175, 843, 2937, 6849, 1,
+    3, 3, 7, 9, 57, 55, 127, 79, 287, 445, 2205, 7989, 1, 1, 7, 13, 23, 17, 93, 129, 157, 135, 1747, 1813, 4183, 1, 1,
+    1, 5, 31, 59, 99, 33, 425, 329, 887, 367, 1761, 1, 1, 7, 9, 17, 53, 77, 139, 435, 387, 49, 3649, 1773, 1, 3, 3, 15,
+    21, 57, 45, 161, 331, 719, 273, 3479, 4173, 1, 1, 3, 9, 3, 3, 105, 201, 373, 877, 919, 1263, 6649, 1, 3, 1, 15, 13,
+    43, 13, 99, 73, 163, 353, 3569, 5601, 1, 3, 7, 3, 5, 9, 69, 177, 449, 47, 781, 1125, 4245, 1, 1, 1, 5, 3, 45, 1,
+    123, 409, 903, 205, 2057, 7637, 1, 3, 5, 9, 19, 47, 87, 135, 481, 799, 101, 3409, 2241, 1, 3, 1, 13, 3, 25, 15, 27,
+    181, 967, 669, 2577, 7249, 1, 1, 7, 3, 31, 5, 103, 53, 1, 911, 1209, 3697, 6685, 1, 1, 3, 1, 5, 5, 49, 135, 281,
+    747, 761, 2973, 7963, 1, 3, 3, 5, 19, 61, 125, 199, 299, 515, 1365, 369, 7027, 1, 3, 1, 7, 5, 41, 63, 229, 283,
+    571, 147, 447, 657, 1, 3, 1, 11, 5, 15, 55, 7, 259, 61, 27, 1429, 5631, 1, 1, 5, 1, 3, 53, 51, 253, 155, 553, 1293,
+    3735, 6567, 1, 3, 5, 9, 5, 41, 21, 159, 101, 785, 1981, 3799, 7693, 1, 3, 7, 7, 9, 3, 95, 105, 129, 213, 1215,
+    1027, 5699, 1, 1, 3, 3, 29, 13, 9, 253, 449, 321, 341, 2879, 171, 1, 3, 7, 11, 21, 11, 75, 35, 43, 965, 675, 2217,
+    7175, 1, 1, 5, 15, 31, 5, 29, 137, 311, 751, 47, 1367, 5921, 1, 1, 3, 15, 17, 1, 45, 69, 55, 649, 835, 569, 7615,
+    1, 3, 1, 13, 31, 7, 23, 15, 391, 145, 1845, 1825, 1403, 1, 1, 3, 15, 5, 9, 79, 77, 105, 399, 1933, 2503, 4781, 1,
+    3, 1, 3, 17, 47, 19, 13, 107, 475, 759, 2933, 3761, 1, 1, 7, 11, 3, 7, 121, 209, 397, 877, 293, 847, 7039, 1, 1, 1,
+    15, 29, 45, 5, 109, 335, 461, 143, 931, 4045, 1, 3, 1, 7, 11, 57, 73, 89, 201, 173, 803, 3953, 5205, 1, 1, 5, 11,
+    11, 33, 37, 29, 263, 1019, 657, 1453, 7807
+};
 
-    constexpr void seed(result_type seed) noexcept {
-        result_type splitmix64_state = _ensure_nonzero(seed); // Xoshiro256++ shouln't be zero-initialized
-        this->s[0]                   = _splitmix64(splitmix64_state);
-        this->s[1]                   = _splitmix64(splitmix64_state);
-        this->s[2]                   = _splitmix64(splitmix64_state);
-        this->s[3]                   = _splitmix64(splitmix64_state);
+namespace sequences {
+
+// Sobol sequence, points are generated in the Gray code order, which means that each step flips a single
+// direction number per dimension. Coordinates have 32 bits of precision, which limits the sequence to 2^32 points.
+class Sobol {
+    constexpr static std::size_t bits = 32;
+
+    std::size_t                dims;
+    std::uint64_t              position = 0; // index of the next point
+    std::vector<std::uint32_t> directions;   // 'directions[dims * b + d]' is the b-th direction number of d-th dim
+    std::vector<std::uint32_t> state;        // integer coordinates of the next point
+
+    [[nodiscard]] static double to_double(std::uint32_t x) noexcept { return x * (1. / 4294967296.); }
+
+    // Point 'i' is a XOR of direction numbers selected by the bits of its Gray code 'i ^ (i >> 1)',
+    // writes integer coordinates '[first, first + count)' of that point into 'out'
+    void integers_at(std::uint64_t index, std::size_t first, std::size_t count, std::uint32_t* out) const noexcept {
+        std::fill(out, out + count, std::uint32_t(0));
+        for (std::uint64_t gray = index ^ (index >> 1), b = 0; gray; gray >>= 1, ++b) {
+            if (!(gray & 1)) continue;
+            const std::uint32_t* v = this->directions.data() + this->dims * b + first;
+            for (std::size_t d = 0; d < count; ++d) out[d] ^= v[d];
+        }
     }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        this->s[0] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // std::seed_seq can generate zeroes
-        this->s[1] = _ensure_nonzero(_seed_seq_to_uint64(seq)); // and we don't want a zero-state here
-        this->s[2] = _ensure_nonzero(_seed_seq_to_uint64(seq));
-        this->s[3] = _ensure_nonzero(_seed_seq_to_uint64(seq));
-        // we have to generate multiple std::uint32_t's and then join them into std::uint64_t't to properly initialize
+    void check_index(std::uint64_t index) const {
+        if (index >= max_points) throw std::out_of_range("Sobol sequence only has 2^32 points.");
     }
 
-    constexpr result_type operator()() noexcept {
-        const result_type result = _rotl(this->s[0] + this->s[3], 23) + this->s[0];
-        const result_type t      = this->s[1] << 17;
-        this->s[2] ^= this->s[0];
-        this->s[3] ^= this->s[1];
-        this->s[1] ^= this->s[2];
-        this->s[0] ^= this->s[3];
-        this->s[2] ^= t;
-        this->s[3] = _rotl(this->s[3], 45);
-        return result;
+public:
+    constexpr static std::size_t   max_dimensions = _sobol_polynomials.size() + 1;
+    constexpr static std::uint64_t max_points     = std::uint64_t(1) << bits;
+
+    explicit Sobol(std::size_t dimensions) : dims(dimensions), directions(bits * dimensions), state(dimensions) {
+        if (!dimensions || dimensions > max_dimensions)
+            throw std::invalid_argument("Sobol sequence supports 1 to " + std::to_string(max_dimensions) +
+                                        " dimensions, " + std::to_string(dimensions) + " were requested.");
+
+        std::array<std::uint32_t, bits> v{};
+        for (std::size_t d = 0, offset = 0; d < dimensions; ++d) {
+            // First dimension is the van der Corput sequence, all of its initial values are 1
+            if (d == 0) {
+                for (std::size_t k = 0; k < bits; ++k) v[k] = std::uint32_t(1) << (bits - 1 - k);
+            }
+            // Other ones follow the recurrence 'v[k] = a[1] v[k - 1] ^ ... ^ a[s - 1] v[k - s + 1] ^ v[k - s] ^
+            // (v[k - s] >> s)', where 'a[j]' are coefficients of the polynomial, see Bratley & Fox (1988)
+            else {
+                const std::uint32_t polynomial = _sobol_polynomials[d - 1];
+                std::size_t         degree     = 0;
+                while (polynomial >> (degree + 1)) ++degree;
+
+                for (std::size_t k = 0; k < degree; ++k)
+                    v[k] = static_cast<std::uint32_t>(_sobol_initial_directions[offset + k]) << (bits - 1 - k);
+                for (std::size_t k = degree; k < bits; ++k) {
+                    v[k] = v[k - degree] ^ (v[k - degree] >> degree);
+                    for (std::size_t j = 1; j < degree; ++j)
+                        if ((polynomial >> (degree - j)) & 1) v[k] ^= v[k - j];
+                }
+
+                offset += degree;
+            }
+
+            for (std::size_t k = 0; k < bits; ++k) this->directions[dimensions * k + d] = v[k];
+        }
     }
-};
 
-// Implementation XorShift64* suggested by Marsaglia G. in 2003 "Journal of Statistical Software",
-// see https://www.jstatsoft.org/article/view/v008i14
-//     https://en.wikipedia.org/wiki/Xorshift
-//
-// Performance: Good
-// Quality:     4/5
-// State:       8 bytes
-//
-// Generally overshadowed by newer PRNGs in quality & performance,
-// however it still quite good and seems to be among the best we can get at just 8 bytes of state.
-//
-class Xorshift64Star {
-public:
-    using result_type = std::uint64_t;
+    [[nodiscard]] std::size_t   dimensions() const noexcept { return this->dims; }
+    [[nodiscard]] std::uint64_t index() const noexcept { return this->position; }
 
-private:
-    result_type s{};
+    // Writes the next point into 'point' & advances the sequence, O(1) per coordinate
+    template <class Container>
+    void next(Container& point) {
+        _check_point_size(point, this->dims);
+        this->check_index(this->position);
 
-public:
-    constexpr explicit Xorshift64Star(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+        auto* data = std::data(point);
+        for (std::size_t d = 0; d < this->dims; ++d)
+            data[d] = static_cast<std::remove_reference_t<decltype(*data)>>(to_double(this->state[d]));
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit Xorshift64Star(SeedSeq&& seq) {
-        this->seed(seq);
+        // Gray code of 'i + 1' differs from the one of 'i' in the lowest zero bit of 'i'
+        if (++this->position == max_points) return;
+        std::size_t b = 0;
+        while ((this->position - 1) >> b & 1) ++b;
+
+        const std::uint32_t* v = this->directions.data() + this->dims * b;
+        for (std::size_t d = 0; d < this->dims; ++d) this->state[d] ^= v[d];
     }
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return 1; }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+    // Random access, doesn't change the state of the sequence, O(log(index)) per coordinate
+    [[nodiscard]] double at(std::uint64_t index, std::size_t dimension) const {
+        this->check_index(index);
 
-    constexpr void seed(result_type seed) {
-        this->s = _ensure_nonzero(seed); // XorShift64* shouln't be zero-initialized
+        std::uint32_t x = 0;
+        for (std::uint64_t gray = index ^ (index >> 1), b = 0; gray; gray >>= 1, ++b)
+            if (gray & 1) x ^= this->directions[this->dims * b + dimension];
+        return to_double(x);
     }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        this->s = _ensure_nonzero(_seed_seq_to_uint64(seq));
-        // std::seed_seq can generate zeroes and we don't want a zero-state here
+    template <class Container>
+    void at(std::uint64_t index, Container& point) const {
+        _check_point_size(point, this->dims);
+        this->check_index(index);
+
+        std::array<std::uint32_t, 64> integers;
+
+        auto* data = std::data(point);
+        for (std::size_t first = 0; first < this->dims; first += integers.size()) {
+            const std::size_t count = std::min(integers.size(), this->dims - first);
+            this->integers_at(index, first, count, integers.data());
+            for (std::size_t d = 0; d < count; ++d)
+                data[first + d] = static_cast<std::remove_reference_t<decltype(*data)>>(to_double(integers[d]));
+        }
     }
 
-    constexpr result_type operator()() noexcept {
-        this->s ^= this->s >> 12;
-        this->s ^= this->s << 25;
-        this->s ^= this->s >> 27;
-        return this->s * 0x2545F4914F6CDD1DULL;
+    void discard(unsigned long long z) {
+        this->position += z;
+        if (this->position >= max_points) return; // 'next()' will throw
+        this->integers_at(this->position, 0, this->dims, this->state.data());
     }
 };
 
-// --- CSPRNGs ---
-// ---------------
+// Halton sequence, d-th coordinate is a radical inverse of the index in the base of d-th prime. Doesn't have
+// a dimension limit, but correlations between large prime bases make it a poor choice for more than ~10 dimensions.
+// Radical inverses are kept as exact fixed-point fractions 'numerator / base^digits' with 'base^digits' being
+// the largest power that fits into 64 bits, digits past that don't affect the result in double precision.
+class Halton {
+    struct dimension_data {
+        std::uint64_t base;
+        std::uint64_t top;         // 'base^(digits - 1)', weight of the first digit after the point
+        std::size_t   digits;      // number of fractional digits
+        double        denominator; // 'base^digits'
+    };
 
-// Implementation of ChaCha20 CPRNG conforming to RFC 7539 standard
-// see https://datatracker.ietf.org/doc/html/rfc7539
-//     https://www.rfc-editor.org/rfc/rfc7539#section-2.4
-//     https://en.wikipedia.org/wiki/Salsa20
+    std::size_t                 dims;
+    std::uint64_t               position = 0; // index of the next point
+    std::vector<dimension_data> data;
+    std::vector<std::uint64_t>  numerators;  // radical inverses of the next point
+    std::vector<std::uint64_t>  last_digits; // last digits of 'position' in each base
 
-// Quarted-round operation for ChaCha20 stream cipher
-constexpr void _quarter_round(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c, std::uint32_t& d) {
-    a += b, d ^= a, d = _rotl(d, 16);
-    c += d, b ^= c, b = _rotl(b, 12);
-    a += b, d ^= a, d = _rotl(d, 8);
-    c += d, b ^= c, b = _rotl(b, 7);
-}
+    [[nodiscard]] static double to_double(std::uint64_t numerator, const dimension_data& dim) noexcept {
+        return std::min(static_cast<double>(numerator) / dim.denominator, 0x1.fffffffffffffp-1); // rounding can give 1
+    }
 
-[[nodiscard]] constexpr std::array<std::uint32_t, 16> _chacha20_rounds(const std::array<std::uint32_t, 16>& input) {
-    auto state = input;
+    [[nodiscard]] std::uint64_t numerator_at(std::uint64_t index, const dimension_data& dim) const noexcept {
+        std::uint64_t reversed = 0;
+        std::size_t   k        = 0;
+        for (; index >> 32 && k < dim.digits; index /= dim.base, ++k) reversed = reversed * dim.base + index % dim.base;
 
-    constexpr std::size_t round_count = 10;
-    // standard number of ChaCha20 rounds as per RFC 7539
-    // (20 rounds total, alterating between column rounds and diagonal rounds)
+        // 32-bit division is several times faster on most CPUs
+        const auto base = static_cast<std::uint32_t>(dim.base);
+        for (auto i = static_cast<std::uint32_t>(index); i && k < dim.digits; i /= base, ++k)
+            reversed = reversed * base + i % base;
 
-    for (std::size_t i = 0; i < round_count; ++i) {
-        // Column rounds
-        _quarter_round(state[0], state[4], state[8], state[12]);
-        _quarter_round(state[1], state[5], state[9], state[13]);
-        _quarter_round(state[2], state[6], state[10], state[14]);
-        _quarter_round(state[3], state[7], state[11], state[15]);
+        for (std::uint64_t power = dim.base, e = dim.digits - k; e; e >>= 1, power *= power)
+            if (e & 1) reversed *= power;
+        return reversed;
+    }
 
-        // Diagonal rounds
-        _quarter_round(state[0], state[5], state[10], state[15]);
-        _quarter_round(state[1], state[6], state[11], state[12]);
-        _quarter_round(state[2], state[7], state[8], state[13]);
-        _quarter_round(state[3], state[4], state[9], state[14]);
+public:
+    explicit Halton(std::size_t dimensions) : dims(dimensions), numerators(dimensions), last_digits(dimensions) {
+        if (!dimensions) throw std::invalid_argument("Halton sequence requires at least 1 dimension.");
+
+        this->data.reserve(dimensions);
+        for (std::uint64_t candidate = 2; this->data.size() < dimensions; ++candidate) {
+            bool is_prime = true;
+            for (std::size_t i = 0; i < this->data.size() && this->data[i].base * this->data[i].base <= candidate; ++i)
+                if (candidate % this->data[i].base == 0) is_prime = false;
+            if (!is_prime) continue;
+
+            dimension_data dim{candidate, 1, 1, 0.};
+            for (; dim.top * candidate <= std::numeric_limits<std::uint64_t>::max() / candidate; ++dim.digits)
+                dim.top *= candidate;
+            dim.denominator = static_cast<double>(dim.top * candidate);
+            this->data.push_back(dim);
+        }
     }
 
-    for (std::size_t i = 0; i < state.size(); ++i) state[i] += input[i];
-    return state;
-}
+    [[nodiscard]] std::size_t   dimensions() const noexcept { return this->dims; }
+    [[nodiscard]] std::uint64_t index() const noexcept { return this->position; }
 
-class ChaCha20 {
-public:
-    using result_type = std::uint32_t;
+    // Writes the next point into 'point' & advances the sequence, amortized O(1) per coordinate
+    template <class Container>
+    void next(Container& point) {
+        _check_point_size(point, this->dims);
 
-private:
-    // Initial state components
-    std::array<result_type, 8> key{};     // 256-bit key
-    std::array<result_type, 3> nonce{};   // 96-bit nonce
-    std::uint32_t              counter{}; // 32-bit counter
+        auto* out = std::data(point);
+        for (std::size_t d = 0; d < this->dims; ++d) {
+            const dimension_data& dim       = this->data[d];
+            std::uint64_t&        numerator = this->numerators[d];
 
-    // Block
-    std::array<result_type, 16> block{};    // holds next 16 random numbers
-    std::size_t                 position{}; // current position in the block
+            out[d] = static_cast<std::remove_reference_t<decltype(*out)>>(to_double(numerator, dim));
 
-    constexpr static std::array<result_type, 4> constant = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
-    // "Magic constants" for ChaCha20 are defined through bit representations of the following char arrays:
-    // { "expa", "nd 3", "2-by", "te k" },
-    // what we have here is exactly that except written as 'std::uint32_t'
+            // Incrementing the index adds 1 to its last digit, carries propagate towards the higher digits
+            if (++this->last_digits[d] != dim.base) {
+                numerator += dim.top;
+                continue;
+            }
+            this->last_digits[d] = 0;
 
-    constexpr void generate_new_block() {
-        // Set ChaCha20 initial state as per RFC 7539
-        //
-        //          [ const   const const const ]
-        // State    [ key     key   key   key   ]
-        // matrix = [ key     key   key   key   ]
-        //          [ counter nonce nonce nonce ]
-        //
-        const std::array<std::uint32_t, 16> input = {
-            this->constant[0], this->constant[1], this->constant[2], this->constant[3], //
-            this->key[0],      this->key[1],      this->key[2],      this->key[3],      //
-            this->key[4],      this->key[5],      this->key[6],      this->key[7],      //
-            this->counter,     this->nonce[0],    this->nonce[1],    this->nonce[2]     //
-        };
+            std::uint64_t weight = dim.top;
+            for (std::uint64_t i = this->position; i % dim.base == dim.base - 1; i /= dim.base, weight /= dim.base)
+                numerator -= (dim.base - 1) * weight;
+            numerator += weight;
+        }
+        ++this->position;
+    }
 
-        // Fill new block
-        this->block = _chacha20_rounds(input);
-        ++this->counter;
+    // Random access, doesn't change the state of the sequence, O(log(index)) per coordinate
+    [[nodiscard]] double at(std::uint64_t index, std::size_t dimension) const noexcept {
+        return to_double(this->numerator_at(index, this->data[dimension]), this->data[dimension]);
     }
 
-public:
-    constexpr explicit ChaCha20(result_type seed = _default_seed<result_type>) noexcept { this->seed(seed); }
+    template <class Container>
+    void at(std::uint64_t index, Container& point) const {
+        _check_point_size(point, this->dims);
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    explicit ChaCha20(SeedSeq&& seq) {
-        this->seed(seq);
+        auto* out = std::data(point);
+        for (std::size_t d = 0; d < this->dims; ++d)
+            out[d] = static_cast<std::remove_reference_t<decltype(*out)>>(this->at(index, d));
     }
 
-    [[nodiscard]] static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
-    [[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+    void discard(unsigned long long z) noexcept {
+        this->position += z;
+        for (std::size_t d = 0; d < this->dims; ++d) {
+            this->numerators[d]  = this->numerator_at(this->position, this->data[d]);
+            this->last_digits[d] = this->position % this->data[d].base;
+        }
+    }
+};
 
-    constexpr void seed(result_type seed) {
-        // Use some other PRNG to setup initial state
-        result_type splitmix32_state = seed;
+// R2 sequence by M. Roberts, an additive recurrence 'x[i] = (0.5 + i * alpha) mod 1' with 'alpha[d] = phi^-(d+1)',
+// where 'phi' is the unique positive root of 'x^(D+1) = x + 1'. Generalizes the golden ratio sequence to any
+// number of dimensions 'D' and has lower discrepancy than Halton. Everything is computed in 64-bit fixed point,
+// which makes it exact for any index.
+//     https://extremelearning.com.au/unreasonable-effectiveness-of-quasirandom-sequences/
+class R2 {
+    std::size_t                dims;
+    std::uint64_t              position = 0; // index of the next point
+    std::vector<std::uint64_t> alphas;       // fractions scaled by 2^64
 
-        for (auto& e : this->key) e = _splitmix32(splitmix32_state);
-        for (auto& e : this->nonce) e = _splitmix32(splitmix32_state);
-        this->counter  = 0; // counter can be set to any number, but usually 0 or 1 is used
-        this->position = 0;
+public:
+    explicit R2(std::size_t dimensions) : dims(dimensions), alphas(dimensions) {
+        if (!dimensions) throw std::invalid_argument("R2 sequence requires at least 1 dimension.");
+
+        // Newton's method converges monotonically from above since the function is convex on [1, 2]
+        const double power = static_cast<double>(dimensions + 1);
+        double       phi   = 2.;
+        for (int i = 0; i < 100; ++i) {
+            const double next = phi - (std::pow(phi, power) - phi - 1.) / (power * std::pow(phi, power - 1.) - 1.);
+            if (next >= phi) break;
+            phi = next;
+        }
 
-        this->generate_new_block();
+        double alpha = 1.;
+        for (auto& e : this->alphas) {
+            alpha /= phi;
+            e = static_cast<std::uint64_t>(alpha * 18446744073709551616.); // 'alpha < 1' so this can't overflow
+        }
     }
 
-    template <class SeedSeq, _is_seed_seq_enable_if<SeedSeq> = true>
-    void seed(SeedSeq&& seq) {
-        // Seed sequence allows user to introduce more entropy into the state
-
-        seq.generate(this->key.begin(), this->key.end());
-        seq.generate(this->nonce.begin(), this->nonce.end());
+    [[nodiscard]] std::size_t   dimensions() const noexcept { return this->dims; }
+    [[nodiscard]] std::uint64_t index() const noexcept { return this->position; }
 
-        this->counter  = 0; // counter can be set to any number, but usually 0 or 1 is used
-        this->position = 0;
+    template <class Container>
+    void next(Container& point) {
+        this->at(this->position, point);
+        ++this->position;
+    }
 
-        this->generate_new_block();
+    // Random access, doesn't change the state of the sequence
+    [[nodiscard]] double at(std::uint64_t index, std::size_t dimension) const noexcept {
+        // Unsigned overflow is exactly the 'mod 1' we need
+        const std::uint64_t x = (std::uint64_t(1) << 63) + index * this->alphas[dimension];
+        return _bits_to_canonical<double>(x);
     }
 
-    constexpr result_type operator()() noexcept {
-        // Generate new block if necessary
-        if (this->position >= 16) {
-            this->generate_new_block();
-            this->position = 0;
-        }
+    template <class Container>
+    void at(std::uint64_t index, Container& point) const {
+        _check_point_size(point, this->dims);
 
-        // Get random value from the block and advance position cursor
-        return this->block[this->position++];
+        auto* data = std::data(point);
+        for (std::size_t d = 0; d < this->dims; ++d)
+            data[d] = static_cast<std::remove_reference_t<decltype(*data)>>(this->at(index, d));
     }
+
+    void discard(unsigned long long z) noexcept { this->position += z; }
 };
 
-} // namespace generators
+} // namespace sequences
 
-// ===========================
-// --- Default global PRNG ---
-// ===========================
+// ==============================
+// --- Shuffling & sampling ---
+// ==============================
 
-using default_generator_type = generators::Xoshiro256PlusPlus;
-using default_result_type    = default_generator_type::result_type;
+// Parallel algorithms need an independent generator for each task, those get created sequentially from the original
+// generator so the result doesn't depend on the scheduling. Generators without 'split()' seed a Xoshiro256++ instead.
+template <class Generator>
+[[nodiscard]] auto _split_generator(Generator& gen) {
+    if constexpr (_is_splittable_v<Generator>) return gen.split();
+    else return generators::Xoshiro256PlusPlus(_generate_bits<std::uint64_t>(gen));
+}
 
-inline default_generator_type default_generator;
+// MergeShuffle, see "MergeShuffle: A Very Fast, Parallel Random Permutation Algorithm" by A. Bacher, O. Bodini,
+// A. Hollender & J. Lumbroso (2015)
+//     https://arxiv.org/abs/1508.03167
+//
+// Array is split into cache-sized blocks that get shuffled with Fisher-Yates, after which neighbouring shuffled
+// blocks are merged pairwise by picking the side for each position with a coin flip, which keeps the permutation
+// uniform. Both steps are parallel across blocks & stream through memory sequentially, while 'std::shuffle()' does
+// a cache miss per element once the array doesn't fit into the cache. Block layout depends only on the size & every
+// block / merge gets its own generator, which makes the result independent of the thread count.
 
-inline std::seed_seq entropy_seq() {
-    // Ensure thread safery of our entropy source, it should generally work fine even without
-    // it, but with this we can be sure things never race
-    std::mutex                  entropy_mutex;
-    std::lock_guard<std::mutex> entropy_guard(entropy_mutex);
+// Fisher-Yates is fast while the block fits into L2, each halving of the block size adds a whole merge pass
+template <class T>
+constexpr std::size_t _shuffle_block_size = std::max<std::size_t>((1 << 20) / sizeof(T), 1);
 
-    // Hardware entropy (if implemented),
-    // some platfroms (mainly MinGW) implements random device as a regular PRNG that
-    // doesn't change from run to run, this is horrible, but we can somewhat improve
-    // things by mixing other sources of entropy. Since hardware entropy is a rather
-    // limited resource we only call it once.
-    static std::uint32_t seed_rd          = std::random_device{}();
-    // after that we just scramble it with a regular PRNG
-    static std::uint32_t splitmix32_state = seed_rd;
-    seed_rd                               = _splitmix32(splitmix32_state);
+template <class Generator, class T>
+void _fisher_yates(Generator& gen, T* data, std::size_t size) {
+    using std::swap;
+    for (std::size_t i = size; i > 1; --i) swap(data[i - 1], data[_uniform_uint(gen, std::uint64_t(i))]);
+}
 
-    // Time in nanoseconds (on some platforms microseconds)
-    const auto seed_time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+// Merges shuffled '[0, mid)' & '[mid, size)' into a shuffled '[0, size)'
+template <class Generator, class T>
+void _merge_shuffled(Generator& gen, T* data, std::size_t mid, std::size_t size) {
+    using std::swap;
 
-    // Counter that gets incremented each time
-    static std::uint32_t seed_counter = 0;
-    ++seed_counter;
+    std::size_t   i = 0, j = mid;
+    std::uint64_t bits = 0;
+    for (std::size_t bit_count = 0;; ++i, bits >>= 1, --bit_count) {
+        if (!bit_count) bits = _generate_bits<std::uint64_t>(gen), bit_count = 64;
 
-    // Note:
-    // There are other sources of entropy, such as memory space, heap/stack/function adresses,
-    // but those can be rather "constant" on some platforms, using intrinsics could also be good
-    // but that isn't portable
+        // Coin flips are unpredictable, so everything that depends on them is computed arithmetically,
+        // 'cursor' is the position we take the element from & 'limit' is where its side runs out
+        const std::size_t take_right = bits & 1;
+        const std::size_t cursor     = i + take_right * (j - i);
+        const std::size_t limit      = j + take_right * (size - j);
+        if (cursor == limit) break;
 
-    return {seed_rd, _crush_to_uint32(seed_time), seed_counter};
-}
+        if constexpr (std::is_trivially_copyable_v<T>) { // swap with itself is a no-op
+            const T a = data[i], b = data[cursor];
+            data[i] = b, data[cursor] = a;
+        } else if (take_right) swap(data[i], data[cursor]);
+        j += take_right;
+    }
 
-inline std::uint32_t entropy() {
-    auto seq = entropy_seq();
-    return _seed_seq_to_uint32(seq);
-    // returns 'std::uint32_t' to mimic the return type of 'std::random_device', if we return uint64_t
-    // brace-initializers will complain about narrowing conversion on some generators. If someone want
-    // more entropy than that they can always use the whole sequence as a generic solution.
-    // Also having one 'random::entropy()' is much nicer than 'random::entropy_32()' & 'random::entropy_64()'.
+    // One of the sides ran out, the rest gets inserted at random positions like in Fisher-Yates
+    for (; i < size; ++i) swap(data[i], data[_uniform_uint(gen, std::uint64_t(i + 1))]);
 }
 
-inline void seed(default_result_type random_seed) { default_generator.seed(random_seed); }
+// 'thread_count == 0' means all hardware threads
+template <class Generator, class T>
+void _shuffle(Generator& gen, T* data, std::size_t size, std::size_t thread_count = 0) {
+    if (size <= _shuffle_block_size<T>) return _fisher_yates(gen, data, size);
 
-inline void seed_with_entropy() {
-    auto seq = entropy_seq();
-    default_generator.seed(seq);
-    // for some god-forsaken reason seeding sequence constructors std:: generators take only l-value sequences
-}
+    // Blocks are the leaves of a balanced binary tree, 'boundary(i)' is the start of i-th leaf
+    std::size_t levels = 0;
+    while ((size >> levels) > _shuffle_block_size<T>) ++levels;
 
-// ========================
-// --- Random Functions ---
-// ========================
+    const std::size_t leaves   = std::size_t(1) << levels;
+    const auto        boundary = [&](std::size_t i) { return i * (size / leaves) + std::min(i, size % leaves); };
 
-// Note 1:
-// Despite the intuitive judgement, benchmarks don't seem to indicate that creating
-// 'std::uniform_..._distribution<>' on each call introduces any noticeble overhead
-//
-// sizeof(std::uniform_int_distribution<int>) == 8
-// sizeof(std::uniform_real_distribution<double>) == 16
+    std::vector<decltype(_split_generator(gen))> task_generators;
+    const auto                                   split_generators = [&](std::size_t count) {
+        task_generators.clear();
+        for (std::size_t i = 0; i < count; ++i) task_generators.push_back(_split_generator(gen));
+    };
 
-// Note 2:
-// No '[[nodiscard]]' since random functions inherently can't be pure due to advancing the generator state.
-// Discarding return values while not very sensible, can still be done for the sake of advancing state.
-// Ideally we would want users to advance the state directly, but I'm not sure how to communicate that in
-// '[[nodiscard]]' warnings.
+    split_generators(leaves);
+    _parallel_for_blocks(leaves, thread_count, [&](std::size_t leaf) {
+        const std::size_t first = boundary(leaf), last = boundary(leaf + 1);
+        _fisher_yates(task_generators[leaf], data + first, last - first);
+    });
 
-inline int rand_int(int min, int max) {
-    std::uniform_int_distribution<int> distr{min, max};
-    return distr(default_generator);
-}
+    for (std::size_t level = 1; level <= levels; ++level) {
+        const std::size_t span   = std::size_t(1) << level; // leaves per merged range
+        const std::size_t merges = leaves >> level;
 
-inline int rand_uint(unsigned int min, unsigned int max) {
-    std::uniform_int_distribution<unsigned int> distr{min, max};
-    return distr(default_generator);
+        split_generators(merges);
+        _parallel_for_blocks(merges, thread_count, [&](std::size_t merge) {
+            const std::size_t first = boundary(merge * span), mid = boundary(merge * span + span / 2),
+                              last  = boundary(merge * span + span);
+            _merge_shuffled(task_generators[merge], data + first, mid - first, last - first);
+        });
+    }
 }
 
-inline float rand_float() {
-    return std::generate_canonical<float, std::numeric_limits<float>::digits>(default_generator);
+template <class Generator, class Container, _is_generator_enable_if<Generator> = true,
+          _is_contiguous_container_enable_if<Container> = true>
+void shuffle(Generator& gen, Container& container) {
+    _shuffle(gen, std::data(container), std::size(container));
 }
 
-inline float rand_float(float min, float max) {
-    std::uniform_real_distribution<float> distr{min, max};
-    return distr(default_generator);
+template <class Container, _is_contiguous_container_enable_if<Container> = true>
+void shuffle(Container& container) {
+    shuffle(thread_generator(), container);
 }
 
-inline float rand_normal_float() {
-    std::normal_distribution<float> distr;
-    return distr(default_generator);
-}
+// Reservoir sampling with geometric jumps, see "Reservoir-Sampling Algorithms of Time Complexity O(n(1 + log(N/n)))"
+// by K. H. Li (1994), 'Algorithm L'. Instead of drawing a random value per element we draw the number of elements
+// to skip before the next replacement, which takes O(k log(N / k)) random values. Random access iterators skip
+// in O(1), for others skipping is just an increment per element.
+template <class Generator, class InputIt, _is_generator_enable_if<Generator> = true>
+[[nodiscard]] std::vector<typename std::iterator_traits<InputIt>::value_type>
+sample_reservoir(Generator& gen, InputIt first, InputIt last, std::size_t k) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
 
-inline double rand_double() {
-    return std::generate_canonical<double, std::numeric_limits<double>::digits>(default_generator);
-}
+    std::vector<typename std::iterator_traits<InputIt>::value_type> reservoir;
+    reservoir.reserve(k);
 
-inline double rand_double(double min, double max) {
-    std::uniform_real_distribution<double> distr{min, max};
-    return distr(default_generator);
+    for (; first != last && reservoir.size() < k; ++first) reservoir.push_back(*first);
+    if (first == last || !k) return reservoir;
+
+    const auto positive_canonical = [&] { return 1. - _bits_to_canonical<double>(_generate_bits<std::uint64_t>(gen)); };
+    const auto skip_distribution  = [&](double w) {
+        const double skip = std::floor(std::log(positive_canonical()) / std::log1p(-w));
+        return skip < 1e18 ? static_cast<std::uint64_t>(skip) : std::uint64_t(1e18); // 'w' can get very small
+    };
+
+    const double inverse_k = 1. / static_cast<double>(k);
+    for (double w = std::exp(std::log(positive_canonical()) * inverse_k);; ++first) {
+        std::uint64_t skip = skip_distribution(w);
+
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            if (skip >= static_cast<std::uint64_t>(last - first)) break;
+            first += static_cast<typename std::iterator_traits<InputIt>::difference_type>(skip);
+        } else {
+            for (; skip && first != last; --skip) ++first;
+            if (first == last) break;
+        }
+
+        reservoir[_uniform_uint(gen, std::uint64_t(k))] = *first;
+        w *= std::exp(std::log(positive_canonical()) * inverse_k);
+    }
+
+    return reservoir;
 }
 
-inline double rand_normal_double() {
-    std::normal_distribution<double> distr;
-    return distr(default_generator);
+template <class InputIt>
+[[nodiscard]] std::vector<typename std::iterator_traits<InputIt>::value_type> sample_reservoir(InputIt first,
+                                                                                               InputIt last,
+                                                                                               std::size_t k) {
+    return sample_reservoir(thread_generator(), first, last, k);
 }
 
-inline bool rand_bool() { return static_cast<bool>(rand_uint(0, 1)); }
+// Sampling without replacement with Floyd's algorithm, see "A sample of brilliance" by J. Bentley & B. Floyd (1987).
+// It draws exactly 'k' random values, selected indices are tracked in a bitmap or in a hash set (whichever one is
+// smaller), which makes both dense & sparse samples take O(min(N, k)) memory. Dense samples are read from the bitmap
+// in order, sparse ones need an O(k log k) sort.
+class _index_hash_set {
+    constexpr static std::size_t empty = std::size_t(-1);
 
-template <class T>
-const T& rand_choise(std::initializer_list<T> objects) {
-    const int random_index = rand_int(0, static_cast<int>(objects.size()) - 1);
-    return objects.begin()[random_index];
+    std::vector<std::size_t> slots;
+    std::size_t              mask  = 0;
+    int                      shift = 64;
+
+public:
+    explicit _index_hash_set(std::size_t capacity) {
+        while ((std::size_t(1) << (64 - this->shift)) < capacity) --this->shift;
+        this->slots.resize(std::size_t(1) << (64 - this->shift), empty);
+        this->mask = this->slots.size() - 1;
+    }
+
+    // Open addressing with Fibonacci hashing & linear probing
+    bool insert(std::size_t value) noexcept {
+        for (std::size_t i = (static_cast<std::uint64_t>(value) * 0x9E3779B97F4A7C15) >> this->shift;;
+             i             = (i + 1) & this->mask) {
+            if (this->slots[i] == value) return false;
+            if (this->slots[i] == empty) {
+                this->slots[i] = value;
+                return true;
+            }
+        }
+    }
+};
+
+class _index_bitmap {
+    std::vector<std::uint64_t> words;
+
+public:
+    explicit _index_bitmap(std::size_t size) : words(size / 64 + 1) {}
+
+    bool insert(std::size_t value) noexcept {
+        std::uint64_t&      word = this->words[value / 64];
+        const std::uint64_t bit  = std::uint64_t(1) << (value % 64);
+        if (word & bit) return false;
+        word |= bit;
+        return true;
+    }
+
+    void write_to(std::vector<std::size_t>& indices) const {
+        for (std::size_t w = 0; w < this->words.size(); ++w)
+            for (std::uint64_t word = this->words[w], b = 0; word; word >>= 1, ++b)
+                if (word & 1) indices.push_back(w * 64 + b);
+    }
+};
+
+template <class Generator, _is_generator_enable_if<Generator> = true>
+[[nodiscard]] std::vector<std::size_t> sample_indices(Generator& gen, std::size_t n, std::size_t k) {
+    if (k > n)
+        throw std::invalid_argument("Can't sample " + std::to_string(k) + " indices out of " + std::to_string(n) +
+                                    " without replacement.");
+
+    std::vector<std::size_t> indices;
+    indices.reserve(k);
+
+    // Each step adds either a random index from '[0, j]' or 'j' itself if that one was already taken
+    const auto floyd = [&](auto& set, auto&& on_insert) {
+        for (std::size_t j = n - k; j < n; ++j) {
+            const auto t     = static_cast<std::size_t>(_uniform_uint(gen, std::uint64_t(j) + 1));
+            const auto index = set.insert(t) ? t : j; // 'j' can't be in the set yet
+            if (index != t) set.insert(j);
+            on_insert(index);
+        }
+    };
+
+    const std::size_t hash_set_capacity = 2 * k; // keeps the load factor under 1/2
+    if (n / 64 <= hash_set_capacity) {
+        _index_bitmap bitmap(n);
+        floyd(bitmap, [](std::size_t) {});
+        bitmap.write_to(indices);
+    } else {
+        _index_hash_set hash_set(hash_set_capacity);
+        floyd(hash_set, [&](std::size_t index) { indices.push_back(index); });
+        std::sort(indices.begin(), indices.end());
+    }
+
+    return indices;
 }
 
-template <class T>
-T rand_linear_combination(const T& A, const T& B) { // random linear combination of 2 colors/vectors/etc
-    const auto coef = rand_double();
-    return A * coef + B * (1. - coef);
+[[nodiscard]] inline std::vector<std::size_t> sample_indices(std::size_t n, std::size_t k) {
+    return sample_indices(thread_generator(), n, k);
 }
 
 } // namespace utl::random
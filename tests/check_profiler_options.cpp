@@ -0,0 +1,39 @@
+// _______________ COMPILE CHECK & MODULE  _______________
+
+// Profiler options are implemented with preprocessor branches, which only get compiled when the option is
+// defined. This translation unit gets built once for every option set listed in 'tests/CMakeLists.txt' to make
+// sure each one of them compiles cleanly on its own and in combination with others.
+
+#include "UTL/profiler.hpp"
+
+// _______________________ INCLUDES _______________________
+
+#include <string> // string
+#include <vector> // vector<>
+
+// ____________________ IMPLEMENTATION ____________________
+
+UTL_PROFILER_ALLOCATION_HOOKS;
+
+int check_profiler_options() {
+    std::vector<int> values;
+
+    UTL_PROFILER("Inclusive") {
+        UTL_PROFILER_EXCLUSIVE("Exclusive") { values.push_back(1); }
+    }
+
+    UTL_PROFILER_BEGIN(segment, "Segment");
+    values.push_back(2);
+    UTL_PROFILER_END(segment);
+
+    UTL_PROFILER_EXCLUSIVE_BEGIN(exclusive_segment, "Exclusive segment");
+    values.push_back(3);
+    UTL_PROFILER_EXCLUSIVE_END(exclusive_segment);
+
+    const auto        snapshot = utl::profiler::get_snapshot();
+    const std::string report   = utl::profiler::format_table(snapshot) + utl::profiler::format_json(snapshot) +
+                               utl::profiler::format_csv(snapshot);
+    utl::profiler::reset();
+
+    return static_cast<int>(report.size() + values.size());
+}
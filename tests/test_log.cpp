@@ -9,15 +9,21 @@
 
 // _______________________ INCLUDES _______________________
 
+#include <algorithm>     // testing rate limiting
 #include <array>         // testing stringification
+#include <chrono>        // testing rate limiting
 #include <complex>       // testing stringification
+#include <csignal>       // testing fatal signal handlers
 #include <cstdint>       // testing stringification
 #include <deque>         // testing stringification
 #include <filesystem>    // testing stringification
+#include <fstream>       // testing file sinks
 #include <map>           // testing stringification
 #include <queue>         // testing stringification
 #include <set>           // testing stringification
+#include <sstream>       // testing file sinks
 #include <stack>         // testing stringification
+#include <thread>        // testing rate limiting
 #include <unordered_map> // testing stringification
 #include <unordered_set> // testing stringification
 #include <vector>        // testing stringification
@@ -245,6 +251,182 @@ TEST_CASE("Stringifier customization correctly overrides formatting of specific
     CHECK(OverridingStringifier{}(std::set{1, 2, 3}) == "{ 1, 2, 3 }");
 }
 
+// =========================
+// --- Logger sink tests ---
+// =========================
+
+#ifdef UTL_LOG_HAS_POSIX_IO
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path);
+    return (std::ostringstream() << file.rdbuf()).str();
+}
+
+TEST_CASE("POSIX file sink writes messages in order") {
+    log::Columns cols;
+    cols.datetime = false;
+    cols.uptime   = false;
+    cols.thread   = false;
+    cols.callsite = false;
+    cols.level    = false;
+
+    // Messages are much larger than the buffer which forces all of the write paths to get used
+    const std::string long_message(5000, 'x');
+
+    for (auto direct_io : {log::DirectIO::DISABLE, log::DirectIO::ENABLE}) {
+        const fs::path path = fs::temp_directory_path() / "utl_test_log_posix_sink.log";
+
+        auto& sink = log::add_posix_file_sink(path.string(), log::OpenMode::REWRITE, log::Verbosity::TRACE,
+                                              log::Colors::DISABLE, std::chrono::milliseconds{0}, cols, 1, direct_io)
+                         .skip_header();
+
+        std::string expected;
+        for (int i = 0; i < 20; ++i) {
+            UTL_LOG_TRACE(i, " ", (i % 3) ? "short message" : long_message);
+            expected += log::stringify(" ", i, " ", (i % 3) ? "short message" : long_message, "\n");
+        }
+
+        sink.set_verbosity(log::Verbosity::ERR); // mute the sink so other tests don't write to it
+
+        CHECK(read_file(path) == expected);
+
+        fs::remove(path);
+    }
+}
+
+TEST_CASE("Flight recorder sink dumps recent history") {
+    log::Columns cols;
+    cols.datetime = false;
+    cols.uptime   = false;
+    cols.thread   = false;
+    cols.callsite = false;
+    cols.level    = false;
+
+    const fs::path path = fs::temp_directory_path() / "utl_test_log_flight_recorder.log";
+
+    auto& sink = log::add_flight_recorder_sink(path.string(), 4, log::Verbosity::ERR, log::OpenMode::REWRITE, cols);
+
+    // Nothing gets written until the dump, after which only the last 'capacity' records are present
+    for (int i = 0; i < 10; ++i) UTL_LOG_TRACE("record ", i);
+    CHECK(read_file(path).empty());
+
+    sink.dump();
+    std::string expected = " message\n record 6\n record 7\n record 8\n record 9\n";
+    CHECK(read_file(path) == expected);
+
+    // Error triggers a dump automatically, already dumped records don't get repeated
+    UTL_LOG_ERR("error");
+    expected += " message\n error\n";
+    CHECK(read_file(path) == expected);
+
+    sink.set_verbosity(log::Verbosity::ERR); // mute the sink so other tests don't write to it
+
+    fs::remove(path);
+}
+
+volatile std::sig_atomic_t previous_handler_calls = 0;
+
+void previous_abort_handler(int, siginfo_t*, void*) { previous_handler_calls = previous_handler_calls + 1; }
+
+TEST_CASE("Fatal signal handler dumps flight recorders and chains to the previous handler") {
+    log::Columns cols;
+    cols.datetime = false;
+    cols.uptime   = false;
+    cols.thread   = false;
+    cols.callsite = false;
+    cols.level    = false;
+
+    const fs::path path = fs::temp_directory_path() / "utl_test_log_fatal_signal.log";
+
+    auto& sink = log::add_flight_recorder_sink(path.string(), 4, log::Verbosity::ERR, log::OpenMode::REWRITE, cols);
+
+    UTL_LOG_TRACE("before signal");
+
+    struct sigaction previous {};
+    previous.sa_sigaction = previous_abort_handler;
+    previous.sa_flags     = SA_SIGINFO;
+    sigemptyset(&previous.sa_mask);
+    ::sigaction(SIGABRT, &previous, nullptr);
+
+    // Repeated installation shouldn't chain the handler to itself
+    log::dump_flight_recorders_on_fatal_signals();
+    log::dump_flight_recorders_on_fatal_signals();
+
+    ::raise(SIGABRT);
+
+    CHECK(previous_handler_calls == 1);
+    CHECK(read_file(path) == " message\n before signal\n");
+
+    // Previous handler is restored after the dump
+    struct sigaction current {};
+    ::sigaction(SIGABRT, nullptr, &current);
+    CHECK(current.sa_sigaction == previous_abort_handler);
+
+    for (const int signal : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) std::signal(signal, SIG_DFL);
+
+    sink.set_verbosity(log::Verbosity::ERR); // mute the sink so other tests don't write to it
+
+    fs::remove(path);
+}
+#endif
+
+// ========================================
+// --- Rate limiting and sampling tests ---
+// ========================================
+
+std::size_t count_lines(const std::string& str) {
+    return static_cast<std::size_t>(std::count(str.begin(), str.end(), '\n'));
+}
+
+TEST_CASE("Rate-limited and sampled logging skip the expected messages") {
+    static std::ostringstream oss; // sinks are never removed, make sure the stream outlives them
+
+    log::Columns cols;
+    cols.datetime = false;
+    cols.uptime   = false;
+    cols.thread   = false;
+    cols.callsite = false;
+    cols.level    = false;
+
+    auto& sink = log::add_ostream_sink(oss, log::Verbosity::TRACE, log::Colors::DISABLE, std::chrono::milliseconds{0},
+                                       cols)
+                     .skip_header();
+
+    // Rate limiting, all messages get logged within a single 1 second window
+    oss.str("");
+    for (int i = 0; i < 1000; ++i) UTL_LOG_TRACE_LIMITED(10, "message ", i);
+    CHECK(count_lines(oss.str()) == 10);
+    CHECK(oss.str().find("message 9\n") != std::string::npos);
+    CHECK(oss.str().find("message 10\n") == std::string::npos);
+
+    // Messages suppressed in the previous window get reported with the first message of the next one,
+    // this includes messages suppressed by threads that have exited since
+    const auto log_limited = [](int i) { UTL_LOG_TRACE_LIMITED(10, "message ", i); }; // same callsite for all loops
+
+    for (int i = 0; i < 1000; ++i) log_limited(i);
+    std::thread([&] { for (int i = 0; i < 500; ++i) log_limited(i); }).join();
+    oss.str("");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    log_limited(0);
+    CHECK(oss.str() == " message 0 [suppressed 1490 messages]\n");
+
+    // Sampling with edge-case probabilities is deterministic
+    oss.str("");
+    for (int i = 0; i < 1000; ++i) UTL_LOG_TRACE_SAMPLED(0.0, "message ", i);
+    CHECK(count_lines(oss.str()) == 0);
+
+    oss.str("");
+    for (int i = 0; i < 1000; ++i) UTL_LOG_TRACE_SAMPLED(1.0, "message ", i);
+    CHECK(count_lines(oss.str()) == 1000);
+
+    // Sampling with 50% probability should roughly log half of the messages
+    oss.str("");
+    for (int i = 0; i < 10'000; ++i) UTL_LOG_TRACE_SAMPLED(0.5, "message ", i);
+    CHECK(count_lines(oss.str()) > 4'000);
+    CHECK(count_lines(oss.str()) < 6'000);
+
+    sink.set_verbosity(log::Verbosity::ERR); // mute the sink so other tests don't write to it
+}
+
 // ===============================
 // --- Logger formatting tests ---
 // ===============================
@@ -0,0 +1,319 @@
+// _______________ TEST FRAMEWORK & MODULE  _______________
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "thirdparty/doctest.h"
+
+#include "test.hpp"
+
+#define UTL_PROFILER_OPTION_CALL_TREE
+#define UTL_PROFILER_OPTION_STATISTICS
+#include "UTL/profiler.hpp"
+
+#include "UTL/json.hpp" // parsing formatted results
+
+// _______________________ INCLUDES _______________________
+
+#include <algorithm>   // testing formatting
+#include <chrono>      // testing merged records
+#include <cmath>       // testing statistics
+#include <cstdint>     // testing merged records
+#include <map>         // testing call tree
+#include <set>         // testing merged records
+#include <sstream>     // testing formatting
+#include <string>      // testing call tree
+#include <string_view> // testing merged records
+#include <thread>      // testing merged records
+#include <vector>      // testing merged records
+
+// ____________________ DEVELOPER DOCS ____________________
+
+// NOTE: DOCS
+
+// ____________________ IMPLEMENTATION ____________________
+
+// Profiler state is global and shared by all test cases, each test profiles its own callsites with unique labels
+// and looks them up in the snapshot. Durations are only checked against lower bounds set by sleeping.
+
+std::vector<profiler::_record> find_records(const std::vector<profiler::_record>& records, std::string_view label) {
+    std::vector<profiler::_record> result;
+    for (const auto& record : records)
+        if (record.callsite->label == label) result.push_back(record);
+    return result;
+}
+
+// ===============================
+// --- Multithreaded profiling ---
+// ===============================
+
+void profile_merged_work(std::size_t calls) {
+    for (std::size_t i = 0; i < calls; ++i) {
+        UTL_PROFILER("Merged work") { std::this_thread::sleep_for(std::chrono::microseconds(100)); }
+    }
+}
+
+TEST_CASE("Per-thread records get merged across threads") {
+    constexpr std::size_t thread_count = 4;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t) threads.emplace_back(profile_merged_work, 10 * (t + 1));
+    for (auto& thread : threads) thread.join();
+
+    const profiler::snapshot results    = profiler::get_snapshot();
+    const auto               merged     = find_records(results.records, "Merged work");
+    const auto               per_thread = find_records(results.per_thread_records, "Merged work");
+
+    REQUIRE(merged.size() == 1);
+    REQUIRE(per_thread.size() == thread_count);
+    CHECK(results.thread_count >= thread_count);
+
+    // Every thread has its own record, merged one is their sum
+    std::set<std::size_t>   thread_indices;
+    std::set<std::uint64_t> thread_calls;
+    profiler::duration      total_time{};
+    profiler::duration      min = profiler::duration::max(), max{};
+    for (const auto& record : per_thread) {
+        thread_indices.insert(record.thread);
+        thread_calls.insert(record.statistics.calls);
+        total_time += record.accumulated_time;
+        min = std::min(min, record.statistics.min);
+        max = std::max(max, record.statistics.max);
+    }
+
+    CHECK(thread_indices.size() == thread_count);
+    CHECK(thread_calls == std::set<std::uint64_t>{10, 20, 30, 40});
+
+    CHECK(merged.front().accumulated_time == total_time);
+    CHECK(merged.front().accumulated_time >= std::chrono::microseconds(100) * 100);
+    CHECK(merged.front().statistics.calls == 100);
+    CHECK(merged.front().statistics.min == min);
+    CHECK(merged.front().statistics.max == max);
+}
+
+// =================
+// --- Call tree ---
+// =================
+
+void profile_tree_leaf() {
+    UTL_PROFILER("Tree leaf") { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+}
+
+void profile_tree_recursion(int depth) {
+    UTL_PROFILER("Tree recursion") {
+        if (depth) profile_tree_recursion(depth - 1);
+        else profile_tree_leaf();
+    }
+}
+
+void profile_tree() {
+    UTL_PROFILER("Tree root") {
+        profile_tree_recursion(2);
+        profile_tree_leaf();
+    }
+}
+
+TEST_CASE("Call tree tracks nesting, recursion & inclusive/exclusive time") {
+    std::thread([] {
+        for (int i = 0; i < 3; ++i) profile_tree();
+    }).join();
+
+    const profiler::snapshot results = profiler::get_snapshot();
+
+    // Rows are listed depth-first, which means the path of each row is its label appended to the labels
+    // of the last seen rows with smaller depth
+    std::size_t thread = 0;
+    for (const auto& row : results.call_tree)
+        if (row.callsite->label == "Tree root"sv) thread = row.thread;
+
+    std::map<std::string, profiler::_call_tree_row> rows;
+    std::vector<std::string>                        path;
+    for (const auto& row : results.call_tree) {
+        if (row.thread != thread) continue;
+        path.resize(row.depth);
+        path.push_back(path.empty() ? row.callsite->label : path.back() + "/" + row.callsite->label);
+        rows[path.back()] = row;
+    }
+
+    const std::string root      = "Tree root";
+    const std::string recursion = root + "/Tree recursion";
+    const std::string deepest   = recursion + "/Tree recursion/Tree recursion";
+
+    // Recursion isn't collapsed, each level gets its own node
+    const std::vector<std::string> expected_paths = {root,
+                                                     recursion,
+                                                     recursion + "/Tree recursion",
+                                                     deepest,
+                                                     deepest + "/Tree leaf",
+                                                     root + "/Tree leaf"};
+    REQUIRE(rows.size() == expected_paths.size());
+    for (const auto& expected : expected_paths) {
+        REQUIRE(rows.count(expected));
+        CHECK(rows[expected].calls == 3);
+    }
+    CHECK(rows[deepest + "/Tree leaf"].depth == 4);
+
+    // Exclusive time is the inclusive time minus the inclusive time of direct children
+    for (const auto& [row_path, row] : rows) {
+        profiler::duration children_time{};
+        for (const auto& [child_path, child] : rows)
+            if (child.depth == row.depth + 1 && child_path.rfind(row_path + "/", 0) == 0)
+                children_time += child.inclusive_time;
+        CHECK(row.exclusive_time == row.inclusive_time - children_time);
+    }
+
+    const auto leaf_time = std::chrono::milliseconds(2) * 3;
+    CHECK(rows[root + "/Tree leaf"].inclusive_time >= leaf_time);
+    CHECK(rows[deepest + "/Tree leaf"].inclusive_time >= leaf_time);
+    CHECK(rows[root].inclusive_time >= 2 * leaf_time);
+    CHECK(rows[root].exclusive_time <= rows[root].inclusive_time - 2 * leaf_time);
+
+    // Regular records collapse recursion, a recursive scope counts as a single call
+    const auto recursion_records = find_records(results.records, "Tree recursion");
+    REQUIRE(recursion_records.size() == 1);
+    CHECK(recursion_records.front().statistics.calls == 3);
+    CHECK(recursion_records.front().accumulated_time >= leaf_time);
+}
+
+// ==================
+// --- Statistics ---
+// ==================
+
+// Histogram buckets have a relative width of 1/16, percentiles are reported as the bucket middle
+void check_percentile(const profiler::_statistics& statistics, double p, profiler::duration expected) {
+    const auto error = statistics.percentile(p) - expected;
+    CHECK(std::abs(error.count()) <= expected.count() / 16);
+}
+
+TEST_CASE("Statistics match injected durations") {
+    using us = std::chrono::microseconds;
+
+    // Inject 1..1000 us in a scrambled order, exact percentiles are then known
+    profiler::_thread_record record(nullptr);
+    for (int i = 0; i < 1000; ++i) record.add_time(us(1 + (i * 617) % 1000));
+
+    const profiler::_statistics statistics = record.statistics();
+    CHECK(statistics.calls == 1000);
+    CHECK(statistics.min == us(1));
+    CHECK(statistics.max == us(1000));
+    CHECK(record.accumulated_time() == us(500500));
+
+    check_percentile(statistics, 0.50, us(500));
+    check_percentile(statistics, 0.90, us(900));
+    check_percentile(statistics, 0.99, us(990));
+    CHECK(statistics.percentile(1.) <= statistics.max);
+
+    // Merging with 1000 calls of 2000 us moves the median to the boundary between two groups
+    profiler::_thread_record slow_record(nullptr);
+    for (int i = 0; i < 1000; ++i) slow_record.add_time(us(2000));
+
+    profiler::_statistics merged = statistics;
+    merged.merge(slow_record.statistics());
+    CHECK(merged.calls == 2000);
+    CHECK(merged.min == us(1));
+    CHECK(merged.max == us(2000));
+    check_percentile(merged, 0.50, us(1000));
+    check_percentile(merged, 0.99, us(2000));
+
+    // Subtracting restores the histogram, min & max get narrowed down to the non-empty buckets
+    profiler::_statistics subtracted = merged;
+    subtracted.subtract(slow_record.statistics());
+    CHECK(subtracted.calls == 1000);
+    CHECK(subtracted.histogram == statistics.histogram);
+    CHECK(subtracted.min == us(1));
+    CHECK(subtracted.max >= us(1000));
+    CHECK(subtracted.max <= us(1000) + us(1000) / 16);
+    check_percentile(subtracted, 0.50, us(500));
+
+    subtracted.subtract(subtracted);
+    CHECK(subtracted.calls == 0);
+    CHECK(subtracted.percentile(0.5) == profiler::duration::zero());
+}
+
+// =================================
+// --- Snapshots & result export ---
+// =================================
+
+void profile_snapshot_work() {
+    UTL_PROFILER("Snapshot work") { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+}
+
+TEST_CASE("Snapshots report results accumulated since the last reset") {
+    profile_snapshot_work();
+
+    const auto before_reset = find_records(profiler::get_snapshot().records, "Snapshot work");
+    REQUIRE(before_reset.size() == 1);
+    CHECK(before_reset.front().statistics.calls >= 1);
+
+    profiler::reset();
+
+    // Callsite is still listed after the reset, but everything it measured before is gone
+    const auto after_reset = find_records(profiler::get_snapshot().records, "Snapshot work");
+    REQUIRE(after_reset.size() == 1);
+    CHECK(after_reset.front().accumulated_time == profiler::duration::zero());
+    CHECK(after_reset.front().statistics.calls == 0);
+
+    profile_snapshot_work();
+    profile_snapshot_work();
+
+    const profiler::snapshot results = profiler::get_snapshot();
+    const auto               records = find_records(results.records, "Snapshot work");
+    REQUIRE(records.size() == 1);
+    CHECK(records.front().statistics.calls == 2);
+    CHECK(records.front().statistics.min >= std::chrono::milliseconds(1));
+    CHECK(records.front().accumulated_time >= std::chrono::milliseconds(2));
+    CHECK(results.runtime >= records.front().accumulated_time);
+}
+
+TEST_CASE("Snapshots get formatted as parsable JSON & CSV") {
+    profile_snapshot_work();
+
+    const profiler::snapshot results = profiler::get_snapshot();
+    const auto               records = find_records(results.records, "Snapshot work");
+    REQUIRE(records.size() == 1);
+
+    // JSON
+    const json::Node json = json::from_string(profiler::format_json(results));
+
+    CHECK(json.at("runtime_ns").get_number() == profiler::_duration_to_ns(results.runtime));
+    CHECK(json.at("thread_count").get_number() == results.thread_count);
+    CHECK(json.at("records").get_array().size() == results.records.size());
+    CHECK(json.at("per_thread_records").get_array().size() == results.per_thread_records.size());
+    CHECK(json.at("call_tree").get_array().size() == results.call_tree.size());
+
+    std::size_t json_matches = 0;
+    for (const auto& record : json.at("records").get_array()) {
+        if (record.at("label").get_string() != "Snapshot work") continue;
+        ++json_matches;
+        CHECK(record.at("function").get_string() == records.front().callsite->func);
+        CHECK(record.at("line").get_number() == records.front().callsite->line);
+        CHECK(record.at("time_ns").get_number() == profiler::_duration_to_ns(records.front().accumulated_time));
+        CHECK(record.at("calls").get_number() == records.front().statistics.calls);
+    }
+    CHECK(json_matches == 1);
+
+    // CSV
+    std::istringstream csv(profiler::format_csv(results));
+    std::string        line;
+
+    const auto column_count = [](const std::string& line) { return std::count(line.begin(), line.end(), ',') + 1; };
+
+    REQUIRE(std::getline(csv, line));
+    CHECK(line.rfind("thread,file,line,function,label,time_ns,calls", 0) == 0);
+    const auto header_columns = column_count(line);
+
+    std::size_t csv_rows = 0, csv_matches = 0;
+    while (std::getline(csv, line)) {
+        ++csv_rows;
+        CHECK(column_count(line) == header_columns);
+        if (line.rfind("all,", 0) == 0 && line.find("Snapshot work") != std::string::npos) ++csv_matches;
+    }
+    CHECK(csv_rows == results.per_thread_records.size() + results.records.size());
+    CHECK(csv_matches == 1);
+
+    // Snapshot taken right after a reset has no runtime to compute percentages from
+    profiler::snapshot no_runtime = results;
+    no_runtime.runtime            = profiler::duration::zero();
+
+    const std::string table = profiler::format_table(no_runtime);
+    CHECK(table.find("nan") == std::string::npos);
+    CHECK(table.find("inf") == std::string::npos);
+}
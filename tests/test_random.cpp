@@ -9,9 +9,18 @@
 
 // _______________________ INCLUDES _______________________
 
-#include <algorithm> // PRNG sanity tests
-#include <numeric>   // PRNG sanity tests
-#include <vector>    // PRNG sanity tests
+#include <algorithm>     // PRNG sanity tests
+#include <array>         // bulk generation tests
+#include <cmath>         // discrete distribution tests
+#include <cstdint>       // bulk generation tests
+#include <list>          // sampling tests
+#include <map>           // shuffling tests
+#include <numeric>       // PRNG sanity tests
+#include <stdexcept>     // discrete distribution tests
+#include <string>        // shuffling tests
+#include <thread>        // thread-local generator tests
+#include <unordered_set> // bulk generation tests
+#include <vector>        // PRNG sanity tests
 
 // ____________________ DEVELOPER DOCS ____________________
 
@@ -91,4 +100,849 @@ TEST_CASE("Uniform distribution mean/min/max are sensible") {
     // a "good" PRNG would be expected to pass (or at least mostly pass) TestU01 Big Crush,
     // however it is a task for PRNG designers, here we merely implement well known algorithms
     // and check that their implementation wasn't accidentaly broken.
-}
\ No newline at end of file
+}
+
+// =====================
+// --- Distributions ---
+// =====================
+
+TEST_CASE("Distributions produce the same values on every platform") {
+    // Values don't depend on the standard library, these should never change
+    random::generators::Xoshiro256PlusPlus        gen(42);
+    random::distributions::UniformIntDistribution distr(0, 999);
+    CHECK(distr(gen) == 814);
+    CHECK(distr(gen) == 318);
+    CHECK(distr(gen) == 983);
+    CHECK(distr(gen) == 701);
+
+    random::generators::JSF32                                   gen_32(42);
+    random::distributions::UniformIntDistribution<std::int64_t> distr_64(-1'000'000'000'000, 1'000'000'000'000);
+    CHECK(distr_64(gen_32) == 899'943'570'740);
+    CHECK(distr_64(gen_32) == -736'535'735'210);
+
+    random::generators::Xoshiro256PlusPlus gen_canonical(42);
+    CHECK(random::distributions::generate_canonical<double>(gen_canonical) == 0.81430514512290986);
+    CHECK(random::distributions::generate_canonical<double>(gen_canonical) == 0.31882104006166112);
+
+    random::generators::Xoshiro256PlusPlus          gen_discrete(42);
+    random::distributions::DiscreteDistribution<int> distr_discrete{1, 2, 3, 4};
+    CHECK(distr_discrete(gen_discrete) == 3);
+    CHECK(distr_discrete(gen_discrete) == 1);
+    CHECK(distr_discrete(gen_discrete) == 3);
+    CHECK(distr_discrete(gen_discrete) == 3);
+}
+
+TEST_CASE("Distributions cover their range & have sensible moments") {
+    constexpr std::size_t N   = 500'000;
+    constexpr double      eps = 2e-2;
+
+    random::generators::RomuTrio32 gen(17);
+    std::vector<double>            vec(N);
+
+    // Full range of a type makes the bounded range wrap around to 0
+    const random::distributions::UniformIntDistribution<std::int8_t> full_range_distr(-128, 127);
+    for (auto& e : vec) e = full_range_distr(gen);
+    CHECK(vec_min(vec) == -128.);
+    CHECK(vec_max(vec) == 127.);
+
+    const random::distributions::UniformRealDistribution<float> uniform_distr(-3.f, 1.f);
+    for (auto& e : vec) e = uniform_distr(gen);
+    CHECK(vec_mean(vec) == doctest::Approx(-1.0).epsilon(eps));
+    CHECK(vec_min(vec) >= -3.);
+    CHECK(vec_max(vec) < 1.);
+
+    const auto variance = [&](double mean) {
+        double sum = 0.;
+        for (const auto& e : vec) sum += (e - mean) * (e - mean);
+        return sum / N;
+    };
+
+    const random::distributions::NormalDistribution normal_distr(2., 3.);
+    for (auto& e : vec) e = normal_distr(gen);
+    CHECK(vec_mean(vec) == doctest::Approx(2.0).epsilon(eps));
+    CHECK(variance(2.) == doctest::Approx(9.0).epsilon(eps));
+
+    const random::distributions::ExponentialDistribution exponential_distr(4.);
+    for (auto& e : vec) e = exponential_distr(gen);
+    CHECK(vec_mean(vec) == doctest::Approx(0.25).epsilon(eps));
+    CHECK(variance(0.25) == doctest::Approx(0.0625).epsilon(eps));
+    CHECK(vec_min(vec) >= 0.);
+}
+
+TEST_CASE("Discrete distribution follows the weights") {
+    constexpr std::size_t N   = 500'000;
+    constexpr double      eps = 2e-2;
+
+    const std::vector<double> weights = {1., 0., 2., 3., 4., 0., 10.};
+    const double              total   = 20.;
+
+    const random::distributions::DiscreteDistribution<int> distr(weights.begin(), weights.end());
+    CHECK(distr.min() == 0);
+    CHECK(distr.max() == 6);
+
+    const auto probabilities = distr.probabilities();
+    for (std::size_t i = 0; i < weights.size(); ++i) CHECK(probabilities[i] == doctest::Approx(weights[i] / total));
+
+    const auto check_frequencies = [&](const std::vector<int>& samples) {
+        std::vector<double> frequencies(weights.size());
+        for (const auto& e : samples) frequencies.at(e) += 1. / N;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            if (weights[i] == 0.) CHECK(frequencies[i] == 0.); // zero weights are never sampled
+            else CHECK(frequencies[i] == doctest::Approx(weights[i] / total).epsilon(eps));
+        }
+    };
+
+    random::generators::Xoshiro256PlusPlus gen(17);
+    std::vector<int>                       samples(N);
+
+    for (auto& e : samples) e = distr(gen);
+    check_frequencies(samples);
+
+    distr.fill(gen, samples);
+    check_frequencies(samples);
+
+    // Invalid weights
+    const std::vector<double> negative = {1., -1.}, zero = {0., 0.}, empty = {};
+    CHECK_THROWS_AS(random::distributions::DiscreteDistribution<>(negative.begin(), negative.end()),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(random::distributions::DiscreteDistribution<>(zero.begin(), zero.end()), std::invalid_argument);
+    CHECK_THROWS_AS(random::distributions::DiscreteDistribution<>(empty.begin(), empty.end()), std::invalid_argument);
+}
+
+TEST_CASE("Discrete distribution table doesn't depend on the thread count") {
+    // Large enough to be split into several blocks, weights are skewed with some zeros
+    random::generators::RomuTrio32 gen(17);
+    std::vector<double>            weights(300'000);
+    for (auto& e : weights) {
+        const double u = random::distributions::generate_canonical<double>(gen);
+        e              = (u < 0.2) ? 0. : u * u * u;
+    }
+
+    const auto weight   = [&](std::size_t i) { return weights[i]; };
+    const auto single   = random::_build_alias_table(weights.size(), weight, 1);
+    const auto parallel = random::_build_alias_table(weights.size(), weight, 4);
+
+    bool tables_match = true;
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        tables_match &= (single[i].threshold == parallel[i].threshold && single[i].alias == parallel[i].alias);
+    CHECK(tables_match);
+
+    // Table should reproduce all of the weights
+    const random::distributions::DiscreteDistribution<> distr(weights.begin(), weights.end());
+    const auto                                          probabilities = distr.probabilities();
+
+    double total = 0.;
+    for (const auto& e : weights) total += e;
+
+    double max_error = 0.;
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        max_error = std::max(max_error, std::abs(probabilities[i] - weights[i] / total));
+    CHECK(max_error < 1e-12);
+}
+
+// ==================================
+// --- Thread-local default PRNGs ---
+// ==================================
+
+std::vector<double> generate_sequence(std::size_t size) {
+    std::vector<double> vec(size);
+    for (auto& e : vec) e = random::rand_double();
+    return vec;
+}
+
+TEST_CASE("Default generators are reproducible after reseeding") {
+    random::seed(42);
+    const auto first = generate_sequence(16);
+    random::seed(42);
+    const auto second = generate_sequence(16);
+
+    CHECK(first == second);
+}
+
+TEST_CASE("Default generators of different threads produce different sequences") {
+    constexpr std::size_t thread_count = 4;
+
+    random::seed(42);
+
+    std::vector<std::vector<double>> sequences(thread_count);
+    std::vector<std::thread>         threads;
+    for (std::size_t i = 0; i < thread_count; ++i)
+        threads.emplace_back([&, i] { sequences[i] = generate_sequence(100'000); });
+    for (auto& thread : threads) thread.join();
+
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        CHECK(vec_mean(sequences[i]) == doctest::Approx(0.5).epsilon(2e-2));
+        for (std::size_t j = i + 1; j < thread_count; ++j) CHECK(sequences[i] != sequences[j]);
+    }
+
+    // Reseeding with the same seed restarts the sequence of an already running thread
+    std::vector<double> before, after;
+    std::thread         thread([&] {
+        before = generate_sequence(16);
+        random::seed(42);
+        after = generate_sequence(16);
+    });
+    thread.join();
+
+    CHECK(before == after);
+}
+
+TEST_CASE("Pinned thread indices don't depend on the thread start order") {
+    constexpr std::size_t thread_count = 4;
+
+    random::seed(42);
+
+    // Start threads one by one in opposite orders, automatic indices would differ between the runs
+    const auto run_pinned = [&](bool reversed) {
+        std::vector<std::vector<double>> sequences(thread_count);
+        for (std::size_t k = 0; k < thread_count; ++k) {
+            const std::size_t i = reversed ? thread_count - 1 - k : k;
+            std::thread([&, i] {
+                random::seed_thread(100 + i);
+                sequences[i] = generate_sequence(16);
+            }).join();
+        }
+        return sequences;
+    };
+
+    const auto forward  = run_pinned(false);
+    const auto backward = run_pinned(true);
+
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        CHECK(forward[i] == backward[i]);
+        for (std::size_t j = i + 1; j < thread_count; ++j) CHECK(forward[i] != forward[j]);
+    }
+
+    // Index 0 uses the global seed directly
+    std::thread([] {
+        random::seed_thread(0);
+        random::default_generator_type reference{42};
+        for (int i = 0; i < 16; ++i) CHECK(random::thread_generator()() == reference());
+    }).join();
+}
+
+TEST_CASE("Default generator handle works with the standard algorithms") {
+    std::thread([] {
+        random::seed_thread(0);
+        random::default_generator.seed(42);
+
+        std::vector<int> values(100), expected(100);
+        std::iota(values.begin(), values.end(), 0);
+        std::iota(expected.begin(), expected.end(), 0);
+
+        std::shuffle(values.begin(), values.end(), random::default_generator);
+        std::shuffle(expected.begin(), expected.end(), random::default_generator_type{42});
+
+        CHECK(values == expected);
+    }).join();
+}
+
+// ===============================
+// --- Jump-ahead & splitting ---
+// ===============================
+
+template <class Generator>
+void check_discard_and_streams() {
+    // 'discard(z)' is the same as 'z' calls
+    for (unsigned long long z : {0ull, 1ull, 15ull, 16ull, 17ull, 100ull, 1000ull}) {
+        Generator a(17), b(17);
+        a.discard(z);
+        for (unsigned long long i = 0; i < z; ++i) b();
+        CHECK(a() == b());
+    }
+
+    // 'stream(n)' is the same as the n-th 'split()', all streams are different
+    Generator                                    master(17);
+    std::vector<typename Generator::result_type> first_values;
+    for (std::uint64_t n = 0; n < 8; ++n) {
+        Generator child    = master.split();
+        Generator expected = Generator(17).stream(n);
+        CHECK(child() == expected());
+        first_values.push_back(Generator(17).stream(n)());
+    }
+    std::sort(first_values.begin(), first_values.end());
+    CHECK(std::adjacent_find(first_values.begin(), first_values.end()) == first_values.end());
+}
+
+TEST_CASE("Generators support discard(), split() & stream()") {
+    check_discard_and_streams<random::generators::RomuTrio32>();
+    check_discard_and_streams<random::generators::JSF32>();
+    check_discard_and_streams<random::generators::RomuDuoJr>();
+    check_discard_and_streams<random::generators::JSF64>();
+    check_discard_and_streams<random::generators::Xoshiro256PlusPlus>();
+    check_discard_and_streams<random::generators::Xorshift64Star>();
+    check_discard_and_streams<random::generators::ChaCha20>();
+    check_discard_and_streams<random::generators::Philox4x32>();
+    check_discard_and_streams<random::generators::Philox4x64>();
+}
+
+template <class Generator>
+void check_nested_splits() {
+    // Tree of splits 3 levels deep, every generator in it should get its own stream, this includes the streams
+    // of grandchildren and the siblings of their parents
+    std::vector<Generator> generators = {Generator(17)};
+    for (std::size_t level = 0, begin = 0; level < 3; ++level) {
+        const std::size_t end = generators.size();
+        for (std::size_t i = begin; i < end; ++i)
+            for (std::size_t k = 0; k < 3; ++k) generators.push_back(generators[i].split());
+        begin = end;
+    }
+
+    std::unordered_set<typename Generator::result_type> values;
+    std::size_t                                         repeats = 0;
+    for (auto& gen : generators)
+        for (std::size_t i = 0; i < 64; ++i) repeats += !values.insert(gen()).second;
+    CHECK(repeats == 0);
+}
+
+TEST_CASE("Nested splits don't alias") {
+    check_nested_splits<random::generators::RomuTrio32>();
+    check_nested_splits<random::generators::JSF32>();
+    check_nested_splits<random::generators::RomuDuoJr>();
+    check_nested_splits<random::generators::JSF64>();
+    check_nested_splits<random::generators::Xoshiro256PlusPlus>();
+    check_nested_splits<random::generators::Xorshift64Star>();
+    check_nested_splits<random::generators::ChaCha20>();
+    check_nested_splits<random::generators::Philox4x32>();
+    check_nested_splits<random::generators::Philox4x64>();
+}
+
+TEST_CASE("Xoshiro256++ jumps match the reference implementation") {
+    // Values were computed with the reference 'jump()' & 'long_jump()' from https://prng.di.unimi.it
+    random::generators::Xoshiro256PlusPlus gen(123);
+    gen.jump();
+    const auto after_jump = gen();
+    gen.long_jump();
+    const auto after_long_jump = gen();
+
+    CHECK(after_jump == 13285307497005853760ull);
+    CHECK(after_long_jump == 11206133844958219998ull);
+}
+
+TEST_CASE("ChaCha20 SIMD blocks match the constexpr scalar ones") {
+    // Constant evaluation always takes the scalar path, runtime uses SSE2/AVX2 when available
+    constexpr auto compile_time_values = [] {
+        random::generators::ChaCha20 gen(17);
+        std::array<std::uint32_t, 3> values{};
+        values[0] = gen();
+        gen.discard(1000);
+        values[1] = gen();
+        gen.discard(123'456);
+        values[2] = gen.stream(3)();
+        return values;
+    }();
+
+    random::generators::ChaCha20 gen(17);
+    std::array<std::uint32_t, 3> values{};
+    values[0] = gen();
+    for (std::size_t i = 0; i < 1000; ++i) gen(); // sequential generation goes through all of the buffer refills
+    values[1] = gen();
+    gen.discard(123'456);
+    values[2] = gen.stream(3)();
+
+    CHECK(values == compile_time_values);
+}
+
+// ================================
+// --- Counter-based generators ---
+// ================================
+
+TEST_CASE("Philox rounds match the known-answer tests") {
+    // Values are taken from the 'kat_vectors' of the reference Random123 library
+    using random::generators::_philox_rounds;
+
+    using u32 = std::uint32_t;
+    using u64 = std::uint64_t;
+
+    CHECK(_philox_rounds<u32>({0, 0, 0, 0}, {0, 0}) ==
+          std::array<u32, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    CHECK(_philox_rounds<u32>({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+          std::array<u32, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    CHECK(_philox_rounds<u32>({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+          std::array<u32, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+
+    CHECK(_philox_rounds<u64>({0, 0, 0, 0}, {0, 0}) ==
+          std::array<u64, 4>{0x16554d9eca36314c, 0xdb20fe9d672d0fdc, 0xd7e772cee186176b, 0x7e68b68aec7ba23b});
+    constexpr u64 ones = 0xffffffffffffffff;
+    CHECK(_philox_rounds<u64>({ones, ones, ones, ones}, {ones, ones}) ==
+          std::array<u64, 4>{0x87b092c3013fe90b, 0x438c3c67be8d0224, 0x9cc7d7c69cd777b6, 0xa09caebf594f0ba0});
+}
+
+template <class Generator>
+void check_counter_access() {
+    // Sequential generation is the same as stateless access
+    Generator gen(17);
+    bool      sequence_matches = true;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        const auto block = gen.at(i);
+        for (const auto& e : block) sequence_matches &= (e == gen());
+    }
+    CHECK(sequence_matches);
+
+    Generator stream(17);
+    for (std::size_t i = 0; i < 3; ++i) (void)stream.split();
+    stream.discard(4 * 5);
+    CHECK(stream() == gen.at(5, 3)[0]);
+
+    // Batch access is the same as single block access, including the carry into the upper counter words
+    for (std::uint64_t start : {std::uint64_t(0), std::uint64_t(5), std::uint64_t(0xFFFFFFF0)}) {
+        std::vector<typename Generator::result_type> values(4 * 100);
+        gen.at(start, 7, values.data(), 100);
+
+        bool batch_matches = true;
+        for (std::size_t i = 0; i < 100; ++i) {
+            const auto block = gen.at(start + i, 7);
+            for (std::size_t j = 0; j < 4; ++j) batch_matches &= (values[4 * i + j] == block[j]);
+        }
+        CHECK(batch_matches);
+    }
+}
+
+TEST_CASE("Philox sequential, single block & batch access agree") {
+    check_counter_access<random::generators::Philox4x32>();
+    check_counter_access<random::generators::Philox4x64>();
+
+    // Constant evaluation always takes the scalar path
+    constexpr auto compile_time_block = random::generators::Philox4x32(17).at(1000, 2);
+    CHECK(random::generators::Philox4x32(17).at(1000, 2) == compile_time_block);
+}
+
+// =======================
+// --- Bulk generation ---
+// =======================
+
+TEST_CASE("Bulk generation matches the lane streams") {
+    constexpr std::size_t lanes = 16;
+    constexpr std::size_t size  = 1 << 17; // large enough to use multi-lane generation
+
+    random::generators::Xoshiro256PlusPlus bulk(17), first_lane(17);
+
+    std::vector<std::uint64_t> values(size);
+    random::generate(bulk, values);
+
+    bool lanes_match = true;
+    for (std::size_t k = 0; k < size / lanes; ++k) lanes_match &= (values[k * lanes] == first_lane());
+    CHECK(lanes_match);
+    CHECK(bulk() == first_lane()); // generator continues the first lane
+
+    // Third lane starts 2 * 2^96 steps ahead, value was computed independently from the characteristic polynomial
+    CHECK(values[2] == 6547991070290527744ull);
+
+    // Small sizes are generated sequentially
+    random::generators::RomuTrio32 small(17), sequential(17);
+    std::array<std::uint32_t, 100> small_values;
+    random::generate(small, small_values);
+    for (const auto& e : small_values) CHECK(e == sequential());
+}
+
+TEST_CASE("Bulk generation lanes don't coincide with public streams") {
+    // Lanes that match 'split()' or 'long_jump()' streams would repeat values between split or distributed
+    // generators that all fill their data in bulk, lane outputs should never appear in any of these streams
+    constexpr std::size_t lanes = 16;
+    constexpr std::size_t size  = 1 << 17;
+
+    auto check_lanes = [&](auto gen) {
+        using generator = decltype(gen);
+
+        std::vector<typename generator::result_type> values(size);
+        auto                                         bulk = gen;
+        random::generate(bulk, values);
+
+        // Lane 0 is the original stream, everything else should be new
+        std::unordered_set<typename generator::result_type> lane_values;
+        for (std::size_t i = 0; i < size; ++i)
+            if (i % lanes) lane_values.insert(values[i]);
+
+        std::vector<generator> streams;
+        for (std::uint64_t n = 1; n <= lanes; ++n) streams.push_back(gen.stream(n));
+        if constexpr (std::is_same_v<generator, random::generators::Xoshiro256PlusPlus>) {
+            auto machine = gen;
+            for (std::size_t n = 1; n <= lanes; ++n) {
+                machine.long_jump();
+                streams.push_back(machine);
+                streams.push_back(machine.stream(1));
+            }
+        }
+
+        std::size_t collisions = 0;
+        for (auto& stream : streams)
+            for (std::size_t i = 0; i < size / lanes; ++i) collisions += lane_values.count(stream());
+        return collisions;
+    };
+
+    // 32-bit values can collide by chance, for 'RomuTrio32' we expect ~2^17 * 2^17 * 16 / 2^32 = 64 of them,
+    // while coinciding streams would produce hundreds of thousands
+    CHECK(check_lanes(random::generators::Xoshiro256PlusPlus(17)) == 0);
+    CHECK(check_lanes(random::generators::RomuTrio32(17)) < 1000);
+}
+
+TEST_CASE("Bulk uniform & normal fills are sensible") {
+    constexpr std::size_t N   = 500'000;
+    constexpr double      eps = 2e-2;
+
+    std::vector<double> vec(N);
+
+    random::fill_uniform(vec, -8., 8.);
+    CHECK(vec_mean(vec) == doctest::Approx(0.0).epsilon(eps));
+    CHECK(vec_min(vec) == doctest::Approx(-8.0).epsilon(eps));
+    CHECK(vec_max(vec) == doctest::Approx(8.0).epsilon(eps));
+
+    random::generators::RomuTrio32 gen(17);
+    random::fill_uniform(gen, vec);
+    CHECK(vec_mean(vec) == doctest::Approx(0.5).epsilon(eps));
+    CHECK(vec_min(vec) >= 0.);
+    CHECK(vec_max(vec) < 1.);
+
+    random::fill_normal(vec, 2., 3.);
+    double variance = 0.;
+    for (const auto& e : vec) variance += (e - 2.) * (e - 2.);
+    variance /= N;
+    CHECK(vec_mean(vec) == doctest::Approx(2.0).epsilon(eps));
+    CHECK(variance == doctest::Approx(9.0).epsilon(eps));
+
+    std::vector<float> odd_size(N + 1, -100.f);
+    random::fill_normal(odd_size);
+    CHECK(odd_size.back() != -100.f);
+}
+
+// ================================
+// --- Quasi-random sequences ---
+// ================================
+
+template <class Sequence>
+void check_sequence_access(std::size_t dimensions) {
+    Sequence sequential(dimensions), skipped(dimensions), indexed(dimensions);
+    skipped.discard(1000);
+
+    std::vector<double> point(dimensions), expected(dimensions);
+    bool                points_match = true, points_in_range = true;
+    for (std::uint64_t i = 0; i < 2000; ++i) {
+        sequential.next(point);
+        indexed.at(i, expected);
+        points_match &= (point == expected);
+        for (const auto& e : point) points_in_range &= (0. <= e && e < 1.);
+
+        if (i < 1000) continue;
+        skipped.next(point);
+        points_match &= (point == expected);
+    }
+    CHECK(points_match);
+    CHECK(points_in_range);
+    CHECK(sequential.index() == 2000);
+
+    std::vector<double> wrong_size(dimensions + 1);
+    CHECK_THROWS_AS(sequential.next(wrong_size), std::invalid_argument);
+    CHECK_THROWS_AS(Sequence(0), std::invalid_argument);
+}
+
+TEST_CASE("Quasi-random sequences support sequential, skip-ahead & random access") {
+    check_sequence_access<random::sequences::Sobol>(7);
+    check_sequence_access<random::sequences::Halton>(7);
+    check_sequence_access<random::sequences::R2>(7);
+}
+
+TEST_CASE("Sobol sequence matches the reference direction numbers") {
+    // Values generated by 'boost::random::sobol' which uses the same Joe-Kuo direction numbers
+    const random::sequences::Sobol sobol(1024);
+
+    const auto integer_at = [&](std::uint64_t index, std::size_t dimension) {
+        return static_cast<std::uint32_t>(sobol.at(index, dimension) * 4294967296.);
+    };
+
+    for (std::size_t d : {0, 1, 9, 1023}) CHECK(integer_at(0, d) == 0);
+    for (std::size_t d : {0, 1, 9, 1023}) CHECK(integer_at(1, d) == 2147483648);
+
+    CHECK(integer_at(1000, 0) == 943718400);
+    CHECK(integer_at(1000, 1) == 415236096);
+    CHECK(integer_at(1000, 9) == 297795584);
+    CHECK(integer_at(1000, 1023) == 3066036224);
+
+    CHECK(integer_at(123456789, 0) == 4191448864);
+    CHECK(integer_at(123456789, 1) == 3403469216);
+    CHECK(integer_at(123456789, 9) == 1734853024);
+    CHECK(integer_at(123456789, 1023) == 2876975264);
+
+    CHECK_THROWS_AS(random::sequences::Sobol(1025), std::invalid_argument);
+    CHECK_THROWS_AS((void)sobol.at(random::sequences::Sobol::max_points, 0), std::out_of_range);
+}
+
+TEST_CASE("Halton & R2 sequences produce the expected points") {
+    const random::sequences::Halton halton(3);
+    const double                    halton_points[][3] = {
+        {0.,     0.,     0.    },
+        {1. / 2, 1. / 3, 1. / 5},
+        {1. / 4, 2. / 3, 2. / 5},
+        {3. / 4, 1. / 9, 3. / 5},
+        {1. / 8, 4. / 9, 4. / 5}
+    };
+    for (std::uint64_t i = 0; i < 5; ++i)
+        for (std::size_t d = 0; d < 3; ++d) CHECK(halton.at(i, d) == doctest::Approx(halton_points[i][d]));
+    CHECK(halton.at(~std::uint64_t(0), 0) < 1.);
+
+    // 1D case is the golden ratio sequence, 2D case uses the plastic number
+    const random::sequences::R2 golden(1), plastic(2);
+    CHECK(golden.at(0, 0) == 0.5);
+    CHECK(golden.at(1, 0) == doctest::Approx(0.1180339887498949));
+    CHECK(plastic.at(1, 0) == doctest::Approx(0.2548776662466927));
+    CHECK(plastic.at(1, 1) == doctest::Approx(0.0698402909980532));
+}
+
+TEST_CASE("Quasi-random sequences have low discrepancy") {
+    // Largest deviation of the fraction of points inside '[0, a) x [0, b)' from its area 'a * b',
+    // random points have it around ~1e-2 at this N while low-discrepancy sequences should get ~1e-3
+    constexpr std::size_t N = 1 << 12, grid = 16;
+
+    const auto discrepancy = [&](auto&& sequence) {
+        std::vector<std::array<double, 2>> points(N);
+        for (auto& point : points) sequence.next(point);
+
+        double worst = 0.;
+        for (std::size_t i = 1; i <= grid; ++i) {
+            for (std::size_t j = 1; j <= grid; ++j) {
+                const double a = 0.97 * i / grid, b = 0.93 * j / grid; // avoid dyadic boxes that favor Sobol
+
+                std::size_t count = 0;
+                for (const auto& p : points) count += (p[0] < a && p[1] < b);
+                worst = std::max(worst, std::abs(static_cast<double>(count) / N - a * b));
+            }
+        }
+        return worst;
+    };
+
+    CHECK(discrepancy(random::sequences::Sobol(2)) < 3e-3);
+    CHECK(discrepancy(random::sequences::Halton(2)) < 3e-3);
+    CHECK(discrepancy(random::sequences::R2(2)) < 3e-3);
+}
+
+// ==============================
+// --- Shuffling & sampling ---
+// ==============================
+
+TEST_CASE("Shuffle produces the same permutation for any thread count") {
+    constexpr std::size_t N = (1 << 20) + 3; // large enough to use several merge levels
+
+    std::vector<std::uint32_t> single(N), multiple(N);
+    std::iota(single.begin(), single.end(), 0);
+    std::iota(multiple.begin(), multiple.end(), 0);
+
+    random::generators::Xoshiro256PlusPlus gen_1(17), gen_2(17);
+    random::_shuffle(gen_1, single.data(), N, 1);
+    random::_shuffle(gen_2, multiple.data(), N, 4);
+    CHECK(single == multiple);
+
+    // Every element should end up in a random quarter of the array, merges are what moves them between the blocks
+    std::size_t stayed = 0;
+    for (std::size_t i = 0; i < N; ++i) stayed += (single[i] * std::uint64_t(4) / N == i * 4 / N);
+    CHECK(static_cast<double>(stayed) / N == doctest::Approx(0.25).epsilon(0.02));
+
+    std::sort(single.begin(), single.end());
+    bool is_permutation = true;
+    for (std::size_t i = 0; i < N; ++i) is_permutation &= (single[i] == i);
+    CHECK(is_permutation);
+
+    // Non-trivial types use regular swaps
+    std::vector<std::string> strings(100'000);
+    for (std::size_t i = 0; i < strings.size(); ++i) strings[i] = "long enough to allocate " + std::to_string(i);
+    random::shuffle(gen_1, strings);
+    std::sort(strings.begin(), strings.end());
+    CHECK(std::adjacent_find(strings.begin(), strings.end()) == strings.end());
+}
+
+TEST_CASE("Shuffle merges produce every permutation with the same probability") {
+    constexpr int trials = 120'000;
+
+    random::generators::Xoshiro256PlusPlus gen(17);
+    std::map<std::array<int, 5>, int>      counts;
+    for (int i = 0; i < trials; ++i) {
+        std::array<int, 5> values = {0, 1, 2, 3, 4};
+        random::_fisher_yates(gen, values.data(), 2);
+        random::_fisher_yates(gen, values.data() + 2, 3);
+        random::_merge_shuffled(gen, values.data(), 2, 5);
+        ++counts[values];
+    }
+
+    CHECK(counts.size() == 120);
+    for (const auto& [permutation, count] : counts) CHECK(count == doctest::Approx(trials / 120).epsilon(0.15));
+}
+
+TEST_CASE("Reservoir sampling selects every element with the same probability") {
+    constexpr int trials = 100'000;
+
+    const std::vector<int> vector = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const std::list<int>   list(vector.begin(), vector.end()); // skips one element at a time
+
+    random::generators::Xoshiro256PlusPlus gen(17);
+    std::vector<int>                       vector_counts(10), list_counts(10);
+    for (int i = 0; i < trials; ++i) {
+        for (int e : random::sample_reservoir(gen, vector.begin(), vector.end(), 3)) ++vector_counts[e];
+        for (int e : random::sample_reservoir(gen, list.begin(), list.end(), 3)) ++list_counts[e];
+    }
+    for (int e : vector_counts) CHECK(e == doctest::Approx(0.3 * trials).epsilon(0.02));
+    for (int e : list_counts) CHECK(e == doctest::Approx(0.3 * trials).epsilon(0.02));
+
+    CHECK(random::sample_reservoir(gen, vector.begin(), vector.end(), 20) == vector);
+    CHECK(random::sample_reservoir(gen, vector.begin(), vector.end(), 0).empty());
+}
+
+TEST_CASE("Floyd sampling returns sorted distinct indices") {
+    random::generators::Xoshiro256PlusPlus gen(17);
+
+    // Dense samples use a bitmap, sparse ones use a hash set
+    for (const auto& [n, k] : std::vector<std::pair<std::size_t, std::size_t>>{
+             {1000, 300}, {64, 64}, {100, 0}, {1'000'000'000, 1000}
+    }) {
+        const auto indices = random::sample_indices(gen, n, k);
+        CHECK(indices.size() == k);
+        CHECK(std::is_sorted(indices.begin(), indices.end()));
+        CHECK(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+        if (k) CHECK(indices.back() < n);
+    }
+
+    // Sparse indices are counted in 20 buckets of 10'000 indices each
+    constexpr int    trials = 100'000;
+    std::vector<int> dense_counts(20), sparse_counts(20);
+    for (int i = 0; i < trials; ++i) {
+        for (auto index : random::sample_indices(gen, 20, 5)) ++dense_counts[index];
+        for (auto index : random::sample_indices(gen, 200'000, 100)) ++sparse_counts[index / 10'000];
+    }
+    for (int e : dense_counts) CHECK(e == doctest::Approx(0.25 * trials).epsilon(0.03));
+    for (int e : sparse_counts) CHECK(e == doctest::Approx(5 * trials).epsilon(0.03));
+
+    CHECK_THROWS_AS((void)random::sample_indices(gen, 5, 6), std::invalid_argument);
+}
+
+// ===================================
+// --- Statistical smoke battery ---
+// ===================================
+
+// Quick versions of the bit frequency, birthday spacings & gap tests (see Knuth TAOCP Vol. 2 and TestU01),
+// every test returns the z-score of its statistic. This is nowhere near a proper test suite like PractRand,
+// but optimizations that break a generator (lost carries, wrong lane offsets, correlated streams) tend to fail
+// these by hundreds of sigmas, which makes them a cheap regression check.
+
+double chi_squared_z(double chi_squared, double dof) {
+    // Wilson-Hilferty transform, 'chi_squared / dof' is approximately normal after taking a cube root
+    const double a = 2. / (9. * dof);
+    return (std::cbrt(chi_squared / dof) - (1. - a)) / std::sqrt(a);
+}
+
+template <class T>
+double bit_frequency_z(const std::vector<T>& values) {
+    const double n = static_cast<double>(values.size());
+
+    double worst = 0;
+    for (int b = 0; b < nlim<T>::digits; ++b) {
+        std::uint64_t ones = 0;
+        for (const T& e : values) ones += (e >> b) & 1;
+        worst = std::max(worst, std::abs((static_cast<double>(ones) - n / 2) / std::sqrt(n / 4)));
+    }
+    return worst;
+}
+
+template <class T>
+double birthday_spacings_z(const std::vector<T>& values, bool low_bits) {
+    // 512 birthdays in a year of 2^24 days, duplicate spacings are Poisson with 'lambda = m^3 / (4 n) = 2'
+    constexpr std::size_t m = 512;
+
+    std::vector<std::uint32_t> days(m), spacings(m);
+
+    const std::size_t samples    = values.size() / m;
+    std::size_t       duplicates = 0;
+    for (std::size_t s = 0; s < samples; ++s) {
+        for (std::size_t i = 0; i < m; ++i) {
+            const T x = values[s * m + i];
+            days[i]   = static_cast<std::uint32_t>(low_bits ? x & 0xFFFFFF : x >> (nlim<T>::digits - 24));
+        }
+        std::sort(days.begin(), days.end());
+
+        spacings[0] = days[0];
+        for (std::size_t i = 1; i < m; ++i) spacings[i] = days[i] - days[i - 1];
+        std::sort(spacings.begin(), spacings.end());
+
+        for (std::size_t i = 1; i < m; ++i) duplicates += (spacings[i] == spacings[i - 1]);
+    }
+
+    const double expected = 2. * static_cast<double>(samples);
+    return (static_cast<double>(duplicates) - expected) / std::sqrt(expected);
+}
+
+template <class T>
+double gap_z(const std::vector<T>& values) {
+    // Gaps between the values in '[1/4, 3/8)' are geometric, longer ones are lumped into the last category
+    constexpr std::size_t t = 64;
+    constexpr double      p = 1. / 8;
+
+    std::array<std::uint64_t, t + 1> counts{};
+    std::size_t                      gap = 0, gaps = 0;
+    for (const T& e : values) {
+        const auto u = static_cast<std::uint32_t>(e >> (nlim<T>::digits - 32)) >> 29; // top 3 bits
+        if (u == 2) ++counts[std::min(gap, t)], ++gaps, gap = 0;
+        else ++gap;
+    }
+
+    double chi_squared = 0, probability = p;
+    for (std::size_t r = 0; r <= t; ++r, probability *= 1 - p) {
+        const double expected = static_cast<double>(gaps) * (r < t ? probability : std::pow(1 - p, t));
+        const double diff     = static_cast<double>(counts[r]) - expected;
+        chi_squared += diff * diff / expected;
+    }
+    return chi_squared_z(chi_squared, t);
+}
+
+template <class T>
+double worst_battery_z(const std::vector<T>& values) {
+    return std::max({bit_frequency_z(values), std::abs(birthday_spacings_z(values, false)),
+                     std::abs(birthday_spacings_z(values, true)), std::abs(gap_z(values))});
+}
+
+constexpr std::size_t battery_size      = 1 << 20;
+constexpr double      battery_threshold = 5.5; // good generators stay under ~4 sigma
+
+template <class Generator>
+void check_statistical_battery() {
+    using T = typename Generator::result_type;
+
+    // Sequential stream
+    Generator      gen(17);
+    std::vector<T> sequential(battery_size);
+    for (auto& e : sequential) e = gen();
+    CHECK(worst_battery_z(sequential) < battery_threshold);
+
+    // Interleaved split streams, each one filled in bulk
+    constexpr std::size_t       streams = 4;
+    std::vector<std::vector<T>> children(streams, std::vector<T>(battery_size / streams));
+    for (auto& child : children) {
+        Generator child_gen = gen.split();
+        random::generate(child_gen, child);
+    }
+
+    std::vector<T> interleaved(battery_size);
+    for (std::size_t i = 0; i < battery_size; ++i) interleaved[i] = children[i % streams][i / streams];
+    CHECK(worst_battery_z(interleaved) < battery_threshold);
+}
+
+TEST_CASE("Generators pass the statistical smoke battery") {
+    check_statistical_battery<random::generators::RomuTrio32>();
+    check_statistical_battery<random::generators::JSF32>();
+    check_statistical_battery<random::generators::RomuDuoJr>();
+    check_statistical_battery<random::generators::JSF64>();
+    check_statistical_battery<random::generators::Xoshiro256PlusPlus>();
+    check_statistical_battery<random::generators::Xorshift64Star>();
+    check_statistical_battery<random::generators::ChaCha20>();
+    check_statistical_battery<random::generators::Philox4x32>();
+    check_statistical_battery<random::generators::Philox4x64>();
+}
+
+TEST_CASE("Statistical smoke battery catches broken generators") {
+    std::vector<std::uint64_t> values(battery_size);
+
+    // Weyl sequence has perfect bit frequencies, but its spacings & gaps are far too regular
+    std::uint64_t weyl = 0;
+    for (auto& e : values) e = (weyl += 0x9E3779B97F4A7C15);
+    CHECK(worst_battery_z(values) > battery_threshold);
+
+    // A single stuck bit in an otherwise good generator
+    random::generators::Xoshiro256PlusPlus gen(17);
+    for (auto& e : values) e = gen() | (std::uint64_t(1) << 17);
+    CHECK(worst_battery_z(values) > battery_threshold);
+}